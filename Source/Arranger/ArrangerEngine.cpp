@@ -2,7 +2,11 @@
 #include "ArrangerTime.h"
 #include "ArrangerCountIn.h"
 
-ArrangerEngine::ArrangerEngine (std::weak_ptr<juce::MidiOutput> out) : outputDevice (out) {}
+ArrangerEngine::ArrangerEngine (std::weak_ptr<juce::MidiOutput> out) : outputDevice (out)
+{
+    clearPlayedNotes();
+    sequencerStep.segments.reserve (64);
+}
 
 ArrangerEngine::~ArrangerEngine()
 {
@@ -43,8 +47,15 @@ void ArrangerEngine::rebuildFromStyle()
         schedulers.push_back (std::move (s));
     }
 
+    // One tick can emit at most a full loop of a section plus its seam note-offs.
+    size_t maxEmitted = 0;
+    for (const auto& s : schedulers)
+        maxEmitted = std::max (maxEmitted, (size_t) s.getNumEvents());
+    emitted.reserve (maxEmitted + 16 * 128);
+
     sequencer.setStyle (style);
     currentSchedulerIndex = -1;
+    renderedSectionIndex.store (sequencer.getActiveIndex());
     updateActiveLoopLength();
 }
 
@@ -111,9 +122,14 @@ void ArrangerEngine::setStyle (ArrangerStyle newStyle)
     if (wasPlaying)
     {
         stopTimer();
-        silenceArrangerNotes();
     }
 
+    // In audio-clock mode stopTimer() doesn't idle the renderer; holding renderLock does (the audio
+    // thread skips a block rather than wait on it).
+    const juce::SpinLock::ScopedLockType rl (renderLock);
+    if (wasPlaying)
+        dispatchFromMessageThread ([this] { silenceArrangerNotes(); });
+
     style = std::move (newStyle);
     if (style.originalTempo > 0.0) currentBpm = style.originalTempo;
     rebuildFromStyle();
@@ -161,48 +177,92 @@ void ArrangerEngine::setActiveChord (ArrangerChord played)
 
 void ArrangerEngine::setOriginalChord (ArrangerChord recorded)
 {
+    const juce::SpinLock::ScopedLockType rl (renderLock);   // swaps the transposer's active table
     transposer.setOriginalChord (recorded);
 }
 
 void ArrangerEngine::setBassInversion (bool shouldInvert)
 {
+    const juce::SpinLock::ScopedLockType rl (renderLock);
     transposer.setBassInversion (shouldInvert);
 }
 
 void ArrangerEngine::dispatch (const juce::MidiMessage& m)
 {
-    if (auto out = outputDevice.lock())
+    if (blockOut != nullptr)
+    {
+        // Rendering an audio block: the SFZ gets the note at its exact sample; MIDI-out gets it queued
+        // with the time that sample will be heard, for the timer thread to schedule.
+        const int pos = juce::jlimit (0, juce::jmax (0, blockNumSamples - 1),
+                                      juce::roundToInt (dispatchOffsetBeats * blockSamplesPerBeat));
+        blockOut->addEvent (m, pos);
+        scheduleMidiOut (m, blockOutputSeconds + (blockSampleRate > 0.0 ? pos / blockSampleRate : 0.0));
+        return;
+    }
+
+    // A timer tick (or a message-thread stop) queues MIDI-out at the event's own time within the window,
+    // instead of sending the whole window at once when the tick happens to run.
+    if (windowStartSeconds >= 0.0)
+        scheduleMidiOut (m, windowStartSeconds + ArrangerTime::beatsToSeconds (dispatchOffsetBeats, currentBpm));
+    else if (auto out = outputDevice.lock())
         out->sendMessageNow (m);
     if (onMidiMessage)
         onMidiMessage (m);
 }
 
+void ArrangerEngine::scheduleMidiOut (const juce::MidiMessage& m, double playSeconds)
+{
+    if (outputDevice.expired())
+        return;
+
+    const double at = playSeconds + midiOutLookaheadSeconds;
+    scheduledMidiOut.push (m, at);
+    lastScheduledSeconds = juce::jmax (lastScheduledSeconds, at);
+}
+
+template <typename Fn>
+void ArrangerEngine::dispatchFromMessageThread (Fn&& fn)
+{
+    // Message thread, with the timer stopped and renderLock held, so nothing else queues or drains
+    // MIDI-out. Stamp from the last event already queued: a note-off sent now could otherwise reach the
+    // device before a note-on still waiting in MidiOutput's buffer, and hang it.
+    windowStartSeconds  = juce::jmax (juce::Time::getMillisecondCounterHiRes() * 0.001,
+                                      lastScheduledSeconds - midiOutLookaheadSeconds);
+    dispatchOffsetBeats = 0.0;
+    fn();
+    windowStartSeconds  = -1.0;
+    forwardScheduledOutput();
+}
+
 void ArrangerEngine::dispatchEmitted (const EmittedEvent& e)
 {
-    juce::MidiMessage m = e.message;
+    const auto& m = e.message;
+    const int ch  = m.getChannel();
 
-    if (m.isNoteOn() && m.getVelocity() > 0 && e.part != PartKind::Fixed)
+    if (m.isNoteOn() && e.part != PartKind::Fixed)
     {
         // Transpose the pitched note and remember the played pitch, keyed by its ORIGINAL note, so
         // the matching note-off (which carries the original pitch) closes the same sounding note even
         // if the chord changed in between.
         const int orig   = m.getNoteNumber();
-        const int played = transposer.transpose (orig, e.part);
-        activePlayedNote[{ m.getChannel(), orig }] = played;
-        m = juce::MidiMessage::noteOn (m.getChannel(), played, m.getVelocity());
+        const int played = transposer.lookup (orig, e.part);
+        activePlayedNote[(size_t) ((ch - 1) * 128 + orig)] = (juce::int8) played;
+        dispatch (juce::MidiMessage::noteOn (ch, played, (juce::uint8) m.getVelocity()));
+        return;
     }
-    else if (m.isNoteOff() || (m.isNoteOn() && m.getVelocity() == 0))
+    if (m.isNoteOff())
     {
-        const auto key = std::make_pair (m.getChannel(), m.getNoteNumber());
-        const auto it  = activePlayedNote.find (key);
-        if (it != activePlayedNote.end())
+        auto& played = activePlayedNote[(size_t) ((ch - 1) * 128 + m.getNoteNumber())];
+        if (played >= 0)
         {
-            m = juce::MidiMessage::noteOff (m.getChannel(), it->second);
-            activePlayedNote.erase (it);
+            const int note = played;
+            played = -1;
+            dispatch (juce::MidiMessage::noteOff (ch, note));
+            return;
         }
     }
 
-    dispatch (m);
+    dispatch (m.toMidiMessage());
 }
 
 void ArrangerEngine::silenceArrangerNotes()
@@ -214,12 +274,17 @@ void ArrangerEngine::silenceArrangerNotes()
     // note for pitched parts (and clears activePlayedNote) while leaving drums/Fixed as-is. Any pitched
     // note still tracked (e.g. its scheduler was already reset) is then closed directly.
     for (auto& s : schedulers)
-        for (auto& e : s.flushActiveNotes (0.0))
+    {
+        emitted.clear();
+        s.flushActiveNotes (0.0, emitted);
+        for (const auto& e : emitted)
             dispatchEmitted (e);
+    }
 
-    for (const auto& entry : activePlayedNote)
-        dispatch (juce::MidiMessage::noteOff (entry.first.first, entry.second));
-    activePlayedNote.clear();
+    for (int slot = 0; slot < (int) activePlayedNote.size(); ++slot)
+        if (activePlayedNote[(size_t) slot] >= 0)
+            dispatch (juce::MidiMessage::noteOff (slot / 128 + 1, (int) activePlayedNote[(size_t) slot]));
+    clearPlayedNotes();
 }
 
 void ArrangerEngine::sendInstrumentSetup()
@@ -252,7 +317,10 @@ bool ArrangerEngine::renderCountIn (double deltaBeats)
     const double from = countInPlayhead;
     const double to   = countInPlayhead + deltaBeats;
     for (const auto& c : ArrangerCountIn::clicksInWindow (from, to, countInLengthBeats))
+    {
+        dispatchOffsetBeats = c.beat - from;
         dispatch (juce::MidiMessage::noteOn (c.channel, c.note, (juce::uint8) c.velocity));
+    }
 
     countInPlayhead = to;
     if (countInPlayhead >= countInLengthBeats)
@@ -271,9 +339,10 @@ void ArrangerEngine::renderRange (double fromBeats, double toBeats)
     // Apply any UI-queued section switch before advancing. Done here (not only in the timer callback)
     // so the request is honoured whether we're driven by the timer or by a direct renderRange call
     // (e.g. unit tests). The lock guards the request fields; sequencer mutation stays on this thread.
+    // Try-locks: this may be the audio thread, and a request that's mid-write just applies next window.
     {
-        const juce::ScopedLock sl (requestLock);
-        if (hasQueuedRequest)
+        const juce::ScopedTryLock sl (requestLock);
+        if (sl.isLocked() && hasQueuedRequest)
         {
             sequencer.queue (requestedType, requestedName);
             hasQueuedRequest = false;
@@ -282,25 +351,33 @@ void ArrangerEngine::renderRange (double fromBeats, double toBeats)
 
     // Apply the latest played chord (from the MIDI input thread) before emitting this window's notes.
     {
-        const juce::ScopedLock sl (chordLock);
-        if (hasChordUpdate)
+        const juce::ScopedTryLock sl (chordLock);
+        if (sl.isLocked() && hasChordUpdate)
         {
             transposer.setActiveChord (pendingChord);
             hasChordUpdate = false;
         }
     }
 
-    SequencerStep step = sequencer.advance (fromBeats, toBeats);
+    sequencer.advance (fromBeats, toBeats, sequencerStep);
+    const SequencerStep& step = sequencerStep;
 
+    // Segments tile the window in order; segmentStartAbs tracks where each one begins so every event
+    // knows its offset from fromBeats (used for sample positions when rendering an audio block).
+    double segmentStartAbs = fromBeats;
     for (const auto& seg : step.segments)
     {
+        dispatchOffsetBeats = segmentStartAbs - fromBeats;
+
         if (seg.sectionIndex != currentSchedulerIndex)
         {
             // Flush the outgoing section's hung notes, then reset both sides so the
             // incoming section enters clean at its own bar 0.
             if (currentSchedulerIndex >= 0 && currentSchedulerIndex < (int) schedulers.size())
             {
-                for (auto& e : schedulers[currentSchedulerIndex].flushActiveNotes (0.0))
+                emitted.clear();
+                schedulers[currentSchedulerIndex].flushActiveNotes (0.0, emitted);
+                for (const auto& e : emitted)
                     dispatchEmitted (e);
                 schedulers[currentSchedulerIndex].reset();
             }
@@ -310,20 +387,136 @@ void ArrangerEngine::renderRange (double fromBeats, double toBeats)
         }
 
         if (seg.sectionIndex >= 0 && seg.sectionIndex < (int) schedulers.size())
-            for (auto& e : schedulers[seg.sectionIndex].advance (seg.localFromBeats, seg.localToBeats))
+        {
+            emitted.clear();
+            schedulers[seg.sectionIndex].advance (seg.localFromBeats, seg.localToBeats, emitted);
+            for (const auto& e : emitted)
+            {
+                dispatchOffsetBeats = segmentStartAbs - fromBeats + (e.beats - seg.localFromBeats);
                 dispatchEmitted (e);
+            }
+        }
+
+        segmentStartAbs += seg.localToBeats - seg.localFromBeats;
     }
 
     if (step.stopRequested)
     {
-        haltAudio();            // silence + reset, but do not touch the timer here
-        timerShouldStop = true; // the timer callback will stop the timer on the message thread
+        // This may be the audio thread: reset without posting anything. The timer sees timerShouldStop
+        // and has the message thread stop it and tell the UI.
+        dispatchOffsetBeats = segmentStartAbs - fromBeats;
+        if (resetPlayback())
+            stoppedItself = true;
+        timerShouldStop = true;
         return;
     }
 
+    renderedSectionIndex.store (sequencer.getActiveIndex());
     updateActiveLoopLength();
 }
 
+void ArrangerEngine::renderRange (double fromBeats, double toBeats, juce::MidiBuffer& out, int numSamples)
+{
+    if (toBeats <= fromBeats || numSamples <= 0)
+        return;
+
+    blockOut            = &out;
+    blockNumSamples     = numSamples;
+    blockSamplesPerBeat = (double) numSamples / (toBeats - fromBeats);
+    renderRange (fromBeats, toBeats);
+    blockOut = nullptr;
+}
+
+void ArrangerEngine::setAudioClockDriven (bool shouldBeDriven)
+{
+    const juce::SpinLock::ScopedLockType rl (renderLock);
+    audioClockDriven.store (shouldBeDriven);
+    // Handing back to the timer: restart its wall-clock so the first tick doesn't see the whole time
+    // the audio clock was in charge as one huge delta.
+    lastNowSeconds = (double) juce::Time::getHighResolutionTicks()
+                     / (double) juce::Time::getHighResolutionTicksPerSecond();
+}
+
+void ArrangerEngine::renderAudioBlock (juce::MidiBuffer& out, int numSamples, double sampleRate)
+{
+    if (! audioClockDriven.load() || ! playing.load() || numSamples <= 0 || sampleRate <= 0.0)
+    {
+        unrenderedSeconds = 0.0;
+        return;
+    }
+
+    const juce::SpinLock::ScopedTryLockType rl (renderLock);
+    if (! rl.isLocked())
+    {
+        unrenderedSeconds += numSamples / sampleRate;   // caught up with the next block we get the lock for
+        return;
+    }
+
+    // Phase 6: Synchro Start -- hold at the downbeat until the first chord clears the gate.
+    if (synchroArmed.load())
+    {
+        unrenderedSeconds = 0.0;
+        return;
+    }
+
+    const double carriedBeats = ArrangerTime::secondsToBeats (unrenderedSeconds, currentBpm);
+    const double deltaBeats   = ArrangerTime::secondsToBeats (numSamples / sampleRate, currentBpm);
+    unrenderedSeconds = 0.0;
+
+    // The block is heard roughly one block after this callback, which is when MIDI-out should play it too.
+    blockSampleRate    = sampleRate;
+    blockOutputSeconds = juce::Time::getMillisecondCounterHiRes() * 0.001 + numSamples / sampleRate;
+
+    if (countingIn.load())
+    {
+        blockOut            = &out;
+        blockNumSamples     = numSamples;
+        blockSamplesPerBeat = (double) numSamples / (carriedBeats + deltaBeats);
+        renderCountIn (carriedBeats + deltaBeats);
+        blockOut = nullptr;
+        return;
+    }
+
+    // Time skipped on a failed try-lock is rendered first and lands at sample 0: late, but in order,
+    // and the playhead stays on the audio clock.
+    const double from     = playheadBeats;
+    const double caughtUp = from + carriedBeats;
+    const double to       = caughtUp + deltaBeats;
+    if (caughtUp > from)
+        renderRange (from, caughtUp, out, 1);
+    if (playing.load())
+        renderRange (caughtUp, to, out, numSamples);
+    playheadBeats = to;
+    uiPlayheadBeats.store (playheadBeats);
+}
+
+void ArrangerEngine::forwardScheduledOutput()
+{
+    // Timer thread (or the message thread with the timer stopped). Everything queued since the last tick
+    // goes to the device in one time-stamped block; MidiOutput's own thread plays each event at its
+    // stamp, and the lookahead in the stamps covers the gap until the next tick, so MIDI-out keeps the
+    // render's timing instead of the timer's 10 ms granularity.
+    auto out = outputDevice.lock();
+    scheduledOutBlock.clear();
+
+    double firstMs = 0.0;
+    bool any = false;
+    scheduledMidiOut.drain ([&] (const QueuedMidiEvent& e)
+    {
+        const double ms = e.arrivalSeconds * 1000.0;
+        if (! any) { firstMs = ms; any = true; }
+        // 0.1 ms resolution: the block is sent as if recorded at 10 kHz.
+        scheduledOutBlock.addEvent (e.data, (int) e.size, juce::jmax (0, juce::roundToInt ((ms - firstMs) * 10.0)));
+    });
+
+    if (! any || out == nullptr)
+        return;
+
+    if (! out->isBackgroundThreadRunning())
+        out->startBackgroundThread();
+    out->sendBlockOfMessages (scheduledOutBlock, firstMs, 10000.0);
+}
+
 void ArrangerEngine::start (bool useTransportFeel)
 {
     if (schedulers.empty() || loopLengthBeats <= 0.0)
@@ -331,21 +524,29 @@ void ArrangerEngine::start (bool useTransportFeel)
 
     // A restart while already playing (e.g. pressing Preview again) must close the previous run's
     // sounding notes first; the reset/clear below would otherwise strand them as an overlapping drone.
-    if (playing.load())
-        silenceArrangerNotes();
+    // The timer is stopped for it so this thread is the only one sending MIDI-out.
+    const bool wasPlaying = playing.load();
+    if (wasPlaying)
+        stopTimer();
+
+    const juce::SpinLock::ScopedLockType rl (renderLock);   // audio-clock mode: no block mid-restart
+    if (wasPlaying)
+        dispatchFromMessageThread ([this] { silenceArrangerNotes(); });
 
     for (auto& s : schedulers) s.reset();
     sequencer.reset();
-    activePlayedNote.clear();
+    clearPlayedNotes();
     if (pendingStartIndex >= 0)
         sequencer.startAt (pendingStartIndex);
     pendingStartIndex = -1;
     currentSchedulerIndex = -1;
     lastReportedSectionIndex = -1;   // so the first tick reports the starting section
     timerShouldStop = false;
+    stoppedItself   = false;
 
     sendInstrumentSetup();   // select instruments + volumes before the first notes play
     playheadBeats = 0.0;
+    uiPlayheadBeats.store (0.0);
     lastNowSeconds = (double) juce::Time::getHighResolutionTicks()
                      / (double) juce::Time::getHighResolutionTicksPerSecond();
     // Transport feel (Synchro Start / Count-In) applies only to live performance. The editor preview
@@ -361,28 +562,42 @@ void ArrangerEngine::start (bool useTransportFeel)
 void ArrangerEngine::stop()
 {
     stopTimer();   // only safe off the timer thread; the Ending path defers this via callAsync
-    haltAudio();
+    bool wasPlaying = false;
+    {
+        const juce::SpinLock::ScopedLockType rl (renderLock);
+        dispatchFromMessageThread ([this, &wasPlaying] { wasPlaying = resetPlayback(); });
+    }
+    notifyStopped (stoppedItself.exchange (false) || wasPlaying);
 }
 
-void ArrangerEngine::haltAudio()
+bool ArrangerEngine::resetPlayback()
 {
+    // Runs on whichever thread renders (the audio thread for an Ending in audio-clock mode), so it only
+    // dispatches and resets plain state: no locks, no allocation, nothing posted to the message thread.
     const bool wasPlaying = playing.exchange (false);
     synchroArmed.store (false);   // Phase 6: never leave the Synchro gate armed across a stop
     countingIn.store (false);     // Phase 6b: cancel any in-progress count-in
     silenceArrangerNotes();
     for (auto& s : schedulers) s.reset();
     sequencer.reset();
-    activePlayedNote.clear();
+    clearPlayedNotes();
     currentSchedulerIndex = -1;
     pendingStartIndex = -1;
     playheadBeats = 0.0;
+    uiPlayheadBeats.store (0.0);
+    renderedSectionIndex.store (sequencer.getActiveIndex());
     lastReportedSectionIndex = -1;
+    return wasPlaying;
+}
+
+void ArrangerEngine::notifyStopped (bool stoppedPlaying)
+{
     if (onElapsedBeats)   // reset the beat bar to the downbeat, like the classic player does
         juce::MessageManager::callAsync ([this] { if (onElapsedBeats) onElapsedBeats (0.0); });
 
     // Only when we were actually playing: re-arm the first variation (sequencer.reset() landed on it)
     // and tell the UI we stopped, so the buttons clear the Ending and the beat bar leaves its play state.
-    if (wasPlaying)
+    if (stoppedPlaying)
     {
         notifyActiveSection (true);
         if (onStoppedItself)
@@ -392,7 +607,7 @@ void ArrangerEngine::haltAudio()
 
 void ArrangerEngine::notifyActiveSection (bool force)
 {
-    const int idx = sequencer.getActiveIndex();
+    const int idx = renderedSectionIndex.load();
     if (! force && idx == lastReportedSectionIndex)
         return;
     lastReportedSectionIndex = idx;
@@ -411,9 +626,36 @@ void ArrangerEngine::notifyActiveSection (bool force)
 
 void ArrangerEngine::hiResTimerCallback()
 {
+    if (audioClockDriven.load())
+    {
+        // The audio callback renders; this tick only ships MIDI-out ahead of time and updates the UI.
+        forwardScheduledOutput();
+
+        if (timerShouldStop.exchange (false))
+        {
+            juce::MessageManager::callAsync ([this] { stop(); });
+            return;
+        }
+        if (! playing.load())
+            return;
+
+        notifyActiveSection (false);
+        if (onElapsedBeats)
+        {
+            const double beats = uiPlayheadBeats.load();
+            juce::MessageManager::callAsync ([this, beats] { if (onElapsedBeats) onElapsedBeats (beats); });
+        }
+        return;
+    }
+
     if (! playing.load())
         return;
 
+    // Serialises against a switch to audio-clock mode made while this tick is rendering.
+    const juce::SpinLock::ScopedLockType rl (renderLock);
+    if (audioClockDriven.load())
+        return;
+
     const double now = (double) juce::Time::getHighResolutionTicks()
                        / (double) juce::Time::getHighResolutionTicksPerSecond();
 
@@ -432,10 +674,16 @@ void ArrangerEngine::hiResTimerCallback()
 
     const double deltaBeats = ArrangerTime::secondsToBeats (deltaSeconds, currentBpm);
 
+    // The window just rendered covers the last deltaSeconds; MIDI-out is stamped from its start so each
+    // event keeps its place within the tick (see dispatch).
+    windowStartSeconds = juce::Time::getMillisecondCounterHiRes() * 0.001 - deltaSeconds;
+
     // Phase 6b: count-in pre-roll — play one bar of metronome clicks before the section advances.
     if (countingIn.load())
     {
         renderCountIn (deltaBeats);
+        windowStartSeconds = -1.0;
+        forwardScheduledOutput();
         return;   // hold the section at beat 0 until the count-in bar elapses
     }
 
@@ -445,10 +693,12 @@ void ArrangerEngine::hiResTimerCallback()
 
     renderRange (from, to);
     playheadBeats = to;
+    windowStartSeconds = -1.0;
+    forwardScheduledOutput();
 
     notifyActiveSection (false);   // highlight the live button for the section now sounding
 
-    if (timerShouldStop)
+    if (timerShouldStop.load())
     {
         timerShouldStop = false;
         juce::MessageManager::callAsync ([this] { stop(); }); // stopTimer() safely off the timer thread
@@ -5,15 +5,27 @@
 #include "ArrangerSectionSequencer.h"
 #include "Chord.h"
 #include "ChordTransposer.h"
+#include "AudioClockMidiSource.h"
+#include "MidiEventQueue.h"
 #include <atomic>
 #include <vector>
-#include <map>
+#include <array>
 
 /**
  * Real-time arranger playback: loops the active section of a style to MIDI-out and/or
  * an inject callback (SFZ). Parallel to MultipleTrackPlayer; the classic player is untouched.
+ *
+ * Two clocks: by default a 10 ms HighResolutionTimer advances the groove from wall-clock deltas. In
+ * audio-clock mode (setAudioClockDriven) the audio callback renders it block by block through
+ * renderAudioBlock, so SFZ notes land on their exact sample, and the timer thread no longer renders.
+ *
+ * Either way MIDI-out is queued with the time each event should play plus midiOutLookaheadSeconds,
+ * and the timer hands it to MidiOutput's scheduling thread, so a tick that runs late still sends
+ * every event before it's due. The audio thread never sends, posts to the message thread or locks:
+ * an Ending that stops the engine mid-block only raises flags, which the timer picks up.
  */
-class ArrangerEngine : private juce::HighResolutionTimer
+class ArrangerEngine : private juce::HighResolutionTimer,
+                       public AudioClockMidiSource
 {
 public:
     std::function<void (const juce::MidiMessage&)> onMidiMessage; // SFZ inject
@@ -52,6 +64,10 @@ public:
     int getActiveSectionIndex() const;
     int peekPendingStartIndex() const { return pendingStartIndex; } // test seam
 
+    /** How far past its musical time MIDI-out is stamped: more than one timer tick, so the timer is
+        never late handing an event to the device. External synths hear the groove this much later. */
+    static constexpr double midiOutLookaheadSeconds = 0.015;
+
     /** Beats elapsed within the currently-active section (monotonic playhead minus the section's
         start). For the editor's section-relative playhead arrow; read on the message thread, so a
         sub-tick-stale value is fine. */
@@ -82,17 +98,34 @@ public:
 
     /** Render and dispatch events for the monotonic beat window [fromBeats, toBeats). Public for tests. */
     void renderRange (double fromBeats, double toBeats);
+    /** Render [fromBeats, toBeats) as one audio block of `numSamples`: events go into `out` at their
+        sample offsets instead of the inject callback (MIDI-out still receives them, time-stamped). */
+    void renderRange (double fromBeats, double toBeats, juce::MidiBuffer& out, int numSamples);
+
+    /** Audio-clock mode: the audio callback drives rendering through renderAudioBlock and the timer only
+        forwards MIDI-out and UI updates. Set by whoever attaches the engine to the audio callback. */
+    void setAudioClockDriven (bool shouldBeDriven);
+    bool isAudioClockDriven() const { return audioClockDriven.load(); }
+
+    /** AudioClockMidiSource: advance the playhead by one audio block (audio thread). Skips the block
+        rather than wait if a message-thread start/stop/setStyle currently owns the engine state; the
+        skipped time is rendered (late, at sample 0) with the next block so the groove doesn't drift. */
+    void renderAudioBlock (juce::MidiBuffer& out, int numSamples, double sampleRate) override;
 
 private:
     void hiResTimerCallback() override;
     void dispatch (const juce::MidiMessage& m);
     void dispatchEmitted (const EmittedEvent& e);   // transpose (by PartKind) then dispatch
+    void scheduleMidiOut (const juce::MidiMessage& m, double playSeconds);   // queue for forwardScheduledOutput
     void silenceArrangerNotes();   // note-off ONLY the arranger's own sounding notes (not the player's)
     void sendInstrumentSetup();   // program-change + volume per channel, like the classic player
     void rebuildFromStyle();
     void updateActiveLoopLength();
-    void haltAudio();             // silence + reset state, WITHOUT stopping the timer
+    bool resetPlayback();         // silence + reset state, WITHOUT stopping the timer; true if it was playing
+    void notifyStopped (bool stoppedPlaying);   // message thread: beat bar to 0, UI out of play state
     void notifyActiveSection (bool force);   // tell the UI which section is active (on change, or forced)
+    void forwardScheduledOutput();           // send queued MIDI-out to the device with its timestamps
+    template <typename Fn> void dispatchFromMessageThread (Fn&& fn);
     int  indexOfSection (ArrangerSectionType type, const juce::String& name) const;
 
     std::weak_ptr<juce::MidiOutput> outputDevice;
@@ -102,7 +135,9 @@ private:
     int  currentSchedulerIndex = -1;                 // which scheduler is currently sounding
     int  pendingStartIndex     = -1;                 // section start() should begin on (-1 = default)
     int  lastReportedSectionIndex = -1;              // last index sent to onActiveSectionChanged
-    bool timerShouldStop       = false;              // set on the timer thread, honoured on the msg thread
+    std::atomic<bool> timerShouldStop { false };     // set by the render thread, honoured on the msg thread
+    std::atomic<bool> stoppedItself { false };       // an Ending stopped playback; the msg thread tells the UI
+    std::atomic<int>  renderedSectionIndex { 0 };    // sequencer.getActiveIndex() after the last render
 
     // Section-switch request: set on the message thread (UI click/button), applied on the timer
     // thread at the top of each callback so all sequencer mutation stays single-threaded.
@@ -117,6 +152,32 @@ private:
     double lastNowSeconds = 0.0;    // wall-clock of previous tick (for delta accumulation)
     std::atomic<bool> playing { false };
 
+    // Audio-clock mode. renderLock is held by the audio thread for a block (try-lock, never waited on)
+    // or by the timer for a tick, and by message-thread mutations (start/stop/setStyle, transposer
+    // settings) so they can't interleave with a render.
+    std::atomic<bool>   audioClockDriven { false };
+    std::atomic<double> uiPlayheadBeats { 0.0 };       // playheadBeats as of the last audio block
+    juce::SpinLock      renderLock;
+    double unrenderedSeconds = 0.0;   // audio thread only: blocks skipped on a failed try-lock
+
+    // While rendering into an audio block, dispatch() writes to blockOut at the current event's offset.
+    juce::MidiBuffer* blockOut = nullptr;
+    int    blockNumSamples      = 0;
+    double blockSamplesPerBeat  = 0.0;
+    double blockOutputSeconds   = 0.0;   // when sample 0 of the block is heard (hi-res ms clock, seconds)
+    double blockSampleRate      = 0.0;
+    double dispatchOffsetBeats  = 0.0;   // offset of the event being dispatched from the window start
+
+    // MIDI-out: the render thread (audio or timer) queues time-stamped events, the timer thread sends
+    // them through MidiOutput's scheduling thread so they play at their stamped time. Outside an audio
+    // block, windowStartSeconds >= 0 means dispatch() stamps from it instead of sending immediately.
+    // lastScheduledSeconds (written under renderLock) lets a stop stamp its note-offs after everything
+    // already queued, so none can overtake the note-on it closes.
+    MidiEventQueue   scheduledMidiOut;
+    juce::MidiBuffer scheduledOutBlock;   // consumer only: the timer, or the message thread with it stopped
+    double windowStartSeconds   = -1.0;
+    double lastScheduledSeconds = 0.0;
+
     // Phase 6: Synchro Start. synchroStartEnabled is the user's setting (message thread); synchroArmed
     // is the live "waiting for the first chord" gate, set on start() and cleared on the first valid
     // chord (input thread) or on stop. Atomic so the timer thread can check it lock-free.
@@ -135,5 +196,11 @@ private:
     juce::CriticalSection chordLock;
     ArrangerChord                 pendingChord;
     bool                  hasChordUpdate = false;
-    std::map<std::pair<int,int>, int> activePlayedNote;  // (channel, originalNote) -> sounding note
+    // (channel - 1) * 128 + originalNote -> sounding note, -1 = not sounding. Flat so a note-on never allocates.
+    std::array<juce::int8, 16 * 128> activePlayedNote;
+    void clearPlayedNotes() { activePlayedNote.fill (-1); }
+
+    // Render-tick scratch, reserved in rebuildFromStyle so renderRange doesn't allocate.
+    SequencerStep             sequencerStep;
+    std::vector<EmittedEvent> emitted;
 };
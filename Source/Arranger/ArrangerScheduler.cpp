@@ -18,60 +18,87 @@ void ArrangerScheduler::setLoop (std::vector<TimedBeatEvent> events,
                       [&] (size_t a, size_t b) { return events[a].beats < events[b].beats; });
 
     sortedEvents.clear();
-    sortedParts.clear();
     sortedEvents.reserve (events.size());
-    sortedParts.reserve (events.size());
     for (size_t i : idx)
-    {
-        sortedEvents.push_back (events[i]);
-        sortedParts.push_back (i < parts.size() ? parts[i] : PartKind::Fixed);
-    }
+        if (ShortMidiMessage::fits (events[i].message))
+            sortedEvents.push_back ({ events[i].beats, ShortMidiMessage::from (events[i].message),
+                                      i < parts.size() ? parts[i] : PartKind::Fixed });
 
     loopLen = loopLengthBeats;
-    activeNotes.clear();
-    activeNoteParts.clear();
+    activeNotes.reset();
+    cursorPhase = -1.0;
 }
 
 void ArrangerScheduler::reset()
 {
-    activeNotes.clear();
-    activeNoteParts.clear();
+    activeNotes.reset();
+    cursorPhase = -1.0;
+}
+
+size_t ArrangerScheduler::cursorFor (double phaseStart)
+{
+    // The common case is a tick that starts exactly where the previous one stopped.
+    if (cursorPhase >= 0.0 && std::abs (phaseStart - cursorPhase) < 1e-9)
+        return cursor;
+
+    const auto it = std::lower_bound (sortedEvents.begin(), sortedEvents.end(), phaseStart - 1e-12,
+                                      [] (const EmittedEvent& ev, double beat) { return ev.beats < beat; });
+    return (size_t) std::distance (sortedEvents.begin(), it);
+}
+
+void ArrangerScheduler::closeActiveNotes (double atBeats, std::vector<EmittedEvent>& out)
+{
+    if (activeNotes.none())
+        return;
+
+    // Slot order is (channel, note) ascending -- the same order the old std::set produced.
+    for (int slot = 0; slot < numNoteSlots; ++slot)
+        if (activeNotes.test ((size_t) slot))
+            out.push_back ({ atBeats, ShortMidiMessage::noteOff (slot / 128 + 1, slot % 128),
+                             activeNoteParts[(size_t) slot] });
+    activeNotes.reset();
+}
+
+void ArrangerScheduler::flushActiveNotes (double atBeats, std::vector<EmittedEvent>& out)
+{
+    closeActiveNotes (atBeats, out);
 }
 
 std::vector<EmittedEvent> ArrangerScheduler::flushActiveNotes (double atBeats)
 {
     std::vector<EmittedEvent> result;
-    for (const auto& key : activeNotes)
-    {
-        const auto it = activeNoteParts.find (key);
-        const PartKind part = (it != activeNoteParts.end()) ? it->second : PartKind::Fixed;
-        result.push_back ({ atBeats, juce::MidiMessage::noteOff (key.first, key.second), part });
-    }
-    activeNotes.clear();
-    activeNoteParts.clear();
+    flushActiveNotes (atBeats, result);
     return result;
 }
 
-void ArrangerScheduler::trackActiveNote (const juce::MidiMessage& m, PartKind part)
+void ArrangerScheduler::trackActiveNote (const ShortMidiMessage& m, PartKind part)
 {
-    const auto key = std::make_pair (m.getChannel(), m.getNoteNumber());
-    if (m.isNoteOn() && m.getVelocity() > 0)
+    if (! m.isNoteOnOrOff())
+        return;
+
+    const size_t slot = (size_t) ((m.getChannel() - 1) * 128 + m.getNoteNumber());
+    if (m.isNoteOn())
     {
-        activeNotes.insert (key);
-        activeNoteParts[key] = part;
+        activeNotes.set (slot);
+        activeNoteParts[slot] = part;
     }
-    else if (m.isNoteOff() || (m.isNoteOn() && m.getVelocity() == 0))
+    else
     {
-        activeNotes.erase (key);
-        activeNoteParts.erase (key);
+        activeNotes.reset (slot);
     }
 }
 
 std::vector<EmittedEvent> ArrangerScheduler::advance (double fromBeats, double toBeats)
 {
     std::vector<EmittedEvent> result;
+    advance (fromBeats, toBeats, result);
+    return result;
+}
+
+void ArrangerScheduler::advance (double fromBeats, double toBeats, std::vector<EmittedEvent>& out)
+{
     if (loopLen <= 0.0 || toBeats <= fromBeats)
-        return result;
+        return;
 
     double pos = fromBeats;
     while (pos < toBeats - 1e-12)
@@ -83,32 +110,24 @@ std::vector<EmittedEvent> ArrangerScheduler::advance (double fromBeats, double t
         const double segmentEndAbs     = std::min (toBeats, nextWrapAbs);
         const double phaseEnd          = segmentEndAbs - iterationStartAbs;
 
-        for (size_t i = 0; i < sortedEvents.size(); ++i)
+        size_t i = cursorFor (phaseStart);
+        for (; i < sortedEvents.size() && sortedEvents[i].beats < phaseEnd - 1e-12; ++i)
         {
             const auto& ev = sortedEvents[i];
-            if (ev.beats >= phaseStart - 1e-12 && ev.beats < phaseEnd - 1e-12)
-            {
-                const PartKind part = sortedParts[i];
-                result.push_back ({ iterationStartAbs + ev.beats, ev.message, part });
-                trackActiveNote (ev.message, part);
-            }
+            out.push_back ({ iterationStartAbs + ev.beats, ev.message, ev.part });
+            trackActiveNote (ev.message, ev.part);
         }
+        cursor      = i;
+        cursorPhase = phaseEnd;
 
         // If we actually reached a seam within the window, close hanging notes there.
         if (std::abs (segmentEndAbs - nextWrapAbs) < 1e-9 && nextWrapAbs <= toBeats + 1e-12)
-        {
-            for (const auto& key : activeNotes)
-            {
-                const auto it = activeNoteParts.find (key);
-                const PartKind part = (it != activeNoteParts.end()) ? it->second : PartKind::Fixed;
-                result.push_back ({ nextWrapAbs, juce::MidiMessage::noteOff (key.first, key.second), part });
-            }
-            activeNotes.clear();
-            activeNoteParts.clear();
-        }
+            closeActiveNotes (nextWrapAbs, out);
+
+        // Wrapped: the next segment starts back at phase 0, so re-find the cursor there (once a loop).
+        if (segmentEndAbs >= nextWrapAbs)
+            cursorPhase = -1.0;
 
         pos = segmentEndAbs;
     }
-
-    return result;
 }
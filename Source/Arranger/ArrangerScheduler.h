@@ -3,15 +3,63 @@
 #include "ArrangerModel.h"
 #include "Chord.h"     // PartKind
 #include <vector>
-#include <set>
-#include <map>
-#include <utility>
+#include <array>
+#include <bitset>
+
+/** A channel message packed into 3 bytes (no heap, trivially copyable). Mirrors the juce::MidiMessage
+    queries the arranger uses so call sites read the same. */
+struct ShortMidiMessage
+{
+    juce::uint8 data[3] {};
+    juce::uint8 size = 0;
+
+    /** False for messages longer than 3 bytes (SysEx, meta events), which the scheduler skips. */
+    static bool fits (const juce::MidiMessage& m)  { return m.getRawDataSize() > 0 && m.getRawDataSize() <= 3; }
+
+    static ShortMidiMessage from (const juce::MidiMessage& m)
+    {
+        ShortMidiMessage s;
+        s.size = (juce::uint8) juce::jlimit (0, 3, m.getRawDataSize());
+        std::memcpy (s.data, m.getRawData(), s.size);
+        return s;
+    }
+
+    static ShortMidiMessage noteOff (int channel, int note)
+    {
+        ShortMidiMessage s;
+        s.data[0] = (juce::uint8) (0x80 | ((channel - 1) & 0x0f));
+        s.data[1] = (juce::uint8) (note & 0x7f);
+        s.size = 3;
+        return s;
+    }
+
+    /** Builds the juce message; up to 3 bytes live in its inline storage, so this doesn't allocate. */
+    juce::MidiMessage toMidiMessage() const   { return juce::MidiMessage (data, (int) size); }
+
+    int  getChannel() const                   { return (data[0] & 0x0f) + 1; }
+    int  getNoteNumber() const                { return data[1]; }
+    int  getVelocity() const                  { return isNoteOnOrOff() ? data[2] : 0; }
+    bool isNoteOnOrOff() const                { return size == 3 && (data[0] & 0xe0) == 0x80; }
+    bool isNoteOn (bool returnTrueForVelocity0 = false) const
+    {
+        return size == 3 && (data[0] & 0xf0) == 0x90 && (returnTrueForVelocity0 || data[2] != 0);
+    }
+    bool isNoteOff (bool returnTrueForNoteOnVelocity0 = true) const
+    {
+        return size == 3 && ((data[0] & 0xf0) == 0x80
+                             || (returnTrueForNoteOnVelocity0 && (data[0] & 0xf0) == 0x90 && data[2] == 0));
+    }
+    bool operator== (const ShortMidiMessage& o) const
+    {
+        return size == o.size && std::memcmp (data, o.data, size) == 0;
+    }
+};
 
 /** One event to emit, positioned at a monotonic beat within the advance window. */
 struct EmittedEvent
 {
     double beats = 0.0;
-    juce::MidiMessage message;
+    ShortMidiMessage message;
     PartKind part = PartKind::Fixed;   // Phase 4: how the engine should transpose this note (Fixed = not)
 };
 
@@ -20,6 +68,10 @@ struct EmittedEvent
  * [0, loopLengthBeats)) and, on each advance(from, to), returns the events to emit,
  * wrapping the loop and closing any still-sounding notes at every seam so nothing hangs.
  * No threading, no I/O — fully unit-testable.
+ *
+ * The hot path is allocation-free: advance/flushActiveNotes append to a caller-owned vector that the
+ * caller reserves up front, events are stored as ShortMidiMessages, and sounding notes live in a
+ * fixed 16x128 table.
  */
 class ArrangerScheduler
 {
@@ -27,23 +79,39 @@ public:
     /** Legacy: every event is non-transposable (PartKind::Fixed). */
     void setLoop (std::vector<TimedBeatEvent> events, double loopLengthBeats);
     /** Phase 4: each event carries a PartKind (parallel to `events`) so the engine knows how to
-        transpose it. `parts` shorter than `events` pads with Fixed. */
+        transpose it. `parts` shorter than `events` pads with Fixed. Messages longer than 3 bytes
+        (SysEx/meta) are dropped. */
     void setLoop (std::vector<TimedBeatEvent> events, std::vector<PartKind> parts, double loopLengthBeats);
     void reset();   // forget which notes are currently sounding
 
     /** Emit note-offs for every currently-sounding note (used when switching sections
-        mid-loop, where the normal loop-seam close would not fire). Clears active-note state. */
-    std::vector<EmittedEvent> flushActiveNotes (double atBeats);
+        mid-loop, where the normal loop-seam close would not fire). Clears active-note state.
+        Appends to `out`; doesn't allocate while `out` has capacity. */
+    void flushActiveNotes (double atBeats, std::vector<EmittedEvent>& out);
+    std::vector<EmittedEvent> flushActiveNotes (double atBeats);   // convenience (allocates)
+
+    /** Advance the monotonic playhead from `fromBeats` to `toBeats` (from <= to), appending the events
+        to `out` (doesn't allocate while `out` has capacity). Contiguous calls resume from a cursor, so
+        a tick costs O(events in the window); a seek re-finds it in O(log n). */
+    void advance (double fromBeats, double toBeats, std::vector<EmittedEvent>& out);
+    std::vector<EmittedEvent> advance (double fromBeats, double toBeats);   // convenience (allocates)
 
-    /** Advance the monotonic playhead from `fromBeats` to `toBeats` (from <= to). */
-    std::vector<EmittedEvent> advance (double fromBeats, double toBeats);
+    /** Number of pattern events; with 16 * 128 seam note-offs, the most one loop iteration can emit. */
+    int getNumEvents() const { return (int) sortedEvents.size(); }
 
 private:
-    void trackActiveNote (const juce::MidiMessage& m, PartKind part);
+    static constexpr int numNoteSlots = 16 * 128;
 
-    std::vector<TimedBeatEvent> sortedEvents;          // sorted by beats
-    std::vector<PartKind>       sortedParts;           // aligned with sortedEvents
+    void trackActiveNote (const ShortMidiMessage& m, PartKind part);
+    void closeActiveNotes (double atBeats, std::vector<EmittedEvent>& out);
+    size_t cursorFor (double phaseStart);   // index of the first event at or after phaseStart
+
+    std::vector<EmittedEvent> sortedEvents;            // sorted by beats (phase within the loop), with parts
     double loopLen = 0.0;
-    std::set<std::pair<int,int>> activeNotes;          // (channel, noteNumber) currently sounding
-    std::map<std::pair<int,int>, PartKind> activeNoteParts;   // part of each sounding note (for seam offs)
+    size_t cursor      = 0;                            // next event to consider...
+    double cursorPhase = -1.0;                         // ...when the next segment starts at this phase (<0 = unknown)
+
+    // Currently-sounding notes, indexed (channel - 1) * 128 + note, and the part of each (for seam offs).
+    std::bitset<numNoteSlots>            activeNotes;
+    std::array<PartKind, numNoteSlots>   activeNoteParts {};
 };
@@ -135,8 +135,16 @@ void ArrangerSectionSequencer::applyBoundary (double boundaryAbs, SequencerStep&
 SequencerStep ArrangerSectionSequencer::advance (double fromBeats, double toBeats)
 {
     SequencerStep step;
+    advance (fromBeats, toBeats, step);
+    return step;
+}
+
+void ArrangerSectionSequencer::advance (double fromBeats, double toBeats, SequencerStep& step)
+{
+    step.segments.clear();
+    step.stopRequested = false;
     if (sections.empty() || stopped || toBeats <= fromBeats || beatsPerBar <= 0.0)
-        return step;
+        return;
 
     double pos = fromBeats;
     bool   startChanged = false;
@@ -171,6 +179,4 @@ SequencerStep ArrangerSectionSequencer::advance (double fromBeats, double toBeat
                 startChanged = true;
         }
     }
-
-    return step;
 }
@@ -42,6 +42,9 @@ public:
 
     /** Advance the monotonic playhead from `fromBeats` to `toBeats` (from <= to). */
     SequencerStep advance (double fromBeats, double toBeats);
+    /** Same, refilling a caller-owned step so a render tick reuses its segment storage (no allocation
+        while it has capacity). */
+    void advance (double fromBeats, double toBeats, SequencerStep& step);
 
     int    getActiveIndex() const { return activeIndex; }
     double getBeatsPerBar() const { return beatsPerBar; }
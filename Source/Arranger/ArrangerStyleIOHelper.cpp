@@ -1,6 +1,7 @@
 #include "ArrangerStyleIOHelper.h"
 #include "ArrangerEnums.h"
 #include "ArrangerMidiHex.h"
+#include <cstring>
 
 using juce::var;
 
@@ -39,7 +40,7 @@ static var sectionToVar (const SectionWindow& s)
     return var (o);
 }
 
-void ArrangerStyleIOHelper::saveToFile (const juce::File& file, const ArrangerStyleFile& style)
+void ArrangerStyleIOHelper::exportJson (const juce::File& file, const ArrangerStyleFile& style)
 {
     auto* root = new juce::DynamicObject();
     root->setProperty ("schemaVersion", style.schemaVersion);
@@ -64,7 +65,7 @@ void ArrangerStyleIOHelper::saveToFile (const juce::File& file, const ArrangerSt
     file.replaceWithText (juce::JSON::toString (var (root), true));
 }
 
-bool ArrangerStyleIOHelper::loadFromFile (const juce::File& file, ArrangerStyleFile& out, juce::String& error)
+bool ArrangerStyleIOHelper::importJson (const juce::File& file, ArrangerStyleFile& out, juce::String& error)
 {
     if (! file.existsAsFile()) { error = "File does not exist: " + file.getFullPathName(); return false; }
 
@@ -115,3 +116,252 @@ bool ArrangerStyleIOHelper::loadFromFile (const juce::File& file, ArrangerStyleF
 
     return true;
 }
+
+//==============================================================================
+// Binary .style layout (little-endian; strings are uint32 byte length + UTF-8):
+//
+//   header   "ASTY", uint32 formatVersion, int32 schemaVersion, string id, string name,
+//            double originalTempo, int32 timeSigNum, int32 timeSigDenom, int32 originalRoot,
+//            string originalQuality, uint32 numSections, uint32 numTracks
+//   sections numSections x { string id, string name, string type, int32 startBar, int32 lengthBars,
+//                            string afterComplete }
+//   tracks   numTracks x { string id, string name, string partType, int32 channel, int32 instrument,
+//                          double volume, uint32 numEvents, double beats[numEvents],
+//                          uint8 messages[numEvents][3] }
+//
+// Enums are stored by name (as in the JSON) so reordering them can't corrupt old files. Messages
+// longer than 3 bytes are not stored (source tracks only hold note/channel events).
+
+static const char binaryMagic[4] = { 'A', 'S', 'T', 'Y' };
+
+static void writeString (juce::MemoryOutputStream& out, const juce::String& s)
+{
+    const auto utf8 = s.toRawUTF8();
+    const auto len  = (juce::uint32) s.getNumBytesAsUTF8();
+    out.writeInt ((int) len);
+    out.write (utf8, len);
+}
+
+void ArrangerStyleIOHelper::saveToFile (const juce::File& file, const ArrangerStyleFile& style)
+{
+    juce::MemoryOutputStream out;
+    out.write (binaryMagic, sizeof (binaryMagic));
+    out.writeInt ((int) binaryFormatVersion);
+    out.writeInt (style.schemaVersion);
+    writeString (out, style.id);
+    writeString (out, style.name);
+    out.writeDouble (style.originalTempo);
+    out.writeInt (style.timeSigNum);
+    out.writeInt (style.timeSigDenom);
+    out.writeInt (style.originalRoot);
+    writeString (out, toString (style.originalQuality));
+    out.writeInt ((int) style.sections.size());
+    out.writeInt ((int) style.sourceTracks.size());
+
+    for (const auto& s : style.sections)
+    {
+        writeString (out, s.id);
+        writeString (out, s.name);
+        writeString (out, ArrangerEnums::toString (s.type));
+        out.writeInt (s.startBar);
+        out.writeInt (s.lengthBars);
+        writeString (out, ArrangerEnums::toString (s.afterComplete));
+    }
+
+    for (const auto& t : style.sourceTracks)
+    {
+        writeString (out, t.id);
+        writeString (out, t.name);
+        writeString (out, ArrangerEnums::toString (t.partType));
+        out.writeInt (t.channel);
+        out.writeInt (t.instrument);
+        out.writeDouble (t.volume);
+
+        std::vector<const TimedBeatEvent*> stored;
+        stored.reserve (t.events.size());
+        for (const auto& e : t.events)
+            if (e.message.getRawDataSize() > 0 && e.message.getRawDataSize() <= 3)
+                stored.push_back (&e);
+
+        out.writeInt ((int) stored.size());
+        for (const auto* e : stored)
+            out.writeDouble (e->beats);
+        for (const auto* e : stored)
+        {
+            juce::uint8 packed[3] {};
+            std::memcpy (packed, e->message.getRawData(), (size_t) e->message.getRawDataSize());
+            out.write (packed, 3);
+        }
+    }
+
+    file.getParentDirectory().createDirectory();   // getFolder() doesn't create it
+    file.replaceWithData (out.getData(), out.getDataSize());
+}
+
+namespace
+{
+    /** Bounds-checked little-endian reader over the mapped bytes. Any overrun latches `failed`. */
+    struct BinaryReader
+    {
+        const juce::uint8* data;
+        size_t size, pos = 0;
+        bool failed = false;
+
+        const juce::uint8* take (size_t n)
+        {
+            if (failed || n > size - pos) { failed = true; return nullptr; }
+            auto* p = data + pos;
+            pos += n;
+            return p;
+        }
+        int readInt()
+        {
+            auto* p = take (4);
+            return p != nullptr ? (int) juce::ByteOrder::littleEndianInt (p) : 0;
+        }
+        double readDouble()
+        {
+            auto* p = take (8);
+            if (p == nullptr) return 0.0;
+            const auto bits = juce::ByteOrder::littleEndianInt64 (p);
+            double d;
+            std::memcpy (&d, &bits, sizeof (d));
+            return d;
+        }
+        juce::String readString()
+        {
+            const auto len = (size_t) (juce::uint32) readInt();
+            auto* p = take (len);
+            return p != nullptr ? juce::String::fromUTF8 ((const char*) p, (int) len) : juce::String();
+        }
+        /** A count that must be backed by at least `minBytesEach` bytes per item (rejects garbage counts). */
+        size_t readCount (size_t minBytesEach)
+        {
+            const auto n = (size_t) (juce::uint32) readInt();
+            if (failed || n > (size - pos) / juce::jmax ((size_t) 1, minBytesEach)) { failed = true; return 0; }
+            return n;
+        }
+    };
+
+    bool parseBinary (const void* bytes, size_t size, ArrangerStyleFile& out, juce::String& error, bool withEvents)
+    {
+        BinaryReader r { static_cast<const juce::uint8*> (bytes), size };
+        r.take (sizeof (binaryMagic));
+        const auto version = (juce::uint32) r.readInt();
+        if (! r.failed && version > ArrangerStyleIOHelper::binaryFormatVersion)
+        {
+            error = "Unsupported style format version " + juce::String (version);
+            return false;
+        }
+
+        out = ArrangerStyleFile();
+        out.schemaVersion   = r.readInt();
+        out.id              = r.readString();
+        out.name            = r.readString();
+        out.originalTempo   = r.readDouble();
+        out.timeSigNum      = r.readInt();
+        out.timeSigDenom    = r.readInt();
+        out.originalRoot    = r.readInt();
+        out.originalQuality = chordQualityFromString (r.readString());
+        if (out.originalQuality == ChordQuality::None) out.originalQuality = ChordQuality::Maj;
+
+        const size_t numSections = r.readCount (4);
+        const size_t numTracks   = r.readCount (4);
+
+        out.sections.reserve (numSections);
+        for (size_t i = 0; i < numSections && ! r.failed; ++i)
+        {
+            SectionWindow s;
+            s.id            = r.readString();
+            s.name          = r.readString();
+            s.type          = ArrangerEnums::sectionTypeFromString (r.readString());
+            s.startBar      = r.readInt();
+            s.lengthBars    = r.readInt();
+            s.afterComplete = ArrangerEnums::afterFromString (r.readString());
+            out.sections.push_back (std::move (s));
+        }
+
+        out.sourceTracks.reserve (numTracks);
+        for (size_t i = 0; i < numTracks && ! r.failed; ++i)
+        {
+            SourceTrackFile t;
+            t.id         = r.readString();
+            t.name       = r.readString();
+            t.partType   = ArrangerEnums::partFromString (r.readString());
+            t.channel    = r.readInt();
+            t.instrument = r.readInt();
+            t.volume     = r.readDouble();
+
+            const size_t numEvents = r.readCount (8 + 3);
+            const auto* beats    = r.take (numEvents * 8);
+            const auto* messages = r.take (numEvents * 3);
+            if (r.failed)
+                break;
+
+            if (! withEvents)
+            {
+                out.sourceTracks.push_back (std::move (t));
+                continue;
+            }
+
+            t.events.resize (numEvents);
+            for (size_t e = 0; e < numEvents; ++e)
+            {
+                const auto bits = juce::ByteOrder::littleEndianInt64 (beats + e * 8);
+                std::memcpy (&t.events[e].beats, &bits, sizeof (double));
+
+                const juce::uint8* m = messages + e * 3;
+                const int len = juce::jlimit (1, 3, juce::MidiMessage::getMessageLengthFromFirstByte (m[0]));
+                t.events[e].message = juce::MidiMessage (m, len);
+            }
+            out.sourceTracks.push_back (std::move (t));
+        }
+
+        if (r.failed)
+        {
+            error = "Truncated or corrupt style file";
+            return false;
+        }
+        return true;
+    }
+}
+
+static bool loadStyle (const juce::File& file, ArrangerStyleFile& out, juce::String& error, bool withEvents)
+{
+    if (! file.existsAsFile()) { error = "File does not exist: " + file.getFullPathName(); return false; }
+
+    auto fromJson = [&]
+    {
+        if (! ArrangerStyleIOHelper::importJson (file, out, error))
+            return false;
+        if (! withEvents)
+            for (auto& t : out.sourceTracks) { t.events.clear(); t.events.shrink_to_fit(); }
+        return true;
+    };
+
+    juce::MemoryMappedFile mapped (file, juce::MemoryMappedFile::readOnly);
+    if (mapped.getData() != nullptr)
+    {
+        if (mapped.getSize() < sizeof (binaryMagic)
+            || std::memcmp (mapped.getData(), binaryMagic, sizeof (binaryMagic)) != 0)
+            return fromJson();   // an older (or exported) JSON style
+        return parseBinary (mapped.getData(), mapped.getSize(), out, error, withEvents);
+    }
+
+    // Mapping can fail (e.g. an empty file, or a filesystem that doesn't support it): read it instead.
+    juce::MemoryBlock block;
+    if (! file.loadFileAsData (block)) { error = "Could not read " + file.getFullPathName(); return false; }
+    if (block.getSize() < sizeof (binaryMagic) || std::memcmp (block.getData(), binaryMagic, sizeof (binaryMagic)) != 0)
+        return fromJson();
+    return parseBinary (block.getData(), block.getSize(), out, error, withEvents);
+}
+
+bool ArrangerStyleIOHelper::loadFromFile (const juce::File& file, ArrangerStyleFile& out, juce::String& error)
+{
+    return loadStyle (file, out, error, true);
+}
+
+bool ArrangerStyleIOHelper::loadSummaryFromFile (const juce::File& file, ArrangerStyleFile& out, juce::String& error)
+{
+    return loadStyle (file, out, error, false);
+}
@@ -2,9 +2,30 @@
 #include <JuceHeader.h>
 #include "ArrangerStyleFile.h"
 
+/**
+ * Reads and writes .style files.
+ *
+ * .style files are a versioned binary container (header, section table, then per track packed arrays
+ * of beat positions and 3-byte MIDI messages), opened through juce::MemoryMappedFile so a large style
+ * loads without a text parse or a juce::var per event. The earlier JSON layout is still readable
+ * (loadFromFile detects it) and remains available as an explicit import/export format.
+ */
 class ArrangerStyleIOHelper
 {
 public:
+    /** Writes the binary format. */
     static void saveToFile (const juce::File& file, const ArrangerStyleFile& style);
+    /** Loads a binary .style, or a JSON one (detected by content). */
     static bool loadFromFile (const juce::File& file, ArrangerStyleFile& out, juce::String& error);
+
+    /** Loads everything except the tracks' events (tracks are present, with empty event lists). For a
+        binary file the event arrays are skipped without being read: cheap enough to summarise a folder. */
+    static bool loadSummaryFromFile (const juce::File& file, ArrangerStyleFile& out, juce::String& error);
+
+    /** JSON import/export (human-readable interchange; also what older .style files contain). */
+    static void exportJson (const juce::File& file, const ArrangerStyleFile& style);
+    static bool importJson (const juce::File& file, ArrangerStyleFile& out, juce::String& error);
+
+    /** Binary container version written by saveToFile; readers reject anything newer. */
+    static constexpr juce::uint32 binaryFormatVersion = 1;
 };
@@ -0,0 +1,192 @@
+#include "ArrangerStyleIndex.h"
+#include "ArrangerStyleIOHelper.h"
+#include <algorithm>
+#include <map>
+
+using juce::var;
+
+ArrangerStyleIndex::ArrangerStyleIndex (const juce::File& stylesFolder, bool startBackgroundThread)
+    : juce::Thread ("Style indexer"), folder (stylesFolder)
+{
+    loadIndex();
+    if (startBackgroundThread)
+        startThread (juce::Thread::Priority::low);
+}
+
+ArrangerStyleIndex::~ArrangerStyleIndex()
+{
+    stopThread (4000);
+}
+
+std::vector<ArrangerStyleSummary> ArrangerStyleIndex::getSummaries() const
+{
+    const juce::ScopedLock sl (lock);
+    return summaries;
+}
+
+bool ArrangerStyleIndex::getSummary (const juce::String& fileName, ArrangerStyleSummary& out) const
+{
+    const juce::ScopedLock sl (lock);
+    for (const auto& s : summaries)
+        if (s.fileName == fileName)
+        {
+            out = s;
+            return true;
+        }
+    return false;
+}
+
+void ArrangerStyleIndex::fileChanged (const juce::File& file)
+{
+    {
+        const juce::ScopedLock sl (lock);
+        changedFiles.addIfNotAlreadyThere (file.getFileName());
+    }
+    requestRescan();
+}
+
+void ArrangerStyleIndex::run()
+{
+    while (! threadShouldExit())
+    {
+        if (rescanNow())
+            sendChangeMessage();
+        rescanDone.signal();
+        wait (-1);   // until requestRescan(), or the destructor stops the thread
+    }
+}
+
+bool ArrangerStyleIndex::rescanNow()
+{
+    const juce::ScopedLock scan (scanLock);
+
+    std::map<juce::String, ArrangerStyleSummary> previous;
+    juce::StringArray forced;
+    {
+        const juce::ScopedLock sl (lock);
+        for (const auto& s : summaries)
+            previous[s.fileName] = s;
+        forced.swapWith (changedFiles);
+    }
+
+    std::vector<ArrangerStyleSummary> next;
+    bool changed = false;
+
+    for (const auto& f : folder.findChildFiles (juce::File::findFiles, false, "*.style"))
+    {
+        if (threadShouldExit())
+            return false;
+
+        const auto fileName = f.getFileName();
+        const auto mtime    = f.getLastModificationTime().toMilliseconds();
+        const auto size     = f.getSize();
+
+        const auto it = previous.find (fileName);
+        if (it != previous.end() && it->second.modificationTime == mtime && it->second.fileSize == size
+            && ! forced.contains (fileName))
+        {
+            next.push_back (std::move (it->second));   // unchanged: keep the indexed metadata
+            previous.erase (it);
+            continue;
+        }
+        if (it != previous.end())
+            previous.erase (it);
+
+        ArrangerStyleSummary s;
+        s.fileName         = fileName;
+        s.modificationTime = mtime;
+        s.fileSize         = size;
+
+        ArrangerStyleFile sf; juce::String err;
+        s.readable = ArrangerStyleIOHelper::loadSummaryFromFile (f, sf, err);
+        ++numFilesParsed;
+        if (s.readable)
+        {
+            s.name         = sf.name.isNotEmpty() ? sf.name : f.getFileNameWithoutExtension();
+            s.tempo        = sf.originalTempo;
+            s.timeSigNum   = sf.timeSigNum;
+            s.timeSigDenom = sf.timeSigDenom;
+            s.numTracks    = (int) sf.sourceTracks.size();
+            for (const auto& w : sf.sections)
+                s.sections.add (w.name);
+        }
+        next.push_back (std::move (s));
+        changed = true;
+    }
+
+    changed = changed || ! previous.empty();   // anything left over was deleted
+    if (! changed)
+        return false;
+
+    std::sort (next.begin(), next.end(), [] (const ArrangerStyleSummary& a, const ArrangerStyleSummary& b)
+               { return a.fileName.compareNatural (b.fileName) < 0; });
+    saveIndex (next);
+
+    const juce::ScopedLock sl (lock);
+    summaries = std::move (next);
+    return true;
+}
+
+void ArrangerStyleIndex::loadIndex()
+{
+    const auto file = getIndexFile();
+    if (! file.existsAsFile())
+        return;
+
+    var root;
+    if (juce::JSON::parse (file.loadFileAsString(), root).failed())
+        return;   // a damaged index is simply rebuilt by the first rescan
+
+    std::vector<ArrangerStyleSummary> loaded;
+    if (auto* styles = root.getProperty ("styles", var()).getArray())
+        for (const auto& v : *styles)
+        {
+            ArrangerStyleSummary s;
+            s.fileName         =                v.getProperty ("file", "").toString();
+            s.modificationTime = (juce::int64)  v.getProperty ("mtime", 0);
+            s.fileSize         = (juce::int64)  v.getProperty ("size", 0);
+            s.readable         = (bool)         v.getProperty ("readable", true);
+            s.name             =                v.getProperty ("name", "").toString();
+            s.tempo            = (double)       v.getProperty ("tempo", 120.0);
+            s.timeSigNum       = (int)          v.getProperty ("timeSigNum", 4);
+            s.timeSigDenom     = (int)          v.getProperty ("timeSigDenom", 4);
+            s.numTracks        = (int)          v.getProperty ("tracks", 0);
+            if (auto* secs = v.getProperty ("sections", var()).getArray())
+                for (const auto& sv : *secs)
+                    s.sections.add (sv.toString());
+            if (s.fileName.isNotEmpty())
+                loaded.push_back (std::move (s));
+        }
+
+    const juce::ScopedLock sl (lock);
+    summaries = std::move (loaded);
+}
+
+void ArrangerStyleIndex::saveIndex (const std::vector<ArrangerStyleSummary>& toSave) const
+{
+    juce::Array<var> styles;
+    for (const auto& s : toSave)
+    {
+        auto* o = new juce::DynamicObject();
+        o->setProperty ("file", s.fileName);
+        o->setProperty ("mtime", s.modificationTime);
+        o->setProperty ("size", s.fileSize);
+        o->setProperty ("readable", s.readable);
+        o->setProperty ("name", s.name);
+        o->setProperty ("tempo", s.tempo);
+        o->setProperty ("timeSigNum", s.timeSigNum);
+        o->setProperty ("timeSigDenom", s.timeSigDenom);
+        o->setProperty ("tracks", s.numTracks);
+        juce::Array<var> secs;
+        for (const auto& n : s.sections) secs.add (n);
+        o->setProperty ("sections", secs);
+        styles.add (var (o));
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty ("version", 1);
+    root->setProperty ("styles", styles);
+
+    folder.createDirectory();
+    getIndexFile().replaceWithText (juce::JSON::toString (var (root), true));
+}
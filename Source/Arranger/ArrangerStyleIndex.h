@@ -0,0 +1,80 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+/** What the style browser shows for one .style file, without its event data. */
+struct ArrangerStyleSummary
+{
+    juce::String      fileName;                 // e.g. "Pop 1.style", relative to the styles folder
+    juce::int64       modificationTime = 0;     // ms since epoch; with fileSize, decides if a re-read is due
+    juce::int64       fileSize = 0;
+    bool              readable = true;          // false if the file couldn't be parsed (still listed)
+    juce::String      name;
+    double            tempo = 120.0;
+    int               timeSigNum = 4, timeSigDenom = 4;
+    juce::StringArray sections;                 // section names, in file order
+    int               numTracks = 0;
+};
+
+/**
+ * Persistent metadata index of the .style files in a folder, kept in StyleIndex.json next to them.
+ *
+ * The index file is read on construction, so a browser can list names, tempo and sections at once.
+ * A background thread then rescans the folder once, and again whenever requestRescan() is called
+ * (the browser asks when it opens and after a delete) or fileChanged() (the editor, after a save);
+ * it doesn't poll. A rescan re-reads only the files whose size or modification time changed, or that
+ * fileChanged() named (ArrangerStyleIOHelper::loadSummaryFromFile, which skips event data). When
+ * anything changed it rewrites the index and sends a change message.
+ *
+ * There should be one per folder, or two would race writing StyleIndex.json: MainComponent owns the
+ * one for IOHelper::getArrangerStylesFolder() and hands it down to the style components.
+ */
+class ArrangerStyleIndex : public juce::ChangeBroadcaster,
+                           private juce::Thread
+{
+public:
+    static constexpr const char* indexFileName = "StyleIndex.json";
+
+    /** startBackgroundThread=false leaves rescanning to explicit rescanNow() calls (tests). */
+    explicit ArrangerStyleIndex (const juce::File& stylesFolder, bool startBackgroundThread = true);
+    ~ArrangerStyleIndex() override;
+
+    /** Snapshot of the index, sorted by file name. Any thread. */
+    std::vector<ArrangerStyleSummary> getSummaries() const;
+
+    /** The indexed entry for fileName (e.g. "Pop 1.style"); false if the index doesn't list it. Any thread. */
+    bool getSummary (const juce::String& fileName, ArrangerStyleSummary& out) const;
+
+    /** Wake the background thread to rescan now (e.g. after a save or delete). */
+    void requestRescan() { notify(); }
+
+    /** Re-read file on the next rescan and request one, so a save is picked up even when it kept the
+        size and landed within the file system's timestamp resolution. Any thread. */
+    void fileChanged (const juce::File& file);
+
+    /** Rescan synchronously; saves the index and returns true if anything changed. */
+    bool rescanNow();
+
+    /** Block until the background thread finishes a rescan it hadn't reported yet; false on timeout (tests). */
+    bool waitForRescan (int timeoutMs) { return rescanDone.wait (timeoutMs); }
+
+    /** Number of files parsed by rescans so far (unchanged files are never re-read). */
+    int getNumFilesParsed() const { return numFilesParsed.load(); }
+
+    juce::File getIndexFile() const { return folder.getChildFile (indexFileName); }
+
+private:
+    void run() override;
+    void loadIndex();
+    void saveIndex (const std::vector<ArrangerStyleSummary>& toSave) const;
+
+    const juce::File folder;
+    mutable juce::CriticalSection lock;          // guards summaries and changedFiles
+    juce::CriticalSection scanLock;              // one rescan at a time
+    std::vector<ArrangerStyleSummary> summaries;
+    juce::StringArray changedFiles;              // named by fileChanged(), re-read by the next rescan
+    std::atomic<int> numFilesParsed { 0 };
+    juce::WaitableEvent rescanDone;              // signalled after each background rescan
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ArrangerStyleIndex)
+};
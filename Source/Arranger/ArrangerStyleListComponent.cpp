@@ -1,7 +1,8 @@
 #include "ArrangerStyleListComponent.h"
 #include "IOHelper.h"
 
-ArrangerStyleListComponent::ArrangerStyleListComponent()
+ArrangerStyleListComponent::ArrangerStyleListComponent (ArrangerStyleIndex& styleIndex)
+    : index (styleIndex)
 {
     addAndMakeVisible (title);
     title.setColour (juce::Label::textColourId, juce::Colours::white);
@@ -32,6 +33,7 @@ ArrangerStyleListComponent::ArrangerStyleListComponent()
             {
                 if (result != 1) return;          // 1 = Delete, 0 = Cancel
                 file.deleteFile();
+                index.requestRescan();
                 if (onDeleteStyle) onDeleteStyle (file);   // let host clear it if it was active
                 refresh();
             }));
@@ -41,19 +43,41 @@ ArrangerStyleListComponent::ArrangerStyleListComponent()
         const int r = list.getSelectedRow();
         if (r >= 0 && r < files.size() && onLoadStyle) onLoadStyle (files[r]);
     };
+    index.addChangeListener (this);
     refresh();
 }
 
+ArrangerStyleListComponent::~ArrangerStyleListComponent()
+{
+    index.removeChangeListener (this);
+}
+
 void ArrangerStyleListComponent::refresh()
 {
+    // Listing the folder only stats files; metadata comes from the index and fills in when it catches up.
     files.clear();
     auto folder = IOHelper::getArrangerStylesFolder();
     for (auto& f : folder.findChildFiles (juce::File::findFiles, false, "*.style"))
         files.add (f);
+    updateSummaries();
+    index.requestRescan();
     list.updateContent();
     repaint();
 }
 
+void ArrangerStyleListComponent::updateSummaries()
+{
+    summaries.clear();
+    for (auto& s : index.getSummaries())
+        summaries[s.fileName] = std::move (s);
+}
+
+void ArrangerStyleListComponent::changeListenerCallback (juce::ChangeBroadcaster*)
+{
+    updateSummaries();
+    list.repaint();
+}
+
 int ArrangerStyleListComponent::getNumRows() { return files.size(); }
 
 void ArrangerStyleListComponent::setActiveConfigName (const juce::String& name)
@@ -87,8 +111,29 @@ void ArrangerStyleListComponent::paintListBoxItem (int row, juce::Graphics& g, i
     }
 
     const int activeLabelW = isActive ? 48 : 0;
+
+    // "120 BPM  4/4  5 sections" from the index; left out until the file has been indexed.
+    juce::String details;
+    const auto it = summaries.find (files[row].getFileName());
+    if (it != summaries.end())
+    {
+        const auto& s = it->second;
+        details = s.readable ? juce::String (juce::roundToInt (s.tempo)) + " BPM  "
+                                   + juce::String (s.timeSigNum) + "/" + juce::String (s.timeSigDenom) + "  "
+                                   + juce::String (s.sections.size()) + (s.sections.size() == 1 ? " section" : " sections")
+                             : juce::String ("unreadable");
+    }
+    const int detailsW = details.isEmpty() ? 0 : juce::jmin (150, w / 2);
+
     g.setColour (text);
-    g.drawText (rowName, nameX, 0, w - nameX - 6 - activeLabelW, h, juce::Justification::centredLeft);
+    g.drawText (rowName, nameX, 0, w - nameX - 6 - activeLabelW - detailsW, h, juce::Justification::centredLeft);
+
+    if (detailsW > 0)
+    {
+        g.setColour (text.withAlpha (0.6f));
+        g.setFont (juce::jmin (12.0f, (float) h - 4.0f));
+        g.drawText (details, w - 6 - activeLabelW - detailsW, 0, detailsW - 6, h, juce::Justification::centredRight);
+    }
 
     if (isActive)                                        // trailing "active" tag
     {
@@ -1,10 +1,15 @@
 #pragma once
 #include <JuceHeader.h>
+#include "ArrangerStyleIndex.h"
 #include <functional>
+#include <map>
 
-/** Lists *.style files from the ArrangerStyles folder; fires callbacks to load or edit. */
+/** Lists *.style files from the ArrangerStyles folder; fires callbacks to load or edit.
+    Rows show tempo, metre and section count from the shared ArrangerStyleIndex for that folder, so
+    no style is parsed on the message thread until it is actually loaded. */
 class ArrangerStyleListComponent : public juce::Component,
-                                   private juce::ListBoxModel
+                                   private juce::ListBoxModel,
+                                   private juce::ChangeListener
 {
 public:
     std::function<void (const juce::File&)> onLoadStyle;
@@ -13,8 +18,9 @@ public:
     std::function<void()> onCreateNew;
     std::function<void()> onClose;
 
-    ArrangerStyleListComponent();
-    void refresh();                 // rescan the folder
+    explicit ArrangerStyleListComponent (ArrangerStyleIndex& styleIndex);
+    ~ArrangerStyleListComponent() override;
+    void refresh();                 // relist the folder and ask the index to catch up
     /** Mark the configuration that is currently active for the style (check + "active"
         + subtle highlight). Pass an empty string to clear the marker. */
     void setActiveConfigName (const juce::String& name);
@@ -26,6 +32,11 @@ public:
     void listBoxItemDoubleClicked (int row, const juce::MouseEvent&) override;
 
 private:
+    void changeListenerCallback (juce::ChangeBroadcaster*) override;   // index updated
+    void updateSummaries();
+
+    ArrangerStyleIndex& index;   // shared; outlives this
+    std::map<juce::String, ArrangerStyleSummary> summaries;   // by file name
     juce::Label title { {}, "Saved section configurations" };
     juce::ListBox list { "styles", this };
     juce::TextButton newBtn { "New" }, editBtn { "Edit" }, deleteBtn { "Delete" }, loadBtn { "Load" }, closeBtn { "Close" };
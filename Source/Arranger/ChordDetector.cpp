@@ -3,33 +3,67 @@
 
 namespace
 {
-    struct Template { ChordQuality q; std::vector<int> intervals; };
+    // Richer (4-note) templates first so a 4-note chord wins over its 3-note subset. Each template is a
+    // 12-bit pitch-class mask rooted on C (bit n = n semitones above the root); must stay in step with
+    // chordIntervals() in Chord.h (the exhaustive test checks both against each other).
+    struct Template { ChordQuality q; int mask; };
 
-    // Richer (4-note) templates first so a 4-note chord wins over its 3-note subset.
-    const std::vector<Template>& templates()
+    constexpr int intervalMask (std::initializer_list<int> intervals)
     {
-        static const std::vector<Template> t = {
-            { ChordQuality::Maj7,    chordIntervals (ChordQuality::Maj7)    },
-            { ChordQuality::Dom7,    chordIntervals (ChordQuality::Dom7)    },
-            { ChordQuality::Min7,    chordIntervals (ChordQuality::Min7)    },
-            { ChordQuality::HalfDim, chordIntervals (ChordQuality::HalfDim) },
-            { ChordQuality::Maj,     chordIntervals (ChordQuality::Maj)     },
-            { ChordQuality::Min,     chordIntervals (ChordQuality::Min)     },
-            { ChordQuality::Dim,     chordIntervals (ChordQuality::Dim)     },
-            { ChordQuality::Aug,     chordIntervals (ChordQuality::Aug)     },
-            { ChordQuality::Sus2,    chordIntervals (ChordQuality::Sus2)    },
-            { ChordQuality::Sus4,    chordIntervals (ChordQuality::Sus4)    },
-        };
-        return t;
+        int m = 0;
+        for (int iv : intervals) m |= 1 << iv;
+        return m;
     }
 
-    bool matches (const std::set<int>& pcs, int root, const std::vector<int>& intervals)
+    constexpr Template templates[] = {
+        { ChordQuality::Maj7,    intervalMask ({ 0, 4, 7, 11 }) },
+        { ChordQuality::Dom7,    intervalMask ({ 0, 4, 7, 10 }) },
+        { ChordQuality::Min7,    intervalMask ({ 0, 3, 7, 10 }) },
+        { ChordQuality::HalfDim, intervalMask ({ 0, 3, 6, 10 }) },
+        { ChordQuality::Maj,     intervalMask ({ 0, 4, 7 })     },
+        { ChordQuality::Min,     intervalMask ({ 0, 3, 7 })     },
+        { ChordQuality::Dim,     intervalMask ({ 0, 3, 6 })     },
+        { ChordQuality::Aug,     intervalMask ({ 0, 4, 8 })     },
+        { ChordQuality::Sus2,    intervalMask ({ 0, 2, 7 })     },
+        { ChordQuality::Sus4,    intervalMask ({ 0, 5, 7 })     },
+    };
+
+    constexpr int rotateUp (int mask, int semis)   // transpose a pitch-class mask up by `semis`
     {
-        if ((int) pcs.size() != (int) intervals.size()) return false;
-        for (int iv : intervals)
-            if (pcs.find ((root + iv) % 12) == pcs.end()) return false;
-        return true;
+        return ((mask << semis) | (mask >> (12 - semis))) & 0xfff;
     }
+
+    /** What one pitch-class set can mean: the highest-priority (template order, then lowest root)
+        match, and the quality it has when read with C as the root (None if no template fits so). */
+    struct MaskEntry
+    {
+        juce::int8   firstRoot = -1;
+        ChordQuality firstQuality = ChordQuality::None;
+        ChordQuality rootedOnC    = ChordQuality::None;
+    };
+
+    struct MaskTable
+    {
+        MaskEntry entries[4096] {};
+
+        constexpr MaskTable()
+        {
+            for (const auto& tpl : templates)
+                for (int root = 0; root < 12; ++root)
+                {
+                    auto& e = entries[rotateUp (tpl.mask, root)];
+                    if (e.firstRoot < 0)
+                    {
+                        e.firstRoot    = (juce::int8) root;
+                        e.firstQuality = tpl.q;
+                    }
+                    if (root == 0 && e.rootedOnC == ChordQuality::None)
+                        e.rootedOnC = tpl.q;
+                }
+        }
+    };
+
+    constexpr MaskTable maskTable;
 }
 
 void ChordDetector::noteOn  (int n) { heldNotes.insert (n); recompute(); }
@@ -41,30 +75,35 @@ void ChordDetector::reset()
     recognized = ArrangerChord{};
 }
 
-ArrangerChord ChordDetector::recognizeSet (const std::set<int>& notes)
+ArrangerChord ChordDetector::recognizePitchClasses (int pitchClassMask, int bassPc)
 {
-    if (notes.empty()) return {};
-
-    std::set<int> pcs;
-    for (int n : notes) pcs.insert (n % 12);
-    const int lowestPc = (*notes.begin()) % 12;   // std::set is ascending
+    pitchClassMask &= 0xfff;
+    if (pitchClassMask == 0) return {};
 
     // Some pitch-class sets name two chords that are inversions of each other (e.g. C-F-G is both
     // Csus4 and Fsus2). Prefer the interpretation whose root IS the lowest (bass) note â€” the Fingered
-    // convention. If no match is rooted on the bass (a true inversion like E-G-C = C major), fall back
-    // to the highest-priority template match.
-    ArrangerChord firstMatch { -1, ChordQuality::None, lowestPc };
-    for (const auto& tpl : templates())
-        for (int root = 0; root < 12; ++root)
-            if (matches (pcs, root, tpl.intervals))
-            {
-                if (root == lowestPc)
-                    return { root, tpl.q, lowestPc };
-                if (! firstMatch.isValid())
-                    firstMatch = { root, tpl.q, lowestPc };
-            }
-
-    return firstMatch;   // invalid if nothing matched
+    // convention: transpose the set down so the bass sits on C and see whether it reads as a chord
+    // there. If not (a true inversion like E-G-C = C major), fall back to the highest-priority match.
+    if (bassPc >= 0 && bassPc < 12)
+    {
+        const ChordQuality rooted = maskTable.entries[rotateUp (pitchClassMask, (12 - bassPc) % 12)].rootedOnC;
+        if (rooted != ChordQuality::None)
+            return { bassPc, rooted, bassPc };
+    }
+
+    const auto& e = maskTable.entries[pitchClassMask];
+    if (e.firstRoot < 0)
+        return { -1, ChordQuality::None, bassPc };   // invalid: nothing matched
+    return { (int) e.firstRoot, e.firstQuality, bassPc };
+}
+
+ArrangerChord ChordDetector::recognizeSet (const std::set<int>& notes)
+{
+    if (notes.empty()) return {};
+
+    int mask = 0;
+    for (int n : notes) mask |= 1 << (n % 12);
+    return recognizePitchClasses (mask, (*notes.begin()) % 12);   // std::set is ascending
 }
 
 ArrangerChord ChordDetector::recognizeSingleFinger (const std::set<int>& notes)
@@ -115,19 +154,18 @@ void ChordDetector::recompute()
     // Favour the bass hand: try the lowest 3 (the core triad), then the lowest 4 (a bass 7th), then
     // the full set as a last resort. The first valid match wins, so a melody played on top is ignored.
     // Pure and instant (no debounce); stability comes from order + hysteresis, not from delay.
-    auto lowest = [this] (int take)
-    {
-        std::set<int> s;
-        for (int n : heldNotes) { s.insert (n); if ((int) s.size() == take) break; }
-        return s;
-    };
-
-    for (int take : { 3, 4 })
+    const int bassPc = (*heldNotes.begin()) % 12;
+    int mask = 0, taken = 0;
+    for (int n : heldNotes)
     {
-        ArrangerChord c = recognizeSet (lowest (take));
-        if (c.isValid()) { recognized = c; return; }
+        mask |= 1 << (n % 12);
+        if (++taken == 3 || taken == 4)   // the lowest 3, then the lowest 4
+        {
+            ArrangerChord c = recognizePitchClasses (mask, bassPc);
+            if (c.isValid()) { recognized = c; return; }
+        }
     }
-    ArrangerChord cFull = recognizeSet (heldNotes);
+    ArrangerChord cFull = recognizePitchClasses (mask, bassPc);
     if (cFull.isValid())
         recognized = cFull;
     // else: hold the previously recognized chord (hysteresis)
@@ -35,6 +35,10 @@ public:
         being held" from "Chord Memory is still remembering a released chord". */
     bool hasHeldNotes() const { return ! heldNotes.empty(); }
 
+    /** Fingered recognition of a pitch-class set (bit n = pitch class n) whose lowest note has pitch
+        class `bassPc`: one table lookup (built at compile time for all 4096 sets) plus the bass check. */
+    static ArrangerChord recognizePitchClasses (int pitchClassMask, int bassPc);
+
 private:
     void  recompute();                                   // re-run recognition after a held-note change
     static ArrangerChord recognizeSet (const std::set<int>& notes);   // direct template match on a note set
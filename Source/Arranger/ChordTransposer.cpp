@@ -55,3 +55,36 @@ int ChordTransposer::transpose (int noteNumber, PartKind part) const
     while (shifted > 127) shifted -= 12;
     return shifted;
 }
+
+void ChordTransposer::selectTable()
+{
+    ++useCounter;
+
+    size_t oldest = 0;
+    for (size_t i = 0; i < cache.size(); ++i)
+    {
+        auto& t = cache[i];
+        if (t.lastUsed != 0 && t.original == original && t.active == active && t.bassInversion == bassInversion)
+        {
+            t.lastUsed = useCounter;
+            currentIndex = i;
+            return;
+        }
+        if (t.lastUsed < cache[oldest].lastUsed)
+            oldest = i;
+    }
+
+    // Miss: rebuild the least recently used slot from the reference transpose().
+    Table& t = cache[oldest];
+    t.original      = original;
+    t.active        = active;
+    t.bassInversion = bassInversion;
+    t.lastUsed      = useCounter;
+    for (int n = 0; n < 128; ++n)
+    {
+        t.notes[0][(size_t) n] = (juce::uint8) transpose (n, PartKind::Acc);
+        t.notes[1][(size_t) n] = (juce::uint8) transpose (n, PartKind::Bass);
+    }
+    ++numTableBuilds;
+    currentIndex = oldest;
+}
@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "Chord.h"
+#include <array>
 
 /**
  * Note Transposition Table (NTT): maps each accompaniment note from the recorded (original) chord
@@ -10,16 +11,51 @@
 class ChordTransposer
 {
 public:
-    void setOriginalChord (ArrangerChord recorded) { original = recorded; }
-    void setActiveChord   (ArrangerChord played)   { active = played; }
-    void setBassInversion (bool shouldInvert) { bassInversion = shouldInvert; }
+    ChordTransposer() { selectTable(); }
+
+    void setOriginalChord (ArrangerChord recorded) { original = recorded; selectTable(); }
+    void setActiveChord   (ArrangerChord played)   { active = played; selectTable(); }
+    void setBassInversion (bool shouldInvert) { bassInversion = shouldInvert; selectTable(); }
     bool isBassInversionOn() const { return bassInversion; }
 
-    /** Map one note for a part. Fixed parts and invalid chords return the note unchanged. */
+    /** Map one note for a part. Fixed parts and invalid chords return the note unchanged. This is the
+        reference computation; the playback path uses lookup(). */
     int transpose (int noteNumber, PartKind part) const;
 
+    /** Same result as transpose(), read from the table for the current (original, active, bass
+        inversion) triple. The table is built (or found in the LRU) when any of the three changes, so
+        a live re-harmonisation costs one array index per note. */
+    int lookup (int noteNumber, PartKind part) const
+    {
+        if (part == PartKind::Fixed)
+            return noteNumber;
+        return cache[currentIndex].notes[part == PartKind::Bass ? 1 : 0][(size_t) (noteNumber & 0x7f)];
+    }
+
+    /** Table-cache misses so far (for tests/benchmarks). */
+    int getNumTableBuilds() const { return numTableBuilds; }
+
 private:
+    static constexpr int cacheSize = 8;
+
+    struct Table
+    {
+        ArrangerChord original, active;
+        bool          bassInversion = false;
+        juce::uint32  lastUsed = 0;                               // 0 = empty slot
+        std::array<std::array<juce::uint8, 128>, 2> notes {};     // [Acc, Bass][original note]
+    };
+
+    void selectTable();   // point currentIndex at the table for the current triple, building it on a miss
+
     ArrangerChord original { 0, ChordQuality::Maj, 0 };   // default C major
     ArrangerChord active;
     bool  bassInversion = false;
+
+    // Small LRU of recently used chord tables: a performer alternates between a handful of chords, so
+    // most chord changes are a hit. Fixed-size, so switching never allocates.
+    std::array<Table, cacheSize> cache;
+    size_t       currentIndex = 0;   // an index (not a pointer) so copies stay self-contained
+    juce::uint32 useCounter = 0;
+    int          numTableBuilds = 0;
 };
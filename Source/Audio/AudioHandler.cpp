@@ -27,92 +27,70 @@ void ChannelDSP::prepare(double sr, int blockSize)
     filter.setCutoffFrequency(20000.0f);
     filter.setResonance(0.707f);
 
-    reverbParams          = juce::Reverb::Parameters{};
-    reverbParams.roomSize = 0.5f;
-    reverbParams.damping  = 0.5f;
-    reverbParams.wetLevel = 0.0f;
-    reverbParams.dryLevel = 1.0f;
-    reverbParams.width    = 1.0f;
-    reverb.setParameters(reverbParams);
-    reverb.setSampleRate(sr);
-    reverb.reset();
+    for (auto* v : { &expression, &reverbSend, &chorusSend, &delaySend, &tremoloDepth,
+                     &distortionDrive, &randomModDepth, &filterResonance })
+        v->reset(sr, smoothingSeconds);
+    filterCutoffHz.reset(sr, smoothingSeconds);
+
+    expression.setCurrentAndTargetValue(1.0f);
+    for (auto* v : { &reverbSend, &chorusSend, &delaySend, &tremoloDepth, &distortionDrive, &randomModDepth })
+        v->setCurrentAndTargetValue(0.0f);
+    filterCutoffHz.setCurrentAndTargetValue(20000.0f);
+    filterResonance.setCurrentAndTargetValue(0.707f);
+    reverbRamp = chorusRamp = delayRamp = {};
 
-    chorus.prepare(spec);
-    chorus.setRate(1.5f);
-    chorus.setDepth(0.3f);
-    chorus.setCentreDelay(15.0f);
-    chorus.setFeedback(0.1f);
-    chorus.setMix(0.0f);
-
-    const int maxDelaySamples = static_cast<int>(sr * 0.5);
-    delayLineL.assign(maxDelaySamples, 0.0f);
-    delayLineR.assign(maxDelaySamples, 0.0f);
-    delayWritePos      = 0;
-    delayReadOffset    = static_cast<int>(sr * 0.25);
     tremoloPhase       = 0.0f;
     tremoloPhaseInc    = juce::MathConstants<float>::twoPi * 5.0f / static_cast<float>(sr);
     randomModSmoothed  = 0.0f;
     filterCutoffCC     = 127;
     filterResonanceCC  = 0;
     distortionNormFactor = 1.0f;
+    modGains.assign((size_t) juce::jmax(coefficientUpdateInterval, blockSize), 1.0f);
 }
 
 void ChannelDSP::updateCC(int ccNumber, int value)
 {
+    // Only targets are set here; process() ramps towards them.
     const float norm = value / 127.0f;
     switch (ccNumber)
     {
         case 11: // expression
-            expression = norm;
+            expression.setTargetValue(norm);
             break;
 
         case 71: // resonance → filter Q
             filterResonanceCC = value;
-            filter.setResonance(0.5f + norm * 9.5f);
+            filterResonance.setTargetValue(0.5f + norm * 9.5f);
             break;
 
         case 74: // brightness → LP filter cutoff (100 Hz – 20 kHz, log)
-        {
             filterCutoffCC = value;
-            const float hz = 100.0f * std::pow(200.0f, norm);
-            filter.setCutoffFrequency(juce::jlimit(20.0f, 20000.0f, hz));
+            filterCutoffHz.setTargetValue(juce::jlimit(20.0f, 20000.0f, 100.0f * std::pow(200.0f, norm)));
             break;
-        }
 
         case 80: // distortion drive
-        {
-            distortionDrive = norm;
-            const float drive = 1.0f + norm * 15.0f;
-            distortionNormFactor = 1.0f / std::tanh(drive);
+            distortionDrive.setTargetValue(norm);
+            distortionNormFactor = 1.0f / std::tanh(1.0f + norm * 15.0f);
             break;
-        }
 
-        case 91: // reverb wet amount
-            reverbMix = norm * 0.85f;
-            reverbParams.wetLevel = reverbMix;
-            reverb.setParameters(reverbParams);
+        case 91: // reverb send
+            reverbSend.setTargetValue(norm * 0.85f);
             break;
 
         case 92: // tremolo depth
-            tremoloDepth = norm;
+            tremoloDepth.setTargetValue(norm);
             break;
 
-        case 93: // chorus mix
-            chorusMix = norm;
-            chorus.setMix(norm);
+        case 93: // chorus send
+            chorusSend.setTargetValue(norm);
             break;
 
-        case 94: // delay — mix + time
-            delayMix = norm * 0.8f;
-            if (!delayLineL.empty())
-            {
-                int offset = static_cast<int>(sampleRate * (0.05 + norm * 0.35));
-                delayReadOffset = juce::jlimit(1, static_cast<int>(delayLineL.size()) - 1, offset);
-            }
+        case 94: // delay send (the bus delay time is fixed)
+            delaySend.setTargetValue(norm * 0.8f);
             break;
 
         case 95: // random mod depth
-            randomModDepth = norm;
+            randomModDepth.setTargetValue(norm);
             break;
 
         // CC1 (vibrato): passed through to sfzero — works if the SFZ file defines modwheel
@@ -123,90 +101,221 @@ void ChannelDSP::updateCC(int ccNumber, int value)
     }
 }
 
+bool ChannelDSP::isRamping() const
+{
+    return filterCutoffHz.isSmoothing() || filterResonance.isSmoothing() || distortionDrive.isSmoothing()
+        || tremoloDepth.isSmoothing() || randomModDepth.isSmoothing();
+}
+
 void ChannelDSP::process(juce::AudioBuffer<float>& buffer, int numSamples)
 {
-    // tempBuffer is always prepared with 2 channels
+    // channel buffers are always prepared with 2 channels
     float* left  = buffer.getWritePointer(0);
     float* right = buffer.getWritePointer(1);
 
+    // Sends ramp once per block; SendEffectsBus applies the ramp when it mixes this channel in.
+    const auto advance = [numSamples](SendRamp& ramp, juce::SmoothedValue<float>& send)
+    {
+        ramp.start = send.getCurrentValue();
+        ramp.end   = send.skip(numSamples);
+    };
+    advance(reverbRamp, reverbSend);
+    advance(chorusRamp, chorusSend);
+    advance(delayRamp,  delaySend);
+
+    // Short chunks while a coefficient is ramping, otherwise as long as the scratch buffer allows.
+    for (int start = 0; start < numSamples;)
+    {
+        const int chunk = isRamping() ? coefficientUpdateInterval : (int) modGains.size();
+        const int n = juce::jmin(chunk, numSamples - start);
+        processChunk(left + start, right + start, n);
+        start += n;
+    }
+}
+
+void ChannelDSP::processChunk(float* left, float* right, int numSamples)
+{
     // --- LP filter (CC74 brightness + CC71 resonance) ---
-    // Skip entirely when both CCs are at neutral (CC74=127, CC71=0)
-    if (filterCutoffCC < 127 || filterResonanceCC > 0)
+    // Skip entirely when both CCs are at neutral (CC74=127, CC71=0) and nothing is ramping
+    const bool filterRamping = filterCutoffHz.isSmoothing() || filterResonance.isSmoothing();
+    if (filterRamping)
+    {
+        filter.setCutoffFrequency(filterCutoffHz.skip(numSamples));
+        filter.setResonance(filterResonance.skip(numSamples));
+    }
+    if (filterCutoffCC < 127 || filterResonanceCC > 0 || filterRamping)
     {
-        juce::dsp::AudioBlock<float> block(buffer.getArrayOfWritePointers(),
-                                           (size_t)buffer.getNumChannels(),
-                                           (size_t)numSamples);
+        float* channels[] = { left, right };
+        juce::dsp::AudioBlock<float> block(channels, 2, (size_t)numSamples);
         filter.process(juce::dsp::ProcessContextReplacing<float>(block));
     }
 
     // --- Distortion (CC80) ---
-    if (distortionDrive > 0.005f)
+    const bool driveRamping = distortionDrive.isSmoothing();
+    const float driveAmount = driveRamping ? distortionDrive.skip(numSamples) : distortionDrive.getTargetValue();
+    if (driveAmount > 0.005f)
     {
-        const float drive = 1.0f + distortionDrive * 15.0f;
-        for (int i = 0; i < numSamples; ++i)
-        {
-            left[i]  = std::tanh(left[i]  * drive) * distortionNormFactor;
-            right[i] = std::tanh(right[i] * drive) * distortionNormFactor;
-        }
+        const float drive = 1.0f + driveAmount * 15.0f;
+        const float normFactor = driveRamping ? 1.0f / std::tanh(drive) : distortionNormFactor;
+        DSPKernels::saturate(left,  numSamples, drive, normFactor);
+        DSPKernels::saturate(right, numSamples, drive, normFactor);
     }
 
-    // --- Chorus (CC93) ---
-    if (chorusMix > 0.005f)
+    // --- Tremolo (CC92) and Random Mod (CC95): one gain curve, applied to both sides ---
+    float* gains = modGains.data();
+
+    const float tremolo = tremoloDepth.isSmoothing() ? tremoloDepth.skip(numSamples) : tremoloDepth.getTargetValue();
+    if (tremolo > 0.005f)   // 5 Hz amplitude LFO
     {
-        juce::dsp::AudioBlock<float> block(buffer.getArrayOfWritePointers(),
-                                           (size_t)buffer.getNumChannels(),
-                                           (size_t)numSamples);
-        chorus.process(juce::dsp::ProcessContextReplacing<float>(block));
+        tremoloPhase = DSPKernels::tremoloGains(gains, numSamples, tremoloPhase, tremoloPhaseInc, tremolo);
+        juce::FloatVectorOperations::multiply(left,  gains, numSamples);
+        juce::FloatVectorOperations::multiply(right, gains, numSamples);
     }
 
-    // --- Reverb (CC91) ---
-    if (reverbMix > 0.005f)
-        reverb.processStereo(left, right, numSamples);
+    const float randomMod = randomModDepth.isSmoothing() ? randomModDepth.skip(numSamples) : randomModDepth.getTargetValue();
+    if (randomMod > 0.005f)  // smoothed noise amplitude flutter
+    {
+        noise.fill(gains, numSamples);
+        DSPKernels::smoothedNoiseGains(gains, numSamples, randomModSmoothed, randomMod);
+        juce::FloatVectorOperations::multiply(left,  gains, numSamples);
+        juce::FloatVectorOperations::multiply(right, gains, numSamples);
+    }
 
-    // --- Tremolo (CC92) — 5 Hz amplitude LFO ---
-    if (tremoloDepth > 0.005f)
+    // --- Expression (CC11): ramped per sample ---
+    if (expression.isSmoothing())
     {
         for (int i = 0; i < numSamples; ++i)
         {
-            const float mod = 1.0f - tremoloDepth * 0.5f * (1.0f + std::sin(tremoloPhase));
-            left[i]  *= mod;
-            right[i] *= mod;
-            tremoloPhase += tremoloPhaseInc;
-            if (tremoloPhase >= juce::MathConstants<float>::twoPi)
-                tremoloPhase -= juce::MathConstants<float>::twoPi;
+            const float g = expression.getNextValue();
+            left[i]  *= g;
+            right[i] *= g;
         }
     }
+    else if (expression.getTargetValue() < 0.999f)
+    {
+        juce::FloatVectorOperations::multiply(left,  expression.getTargetValue(), numSamples);
+        juce::FloatVectorOperations::multiply(right, expression.getTargetValue(), numSamples);
+    }
+
+    // Reverb (CC91), chorus (CC93) and delay (CC94) are sends into the shared SendEffectsBus.
+}
+
+//==============================================================================
+// SendEffectsBus
+
+void SendEffectsBus::prepare(double sr, int blockSize)
+{
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate       = sr;
+    spec.maximumBlockSize = static_cast<juce::uint32>(blockSize);
+    spec.numChannels      = 2;
+
+    juce::Reverb::Parameters reverbParams;
+    reverbParams.roomSize = 0.5f;
+    reverbParams.damping  = 0.5f;
+    reverbParams.wetLevel = 1.0f;   // the sends set the amount
+    reverbParams.dryLevel = 0.0f;
+    reverbParams.width    = 1.0f;
+    reverb.setParameters(reverbParams);
+    reverb.setSampleRate(sr);
+    reverb.reset();
+
+    chorus.prepare(spec);
+    chorus.setRate(1.5f);
+    chorus.setDepth(0.3f);
+    chorus.setCentreDelay(15.0f);
+    chorus.setFeedback(0.1f);
+    chorus.setMix(1.0f);
+
+    const int maxDelaySamples = static_cast<int>(sr * 0.5);
+    delayLineL.assign(maxDelaySamples, 0.0f);
+    delayLineR.assign(maxDelaySamples, 0.0f);
+    delayWritePos   = 0;
+    delayReadOffset = static_cast<int>(sr * 0.25);
+
+    reverbIn.setSize(2, blockSize, false, true);
+    chorusIn.setSize(2, blockSize, false, true);
+    delayIn.setSize(2, blockSize, false, true);
+    anySends        = false;
+    tailHoldSamples = maxDelaySamples;
+    quietSamples    = tailHoldSamples;
+}
+
+void SendEffectsBus::beginBlock(int numSamples)
+{
+    for (auto* b : { &reverbIn, &chorusIn, &delayIn })
+    {
+        b->setSize(2, numSamples, false, false, true);
+        b->clear();
+    }
+    anySends = false;
+}
 
-    // --- Delay (CC94) ---
-    if (delayMix > 0.005f && !delayLineL.empty())
+void SendEffectsBus::addChannel(const juce::AudioBuffer<float>& channel, int numSamples,
+                                float leftFrom, float leftTo, float rightFrom, float rightTo, const ChannelDSP& dsp)
+{
+    const auto send = [&](juce::AudioBuffer<float>& bus, const ChannelDSP::SendRamp& level)
     {
+        if (!level.isActive())
+            return;
+        bus.addFromWithRamp(0, 0, channel.getReadPointer(0), numSamples, leftFrom * level.start,  leftTo * level.end);
+        bus.addFromWithRamp(1, 0, channel.getReadPointer(1), numSamples, rightFrom * level.start, rightTo * level.end);
+        anySends = true;
+    };
+    send(reverbIn, dsp.reverbRamp);
+    send(chorusIn, dsp.chorusRamp);
+    send(delayIn,  dsp.delayRamp);
+}
+
+void SendEffectsBus::process(juce::AudioBuffer<float>& out, int numOutputChannels, int numSamples)
+{
+    if (!anySends && quietSamples >= tailHoldSamples)
+        return;
+
+    // --- Chorus ---
+    {
+        juce::dsp::AudioBlock<float> block(chorusIn.getArrayOfWritePointers(), 2, (size_t)numSamples);
+        chorus.process(juce::dsp::ProcessContextReplacing<float>(block));
+    }
+
+    // --- Reverb ---
+    reverb.processStereo(reverbIn.getWritePointer(0), reverbIn.getWritePointer(1), numSamples);
+
+    // --- Delay: a single echo delayReadOffset samples later ---
+    {
+        float* left  = delayIn.getWritePointer(0);
+        float* right = delayIn.getWritePointer(1);
         const int delaySize = static_cast<int>(delayLineL.size());
         for (int i = 0; i < numSamples; ++i)
         {
             const int readPos = (delayWritePos - delayReadOffset + delaySize) % delaySize;
             delayLineL[delayWritePos] = left[i];
             delayLineR[delayWritePos] = right[i];
-            left[i]  += delayMix * delayLineL[readPos];
-            right[i] += delayMix * delayLineR[readPos];
+            left[i]  = delayLineL[readPos];
+            right[i] = delayLineR[readPos];
             delayWritePos = (delayWritePos + 1) % delaySize;
         }
     }
 
-    // --- Random Mod (CC95) — smoothed noise amplitude flutter ---
-    if (randomModDepth > 0.005f)
+    // Sum the returns into reverbIn and add them to the output.
+    reverbIn.addFrom(0, 0, chorusIn, 0, 0, numSamples);
+    reverbIn.addFrom(1, 0, chorusIn, 1, 0, numSamples);
+    reverbIn.addFrom(0, 0, delayIn, 0, 0, numSamples);
+    reverbIn.addFrom(1, 0, delayIn, 1, 0, numSamples);
+
+    if (numOutputChannels >= 2)
     {
-        for (int i = 0; i < numSamples; ++i)
-        {
-            randomModSmoothed = 0.998f * randomModSmoothed + 0.002f * rng.nextFloat();
-            const float mod = 1.0f - randomModDepth * randomModSmoothed;
-            left[i]  *= mod;
-            right[i] *= mod;
-        }
+        out.addFrom(0, 0, reverbIn, 0, 0, numSamples);
+        out.addFrom(1, 0, reverbIn, 1, 0, numSamples);
+    }
+    else
+    {
+        out.addFrom(0, 0, reverbIn, 0, 0, numSamples, 0.5f);
+        out.addFrom(0, 0, reverbIn, 1, 0, numSamples, 0.5f);
     }
 
-    // --- Expression (CC11) ---
-    if (expression < 0.999f)
-        buffer.applyGain(0, numSamples, expression);
+    const bool silent = !anySends && reverbIn.getMagnitude(0, numSamples) < 1.0e-5f;
+    quietSamples = silent ? juce::jmin(quietSamples + numSamples, tailHoldSamples) : 0;
 }
 
 //==============================================================================
@@ -215,13 +324,19 @@ void ChannelDSP::process(juce::AudioBuffer<float>& buffer, int numSamples)
 AudioHandler::AudioHandler(MidiHandler& mh) : midiHandler(mh)
 {
     formatManager.registerBasicFormats();
+    setVoiceBudget(defaultVoicesPerChannel, defaultMaxVoices);
     for (int i = 0; i < 16; ++i)
     {
-        for (int v = 0; v < 16; ++v)
-            sfzSynths[i].addVoice(new sfzero::Voice());
+        sfzSynths[i].setVoiceLimit(&voiceLimit);
+        sfzSynths[i].setReclaimer(&soundReclaimer);
         channelGains[i] = 1.0f;
         channelPans[i]  = 0.5f;
+        mixLeftGain[i]  = std::cos(0.5f * juce::MathConstants<float>::halfPi);
+        mixRightGain[i] = std::sin(0.5f * juce::MathConstants<float>::halfPi);
+        channelDSP[i].noise.setSeed(0x9e3779b9u * (juce::uint32) (i + 1));   // independent flutter per channel
         channelHasSfz[i].store(false, std::memory_order_relaxed);
+        loadGeneration[i].store(0, std::memory_order_relaxed);
+        sfzMemoryBytes[i].store(0, std::memory_order_relaxed);
     }
 }
 
@@ -229,21 +344,62 @@ AudioHandler::~AudioHandler()
 {
 }
 
+void AudioHandler::setAudioClockSource(AudioClockMidiSource* source)
+{
+    const juce::SpinLock::ScopedLockType sl(clockSourceLock);
+    clockSource = source;
+}
+
 void AudioHandler::audioDeviceAboutToStart (juce::AudioIODevice* device)
 {
-    currentSampleRate = device->getCurrentSampleRate();
-    const int bufferSize = device->getCurrentBufferSizeSamples();
-    tempBuffer.setSize(2, bufferSize, false, true);
+    currentDevice = device;
+    prepareToPlay(device->getCurrentSampleRate(), device->getCurrentBufferSizeSamples());
+}
+
+void AudioHandler::prepareToPlay(double sampleRate, int blockSize)
+{
+    currentSampleRate = sampleRate;
 
     for (int i = 0; i < 16; ++i)
     {
         sfzSynths[i].setCurrentPlaybackSampleRate(currentSampleRate);
-        channelDSP[i].prepare(currentSampleRate, bufferSize);
+        channelDSP[i].prepare(currentSampleRate, blockSize);
+        channelBuffers[i].setSize(2, blockSize, false, true);
+        channelMidi[i].ensureSize((size_t) MidiEventQueue::capacity * 16);
+        quietSamples[i] = 0;
     }
+    tailHoldSamples = static_cast<int>(sampleRate * 0.01);  // inserts barely ring; the bus keeps its own tails
+    sendBus.prepare(currentSampleRate, blockSize);
+
+    // Room for every producer queue to be full at once, so draining them never allocates.
+    incomingMidi.ensureSize((size_t) MidiEventQueue::capacity * (size_t) MidiSource::NumSources * 16);
+    midiHandler.prepareToPlay(currentSampleRate);
+    loadMeter.prepare(currentSampleRate);
+}
+
+void AudioHandler::setVoiceBudget(int newVoicesPerChannel, int maxVoices)
+{
+    voiceLimit.setMaxVoices(maxVoices);
+
+    newVoicesPerChannel = juce::jmax(1, newVoicesPerChannel);
+    if (newVoicesPerChannel == voicesPerChannel)
+        return;
+
+    voicesPerChannel = newVoicesPerChannel;
+    for (auto& synth : sfzSynths)
+        synth.setNumVoices(voicesPerChannel);
+}
+
+void AudioHandler::setNumRenderWorkers(int numWorkers)
+{
+    // While this holds the lock the audio thread renders serially rather than waiting.
+    const juce::SpinLock::ScopedLockType sl(renderPoolLock);
+    renderPool.setNumWorkers(numWorkers);
 }
 
 void AudioHandler::audioDeviceStopped()
 {
+    currentDevice = nullptr;
 }
 
 void AudioHandler::audioDeviceIOCallbackWithContext (const float* const* inputChannelData, int numInputChannels,
@@ -251,6 +407,7 @@ void AudioHandler::audioDeviceIOCallbackWithContext (const float* const* inputCh
                                                      int numSamples, const juce::AudioIODeviceCallbackContext& context)
 {
     juce::ignoreUnused(inputChannelData, numInputChannels, context);
+    const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
 
     for (int i = 0; i < numOutputChannels; ++i)
         if (outputChannelData[i] != nullptr)
@@ -259,30 +416,43 @@ void AudioHandler::audioDeviceIOCallbackWithContext (const float* const* inputCh
     if (numOutputChannels == 0)
         return;
 
-    juce::MidiBuffer incomingMidi;
+    incomingMidi.clear();
     midiHandler.getNextMidiBlock(incomingMidi, 0, numSamples);
 
-    // Update per-channel state from incoming CCs before rendering;
-    // also detect noteOns on channels with no SFZ loaded.
+    {
+        // Audio-clock MIDI (the arranger) is rendered straight into this block at sample accuracy.
+        const juce::SpinLock::ScopedTryLockType sl(clockSourceLock);
+        if (sl.isLocked() && clockSource != nullptr)
+            clockSource->renderAudioBlock(incomingMidi, numSamples, currentSampleRate);
+    }
+
+    blockStats.clear();
+    blockStats.numSamples = numSamples;
+    blockStats.midiEvents = incomingMidi.getNumEvents();
+
+    for (auto& midi : channelMidi)
+        midi.clear();
+
+    // One pass over the block: route every channel message to its channel's pre-sized buffer, note the
+    // latest value of each CC, and detect noteOns on channels with no SFZ loaded.
     for (const auto metadata : incomingMidi)
     {
         const auto msg = metadata.getMessage();
+        const int ch = msg.getChannel() - 1;
+        if (ch < 0 || ch >= 16)
+            continue;   // system messages don't reach the synths
+
+        channelMidi[ch].addEvent(metadata.data, metadata.numBytes, metadata.samplePosition);
+
         if (msg.isController())
         {
-            const int ch  = msg.getChannel() - 1;
-            const int cc  = msg.getControllerNumber();
-            const int val = msg.getControllerValue();
-            if (ch >= 0 && ch < 16)
-            {
-                if      (cc == 7)  channelGains[ch] = val / 127.0f;
-                else if (cc == 10) channelPans[ch]  = val / 127.0f;
-                else               channelDSP[ch].updateCC(cc, val);
-            }
+            const int cc = msg.getControllerNumber();
+            pendingCCs[ch].set((size_t) cc);
+            pendingCCValues[ch][cc] = (juce::uint8) msg.getControllerValue();
         }
         else if (msg.isNoteOn() && onNoSfzForChannels)
         {
-            const int ch = msg.getChannel() - 1;
-            if (ch >= 0 && ch < 16 && !channelHasSfz[ch].load(std::memory_order_relaxed))
+            if (!channelHasSfz[ch].load(std::memory_order_relaxed))
             {
                 noSfzChannelMask.fetch_or(1 << ch, std::memory_order_relaxed);
                 bool expected = false;
@@ -299,47 +469,139 @@ void AudioHandler::audioDeviceIOCallbackWithContext (const float* const* inputCh
         }
     }
 
-    // tempBuffer is always 2-channel; reuse its allocation if large enough
-    tempBuffer.setSize(2, numSamples, false, false, true);
-
-    juce::AudioBuffer<float> mainBuffer(outputChannelData, numOutputChannels, numSamples);
-
-    for (int channel = 1; channel <= 16; ++channel)
+    // Apply each controller's last value once; a knob sweep's intermediate values would only be
+    // ramped over anyway.
+    for (int ch = 0; ch < 16; ++ch)
     {
-        if (!channelHasSfz[channel - 1].load(std::memory_order_acquire))
+        if (pendingCCs[ch].none())
             continue;
-
-        juce::MidiBuffer channelMidi;
-        for (const auto metadata : incomingMidi)
+        for (int cc = 0; cc < 128; ++cc)
         {
-            const auto message = metadata.getMessage();
-            if (message.getChannel() == channel)
-                channelMidi.addEvent(message, metadata.samplePosition);
+            if (!pendingCCs[ch].test((size_t) cc))
+                continue;
+            const int val = pendingCCValues[ch][cc];
+            if      (cc == 7)  channelGains[ch] = val / 127.0f;
+            else if (cc == 10) channelPans[ch]  = val / 127.0f;
+            else               channelDSP[ch].updateCC(cc, val);
         }
+        pendingCCs[ch].reset();
+    }
 
-        tempBuffer.clear();
-        sfzSynths[channel - 1].renderNextBlock(tempBuffer, channelMidi, 0, numSamples);
+    // A channel with no events, no sounding voices and a decayed effects tail renders silence: skip it.
+    // One whose instrument was just removed still renders until it has switched and faded out.
+    int numJobs = 0;
+    for (int ch = 0; ch < 16; ++ch)
+        if ((channelHasSfz[ch].load(std::memory_order_acquire) || sfzSynths[ch].hasPublishedSound()
+             || sfzSynths[ch].numVoicesUsed() > 0)
+            && (!channelMidi[ch].isEmpty() || quietSamples[ch] < tailHoldSamples))
+            renderJobs[numJobs++] = ch;
 
-        channelDSP[channel - 1].process(tempBuffer, numSamples);
+    blockNumSamples = numSamples;
+    channelsRendered.store(numJobs, std::memory_order_relaxed);
+    blockStats.channelsRendered = numJobs;
 
-        const float gain = channelGains[channel - 1];
-        const float pan  = channelPans[channel - 1];
+    {
+        const juce::SpinLock::ScopedTryLockType sl(renderPoolLock);
+        if (sl.isLocked() && renderPool.getNumWorkers() > 0 && numJobs > 1)
+            renderPool.run(*this, renderJobs, numJobs);
+        else
+            for (int j = 0; j < numJobs; ++j)
+                renderJob(renderJobs[j]);
+    }
+
+    // Mix in channel order whichever thread rendered each one, so parallel output matches serial.
+    juce::AudioBuffer<float> mainBuffer(outputChannelData, numOutputChannels, numSamples);
+    sendBus.beginBlock(numSamples);
+
+    for (int j = 0; j < numJobs; ++j)
+    {
+        const int ch = renderJobs[j];
+        const auto& rendered = channelBuffers[ch];
+        const float gain = channelGains[ch];
+        const float pan  = channelPans[ch];
+
+        // CC7/CC10 changes ramp across the block from the gains the previous block ended on.
+        const float leftGain  = numOutputChannels >= 2 ? gain * std::cos(pan * juce::MathConstants<float>::halfPi) : gain;
+        const float rightGain = numOutputChannels >= 2 ? gain * std::sin(pan * juce::MathConstants<float>::halfPi) : gain;
+        const float leftFrom  = mixLeftGain[ch], rightFrom = mixRightGain[ch];
+        mixLeftGain[ch]  = leftGain;
+        mixRightGain[ch] = rightGain;
 
         if (numOutputChannels >= 2)
         {
-            const float leftGain  = gain * std::cos(pan * juce::MathConstants<float>::halfPi);
-            const float rightGain = gain * std::sin(pan * juce::MathConstants<float>::halfPi);
-            mainBuffer.addFrom(0, 0, tempBuffer, 0, 0, numSamples, leftGain);
-            mainBuffer.addFrom(1, 0, tempBuffer, 1, 0, numSamples, rightGain);
+            mainBuffer.addFromWithRamp(0, 0, rendered.getReadPointer(0), numSamples, leftFrom,  leftGain);
+            mainBuffer.addFromWithRamp(1, 0, rendered.getReadPointer(1), numSamples, rightFrom, rightGain);
         }
         else
         {
-            mainBuffer.addFrom(0, 0, tempBuffer, 0, 0, numSamples, gain);
+            mainBuffer.addFromWithRamp(0, 0, rendered.getReadPointer(0), numSamples, leftFrom, leftGain);
         }
+
+        if (channelDSP[ch].hasSends())
+            sendBus.addChannel(rendered, numSamples, leftFrom, leftGain, rightFrom, rightGain, channelDSP[ch]);
     }
+
+    const juce::int64 sendsTicks = juce::Time::getHighResolutionTicks();
+    sendBus.process(mainBuffer, numOutputChannels, numSamples);
+    blockStats.sendsMs = AudioLoadMeter::ticksToMs(juce::Time::getHighResolutionTicks() - sendsTicks);
+
+    if (currentDevice != nullptr)
+        loadMeter.setDeviceXRuns(currentDevice->getXRunCount());
+    loadMeter.addBlock(blockStats, startTicks);
 }
 
-void AudioHandler::loadSfz(const juce::File& sfzFile, int midiChannel)
+void AudioHandler::renderJob(int channelIndex)
+{
+    const int numSamples = blockNumSamples;
+    const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+
+    // Reuses the allocation made in prepareToPlay unless the device hands us a bigger block.
+    auto& buffer = channelBuffers[channelIndex];
+    buffer.setSize(2, numSamples, false, false, true);
+    buffer.clear();
+    if (sfzSynths[channelIndex].applyPublishedSound())
+        quietSamples[channelIndex] = 0;   // render the old voices' fade
+    sfzSynths[channelIndex].renderNextBlock(buffer, channelMidi[channelIndex], 0, numSamples);
+    const juce::int64 synthTicks = juce::Time::getHighResolutionTicks();
+
+    channelDSP[channelIndex].process(buffer, numSamples);
+
+    // Each job writes only its own channel's slots; the audio thread reads them after the pool returns.
+    blockStats.synthMs[(size_t) channelIndex] = AudioLoadMeter::ticksToMs(synthTicks - startTicks);
+    blockStats.dspMs[(size_t) channelIndex]   = AudioLoadMeter::ticksToMs(juce::Time::getHighResolutionTicks() - synthTicks);
+    const int voices = sfzSynths[channelIndex].numVoicesUsed();
+    blockStats.voices[(size_t) channelIndex]  = voices;
+
+    // Count how long the channel has been silent (its reverb/delay tails live on the send bus).
+    const bool silent = voices == 0
+                        && buffer.getMagnitude(0, numSamples) < 1.0e-5f;
+    quietSamples[channelIndex] = silent ? juce::jmin(quietSamples[channelIndex] + numSamples, tailHoldSamples) : 0;
+}
+
+void AudioHandler::setSampleDiskCache(const juce::File& folder, juce::int64 maxBytes)
+{
+    jassert(!isLoadingSfz());
+    sampleCache.setDiskCache(nullptr);
+    diskSampleCache = std::make_unique<sfzero::DiskSampleCache>(folder, maxBytes);
+    sampleCache.setDiskCache(diskSampleCache.get());
+}
+
+juce::int64 AudioHandler::getSfzMemoryBytes(int midiChannel) const
+{
+    if (midiChannel < 1 || midiChannel > 16)
+        return 0;
+    return sfzMemoryBytes[midiChannel - 1].load();
+}
+
+juce::int64 AudioHandler::getSfzMemoryBytes(const juce::File& sfzFile) const
+{
+    for (int ch = 1; ch <= 16; ++ch)
+        if (loadedSfzPath[ch - 1] == sfzFile.getFullPathName() && getSfzMemoryBytes(ch) > 0)
+            return getSfzMemoryBytes(ch);
+    return 0;
+}
+
+void AudioHandler::loadSfz(const juce::File& sfzFile, int midiChannel, const SFZLoadOptions& options)
 {
     if (midiChannel < 1 || midiChannel > 16)
         return;
@@ -351,33 +613,57 @@ void AudioHandler::loadSfz(const juce::File& sfzFile, int midiChannel)
         if (channelHasSfz[midiChannel - 1].load(std::memory_order_relaxed)
             || loadedSfzPath[midiChannel - 1].isNotEmpty())
         {
+            const juce::ScopedLock sl(sfzPublishLock);
+            ++loadGeneration[midiChannel - 1];   // a load still in flight must not publish over this
             channelHasSfz[midiChannel - 1].store(false, std::memory_order_release);
-            sfzSynths[midiChannel - 1].clearSounds();
+            sfzSynths[midiChannel - 1].publishSound(nullptr);
+            sfzMemoryBytes[midiChannel - 1].store(0);
             loadedSfzPath[midiChannel - 1] = juce::String();
         }
         return;
     }
 
-    if (sfzFile.getFullPathName() == loadedSfzPath[midiChannel - 1])
+    if (sfzFile.getFullPathName() == loadedSfzPath[midiChannel - 1] && options == loadedOptions[midiChannel - 1])
         return;
     loadedSfzPath[midiChannel - 1] = sfzFile.getFullPathName();
+    loadedOptions[midiChannel - 1] = options;
 
     ++pendingLoads;
     if (onSfzLoadStart)
         onSfzLoadStart();
 
-    juce::Thread::launch([this, sfzFile, midiChannel]()
+    int generation;
+    {
+        const juce::ScopedLock sl(sfzPublishLock);
+        generation = ++loadGeneration[midiChannel - 1];
+    }
+    juce::Thread::launch([this, sfzFile, midiChannel, options, generation]()
     {
-        auto* sound = new sfzero::Sound(sfzFile);
+        sfzero::Sound::Ptr sound(new sfzero::Sound(sfzFile));
         sound->loadRegions();
+        sound->setStreaming(options.streamFromDisk ? &sampleStreamer : nullptr, options.preloadMs / 1000.0);
+        sound->setSampleCache(&sampleCache);
+        sound->setInt16Samples(options.int16Samples);
+        sound->setLoadPool(&sfzLoadPool);
         sound->loadSamples(&formatManager);
-        sfzSynths[midiChannel - 1].clearSounds();
-        sfzSynths[midiChannel - 1].addSound(sound);
-        channelHasSfz[midiChannel - 1].store(true, std::memory_order_release);
+        // Built entirely off the audio thread; the synth switches to it at its next block. An older
+        // load finishing after a newer one was started is dropped here. The check and the publish
+        // share sfzPublishLock with loadSfz's generation bumps, so a newer load or a silencing can't
+        // slip in between them; the audio thread never takes it.
+        {
+            const juce::ScopedLock sl(sfzPublishLock);
+            if (loadGeneration[midiChannel - 1].load() == generation)
+            {
+                sfzSynths[midiChannel - 1].publishSound(sound.get());
+                channelHasSfz[midiChannel - 1].store(true, std::memory_order_release);
+                sfzMemoryBytes[midiChannel - 1].store(sound->getMemoryBytes());
+            }
+        }
 
         if (--pendingLoads == 0)
-            juce::MessageManager::callAsync([this]() {
-                if (onSfzLoadComplete) onSfzLoadComplete();
+            juce::MessageManager::callAsync([weakThis = juce::WeakReference<AudioHandler>(this)]() {
+                if (auto* self = weakThis.get())
+                    if (self->onSfzLoadComplete) self->onSfzLoadComplete();
             });
     });
 }
@@ -11,42 +11,96 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <bitset>
 #include "MidiHandler.h"
+#include "AudioClockMidiSource.h"
+#include "AudioLoadMeter.h"
+#include "ChannelRenderPool.h"
+#include "DSPKernels.h"
+#include "SFZlibrary.h"
 
+/** Per-channel insert effects (filter, distortion, tremolo, random mod, expression) plus the channel's
+    send levels into the shared SendEffectsBus.
+
+    CC changes ramp over smoothingSeconds instead of jumping. While a ramp runs, the filter and drive
+    coefficients are recomputed every coefficientUpdateInterval samples, not per sample or per CC. */
 struct ChannelDSP
 {
-    float expression           = 1.0f;
-    float reverbMix            = 0.0f;
-    float chorusMix            = 0.0f;
-    float tremoloDepth         = 0.0f;
+    static constexpr int    coefficientUpdateInterval = 16;
+    static constexpr double smoothingSeconds          = 0.02;
+
+    /** A send level's start and end over the current block. */
+    struct SendRamp
+    {
+        float start = 0.0f, end = 0.0f;
+        bool isActive() const { return start > 0.005f || end > 0.005f; }
+    };
+
+    juce::SmoothedValue<float> expression { 1.0f };
+    juce::SmoothedValue<float> reverbSend, chorusSend, delaySend;   // CC91 / CC93 / CC94
+    juce::SmoothedValue<float> tremoloDepth;
+    juce::SmoothedValue<float> distortionDrive;
+    juce::SmoothedValue<float> randomModDepth;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> filterCutoffHz { 20000.0f };
+    juce::SmoothedValue<float> filterResonance { 0.707f };
+
+    SendRamp reverbRamp, chorusRamp, delayRamp;   // set by process() for the block just rendered
+
     float tremoloPhase         = 0.0f;
     float tremoloPhaseInc      = 0.0f;   // cached: 2π*5/sampleRate
-    float delayMix             = 0.0f;
-    float distortionDrive      = 0.0f;
-    float distortionNormFactor = 1.0f;   // cached: 1/tanh(drive)
-    float randomModDepth       = 0.0f;
+    float distortionNormFactor = 1.0f;   // cached: 1/tanh(drive) at the drive target
     float randomModSmoothed    = 0.0f;
     int   filterCutoffCC       = 127;    // raw CC74 value; 127 = neutral (no filtering)
     int   filterResonanceCC    = 0;      // raw CC71 value; 0 = neutral
 
     juce::dsp::StateVariableTPTFilter<float> filter;
-    juce::Reverb                             reverb;
-    juce::Reverb::Parameters                 reverbParams;
-    juce::dsp::Chorus<float>                 chorus;
 
-    std::vector<float> delayLineL, delayLineR;
-    int    delayWritePos  = 0;
-    int    delayReadOffset = 0;
-    double sampleRate     = 44100.0;
+    double sampleRate = 44100.0;
 
-    juce::Random rng;
+    DSPKernels::NoiseSource noise;
+    std::vector<float>      modGains;   // scratch gain curve for tremolo / random mod, one block long
 
     void prepare(double sr, int blockSize);
     void updateCC(int ccNumber, int value);
     void process(juce::AudioBuffer<float>& buffer, int numSamples);
+    bool hasSends() const { return reverbRamp.isActive() || chorusRamp.isActive() || delayRamp.isActive(); }
+
+private:
+    bool isRamping() const;
+    void processChunk(float* left, float* right, int numSamples);
 };
 
-class AudioHandler : public juce::AudioIODeviceCallback
+/**
+ * GM-style shared effects: one reverb, one chorus and one delay that every channel feeds through its
+ * CC91/CC93/CC94 send level, after its inserts, gain and pan. Each effect's 100% wet return is added
+ * to the main mix. While nothing is sent and the returns have died away, process() does nothing.
+ */
+struct SendEffectsBus
+{
+    juce::Reverb             reverb;
+    juce::dsp::Chorus<float> chorus;
+    std::vector<float>       delayLineL, delayLineR;
+    int delayWritePos   = 0;
+    int delayReadOffset = 0;
+
+    juce::AudioBuffer<float> reverbIn, chorusIn, delayIn;   // this block's summed sends, stereo
+    bool anySends   = false;    // something was sent this block
+    int  quietSamples = 0;      // samples the returns have been silent with nothing sent
+    int  tailHoldSamples = 0;   // the delay line's length: an echo can follow that much silence
+
+    void prepare(double sr, int blockSize);
+    /** Starts a block: clears the send buffers (sized for numSamples). */
+    void beginBlock(int numSamples);
+    /** Adds a rendered channel to the sends, panned by gains ramping from leftFrom/rightFrom to
+        leftTo/rightTo across the block, at the channel's send levels. */
+    void addChannel(const juce::AudioBuffer<float>& channel, int numSamples,
+                    float leftFrom, float leftTo, float rightFrom, float rightTo, const ChannelDSP& dsp);
+    /** Runs the three effects on their sends and adds their returns to `out`. */
+    void process(juce::AudioBuffer<float>& out, int numOutputChannels, int numSamples);
+};
+
+class AudioHandler : public juce::AudioIODeviceCallback,
+                     private ChannelRenderPool::Client
 {
 public:
     AudioHandler(MidiHandler& mh);
@@ -58,29 +112,125 @@ public:
     void audioDeviceAboutToStart (juce::AudioIODevice* device) override;
     void audioDeviceStopped() override;
 
-    void loadSfz(const juce::File& sfzFile, int midiChannel);
+    /** Sizes every per-channel buffer for blocks of up to blockSize samples (audioDeviceAboutToStart
+        calls this; tests and benchmarks call it directly). */
+    void prepareToPlay(double sampleRate, int blockSize);
+
+    /** Renders the channels on numWorkers extra threads as well as the audio thread; 0 (the default)
+        renders them one after another on the audio thread. Message thread. */
+    void setNumRenderWorkers(int numWorkers);
+    int  getNumRenderWorkers() const { return renderPool.getNumWorkers(); }
+
+    static constexpr int defaultVoicesPerChannel = 32;
+    static constexpr int defaultMaxVoices = 256;
+
+    /** Gives every channel voicesPerChannel voices, with at most maxVoices sounding across all
+        channels; past either limit a channel steals its own released or quietest voice. Changing
+        the per-channel count cuts off the notes playing. Message thread. */
+    void setVoiceBudget(int voicesPerChannel, int maxVoices);
+    int  getVoicesPerChannel() const { return voicesPerChannel; }
+    int  getMaxVoices() const        { return voiceLimit.getMaxVoices(); }
+    /** Voices sounding across all channels. Any thread. */
+    int  getNumActiveVoices() const  { return voiceLimit.getNumVoicesInUse(); }
+
+    /** Channels the last block actually rendered (idle channels are skipped). Any thread. */
+    int getNumChannelsRendered() const { return channelsRendered.load(std::memory_order_relaxed); }
+
+    /** What each audio callback cost: its share of the block period, per-channel synth and DSP time,
+        voices, MIDI events, overruns and the device's xruns. Recorded without locks by the audio
+        thread; collect() and read it on the message thread. */
+    AudioLoadMeter&       getLoadMeter()       { return loadMeter; }
+    const AudioLoadMeter& getLoadMeter() const { return loadMeter; }
+
+    /** True while loadSfz calls are still decoding in the background. */
+    bool isLoadingSfz() const { return pendingLoads.load() > 0; }
+
+    /** Loads sfzFile onto midiChannel in the background; loading the same file with different
+        options reloads it. */
+    void loadSfz(const juce::File& sfzFile, int midiChannel, const SFZLoadOptions& options = {});
+
+    /** Bytes of sample frames the instrument on midiChannel keeps in memory (0 while none is
+        loaded). Any thread. */
+    juce::int64 getSfzMemoryBytes(int midiChannel) const;
+    /** The same for whichever channel has sfzFile loaded with its current options; channels
+        sharing an instrument share its samples, so this is its footprint. Message thread. */
+    juce::int64 getSfzMemoryBytes(const juce::File& sfzFile) const;
+
+    /** The disk reader behind every channel loaded with streamFromDisk, for underrun monitoring. */
+    const sfzero::SampleStreamer& getSampleStreamer() const { return sampleStreamer; }
+
+    /** Decoded samples shared by every channel: an SFZ loaded on several channels, or loaded again
+        after a style change, reads each sample from disk once. */
+    const sfzero::SampleCache& getSampleCache() const { return sampleCache; }
+
+    /** Keeps decoded samples in folder between runs, deleting the least recently used past
+        maxBytes, so instruments load again without decoding their samples. Off unless set; call
+        before loading any SFZ. */
+    void setSampleDiskCache(const juce::File& folder, juce::int64 maxBytes);
+    const sfzero::DiskSampleCache* getSampleDiskCache() const { return diskSampleCache.get(); }
+
+    /** Renders `source` into each block's MIDI alongside the queued input (nullptr detaches). Any
+        thread; once this returns the previous source is no longer being called. */
+    void setAudioClockSource(AudioClockMidiSource* source);
 
     std::function<void()> onSfzLoadStart;
     std::function<void()> onSfzLoadComplete;
     std::function<void(int channelMask)> onNoSfzForChannels;
 
 private:
+    /** Renders one channel's synth and DSP into its channelBuffers slot (audio thread or a render worker). */
+    void renderJob(int channelIndex) override;
+
     std::atomic<int>  pendingLoads      { 0 };
     std::atomic<int>  noSfzChannelMask  { 0 };
     std::atomic<bool> noSfzNotifyPending { false };
 
     MidiHandler& midiHandler;
+    std::unique_ptr<sfzero::DiskSampleCache> diskSampleCache;   // before sampleCache, which points to it
+    sfzero::SampleCache sampleCache;
+    sfzero::SoundReclaimer soundReclaimer;   // before sfzSynths, which unregister from it
+    sfzero::SampleStreamer sampleStreamer { defaultMaxVoices };   // one stream per voice at the default budget
+    sfzero::VoiceLimit voiceLimit { defaultMaxVoices };   // before sfzSynths: they hand their slots back on destruction
+    int voicesPerChannel = 0;
     sfzero::Synth sfzSynths[16];
     juce::AudioFormatManager formatManager;
+    juce::ThreadPool sfzLoadPool { juce::jlimit(1, 7, juce::SystemStats::getNumCpus() - 1) };   // decodes for every load at once
     double currentSampleRate = 44100.0;
 
     std::atomic<bool> channelHasSfz[16];
+    std::atomic<int>  loadGeneration[16];   // bumped by every loadSfz; only the latest load publishes
+    juce::CriticalSection sfzPublishLock;   // a generation bump and a publish are atomic under it; never the audio thread
+    std::atomic<juce::int64> sfzMemoryBytes[16];   // of the sound last published on each channel
     juce::String      loadedSfzPath[16]; // message-thread only
-
-    juce::AudioBuffer<float> tempBuffer;
+    SFZLoadOptions    loadedOptions[16]; // message-thread only
+
+    juce::MidiBuffer         incomingMidi;   // refilled every block; pre-sized in audioDeviceAboutToStart
+    AudioClockMidiSource*    clockSource = nullptr;   // guarded by clockSourceLock
+    juce::SpinLock           clockSourceLock;         // the audio thread only ever try-locks it
+    juce::MidiBuffer         channelMidi[16];      // this block's events per channel, demultiplexed in one pass; pre-sized
+    juce::AudioBuffer<float> channelBuffers[16];   // private stereo render target per channel
+    int   renderJobs[16];                           // channels to render this block
+    int   blockNumSamples = 0;
+    int   quietSamples[16] {};                      // samples each channel has rendered silence for (its own job writes it)
+    int   tailHoldSamples = 0;                      // channels quiet this long are skipped until their next event
+    std::atomic<int> channelsRendered { 0 };
     float channelGains[16];
     float channelPans[16];
+    float mixLeftGain[16], mixRightGain[16];   // gains the last block ended on; the next ramps from there
+
+    // CCs are coalesced per block: only the latest value of each controller is applied.
+    std::bitset<128> pendingCCs[16];
+    juce::uint8      pendingCCValues[16][128];
     ChannelDSP channelDSP[16];
+    SendEffectsBus sendBus;
+
+    AudioLoadMeter             loadMeter;
+    AudioLoadMeter::BlockStats blockStats;   // this block's; render jobs fill in their own channel
+    juce::AudioIODevice*       currentDevice = nullptr;   // between audioDeviceAboutToStart and audioDeviceStopped
+
+    ChannelRenderPool renderPool;
+    juce::SpinLock    renderPoolLock;   // held by setNumRenderWorkers; the audio thread only try-locks it
 
+    JUCE_DECLARE_WEAK_REFERENCEABLE (AudioHandler)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioHandler)
 };
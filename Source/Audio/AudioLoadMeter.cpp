@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+    AudioLoadMeter.cpp
+
+  ==============================================================================
+*/
+
+#include "AudioLoadMeter.h"
+
+const double AudioLoadMeter::msPerTick = 1000.0 / (double) juce::Time::getHighResolutionTicksPerSecond();
+
+void AudioLoadMeter::BlockStats::clear()
+{
+    sendsMs = 0.0f;
+    midiEvents = 0;
+    channelsRendered = 0;
+    voices.fill(0);
+    synthMs.fill(0.0f);
+    dspMs.fill(0.0f);
+}
+
+AudioLoadMeter::AudioLoadMeter()
+    : recentBins((size_t) histogramBlocks, 0),
+      fifoBlocksData((size_t) fifoBlocks + 1),
+      history((size_t) historyBlocks)
+{
+}
+
+void AudioLoadMeter::prepare(double sampleRate)
+{
+    periodMsPerSample = 1000.0 / juce::jmax(1.0, sampleRate);
+}
+
+int AudioLoadMeter::binFor(float load)
+{
+    return (int) (juce::jlimit(0.0f, numBins - 1.0f, load / binWidth));
+}
+
+void AudioLoadMeter::addBlock(BlockStats& stats, juce::int64 startTicks)
+{
+    const juce::int64 endTicks = juce::Time::getHighResolutionTicks();
+
+    if (resetPending.exchange(false, std::memory_order_acquire))
+        applyReset();
+
+    stats.blockNumber = numBlocks.fetch_add(1, std::memory_order_relaxed);
+    stats.startMs     = (double) startTicks * msPerTick;
+    stats.callbackMs  = ticksToMs(endTicks - startTicks);
+    const double periodMs = stats.numSamples * periodMsPerSample;
+    stats.load = periodMs > 0.0 ? (float) (stats.callbackMs / periodMs) : 0.0f;
+
+    if (stats.load > 1.0f)
+        numOverruns.fetch_add(1, std::memory_order_relaxed);
+    if (stats.load > peakLoad.load(std::memory_order_relaxed))
+        peakLoad.store(stats.load, std::memory_order_relaxed);
+
+    // The histogram covers a sliding window: the block leaving it is taken back out.
+    const int bin = binFor(stats.load);
+    if (recentCount == histogramBlocks)
+        histogram[(size_t) recentBins[(size_t) recentPos]].fetch_sub(1, std::memory_order_relaxed);
+    else
+        ++recentCount;
+    histogram[(size_t) bin].fetch_add(1, std::memory_order_relaxed);
+    recentBins[(size_t) recentPos] = (juce::uint8) bin;
+    recentPos = (recentPos + 1) % histogramBlocks;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 + size2 < 1)
+    {
+        numDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    fifoBlocksData[(size_t) (size1 > 0 ? start1 : start2)] = stats;
+    fifo.finishedWrite(1);
+}
+
+void AudioLoadMeter::applyReset()
+{
+    numBlocks.store(0, std::memory_order_relaxed);
+    numOverruns.store(0, std::memory_order_relaxed);
+    numDropped.store(0, std::memory_order_relaxed);
+    peakLoad.store(0.0f, std::memory_order_relaxed);
+    for (auto& count : histogram)
+        count.store(0, std::memory_order_relaxed);
+    recentPos = recentCount = 0;
+}
+
+std::array<int, AudioLoadMeter::numBins> AudioLoadMeter::getHistogram() const
+{
+    std::array<int, numBins> counts;
+    for (int i = 0; i < numBins; ++i)
+        counts[(size_t) i] = histogram[(size_t) i].load(std::memory_order_relaxed);
+    return counts;
+}
+
+void AudioLoadMeter::reset()
+{
+    // This side owns the FIFO's read end and the history, so they are emptied here and now.
+    fifo.finishedRead(fifo.getNumReady());
+    historyStart = historySize = 0;
+    resetPending.store(true, std::memory_order_release);
+}
+
+int AudioLoadMeter::collect()
+{
+    const int numReady = fifo.getNumReady();
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+    const auto append = [this](const BlockStats& stats)
+    {
+        history[(size_t) ((historyStart + historySize) % historyBlocks)] = stats;
+        if (historySize < historyBlocks)
+            ++historySize;
+        else
+            historyStart = (historyStart + 1) % historyBlocks;
+    };
+    for (int i = 0; i < size1; ++i)
+        append(fifoBlocksData[(size_t) (start1 + i)]);
+    for (int i = 0; i < size2; ++i)
+        append(fifoBlocksData[(size_t) (start2 + i)]);
+
+    fifo.finishedRead(size1 + size2);
+    return size1 + size2;
+}
+
+const AudioLoadMeter::BlockStats& AudioLoadMeter::getHistoryBlock(int index) const
+{
+    jassert(index >= 0 && index < historySize);
+    return history[(size_t) ((historyStart + index) % historyBlocks)];
+}
+
+bool AudioLoadMeter::writeCsv(const juce::File& file)
+{
+    collect();
+
+    juce::FileOutputStream out(file);
+    if (!out.openedOk())
+        return false;
+    out.setPosition(0);
+    out.truncate();
+
+    out << "block,start_ms,samples,callback_ms,load,sends_ms,midi_events,channels_rendered";
+    for (int ch = 1; ch <= numChannels; ++ch)
+        out << ",voices_" << ch << ",synth_ms_" << ch << ",dsp_ms_" << ch;
+    out << "\n";
+
+    for (int i = 0; i < historySize; ++i)
+    {
+        const auto& b = getHistoryBlock(i);
+        out << juce::String(b.blockNumber) << "," << juce::String(b.startMs, 3) << "," << b.numSamples << ","
+            << juce::String(b.callbackMs, 4) << "," << juce::String(b.load, 4) << "," << juce::String(b.sendsMs, 4) << ","
+            << b.midiEvents << "," << b.channelsRendered;
+        for (int ch = 0; ch < numChannels; ++ch)
+            out << "," << b.voices[(size_t) ch] << "," << juce::String(b.synthMs[(size_t) ch], 4)
+                << "," << juce::String(b.dspMs[(size_t) ch], 4);
+        out << "\n";
+    }
+
+    out.flush();
+    return !out.getStatus().failed();
+}
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    AudioLoadMeter.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+/**
+ * @class AudioLoadMeter
+ * @brief Measures how much of its deadline each audio callback uses. The audio thread records every
+ *        block without locks or allocation; the message thread reads the results.
+ *
+ * The audio thread fills in a BlockStats for each block and passes it to addBlock(), which:
+ *   - adds the block's load (callback time over block period) to a histogram of the last
+ *     histogramBlocks blocks;
+ *   - counts the block as an overrun when the callback took longer than its period;
+ *   - pushes the block onto a single-producer/single-consumer FIFO, counting it as dropped when the
+ *     FIFO is full.
+ * On the message thread, collect() drains the FIFO into a bounded history. The overlay and
+ * writeCsv() read that history. Counters and the histogram are atomics and can be read from any
+ * thread.
+ */
+class AudioLoadMeter
+{
+public:
+    static constexpr int   numChannels     = 16;
+    static constexpr int   numBins         = 32;      // load in steps of binWidth; the last bin holds everything above
+    static constexpr float binWidth        = 0.05f;
+    static constexpr int   histogramBlocks = 4096;    // blocks the histogram covers
+    static constexpr int   fifoBlocks      = 2048;    // several seconds at small block sizes, so a 10 Hz reader keeps up
+    static constexpr int   historyBlocks   = 16384;   // blocks collect() keeps for the overlay and the CSV
+
+    /** @brief One audio callback. The audio thread (and render workers, one channel each) fill it in */
+    struct BlockStats
+    {
+        juce::int64 blockNumber      = 0;      // since the meter was created or reset
+        double      startMs          = 0.0;    // on the high-resolution tick clock
+        int         numSamples       = 0;
+        float       callbackMs       = 0.0f;   // the whole callback, MIDI routing to mixdown
+        float       load             = 0.0f;   // callbackMs over the block period
+        float       sendsMs          = 0.0f;   // the shared reverb/chorus/delay bus
+        int         midiEvents       = 0;
+        int         channelsRendered = 0;
+        std::array<int,   numChannels> voices  {};   // sounding after the block
+        std::array<float, numChannels> synthMs {};   // 0 for channels skipped this block
+        std::array<float, numChannels> dspMs   {};
+
+        /** @brief Clears the per-block fields, ready for the next callback */
+        void clear();
+    };
+
+    AudioLoadMeter();
+
+    //==============================================================================
+    // Audio thread
+
+    /** @brief Sets the sample rate the block periods are computed from. Call before the callbacks start */
+    void prepare(double sampleRate);
+
+    /** @brief Finishes a block whose callback started at startTicks (Time::getHighResolutionTicks) */
+    void addBlock(BlockStats& stats, juce::int64 startTicks);
+
+    /** @brief The device's own xrun count; -1 when it doesn't report one */
+    void setDeviceXRuns(int count) { deviceXRuns.store(count, std::memory_order_relaxed); }
+
+    /** @brief Milliseconds between two high-resolution tick readings */
+    static float ticksToMs(juce::int64 ticks) { return (float) ((double) ticks * msPerTick); }
+
+    //==============================================================================
+    // Any thread
+
+    juce::int64 getNumBlocks() const   { return numBlocks.load(std::memory_order_relaxed); }
+    /** @brief Blocks whose callback took longer than their period since the last reset */
+    int   getNumOverruns() const       { return numOverruns.load(std::memory_order_relaxed); }
+    int   getNumDeviceXRuns() const    { return deviceXRuns.load(std::memory_order_relaxed); }
+    /** @brief Blocks lost because the FIFO was full (nobody was collecting) */
+    int   getNumDropped() const        { return numDropped.load(std::memory_order_relaxed); }
+    float getPeakLoad() const          { return peakLoad.load(std::memory_order_relaxed); }
+    /** @brief The last histogramBlocks blocks by load; bin i counts loads in [i, i + 1) * binWidth */
+    std::array<int, numBins> getHistogram() const;
+
+    /** @brief Zeroes the counters, the histogram and the history. The audio thread applies it at its
+        next block, so the histogram is only cleared once that block has run */
+    void reset();
+
+    //==============================================================================
+    // Message thread
+
+    /** @brief Moves the blocks the audio thread has finished into the history; returns how many */
+    int collect();
+
+    int getNumHistoryBlocks() const { return historySize; }
+    /** @brief index 0 is the oldest block kept */
+    const BlockStats& getHistoryBlock(int index) const;
+
+    /** @brief Collects, then writes the history as CSV: one row per block, with voices, synth and DSP
+        time for each channel */
+    bool writeCsv(const juce::File& file);
+
+private:
+    static int binFor(float load);
+    void applyReset();
+
+    static const double msPerTick;
+
+    // Audio thread
+    double periodMsPerSample = 1000.0 / 44100.0;
+    std::vector<juce::uint8> recentBins;   // ring of the last histogramBlocks blocks' bins
+    int recentPos = 0, recentCount = 0;
+
+    // FIFO from the audio thread to collect()
+    juce::AbstractFifo       fifo { fifoBlocks + 1 };   // an AbstractFifo holds one fewer than its size
+    std::vector<BlockStats>  fifoBlocksData;
+
+    std::atomic<juce::int64> numBlocks   { 0 };
+    std::atomic<int>         numOverruns { 0 };
+    std::atomic<int>         deviceXRuns { -1 };
+    std::atomic<int>         numDropped  { 0 };
+    std::atomic<float>       peakLoad    { 0.0f };
+    std::array<std::atomic<int>, numBins> histogram {};
+    std::atomic<bool>        resetPending { false };
+
+    // Message thread
+    std::vector<BlockStats> history;   // ring of historyBlocks
+    int historyStart = 0, historySize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioLoadMeter)
+};
@@ -0,0 +1,219 @@
+#include "AudioLoadUI.h"
+
+AudioLoadUI::AudioLoadUI()
+{
+    addAndMakeVisible(resetButton);
+    resetButton.setTooltip("Zero the counters, the histogram and the history");
+    resetButton.onClick = [this]
+    {
+        if (auto* meter = getMeter ? getMeter() : nullptr)
+            meter->reset();
+        recent = {};
+        repaint();
+    };
+
+    addAndMakeVisible(saveCsvButton);
+    saveCsvButton.setTooltip("Save every block in the history, one row each, with per-channel timings");
+    saveCsvButton.onClick = [this] { saveCsvClicked(); };
+
+    addAndMakeVisible(closeButton);
+    closeButton.onClick = [this]
+    {
+        setVisible(false);
+        if (onClose) onClose();
+    };
+}
+
+AudioLoadUI::~AudioLoadUI()
+{
+    stopTimer();
+}
+
+void AudioLoadUI::visibilityChanged()
+{
+    if (isVisible())
+    {
+        timerCallback();
+        startTimerHz(10);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
+
+void AudioLoadUI::timerCallback()
+{
+    if (!isShowing())
+        return;   // the settings window is hidden, with this still open in it
+
+    if (auto* meter = getMeter ? getMeter() : nullptr)
+    {
+        meter->collect();
+        recent = summarise(*meter, 0.5);
+    }
+    repaint();
+}
+
+AudioLoadUI::Recent AudioLoadUI::summarise(const AudioLoadMeter& meter, double seconds)
+{
+    Recent r;
+    const int numHistory = meter.getNumHistoryBlocks();
+    if (numHistory == 0)
+        return r;
+
+    const double newestMs = meter.getHistoryBlock(numHistory - 1).startMs;
+    int midiEvents = 0;
+    double oldestMs = newestMs;
+    for (int i = numHistory - 1; i >= 0; --i)
+    {
+        const auto& b = meter.getHistoryBlock(i);
+        if (r.numBlocks > 0 && newestMs - b.startMs > seconds * 1000.0)
+            break;
+
+        ++r.numBlocks;
+        r.averageLoad += b.load;
+        r.maxLoad = juce::jmax(r.maxLoad, b.load);
+        if (r.numBlocks > 1)
+            midiEvents += b.midiEvents;   // the events between the oldest block's start and now
+        oldestMs = b.startMs;
+        for (size_t ch = 0; ch < (size_t) AudioLoadMeter::numChannels; ++ch)
+        {
+            r.voices[ch]  += (float) b.voices[ch];
+            r.synthMs[ch] += b.synthMs[ch];
+            r.dspMs[ch]   += b.dspMs[ch];
+        }
+    }
+
+    const float scale = 1.0f / (float) r.numBlocks;
+    r.averageLoad *= scale;
+    for (size_t ch = 0; ch < (size_t) AudioLoadMeter::numChannels; ++ch)
+    {
+        r.voices[ch]  *= scale;
+        r.synthMs[ch] *= scale;
+        r.dspMs[ch]   *= scale;
+    }
+    if (newestMs > oldestMs)
+        r.midiEventsPerSecond = (float) (midiEvents * 1000.0 / (newestMs - oldestMs));
+    return r;
+}
+
+void AudioLoadUI::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::darkgrey);
+    auto bounds = getLocalBounds();
+
+    g.setColour(juce::Colours::white);
+    g.setFont(16.0f);
+    g.drawText("Audio Load", bounds.removeFromTop(30), juce::Justification::centred, true);
+    bounds.removeFromBottom(44);   // the buttons
+    bounds.reduce(10, 0);
+
+    auto* meter = getMeter ? getMeter() : nullptr;
+    if (meter == nullptr)
+    {
+        g.setFont(14.0f);
+        g.setColour(juce::Colours::lightgrey);
+        g.drawText("The SFZ engine isn't running.", bounds, juce::Justification::centred, true);
+        return;
+    }
+
+    // --- Summary ---
+    const auto percent = [](float load) { return juce::String(juce::roundToInt(load * 100.0f)) + "%"; };
+    const int xruns = meter->getNumDeviceXRuns();
+    g.setFont(13.0f);
+    g.setColour(recent.maxLoad > 1.0f ? juce::Colours::orange : juce::Colours::lightgreen);
+    g.drawText("Load (last 0.5 s): " + percent(recent.averageLoad) + " average, " + percent(recent.maxLoad) + " max"
+                   + "    Peak: " + percent(meter->getPeakLoad()),
+               bounds.removeFromTop(18), juce::Justification::centredLeft, true);
+    g.setColour(meter->getNumOverruns() > 0 || xruns > 0 ? juce::Colours::orange : juce::Colours::lightgrey);
+    g.drawText("Overruns: " + juce::String(meter->getNumOverruns()) + " of " + juce::String(meter->getNumBlocks())
+                   + " blocks    Device xruns: " + (xruns >= 0 ? juce::String(xruns) : juce::String("n/a")),
+               bounds.removeFromTop(18), juce::Justification::centredLeft, true);
+    g.setColour(juce::Colours::lightgrey);
+    g.drawText("MIDI: " + juce::String(juce::roundToInt(recent.midiEventsPerSecond)) + " events/s"
+                   + (meter->getNumDropped() > 0 ? "    Blocks not recorded: " + juce::String(meter->getNumDropped()) : juce::String()),
+               bounds.removeFromTop(18), juce::Justification::centredLeft, true);
+    bounds.removeFromTop(6);
+
+    // --- Histogram of the last blocks' load; bins past the deadline in red ---
+    {
+        auto area = bounds.removeFromTop(96);
+        g.setColour(juce::Colours::black.withAlpha(0.3f));
+        g.fillRect(area);
+
+        const auto counts = meter->getHistogram();
+        const int maxCount = juce::jmax(1, *std::max_element(counts.begin(), counts.end()));
+        const float barW = (float) area.getWidth() / (float) AudioLoadMeter::numBins;
+        for (int i = 0; i < AudioLoadMeter::numBins; ++i)
+        {
+            // A square-root scale, so a few late blocks still show next to thousands of quick ones.
+            const float h = (float) (area.getHeight() - 14) * std::sqrt((float) counts[(size_t) i] / (float) maxCount);
+            const bool late = (float) i * AudioLoadMeter::binWidth >= 1.0f;
+            g.setColour(late ? juce::Colours::red : juce::Colours::lightgreen);
+            g.fillRect((float) area.getX() + (float) i * barW + 1.0f, (float) area.getBottom() - 14.0f - h, barW - 2.0f, h);
+        }
+
+        const float deadlineX = (float) area.getX() + barW / AudioLoadMeter::binWidth;
+        g.setColour(juce::Colours::white);
+        g.drawVerticalLine(juce::roundToInt(deadlineX), (float) area.getY(), (float) area.getBottom() - 14.0f);
+        g.setFont(11.0f);
+        g.drawText("0%", area.getX(), area.getBottom() - 14, 40, 14, juce::Justification::centredLeft);
+        g.drawText("100%", juce::roundToInt(deadlineX) - 20, area.getBottom() - 14, 40, 14, juce::Justification::centred);
+        g.drawText(percent(AudioLoadMeter::numBins * AudioLoadMeter::binWidth) + "+", area.getRight() - 50, area.getBottom() - 14,
+                   50, 14, juce::Justification::centredRight);
+    }
+    bounds.removeFromTop(6);
+
+    // --- Per channel, averaged over the last 0.5 s ---
+    const int rowH = 13;
+    const int colW = bounds.getWidth() / 4;
+    g.setFont(12.0f);
+    g.setColour(juce::Colours::white);
+    {
+        auto header = bounds.removeFromTop(rowH + 2);
+        for (const char* title : { "Channel", "Voices", "Synth ms", "DSP ms" })
+            g.drawText(title, header.removeFromLeft(colW), juce::Justification::centredLeft, false);
+    }
+    for (size_t ch = 0; ch < (size_t) AudioLoadMeter::numChannels && bounds.getHeight() >= rowH; ++ch)
+    {
+        auto row = bounds.removeFromTop(rowH);
+        const bool idle = recent.synthMs[ch] == 0.0f && recent.voices[ch] == 0.0f;
+        g.setColour(idle ? juce::Colours::grey : juce::Colours::lightgrey);
+        g.drawText(juce::String((int) ch + 1), row.removeFromLeft(colW), juce::Justification::centredLeft, false);
+        g.drawText(juce::String(recent.voices[ch], 1), row.removeFromLeft(colW), juce::Justification::centredLeft, false);
+        g.drawText(juce::String(recent.synthMs[ch], 3), row.removeFromLeft(colW), juce::Justification::centredLeft, false);
+        g.drawText(juce::String(recent.dspMs[ch], 3), row.removeFromLeft(colW), juce::Justification::centredLeft, false);
+    }
+}
+
+void AudioLoadUI::resized()
+{
+    auto bounds = getLocalBounds();
+    closeButton.setBounds(bounds.getRight() - 35, 5, 30, 20);
+
+    auto buttonRow = bounds.removeFromBottom(44).reduced(5);
+    const int btnW = buttonRow.getWidth() / 2;
+    resetButton.setBounds(buttonRow.removeFromLeft(btnW).reduced(2));
+    saveCsvButton.setBounds(buttonRow.reduced(2));
+}
+
+void AudioLoadUI::saveCsvClicked()
+{
+    const auto defaultFile = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                                 .getChildFile("audio-load-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".csv");
+    fileChooser = std::make_unique<juce::FileChooser>("Save Audio Load CSV", defaultFile, "*.csv");
+    auto chooserFlags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::warnAboutOverwriting;
+
+    fileChooser->launchAsync(chooserFlags, [this](const juce::FileChooser& fc)
+    {
+        const auto file = fc.getResult();
+        auto* meter = getMeter ? getMeter() : nullptr;
+        if (file == juce::File() || meter == nullptr)
+            return;
+
+        if (!meter->writeCsv(file))
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+                "Couldn't save", "Couldn't write " + file.getFullPathName());
+    });
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioLoadMeter.h"
+
+/**
+ * @class AudioLoadUI
+ * @brief Settings overlay showing the audio callback's load from an AudioLoadMeter: recent and peak
+ *        load, overruns and device xruns, a histogram of recent blocks, and each channel's voices
+ *        and synth/DSP time. It can reset the meter and save its history as CSV.
+ *
+ * It polls the meter 10 times a second while visible. getMeter returns nullptr while no audio engine
+ * is running.
+ */
+class AudioLoadUI : public juce::Component,
+                    private juce::Timer
+{
+public:
+    AudioLoadUI();
+    ~AudioLoadUI() override;
+
+    std::function<AudioLoadMeter*()> getMeter;
+    std::function<void()> onClose;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void visibilityChanged() override;
+
+    /** @brief Averages over the newest blocks of the meter's history that cover seconds (at least one) */
+    struct Recent
+    {
+        int   numBlocks = 0;
+        float averageLoad = 0.0f, maxLoad = 0.0f;
+        float midiEventsPerSecond = 0.0f;
+        std::array<float, AudioLoadMeter::numChannels> voices {}, synthMs {}, dspMs {};
+    };
+    static Recent summarise(const AudioLoadMeter& meter, double seconds);
+
+private:
+    void timerCallback() override;
+    void saveCsvClicked();
+
+    juce::TextButton resetButton   { "Reset" };
+    juce::TextButton saveCsvButton { "Save CSV..." };
+    juce::TextButton closeButton   { "X" };
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
+    Recent recent;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioLoadUI)
+};
@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+    ChannelRenderPool.cpp
+
+  ==============================================================================
+*/
+
+#include "ChannelRenderPool.h"
+
+class ChannelRenderPool::Worker : public juce::Thread
+{
+public:
+    Worker(ChannelRenderPool& p, int index)
+        : juce::Thread("Channel render " + juce::String(index + 1)), pool(p) {}
+
+    void run() override
+    {
+        const auto spinTicks = juce::Time::secondsToHighResolutionTicks(maxSpinMs * 0.001);
+        juce::uint32 seenGeneration = generationOf(pool.work.load());
+
+        while (!threadShouldExit())
+        {
+            // The next block often arrives before a sleeping thread could be woken, so watch for it
+            // briefly; never longer than maxSpinMs.
+            const auto spinUntil = juce::Time::getHighResolutionTicks() + spinTicks;
+            auto word = pool.work.load();
+            while (generationOf(word) == seenGeneration && juce::Time::getHighResolutionTicks() < spinUntil)
+                word = pool.work.load();
+
+            if (generationOf(word) == seenGeneration)
+            {
+                // Announce the sleep, then look once more: run() publishes before it checks `sleeping`,
+                // so either this sees the new block or run() sees us and signals.
+                sleeping.store(true);
+                if (generationOf(pool.work.load()) == seenGeneration)
+                    wake.wait(-1);
+                sleeping.store(false);
+                continue;
+            }
+
+            seenGeneration = generationOf(word);
+            pool.renderClaimedJobs(word);
+        }
+    }
+
+    /** @brief Audio thread: wakes the worker if it went to sleep waiting for this block */
+    void wakeIfSleeping()
+    {
+        if (sleeping.exchange(false))
+            wake.signal();
+    }
+
+    void stop()
+    {
+        signalThreadShouldExit();
+        wake.signal();
+        stopThread(2000);
+    }
+
+private:
+    ChannelRenderPool& pool;
+    std::atomic<bool> sleeping { false };
+    juce::WaitableEvent wake;
+};
+
+ChannelRenderPool::~ChannelRenderPool()
+{
+    setNumWorkers(0);
+}
+
+void ChannelRenderPool::setNumWorkers(int numWorkers)
+{
+    numWorkers = juce::jlimit(0, maxWorkers, numWorkers);
+
+    while ((int) workers.size() > numWorkers)
+    {
+        workers.back()->stop();
+        workers.pop_back();
+    }
+
+    while ((int) workers.size() < numWorkers)
+    {
+        workers.push_back(std::make_unique<Worker>(*this, (int) workers.size()));
+        auto& worker = *workers.back();
+        // Without real-time rights (e.g. no rtprio on Linux) fall back to the highest normal priority.
+        if (!worker.startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(9)))
+            worker.startThread(juce::Thread::Priority::highest);
+    }
+}
+
+void ChannelRenderPool::renderClaimedJobs(juce::uint64 word)
+{
+    const auto generation = generationOf(word);
+    for (;;)
+    {
+        if (generationOf(word) != generation || nextJobOf(word) >= numJobsOf(word))
+            return;
+
+        if (!work.compare_exchange_weak(word, word + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            continue;   // word now holds the current value; look again
+
+        currentClient->renderJob(currentJobs[nextJobOf(word)]);
+        if (jobsDone.fetch_add(1) + 1 == numJobsOf(word) && runWaiting.exchange(false))
+            blockDone.signal();
+        ++word;
+    }
+}
+
+void ChannelRenderPool::run(Client& client, const int* jobs, int numJobs)
+{
+    jassert(numJobs <= 0xffff);
+    currentClient = &client;
+    currentJobs   = jobs;
+    jobsDone.store(0, std::memory_order_relaxed);
+
+    const auto generation = generationOf(work.load(std::memory_order_relaxed)) + 1;
+    const auto word = ((juce::uint64) generation << 32) | ((juce::uint64) numJobs << 16);
+    work.store(word);
+
+    for (auto& worker : workers)
+        worker->wakeIfSleeping();
+
+    renderClaimedJobs(word);
+
+    // Every job has been claimed; wait for the workers still finishing theirs. They usually finish
+    // within a few microseconds of each other, so spin briefly before sleeping until the last one
+    // signals. A signal left over from an earlier block just costs one more look at jobsDone.
+    const auto spinUntil = juce::Time::getHighResolutionTicks()
+                         + juce::Time::secondsToHighResolutionTicks(maxSpinMs * 0.001);
+    while (jobsDone.load() != numJobs)
+    {
+        if (juce::Time::getHighResolutionTicks() < spinUntil)
+            continue;
+
+        runWaiting.store(true);
+        if (jobsDone.load() != numJobs)
+            blockDone.wait(-1);
+    }
+    runWaiting.store(false);
+}
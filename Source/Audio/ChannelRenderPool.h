@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    ChannelRenderPool.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @class ChannelRenderPool
+ * @brief A fixed set of pre-spawned worker threads that share out one audio block's channel renders.
+ *
+ * The audio thread calls run() with the block's job indices. run() publishes the block in one atomic
+ * word (a generation number, the job count and the next job to claim), claims jobs itself as well,
+ * and returns once every job is done. Jobs are claimed one at a time by compare-and-swap on that word,
+ * so one heavy channel doesn't hold up the rest and a worker from an old block can never claim a job
+ * of a new one.
+ *
+ * run() takes no locks and never allocates. After a job a worker watches the word for at most
+ * maxSpinMs, then sleeps on its own event; run() signals only the workers that went to sleep, so an
+ * idle pool costs no CPU and a busy one rarely pays for a wake-up. Likewise run() watches jobsDone for
+ * at most maxSpinMs once it has nothing left to claim, then sleeps until the worker finishing the last
+ * job signals it. run() only waits for jobs a worker has actually claimed, so a sleeping or preempted
+ * worker costs parallelism, not the deadline. Workers are real-time threads where the OS allows it.
+ *
+ * setNumWorkers() must not overlap run() -- AudioHandler guards the two with a SpinLock that the audio
+ * thread only try-locks.
+ */
+class ChannelRenderPool
+{
+public:
+    /** @brief Renders one job; called concurrently for different indices, never twice for one index per run */
+    struct Client
+    {
+        virtual ~Client() = default;
+        virtual void renderJob(int index) = 0;
+    };
+
+    static constexpr int    maxWorkers = 15;      // the audio thread is the 16th renderer
+    static constexpr double maxSpinMs  = 0.05;    // longest busy-wait before sleeping on an event
+
+    ChannelRenderPool() = default;
+    ~ChannelRenderPool();
+
+    /** @brief Starts or stops threads so that numWorkers are waiting (clamped to [0, maxWorkers]) */
+    void setNumWorkers(int numWorkers);
+    int  getNumWorkers() const { return (int) workers.size(); }
+
+    /** @brief Renders jobs[0..numJobs) across the calling thread and the workers; returns when all are done */
+    void run(Client& client, const int* jobs, int numJobs);
+
+private:
+    class Worker;
+
+    // work: generation << 32 | numJobs << 16 | next job to claim
+    static juce::uint32 generationOf(juce::uint64 w) { return (juce::uint32) (w >> 32); }
+    static int          numJobsOf(juce::uint64 w)    { return (int) ((w >> 16) & 0xffff); }
+    static int          nextJobOf(juce::uint64 w)    { return (int) (w & 0xffff); }
+
+    /** @brief Claims and renders jobs of the block in word until none are left, or a new block replaces it */
+    void renderClaimedJobs(juce::uint64 word);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // Written by run() before it publishes the block's word; only read after claiming one of its jobs,
+    // and run() can't publish the next block until that job is done.
+    Client*    currentClient = nullptr;
+    const int* currentJobs   = nullptr;
+
+    std::atomic<juce::uint64> work     { 0 };
+    std::atomic<int>          jobsDone { 0 };
+
+    // run() sets runWaiting before it sleeps on blockDone; the worker that completes the last job
+    // clears it and signals. Both sides use sequentially consistent accesses, so run() either sees
+    // the final job done or the worker sees it waiting.
+    std::atomic<bool>   runWaiting { false };
+    juce::WaitableEvent blockDone;
+
+    JUCE_DECLARE_NON_COPYABLE(ChannelRenderPool)
+};
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    DSPKernels.cpp
+
+  ==============================================================================
+*/
+
+#include "DSPKernels.h"
+
+void DSPKernels::saturate(float* data, int numSamples, float drive, float outputGain)
+{
+    juce::FloatVectorOperations::multiply(data, drive, numSamples);
+    for (int i = 0; i < numSamples; ++i)
+        data[i] = tanhApprox(data[i]);
+    juce::FloatVectorOperations::multiply(data, outputGain, numSamples);
+}
+
+float DSPKernels::tremoloGains(float* gains, int numSamples, float phase, float phaseInc, float depth)
+{
+    // Rotate (s, c) = (sin, cos) of the phase by phaseInc per sample: two multiply-adds, no sin(). Each
+    // step needs the previous one, so this loop is serial; it is still far cheaper than sin() per sample.
+    const float rotS = std::sin(phaseInc), rotC = std::cos(phaseInc);
+    float s = std::sin(phase), c = std::cos(phase);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        gains[i] = s;
+        const float nextS = s * rotC + c * rotS;
+        c = c * rotC - s * rotS;
+        s = nextS;
+    }
+
+    // 1 - depth*0.5*(1 + sin) = (1 - depth*0.5) - depth*0.5*sin
+    juce::FloatVectorOperations::multiply(gains, -0.5f * depth, numSamples);
+    juce::FloatVectorOperations::add(gains, 1.0f - 0.5f * depth, numSamples);
+
+    const float twoPi = juce::MathConstants<float>::twoPi;
+    phase = std::fmod(phase + phaseInc * (float) numSamples, twoPi);
+    return phase < 0.0f ? phase + twoPi : phase;
+}
+
+void DSPKernels::NoiseSource::setSeed(juce::uint32 seed)
+{
+    for (int l = 0; l < 4; ++l)
+    {
+        seed = seed * 1664525u + 1013904223u;   // spread one seed over the lanes
+        lanes[l] = seed != 0 ? seed : 1u;       // xorshift must not start at 0
+    }
+}
+
+void DSPKernels::NoiseSource::fill(float* dest, int numSamples)
+{
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4)
+        for (int l = 0; l < 4; ++l)
+        {
+            auto x = lanes[l];
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            lanes[l] = x;
+            dest[i + l] = (float) (x >> 8) * (1.0f / 16777216.0f);   // top 24 bits -> [0, 1)
+        }
+
+    for (int l = 0; i < numSamples; ++i, ++l)
+    {
+        auto x = lanes[l];
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        lanes[l] = x;
+        dest[i] = (float) (x >> 8) * (1.0f / 16777216.0f);
+    }
+}
+
+void DSPKernels::smoothedNoiseGains(float* noiseInGainsOut, int numSamples, float& smoothed, float depth)
+{
+    // The one-pole recursion is inherently serial; everything around it is vectorised.
+    float y = smoothed;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        y = 0.998f * y + 0.002f * noiseInGainsOut[i];
+        noiseInGainsOut[i] = y;
+    }
+    smoothed = y;
+
+    juce::FloatVectorOperations::multiply(noiseInGainsOut, -depth, numSamples);
+    juce::FloatVectorOperations::add(noiseInGainsOut, 1.0f, numSamples);
+}
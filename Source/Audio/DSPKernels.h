@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    DSPKernels.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+
+/**
+ * @namespace DSPKernels
+ * @brief Block kernels for ChannelDSP's insert effects.
+ *
+ * Each kernel works on a whole block of contiguous floats with no branches or library calls in its
+ * inner loop. Loops whose samples are independent vectorise; recurrences (the tremolo phasor, the
+ * one-pole filters) stay serial but cheap, and the work around them is vectorised. Modulation
+ * kernels write a gain curve once per block; ChannelDSP then applies it to both channels with
+ * juce::FloatVectorOperations::multiply. This replaces per-sample std::tanh, std::sin and
+ * juce::Random::nextFloat calls made once per channel.
+ */
+namespace DSPKernels
+{
+    /**
+     * @brief Rational (Padé 7/6) tanh approximation, |error| < 1e-4 everywhere
+     *
+     * The input is clamped to ±4.97, where the approximation reaches ±1.
+     */
+    inline float tanhApprox(float x)
+    {
+        x = std::min(4.97f, std::max(-4.97f, x));
+        const float x2  = x * x;
+        const float num = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+        const float den = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f));
+        return std::min(1.0f, std::max(-1.0f, num / den));
+    }
+
+    /** @brief data[i] = tanhApprox(data[i] * drive) * outputGain */
+    void saturate(float* data, int numSamples, float drive, float outputGain);
+
+    /**
+     * @brief Tremolo gain curve: gains[i] = 1 - depth * 0.5 * (1 + sin(phase + i * phaseInc))
+     *
+     * The sine comes from a rotating phasor started from the exact phase each block, so it never drifts.
+     * Each step depends on the one before, so the phasor loop runs serially (two multiply-adds per
+     * sample); only the scale and offset applied afterwards are vectorised.
+     * @return the phase after numSamples, wrapped to [0, 2π)
+     */
+    float tremoloGains(float* gains, int numSamples, float phase, float phaseInc, float depth);
+
+    /**
+     * @class NoiseSource
+     * @brief Uniform [0, 1) white noise from four interleaved xorshift32 generators (one per SIMD lane)
+     */
+    class NoiseSource
+    {
+    public:
+        explicit NoiseSource(juce::uint32 seed = 0x9e3779b9u) { setSeed(seed); }
+
+        void setSeed(juce::uint32 seed);
+        void fill(float* dest, int numSamples);
+
+    private:
+        juce::uint32 lanes[4];
+    };
+
+    /**
+     * @brief Random-mod gain curve from white noise: a one-pole smoother then 1 - depth * smoothed
+     * @param noiseInGainsOut noise in [0, 1) on input; the gain curve on output
+     * @param smoothed the smoother's state, carried from block to block
+     */
+    void smoothedNoiseGains(float* noiseInGainsOut, int numSamples, float& smoothed, float depth);
+}
@@ -130,6 +130,16 @@ SFZLibraryUI::SFZLibraryUI(SFZLibraryManager& managerRef) : manager(managerRef)
     addAndMakeVisible(importConfigButton);
     importConfigButton.onClick = [this] { importConfigButtonClicked(); };
 
+    addAndMakeVisible(streamToggle);
+    streamToggle.setTooltip("Keep only the start of each sample in memory and read the rest while it plays");
+    streamToggle.setEnabled(false);
+    streamToggle.onClick = [this] { streamToggleClicked(); };
+
+    addAndMakeVisible(int16Toggle);
+    int16Toggle.setTooltip("Keep samples in memory as 16-bit integers: half the RAM, slightly more CPU per voice");
+    int16Toggle.setEnabled(false);
+    int16Toggle.onClick = [this] { int16ToggleClicked(); };
+
     addAndMakeVisible(closeButton);
     closeButton.onClick = [this] {
         if (onClose) onClose();
@@ -173,6 +183,10 @@ void SFZLibraryUI::resized()
     assignButton.setBounds(botRow.removeFromLeft(btnW).reduced(2));
     importConfigButton.setBounds(botRow.reduced(2));
 
+    auto toggleRow = bounds.removeFromBottom(26).reduced(7, 2);
+    streamToggle.setBounds(toggleRow.removeFromLeft(toggleRow.getWidth() / 2));
+    int16Toggle.setBounds(toggleRow);
+
     libraryList.setBounds(bounds.reduced(5));
 }
 
@@ -215,6 +229,14 @@ void SFZLibraryUI::paintListBoxItem(int rowNumber, juce::Graphics& g, int width,
             textToDraw += "   [Assigned: " + assignedInsts + "]";
         }
 
+        if (entry.loadOptions.streamFromDisk)
+            textToDraw += "   [Streamed]";
+        if (entry.loadOptions.int16Samples)
+            textToDraw += "   [16-bit]";
+        if (getLoadedMemoryBytes)
+            if (auto bytes = getLoadedMemoryBytes(entry.getFile()))
+                textToDraw += "   [" + juce::File::descriptionOfSizeInBytes(bytes) + " loaded]";
+
         if (rowIsSelected)
             g.setColour(juce::Colours::black);
         else if (isAssigned)
@@ -226,6 +248,45 @@ void SFZLibraryUI::paintListBoxItem(int rowNumber, juce::Graphics& g, int width,
     }
 }
 
+void SFZLibraryUI::selectedRowsChanged(int lastRowSelected)
+{
+    const bool validRow = lastRowSelected >= 0 && lastRowSelected < (int)manager.getEntries().size();
+    streamToggle.setEnabled(validRow);
+    streamToggle.setToggleState(validRow && manager.getEntries()[lastRowSelected].loadOptions.streamFromDisk,
+                                juce::dontSendNotification);
+    int16Toggle.setEnabled(validRow);
+    int16Toggle.setToggleState(validRow && manager.getEntries()[lastRowSelected].loadOptions.int16Samples,
+                               juce::dontSendNotification);
+}
+
+void SFZLibraryUI::streamToggleClicked()
+{
+    int selectedRow = libraryList.getSelectedRow();
+    if (selectedRow < 0 || selectedRow >= (int)manager.getEntries().size())
+        return;
+
+    const auto& entry = manager.getEntries()[selectedRow];
+    auto options = entry.loadOptions;
+    options.streamFromDisk = streamToggle.getToggleState();
+    manager.setLoadOptions(entry.id, options);
+    if (onLibraryChanged) onLibraryChanged();
+    libraryList.repaintRow(selectedRow);
+}
+
+void SFZLibraryUI::int16ToggleClicked()
+{
+    int selectedRow = libraryList.getSelectedRow();
+    if (selectedRow < 0 || selectedRow >= (int)manager.getEntries().size())
+        return;
+
+    const auto& entry = manager.getEntries()[selectedRow];
+    auto options = entry.loadOptions;
+    options.int16Samples = int16Toggle.getToggleState();
+    manager.setLoadOptions(entry.id, options);
+    if (onLibraryChanged) onLibraryChanged();
+    libraryList.repaintRow(selectedRow);
+}
+
 void SFZLibraryUI::addFileButtonClicked()
 {
     fileChooser = std::make_unique<juce::FileChooser>("Select SFZ File", juce::File(), "*.sfz");
@@ -15,17 +15,21 @@ public:
     std::function<juce::String()> getCurrentStyleId;
     std::function<juce::String()> getCurrentStyleName;
     std::function<juce::String(const juce::String&)> getStyleNameForId; // optional: id → display name
+    std::function<juce::int64(const juce::File&)> getLoadedMemoryBytes;  // optional: sample memory of a loaded SFZ, 0 if not loaded
 
     void paint(juce::Graphics& g) override;
     void resized() override;
 
     int getNumRows() override;
     void paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+    void selectedRowsChanged(int lastRowSelected) override;
 
 private:
     void addFileButtonClicked();
     void removeFileButtonClicked();
     void importConfigButtonClicked();
+    void streamToggleClicked();
+    void int16ToggleClicked();
     void updateStatusLabel();
     void buildInstrumentList();
 
@@ -36,6 +40,8 @@ private:
     juce::TextButton assignButton     { "Assign to Style" };
     juce::TextButton importConfigButton { "Import Config" };
     juce::TextButton closeButton      { "X" };
+    juce::ToggleButton streamToggle   { "Stream samples from disk" };
+    juce::ToggleButton int16Toggle    { "Store samples as 16-bit" };
     juce::Label statusLabel;
     std::unique_ptr<juce::FileChooser> fileChooser;
     juce::StringArray instrumentList;
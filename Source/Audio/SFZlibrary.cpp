@@ -122,18 +122,40 @@ const SFZLibraryEntry* SFZLibraryManager::getEntryById(const juce::String& entry
     return nullptr;
 }
 
-juce::File SFZLibraryManager::getSfzForStyleInstrument(const juce::String& styleId, int instrumentNumber) const
+void SFZLibraryManager::setLoadOptions(const juce::String& entryId, const SFZLoadOptions& options)
+{
+    for (auto& entry : data.library)
+    {
+        if (entry.id == entryId)
+            entry.loadOptions = options;
+    }
+}
+
+const SFZLibraryEntry* SFZLibraryManager::getEntryForStyleInstrument(const juce::String& styleId, int instrumentNumber) const
 {
     const auto styleIt = data.styleMappings.find(styleId);
     if (styleIt == data.styleMappings.end())
-        return {};
+        return nullptr;
 
     const auto instrumentIt = styleIt->second.find(instrumentNumber);
     if (instrumentIt == styleIt->second.end())
-        return {};
+        return nullptr;
 
-    if (const auto* entry = getEntryById(instrumentIt->second))
+    return getEntryById(instrumentIt->second);
+}
+
+juce::File SFZLibraryManager::getSfzForStyleInstrument(const juce::String& styleId, int instrumentNumber) const
+{
+    if (const auto* entry = getEntryForStyleInstrument(styleId, instrumentNumber))
         return entry->getFile();
 
     return {};
 }
+
+SFZLoadOptions SFZLibraryManager::getLoadOptionsForStyleInstrument(const juce::String& styleId, int instrumentNumber) const
+{
+    if (const auto* entry = getEntryForStyleInstrument(styleId, instrumentNumber))
+        return entry->loadOptions;
+
+    return {};
+}
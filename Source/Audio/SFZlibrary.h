@@ -12,11 +12,27 @@
 
 #include <JuceHeader.h>
 
+/** How AudioHandler::loadSfz loads an instrument's samples. */
+struct SFZLoadOptions
+{
+    bool streamFromDisk = false;   /**< keep only the first preloadMs of each sample in memory, stream the rest */
+    int  preloadMs      = 300;
+    bool int16Samples   = false;   /**< keep samples as 16-bit integers in memory: half the RAM, a little more CPU per voice */
+
+    bool operator==(const SFZLoadOptions& other) const
+    {
+        return streamFromDisk == other.streamFromDisk && preloadMs == other.preloadMs
+            && int16Samples == other.int16Samples;
+    }
+    bool operator!=(const SFZLoadOptions& other) const { return !(*this == other); }
+};
+
 struct SFZLibraryEntry
 {
     juce::String id;
     juce::String name;
     juce::String sfzPath;
+    SFZLoadOptions loadOptions;
 
     juce::File getFile() const { return juce::File(sfzPath); }
 };
@@ -46,8 +62,12 @@ public:
     void clearStyleInstrumentAssignment(const juce::String& styleId, int instrumentNumber);
     void importMappingsFromStyle(const juce::String& sourceStyleId, const juce::String& targetStyleId);
 
+    void setLoadOptions(const juce::String& entryId, const SFZLoadOptions& options);
+
     const SFZLibraryEntry* getEntryById(const juce::String& entryId) const;
+    const SFZLibraryEntry* getEntryForStyleInstrument(const juce::String& styleId, int instrumentNumber) const;
     juce::File getSfzForStyleInstrument(const juce::String& styleId, int instrumentNumber) const;
+    SFZLoadOptions getLoadOptionsForStyleInstrument(const juce::String& styleId, int instrumentNumber) const;
 
 private:
     SFZLibraryData data;
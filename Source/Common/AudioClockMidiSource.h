@@ -0,0 +1,32 @@
+/*
+  ==============================================================================
+
+    AudioClockMidiSource.h
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/**
+ * @class AudioClockMidiSource
+ * @brief Something that generates MIDI on the audio clock: the audio callback asks it for one block
+ *        at a time and it writes events straight into that block at their sample offsets.
+ *
+ * renderAudioBlock runs on the audio thread, so implementations must not block or allocate.
+ */
+class AudioClockMidiSource {
+public:
+
+    /** @brief Destructor */
+    virtual ~AudioClockMidiSource() = default;
+
+    /**
+     * @brief Renders the next block of MIDI
+     * @param out The block's MIDI buffer; events are added at sample positions in [0, numSamples)
+     * @param numSamples Length of the block
+     * @param sampleRate The audio device's sample rate
+     */
+    virtual void renderAudioBlock(juce::MidiBuffer& out, int numSamples, double sampleRate) = 0;
+};
@@ -677,6 +677,9 @@ void SFZLibraryIOHelper::saveToFile(const juce::File& file, const SFZLibraryData
         entryObj->setProperty("id", entry.id);
         entryObj->setProperty("name", entry.name);
         entryObj->setProperty("sfzPath", entry.sfzPath);
+        entryObj->setProperty("streamFromDisk", entry.loadOptions.streamFromDisk);
+        entryObj->setProperty("preloadMs", entry.loadOptions.preloadMs);
+        entryObj->setProperty("int16Samples", entry.loadOptions.int16Samples);
         libraryArray.add(juce::var(entryObj));
     }
     rootObj->setProperty("library", libraryArray);
@@ -730,6 +733,10 @@ void SFZLibraryIOHelper::loadFromFile(const juce::File& file, SFZLibraryData& da
                     entry.id = entryObj->getProperty("id").toString();
                     entry.name = entryObj->getProperty("name").toString();
                     entry.sfzPath = entryObj->getProperty("sfzPath").toString();
+                    entry.loadOptions.streamFromDisk = entryObj->getProperty("streamFromDisk");
+                    if (entryObj->hasProperty("preloadMs"))
+                        entry.loadOptions.preloadMs = entryObj->getProperty("preloadMs");
+                    entry.loadOptions.int16Samples = entryObj->getProperty("int16Samples");
                     data.library.push_back(entry);
                 }
             }
@@ -23,7 +23,9 @@ public:
     //==============================================================================
     void initialise(const juce::String& commandLine) override
     {
-        /*
+       #if PROJECT_SYNTH_TESTS
+        // The test runner (and the benchmarks) only exist in builds that define PROJECT_SYNTH_TESTS;
+        // Release ignores these switches and starts the app.
         if (commandLine.contains ("--run-tests"))
         {
             juce::UnitTestRunner runner;
@@ -35,6 +37,8 @@ public:
                 runner.runTestsInCategory ("Unit");
             else if (commandLine.contains ("--integration-tests"))
                 runner.runTestsInCategory ("Integration");
+            else if (commandLine.contains ("--benchmarks"))
+                runner.runTestsInCategory ("Benchmark");   // timings are in each result's messages
             else
                 runner.runAllTests();
 
@@ -60,7 +64,9 @@ public:
             quit();
             return;
         }
-        */
+       #else
+        juce::ignoreUnused(commandLine);
+       #endif
 
         mainWindow.reset(new MainWindow(getApplicationName()));
     }
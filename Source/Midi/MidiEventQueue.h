@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    MidiEventQueue.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+/**
+ * @enum MidiSource
+ * @brief The threads that feed MIDI into the audio callback. Each one gets its own queue, so every
+ *        queue has a single producer and the audio thread is the single consumer.
+ */
+enum class MidiSource
+{
+    HardwareInput = 0,   /**< juce::MidiInput callback thread */
+    Keyboard,            /**< message thread: computer keyboard, on-screen keys and effect knobs (CCs) */
+    Arranger,            /**< ArrangerEngine timer thread */
+    TrackPlayer,         /**< MultipleTrackPlayer thread */
+    RecordPlayer,        /**< MidiRecordPlayer timer */
+    NumSources
+};
+
+/**
+ * @struct QueuedMidiEvent
+ * @brief A short (at most 3-byte) MIDI message plus its arrival time, stored by value so pushing and
+ *        popping never allocates.
+ */
+struct QueuedMidiEvent
+{
+    double      arrivalSeconds = 0.0;   /**< on the MidiHandler::nowSeconds() clock */
+    juce::uint8 data[3] {};
+    juce::uint8 size = 0;
+};
+
+/**
+ * @class MidiEventQueue
+ * @brief Fixed-capacity, lock-free single-producer/single-consumer ring of QueuedMidiEvents.
+ *
+ * The audio thread drains it with no locks and no allocation. If one source is occasionally fed from
+ * a second thread (e.g. the arranger's stop() on the message thread while its timer still runs), the
+ * producers serialize on a SpinLock that the consumer never touches.
+ */
+class MidiEventQueue
+{
+public:
+    static constexpr int capacity = 4096;
+
+    /**
+     * @brief Queues a message; messages longer than 3 bytes (SysEx) are not audio events and are skipped
+     * @return false if the message was dropped (too long, or the queue is full)
+     */
+    bool push(const juce::MidiMessage& msg, double arrivalSeconds)
+    {
+        const int size = msg.getRawDataSize();
+        if (size <= 0 || size > 3)
+            return false;
+
+        const juce::SpinLock::ScopedLockType producerLock(producerSpin);
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+        if (size1 + size2 < 1)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        auto& slot = events[(size_t) (size1 > 0 ? start1 : start2)];
+        slot.arrivalSeconds = arrivalSeconds;
+        slot.size = (juce::uint8) size;
+        std::memcpy(slot.data, msg.getRawData(), (size_t) size);
+        fifo.finishedWrite(1);
+        return true;
+    }
+
+    /** @brief Consumer side: calls fn(const QueuedMidiEvent&) for every queued event, oldest first */
+    template <typename Fn>
+    int drain(Fn&& fn)
+    {
+        const auto scope = fifo.read(fifo.getNumReady());
+        scope.forEach([&](int index) { fn(events[(size_t) index]); });
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    /** @brief Consumer side: discards everything queued */
+    void clear() { drain([](const QueuedMidiEvent&) {}); }
+
+    int getNumReady() const { return fifo.getNumReady(); }
+
+    /** @brief Number of events dropped because the queue was full (for monitoring) */
+    int getNumDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<QueuedMidiEvent, (size_t) capacity> events;
+    juce::SpinLock producerSpin;
+    std::atomic<int> dropped { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(MidiEventQueue)
+};
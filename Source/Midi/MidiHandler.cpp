@@ -746,6 +746,8 @@ const juce::String& MidiDevice::get_identifier() const
 
 MidiHandler::MidiHandler(MidiDevice& device, InstrumentHandler* instrumentH) : midiDevice{ device }, instrumentHandler{instrumentH}
 {
+	for (auto& queue : midiQueues)
+		queue = std::make_unique<MidiEventQueue>();
 }
 
 MidiHandler::~MidiHandler()
@@ -836,18 +838,71 @@ void MidiHandler::handleIncomingMidiMessage(juce::MidiInput* source, const juce:
 		listeners.call(&MidiHandlerListener::handleIncomingMessage, juce::MidiMessage::noteOff(channel, note, velocityByte));
 	}
 
-	incomingMidiMessages.addEvent(processedMessage, 0);
+	// juce::MidiInput stamps messages on the same hi-res clock as nowSeconds(); hand-built messages
+	// (tests, tools) carry no stamp, so fall back to "now".
+	const double arrival = message.getTimeStamp() > 0.0 ? message.getTimeStamp() : nowSeconds();
+	enqueueTimestamped(processedMessage, arrival, MidiSource::HardwareInput);
 }
 
 void MidiHandler::getNextMidiBlock(juce::MidiBuffer& destBuffer, int startSample, int numSamples) {
 	//DBG("getNextMidiBlock called");
-	const juce::ScopedLock lock(midiMutex);
-	destBuffer.addEvents(incomingMidiMessages, startSample, numSamples, 0);
-	incomingMidiMessages.clear();
+	getNextMidiBlockAt(destBuffer, startSample, numSamples, nowSeconds());
 	//DBG("getNextMidiBlock: " << destBuffer.getNumEvents());
 
 }
 
+void MidiHandler::getNextMidiBlockAt(juce::MidiBuffer& destBuffer, int startSample, int numSamples, double blockTimeSeconds)
+{
+	// Audio thread: no locks, no allocation (destBuffer is pre-sized by the caller).
+	// Positions are offsets from the previous block's start, i.e. this block's time line shifted by one
+	// block. Anything later than the block (a late callback) is squeezed onto its last sample. Before
+	// the first block, or without a sample rate, there's no time line yet: sample 0, as before.
+	const double sampleRate = midiSampleRate.load(std::memory_order_relaxed);
+	const double blockStart = lastBlockSeconds;
+	const int lastSample = juce::jmax(0, numSamples - 1);
+
+	for (auto& queue : midiQueues)
+	{
+		queue->drain([&](const QueuedMidiEvent& e)
+		{
+			int samplePosition = 0;
+			if (sampleRate > 0.0 && blockStart > 0.0)
+				samplePosition = juce::jlimit(0, lastSample, juce::roundToInt((e.arrivalSeconds - blockStart) * sampleRate));
+
+			destBuffer.addEvent(e.data, (int) e.size, startSample + samplePosition);
+		});
+	}
+
+	lastBlockSeconds = blockTimeSeconds;
+}
+
+void MidiHandler::prepareToPlay(double sampleRate)
+{
+	// Called from audioDeviceAboutToStart, while no audio callback is running.
+	midiSampleRate.store(sampleRate);
+	lastBlockSeconds = 0.0;
+	for (auto& queue : midiQueues)
+		queue->clear();
+}
+
+int MidiHandler::getNumDroppedMidiEvents() const
+{
+	int total = 0;
+	for (const auto& queue : midiQueues)
+		total += queue->getNumDropped();
+	return total;
+}
+
+double MidiHandler::nowSeconds()
+{
+	return juce::Time::getMillisecondCounterHiRes() * 0.001;
+}
+
+void MidiHandler::enqueueTimestamped(const juce::MidiMessage& msg, double arrivalSeconds, MidiSource source)
+{
+	midiQueues[(size_t) source]->push(msg, arrivalSeconds);
+}
+
 void MidiHandler::noteOnKeyboard(int note, juce::uint8 velocity) {
 	int ok = 0;
 	const int channel = channelForHand(note);
@@ -890,8 +945,7 @@ void MidiHandler::noteOnKeyboard(int note, juce::uint8 velocity) {
 		{
 			listeners.call(&MidiHandlerListener::handleIncomingMessage, juce::MidiMessage::noteOn(channel, note, velocity));
 
-			const juce::ScopedLock lock(midiMutex);
-			incomingMidiMessages.addEvent(juce::MidiMessage::noteOn(channel, transposedNote, velocity), 0);
+			enqueueTimestamped(juce::MidiMessage::noteOn(channel, transposedNote, velocity), nowSeconds(), MidiSource::Keyboard);
 		}
 	}
 }
@@ -911,8 +965,7 @@ void MidiHandler::noteOffKeyboard(int note, juce::uint8 velocity) {
 	listeners.call(&MidiHandlerListener::noteOffReceived,note);
 	listeners.call(&MidiHandlerListener::handleIncomingMessage, juce::MidiMessage::noteOff(channel, note));
 
-	const juce::ScopedLock lock(midiMutex);
-	incomingMidiMessages.addEvent(juce::MidiMessage::noteOff(channel, transposedNote, velocity), 0);
+	enqueueTimestamped(juce::MidiMessage::noteOff(channel, transposedNote, velocity), nowSeconds(), MidiSource::Keyboard);
 } 
 
 void MidiHandler::allOffKeyboard()
@@ -1058,10 +1111,14 @@ void MidiHandler::applyInstrumentPreset(int programNumber, std::vector<std::pair
 	}
 }
 
-void MidiHandler::injectMidiMessage(const juce::MidiMessage& msg)
+void MidiHandler::injectMidiMessage(const juce::MidiMessage& msg, MidiSource source)
 {
-	const juce::ScopedLock lock(midiMutex);
-	incomingMidiMessages.addEvent(msg, 0);
+	injectMidiMessageAt(msg, nowSeconds(), source);
+}
+
+void MidiHandler::injectMidiMessageAt(const juce::MidiMessage& msg, double arrivalSeconds, MidiSource source)
+{
+	enqueueTimestamped(msg, arrivalSeconds, source);
 }
 
 void MidiHandler::injectCC(int channel, int ccNumber, int value)
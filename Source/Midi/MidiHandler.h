@@ -8,6 +8,7 @@
 #include "InstrumentHandler.h"
 #include "DisplayListener.h"
 #include "Arranger/ChordDetector.h"
+#include "MidiEventQueue.h"
 #include <atomic>
 #include <functional>
 
@@ -380,6 +381,21 @@ public:
 	 */
 	void getNextMidiBlock(juce::MidiBuffer& destBuffer, int startSample, int numSamples);
 
+	/**
+	 * @brief Same as getNextMidiBlock, but with the block's start time given explicitly (test seam)
+	 * @param blockTimeSeconds Time of this audio callback, on the nowSeconds() clock
+	 */
+	void getNextMidiBlockAt(juce::MidiBuffer& destBuffer, int startSample, int numSamples, double blockTimeSeconds);
+
+	/**
+	 * @brief Sets the sample rate used to turn MIDI arrival times into sample offsets
+	 * @param sampleRate The audio device's sample rate. Call from audioDeviceAboutToStart.
+	 */
+	void prepareToPlay(double sampleRate);
+
+	/** @brief The clock MIDI arrival times are measured on (seconds, same base as juce::MidiInput timestamps) */
+	static double nowSeconds();
+
 	/**
 	 * @brief Sends a note-on message as if triggered from a keyboard
 	 * @param note MIDI note number
@@ -397,9 +413,20 @@ public:
 	/** @brief Turns off all currently active notes from the keyboard */
 	void allOffKeyboard();
 
-	void injectMidiMessage(const juce::MidiMessage& msg);
+	/**
+	 * @brief Queues a message for the SFZ audio engine
+	 * @param msg The message to render
+	 * @param source The producer thread it comes from; each source has its own lock-free queue, so a
+	 *        given source must only be fed from one thread at a time
+	 */
+	void injectMidiMessage(const juce::MidiMessage& msg, MidiSource source = MidiSource::Keyboard);
+	/** Test seam: inject a message as if it arrived at `arrivalSeconds` on the nowSeconds() clock. */
+	void injectMidiMessageAt(const juce::MidiMessage& msg, double arrivalSeconds, MidiSource source = MidiSource::Keyboard);
 	void injectCC(int channel, int ccNumber, int value);
 
+	/** @brief Total events dropped because a producer's queue was full (for monitoring) */
+	int getNumDroppedMidiEvents() const;
+
 	/**
 	 * @brief Sets the instrument program (patch) number
 	 * @param toSetNumber Program number to set
@@ -495,8 +522,20 @@ private:
 	InstrumentHandler* instrumentHandler=nullptr;
 
 	bool receivedValidNote = false;
-	juce::MidiBuffer incomingMidiMessages;
+	// Serializes the MIDI input callback (chord detection, listener fan-out). The audio thread never
+	// takes it: events reach the audio callback through the per-source queues below.
 	juce::CriticalSection midiMutex;
+
+	// One lock-free SPSC queue per producer thread, drained by the audio thread in getNextMidiBlock.
+	// Heap-allocated: together they hold several hundred KB of pre-sized events.
+	std::array<std::unique_ptr<MidiEventQueue>, (size_t) MidiSource::NumSources> midiQueues;
+
+	// Sample-accurate timing (like juce::MidiMessageCollector): each message carries its arrival time
+	// and is placed at its offset from the previous audio block, one block later. That trades one block
+	// of constant latency for no jitter -- a chord played inside one block no longer lands as a flam.
+	std::atomic<double> midiSampleRate { 0.0 };   // 0 until prepareToPlay (events then land on sample 0)
+	double lastBlockSeconds = 0.0;                // audio thread only; 0 before the first block
+	void enqueueTimestamped(const juce::MidiMessage& msg, double arrivalSeconds, MidiSource source);
 	int programNumberLeftHand = 0;
 	int programNumberRightHand = 0;
 	int startNoteSetting=-1;
@@ -100,7 +100,8 @@ void CurrentStyleComponent::seedHeldChordIntoArranger()
 }
 
 CurrentStyleComponent::CurrentStyleComponent(const juce::String& name, std::unordered_map<juce::Uuid, TrackEntry*>& map, std::weak_ptr<juce::MidiOutput> outputDevice,
-    std::weak_ptr<std::unordered_map<juce::String, std::unordered_map<juce::String,StyleSection>>> styleSMap) : name(name), mapUuidToTrackEntry(map), outputDevice(outputDevice), styleSectionsMap{styleSMap}
+    std::weak_ptr<std::unordered_map<juce::String, std::unordered_map<juce::String,StyleSection>>> styleSMap, ArrangerStyleIndex& index)
+    : name(name), mapUuidToTrackEntry(map), outputDevice(outputDevice), styleSectionsMap{styleSMap}, styleIndex(index), arrangerStyleList(index)
 {
     addMouseListener(this, true);
     nameOfStyle.setText(name, juce::dontSendNotification);
@@ -162,6 +163,8 @@ CurrentStyleComponent::CurrentStyleComponent(const juce::String& name, std::unor
     arrangerStyleList.onDeleteStyle = [this] (const juce::File& f)
     {
         // If the deleted file was this style's active configuration, clear + persist that.
+        if (restoringArrangerConfigName == f.getFileNameWithoutExtension())
+            restoringArrangerConfigName = {};
         if (hasActiveArrangerConfig && activeArrangerConfigName == f.getFileNameWithoutExtension())
         {
             hasActiveArrangerConfig  = false;
@@ -488,6 +491,7 @@ void CurrentStyleComponent::configureEditorCallbacks()
     // Refresh the active config from the style the editor already built (no file re-parse -> no freeze).
     arrangerStyleEditor->onSaved = [this] (const juce::File& f, const ArrangerStyle& s)
     {
+        styleIndex.fileChanged(f);
         arrangerStyleList.refresh();
         applyActiveConfig(f, s);
     };
@@ -495,9 +499,10 @@ void CurrentStyleComponent::configureEditorCallbacks()
 
 void CurrentStyleComponent::applyActiveConfig(const juce::File& f, const ArrangerStyle& s)
 {
-    activeArrangerConfig     = s;          // this configuration is now what Start + section buttons use
-    hasActiveArrangerConfig  = true;
-    activeArrangerConfigName = f.getFileNameWithoutExtension();
+    activeArrangerConfig        = s;          // this configuration is now what Start + section buttons use
+    hasActiveArrangerConfig     = true;
+    activeArrangerConfigName    = f.getFileNameWithoutExtension();
+    restoringArrangerConfigName = {};         // a restore still reading in the background loses to this
     rebuildPlaySettingsItems();
     arrangerStyleList.setActiveConfigName(activeArrangerConfigName);
     if (anyTrackChanged) anyTrackChanged();   // persist the selection to allStyles.json
@@ -541,19 +546,6 @@ void CurrentStyleComponent::openStyleEditorFromFile(const juce::File& f)
     });
 }
 
-bool CurrentStyleComponent::buildConfigFromFile(const juce::File& f, ArrangerStyle& out, bool showError)
-{
-    ArrangerStyleFile sf; juce::String err;
-    if (! ArrangerStyleIOHelper::loadFromFile(f, sf, err))
-    {
-        if (showError)
-            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Section configuration", err);
-        return false;
-    }
-    out = ArrangerPatternBuilder::buildStyleFromFile(sf);
-    return true;
-}
-
 void CurrentStyleComponent::loadStyleFileIntoEngine(const juce::File& f)
 {
     // Parse the (large) file off the message thread (the hex-decode of every event is what froze the
@@ -587,6 +579,37 @@ void CurrentStyleComponent::loadStyleFileIntoEngine(const juce::File& f)
     });
 }
 
+void CurrentStyleComponent::restoreActiveConfigAsync(const juce::File& f, const juce::String& cfgName)
+{
+    // Silent, and without the busy overlay: the style is usable on its live tracks meanwhile. The
+    // result is dropped if another choice (Load, Save, live tracks, another tab) won in between.
+    restoringArrangerConfigName = cfgName;
+    juce::Component::SafePointer<CurrentStyleComponent> safe(this);
+
+    juce::Thread::launch([safe, f, cfgName]
+    {
+        auto sf = std::make_shared<ArrangerStyleFile>();
+        juce::String err;
+        const bool ok = ArrangerStyleIOHelper::loadFromFile(f, *sf, err);
+
+        juce::MessageManager::callAsync([safe, sf, ok, cfgName]
+        {
+            if (safe == nullptr || safe->restoringArrangerConfigName != cfgName)
+                return;
+            safe->restoringArrangerConfigName = {};
+            if (! ok)
+                return;
+
+            ArrangerStyle s = ArrangerPatternBuilder::buildStyleFromFile(*sf);
+            safe->activeArrangerConfig     = s;
+            safe->hasActiveArrangerConfig  = true;
+            safe->activeArrangerConfigName = cfgName;
+            safe->arrangerStyleList.setActiveConfigName(cfgName);
+            if (safe->arrangerEngine) { safe->arrangerEngine->setStyle(s); safe->arrangerEngine->setBpm(safe->currentTempo); }
+        });
+    });
+}
+
 void CurrentStyleComponent::closeStyleEditor()
 {
     if (arrangerEngine)
@@ -619,12 +642,35 @@ void CurrentStyleComponent::setDeviceOutputCurrentStyle(std::weak_ptr<juce::Midi
         arrangerEngine->setDeviceOutput(newOutput);
 }
 
-void CurrentStyleComponent::setMidiInjectCallback(std::function<void(const juce::MidiMessage&)> cb)
+void CurrentStyleComponent::setMidiInjectCallback(std::function<void(const juce::MidiMessage&, MidiSource)> cb)
 {
+    // The player and the arranger run on different threads, so each is tagged as its own source
+    // (its own lock-free queue into the audio thread).
     if (trackPlayer)
-        trackPlayer->onMidiMessage = cb;
+    {
+        if (cb) trackPlayer->onMidiMessage = [cb](const juce::MidiMessage& m) { cb(m, MidiSource::TrackPlayer); };
+        else    trackPlayer->onMidiMessage = nullptr;
+    }
+    if (arrangerEngine)
+    {
+        if (cb) arrangerEngine->onMidiMessage = [cb](const juce::MidiMessage& m) { cb(m, MidiSource::Arranger); };
+        else    arrangerEngine->onMidiMessage = nullptr;
+    }
+}
+
+void CurrentStyleComponent::setAudioClockAttach(std::function<void(AudioClockMidiSource*)> attach)
+{
+    // Detach from the previous audio callback first, so the engine is never rendered by two clocks.
+    if (audioClockAttach)
+        audioClockAttach(nullptr);
+    audioClockAttach = std::move(attach);
+
     if (arrangerEngine)
-        arrangerEngine->onMidiMessage = cb;
+    {
+        arrangerEngine->setAudioClockDriven(audioClockAttach != nullptr);
+        if (audioClockAttach)
+            audioClockAttach(arrangerEngine.get());
+    }
 }
 
 void CurrentStyleComponent::applyChangesForOneTrack(TrackEntry& track)
@@ -977,6 +1023,7 @@ void CurrentStyleComponent::comboBoxChanged(juce::ComboBox* comboBoxThatHasChang
     if (id == 1 || id == 2)            // live-track play mode -> also means "play from live tracks"
     {
         lastPlayModeId = id;
+        restoringArrangerConfigName = {};
         if (hasActiveArrangerConfig)   // choosing live tracks clears the active configuration
         {
             hasActiveArrangerConfig  = false;
@@ -1202,6 +1249,8 @@ void CurrentStyleComponent::updateObjects()
 CurrentStyleComponent::~CurrentStyleComponent()
 {
     // Tear down the authoring editor before the engine: it holds a callback into the engine.
+    if (audioClockAttach)
+        audioClockAttach(nullptr);   // the audio callback must stop rendering the engine before it goes
     if (arrangerEngine)
         arrangerEngine->stop();
     arrangerStyleEditor.reset();
@@ -1257,6 +1306,8 @@ juce::DynamicObject* CurrentStyleComponent::getJson() const
 
     if (hasActiveArrangerConfig && activeArrangerConfigName.isNotEmpty())
         styleObj->setProperty("arrangerConfig", activeArrangerConfigName);   // remembered selection
+    else if (restoringArrangerConfigName.isNotEmpty())
+        styleObj->setProperty("arrangerConfig", restoringArrangerConfigName); // still being read in
 
     juce::Array<juce::var> tracksArray;
 
@@ -1290,22 +1341,24 @@ void CurrentStyleComponent::loadJson(const juce::var& styleVar)
         // Configuration selection is strictly per-style. This component is reused across
         // style tabs, so drop any config carried over from the previously-shown style
         // before restoring this style's own (if it has one).
-        hasActiveArrangerConfig  = false;
-        activeArrangerConfig     = {};
-        activeArrangerConfigName = {};
+        hasActiveArrangerConfig     = false;
+        activeArrangerConfig        = {};
+        activeArrangerConfigName    = {};
+        restoringArrangerConfigName = {};
 
         const auto cfgName = obj->getProperty("arrangerConfig").toString();
         if (cfgName.isNotEmpty())
         {
             auto file = IOHelper::getArrangerStylesFolder().getChildFile(cfgName + ".style");
-            ArrangerStyle s;
-            if (buildConfigFromFile(file, s, false))
-            {
-                activeArrangerConfig     = s;
-                hasActiveArrangerConfig  = true;
-                activeArrangerConfigName = cfgName;
-                if (arrangerEngine) { arrangerEngine->setStyle(s); arrangerEngine->setBpm(currentTempo); }
-            }
+            // Ask the index whether the config is worth reading: a file it lists as unreadable (and
+            // that hasn't changed since) is skipped without being opened. The events themselves are
+            // parsed off the message thread, so switching style tabs never waits on a large file.
+            ArrangerStyleSummary summary;
+            const bool indexed = styleIndex.getSummary(file.getFileName(), summary)
+                                 && summary.modificationTime == file.getLastModificationTime().toMilliseconds()
+                                 && summary.fileSize == file.getSize();
+            if (indexed ? summary.readable : file.existsAsFile())
+                restoreActiveConfigAsync(file, cfgName);
         }
 
         rebuildPlaySettingsItems();
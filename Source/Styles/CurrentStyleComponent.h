@@ -8,6 +8,7 @@
 #include "TrackPlayerListener.h"
 #include "StyleSection.h"
 #include "CustomBeatBar.h"
+#include "MidiEventQueue.h"
 
 /**
  * @class CurrentStyleComponent
@@ -82,11 +83,13 @@ public:
      * @param name Name of the style.
      * @param map Reference to the UUID-to-TrackEntry map used for synchronization.
      * @param outputDevice Weak pointer to the MIDI output device used for playback.
+     * @param styleIndex The shared index of the arranger styles folder; must outlive this component.
      */
     CurrentStyleComponent(const juce::String& name,
                           std::unordered_map<juce::Uuid, TrackEntry*>& map,
                           std::weak_ptr<juce::MidiOutput> outputDevice,
-                          std::weak_ptr<std::unordered_map<juce::String, std::unordered_map<juce::String,StyleSection>>> styleSectionsMap);
+                          std::weak_ptr<std::unordered_map<juce::String, std::unordered_map<juce::String,StyleSection>>> styleSectionsMap,
+                          ArrangerStyleIndex& styleIndex);
 
     /** @brief Destructor. Cleans up listeners and internal references. */
     ~CurrentStyleComponent() override;
@@ -227,7 +230,12 @@ public:
     /** Enable/disable Auto Fill on variation switches (forwarded to the arranger engine). */
     void setArrangerAutoFillEnabled(bool enabled);
 
-    void setMidiInjectCallback(std::function<void(const juce::MidiMessage&)> cb);
+    void setMidiInjectCallback(std::function<void(const juce::MidiMessage&, MidiSource)> cb);
+
+    /** Hands the arranger engine to the audio callback so it renders on the audio clock (the SFZ
+        path). `attach` is called with the engine now and with nullptr on detach/destruction; pass
+        nullptr to return the engine to its own timer (external MIDI only). */
+    void setAudioClockAttach(std::function<void(AudioClockMidiSource*)> attach);
 
     struct TrackChannelInstrument { int channel; int instrument; };
     std::vector<TrackChannelInstrument> getTrackChannelInstruments() const;
@@ -297,25 +305,25 @@ private:
     std::unique_ptr<MultipleTrackPlayer> trackPlayer = nullptr; ///< Handles multi-track playback.
     std::unique_ptr<ArrangerEngine> arrangerEngine = nullptr;   ///< Arranger-mode looping engine (parallel to trackPlayer).
     bool arrangerModeEnabled = false;                           ///< When true, play/stop route to arrangerEngine.
+    std::function<void(AudioClockMidiSource*)> audioClockAttach; ///< Attaches arrangerEngine to the audio callback.
     bool arrangerBassInversion = false;                         ///< Remembered Bass Inversion; re-applied on each Start.
     bool synchroStartEnabled = false;                           ///< Remembered Synchro Start; re-applied on each Start.
     bool countInEnabled = false;                                ///< Remembered Count-In; re-applied on each Start.
 
     // --- Phase 3: self-contained style authoring (opened from the play-settings dropdown) ---
+    ArrangerStyleIndex&        styleIndex;                       ///< Shared metadata index of the *.style files (owned by MainComponent).
     ArrangerStyleListComponent arrangerStyleList;                ///< Full-bounds browser of saved *.style files.
     std::unique_ptr<ArrangerStyleEditor> arrangerStyleEditor;    ///< Full-bounds authoring overlay (lazy).
 
     bool          hasActiveArrangerConfig = false;              ///< When set, Start + section buttons use activeArrangerConfig.
     ArrangerStyle activeArrangerConfig;                         ///< The loaded/saved configuration in effect (vs. a demo from live tracks).
     juce::String  activeArrangerConfigName;                     ///< File name (no ext) of the active config; persisted so the style reopens with it selected.
+    juce::String  restoringArrangerConfigName;                  ///< Config loadJson is still reading in the background; cleared when it lands or another choice wins.
     int           lastPlayModeId = 1;                           ///< Live-track play mode: 1 = all tracks, 2 = solo. Survives menu-action picks.
 
     ArrangerSectionType pendingStartType = ArrangerSectionType::Variation;  ///< Section Start begins on (chosen pre-play).
     juce::String        pendingStartName = "Variation 1";                   ///< ...defaults to Variation 1, highlighted while stopped.
 
-    /** Load a .style file and build a runtime style; returns false on failure (showing an error
-        unless showError is false, e.g. silent restore during loadJson). */
-    bool buildConfigFromFile (const juce::File& f, ArrangerStyle& out, bool showError = true);
     /** Rebuild the play-settings dropdown (adds the active-config row when present) and tick the active entry. */
     void rebuildPlaySettingsItems();
 
@@ -329,6 +337,8 @@ private:
     void openStyleEditorNew();
     void openStyleEditorFromFile (const juce::File& f);
     void loadStyleFileIntoEngine (const juce::File& f);
+    /** Read the config loadJson remembered off the message thread and make it active when it lands. */
+    void restoreActiveConfigAsync (const juce::File& f, const juce::String& cfgName);
     /** Wire the standard editor callbacks (close / current-tracks / saved) onto arrangerStyleEditor. */
     void configureEditorCallbacks();
     /** Make a loaded/built style the active arranger configuration and refresh the UI selection. */
@@ -1,6 +1,6 @@
 #include "displayGUI.h"
 
-Display::Display(std::weak_ptr<juce::MidiOutput> outputDev, juce::PropertiesFile* props, int widthForList) : outputDevice{outputDev}, propertiesFile{props}
+Display::Display(std::weak_ptr<juce::MidiOutput> outputDev, juce::PropertiesFile* props, ArrangerStyleIndex& index, int widthForList) : outputDevice{outputDev}, propertiesFile{props}, styleIndex{index}
 {
     availableTracksFromFolder = std::make_shared<std::deque<TrackEntry>>();
     groupedTracks = std::make_shared<std::unordered_map<juce::String, std::deque<TrackEntry>>>();
@@ -184,7 +184,7 @@ void Display::showCurrentStyleTab(const juce::String& name)
     {
         std::weak_ptr<std::unordered_map<juce::String, std::unordered_map<juce::String,StyleSection>>> weakSectionsMap = sectionsPerStyleMap;
 
-        currentStyleComponent = std::make_unique<CurrentStyleComponent>(name, mapUuidToTrack, outputDevice,weakSectionsMap);
+        currentStyleComponent = std::make_unique<CurrentStyleComponent>(name, mapUuidToTrack, outputDevice,weakSectionsMap, styleIndex);
         currentStyleComponent->onRequestTrackSelectionFromTrack = [this](std::function<void(const juce::String&, const juce::Uuid& uuid, const juce::String& type)> trackChosenCallback)
         {
             showListOfTracksToSelectFrom(trackChosenCallback);
@@ -240,6 +240,8 @@ void Display::showCurrentStyleTab(const juce::String& name)
 
         if (pendingMidiInjectCallback)
             currentStyleComponent->setMidiInjectCallback(pendingMidiInjectCallback);
+        if (pendingAudioClockAttach)
+            currentStyleComponent->setAudioClockAttach(pendingAudioClockAttach);
 
         currentStyleComponent->setArrangerModeEnabled(arrangerModeEnabled);
         currentStyleComponent->setArrangerAutoFillEnabled(arrangerAutoFillEnabled);
@@ -426,13 +428,20 @@ void Display::setDeviceOutput(std::weak_ptr<juce::MidiOutput> devOutput)
         currentStyleComponent->setDeviceOutputCurrentStyle(devOutput);
 }
 
-void Display::setMidiInjectCallback(std::function<void(const juce::MidiMessage&)> cb)
+void Display::setMidiInjectCallback(std::function<void(const juce::MidiMessage&, MidiSource)> cb)
 {
     pendingMidiInjectCallback = cb;
     if (currentStyleComponent)
         currentStyleComponent->setMidiInjectCallback(std::move(cb));
 }
 
+void Display::setAudioClockAttach(std::function<void(AudioClockMidiSource*)> attach)
+{
+    pendingAudioClockAttach = attach;
+    if (currentStyleComponent)
+        currentStyleComponent->setAudioClockAttach(std::move(attach));
+}
+
 void Display::setArrangerModeEnabled(bool shouldEnable)
 {
     arrangerModeEnabled = shouldEnable;
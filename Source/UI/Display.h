@@ -34,8 +34,9 @@ public:
      * @param outputDev Pointer to the MIDI output device.
      * @param props Pointer to the application properties file.
      * @param widthForList Width of the style list component.
+     * @param styleIndex Shared index of the arranger styles folder, passed on to the style tab.
      */
-    Display(std::weak_ptr<juce::MidiOutput> outputDev, juce::PropertiesFile* props, int widthForList = 0);
+    Display(std::weak_ptr<juce::MidiOutput> outputDev, juce::PropertiesFile* props, ArrangerStyleIndex& styleIndex, int widthForList = 0);
 
     /** @brief Destructor */
     ~Display() override;
@@ -98,7 +99,10 @@ public:
     /** @brief Sets the MIDI output device */
     void setDeviceOutput(std::weak_ptr<juce::MidiOutput> devOutput);
 
-    void setMidiInjectCallback(std::function<void(const juce::MidiMessage&)> cb);
+    void setMidiInjectCallback(std::function<void(const juce::MidiMessage&, MidiSource)> cb);
+
+    /** Lets the style's arranger render on the audio clock (see CurrentStyleComponent::setAudioClockAttach). */
+    void setAudioClockAttach(std::function<void(AudioClockMidiSource*)> attach);
 
     /** Enable/disable Arranger mode on the active style component (remembered across re-creation). */
     void setArrangerModeEnabled(bool shouldEnable);
@@ -234,7 +238,9 @@ private:
 
     std::weak_ptr<juce::MidiOutput> outputDevice; ///< MIDI output device
     juce::PropertiesFile* propertiesFile = nullptr; ///< Application properties file
-    std::function<void(const juce::MidiMessage&)> pendingMidiInjectCallback;
+    ArrangerStyleIndex& styleIndex; ///< Shared arranger style index (owned by MainComponent)
+    std::function<void(const juce::MidiMessage&, MidiSource)> pendingMidiInjectCallback;
+    std::function<void(AudioClockMidiSource*)> pendingAudioClockAttach;
     bool arrangerModeEnabled = false;   ///< Remembered Arranger-mode state, applied when a style component is created.
     bool arrangerAutoFillEnabled = false;   ///< Remembered Auto Fill state, applied when a style component is created.
     bool arrangerBassInversion = false;     ///< Remembered Bass Inversion, applied when a style component is created.
@@ -106,6 +106,10 @@ MainComponent::MainComponent()
 
 MainComponent::~MainComponent()
 {
+    // audioHandler is destroyed before display: take the arranger off the audio clock first.
+    if (display != nullptr)
+        display->setAudioClockAttach(nullptr);
+
     sfzManager.save(IOHelper::getFile("SFZLibrary.json"));
 
     if (this->MIDIDevice.isOpenIN())
@@ -980,6 +984,16 @@ void MainComponent::setCallBacksForOverlayWindow()
                 return {};
             };
 
+            midiWindow->getSfzMemoryBytes = [this](const juce::File& sfzFile) -> juce::int64
+            {
+                return audioHandler ? audioHandler->getSfzMemoryBytes(sfzFile) : 0;
+            };
+
+            midiWindow->getAudioLoadMeter = [this]() -> AudioLoadMeter*
+            {
+                return audioHandler ? &audioHandler->getLoadMeter() : nullptr;
+            };
+
             midiWindow->onSfzLibraryChanged = [this]()
             {
                 if (audioHandler == nullptr || !MIDIDevice.isOpenAudioOUT())
@@ -1043,6 +1057,7 @@ void MainComponent::setCallBacksForOverlayWindow()
                         // (now closed) SFZ sampler. Mirrors the Play-button wiring path; without this,
                         // switching engine mid-session leaves the players with a stale output -> silence.
                         display->setMidiInjectCallback(nullptr);
+                        display->setAudioClockAttach(nullptr);
                         display->setDeviceOutput(MIDIDevice.getDeviceOUT());
                     }
                 }
@@ -1490,9 +1505,9 @@ void MainComponent::recordButtonsInit()
         int sfzCh = (ch == 14) ? 1 : (ch == 15 ? 16 : ch);
 
         if (msg.isNoteOn())
-            midiHandler.injectMidiMessage(juce::MidiMessage::noteOn(sfzCh, msg.getNoteNumber(), msg.getVelocity()));
+            midiHandler.injectMidiMessage(juce::MidiMessage::noteOn(sfzCh, msg.getNoteNumber(), msg.getVelocity()), MidiSource::RecordPlayer);
         else if (msg.isNoteOff())
-            midiHandler.injectMidiMessage(juce::MidiMessage::noteOff(sfzCh, msg.getNoteNumber()));
+            midiHandler.injectMidiMessage(juce::MidiMessage::noteOff(sfzCh, msg.getNoteNumber()), MidiSource::RecordPlayer);
     };
 
     recordPlayer.notifyFunction = [&]()
@@ -1596,7 +1611,7 @@ void MainComponent::knobsInit()
 
 void MainComponent::displayInit()
 {
-    display = std::make_unique<Display>(deviceOpenedOUT, propertiesFile, 400);
+    display = std::make_unique<Display>(deviceOpenedOUT, propertiesFile, styleIndex, 400);
     headerPanel.addAndMakeVisible(display.get());
     display->setVisible(false);
 
@@ -2082,8 +2097,12 @@ void MainComponent::playButtonOnClick()
 
         if (audioHandler != nullptr && display != nullptr)
         {
-            display->setMidiInjectCallback([this](const juce::MidiMessage& msg) {
-                midiHandler.injectMidiMessage(msg);
+            display->setMidiInjectCallback([this](const juce::MidiMessage& msg, MidiSource source) {
+                midiHandler.injectMidiMessage(msg, source);
+            });
+            display->setAudioClockAttach([this](AudioClockMidiSource* source) {
+                if (audioHandler != nullptr)
+                    audioHandler->setAudioClockSource(source);
             });
         }
 
@@ -2402,7 +2421,7 @@ InstrumentTreeItem* MainComponent::createInstrumentItem(const juce::Image& img,
             if (audioHandler != nullptr)
             {
                 auto sfzFile = sfzManager.getSfzForStyleInstrument(styleId, programNumber);
-                audioHandler->loadSfz(sfzFile, 1);
+                audioHandler->loadSfz(sfzFile, 1, sfzManager.getLoadOptionsForStyleInstrument(styleId, programNumber));
             }
         }
 
@@ -2417,7 +2436,7 @@ InstrumentTreeItem* MainComponent::createInstrumentItem(const juce::Image& img,
             if (audioHandler != nullptr)
             {
                 auto sfzFile = sfzManager.getSfzForStyleInstrument(styleId, programNumber);
-                audioHandler->loadSfz(sfzFile, 16);
+                audioHandler->loadSfz(sfzFile, 16, sfzManager.getLoadOptionsForStyleInstrument(styleId, programNumber));
             }
         }
 
@@ -2444,6 +2463,18 @@ void MainComponent::ensureAudioHandlerReady()
     if (audioHandler == nullptr)
     {
         audioHandler = std::make_unique<AudioHandler>(midiHandler);
+        // Optional: render the SFZ channels on extra threads (0 = all on the audio thread), and the
+        // polyphony budget.
+        if (propertiesFile != nullptr)
+        {
+            audioHandler->setNumRenderWorkers(propertiesFile->getIntValue("AudioRenderWorkers", 0));
+            audioHandler->setVoiceBudget(propertiesFile->getIntValue("VoicesPerChannel", AudioHandler::defaultVoicesPerChannel),
+                                         propertiesFile->getIntValue("MaxVoices", AudioHandler::defaultMaxVoices));
+        }
+        // Decoded samples kept between runs, so the next start maps them instead of decoding.
+        const int sampleDiskCacheMB = propertiesFile != nullptr ? propertiesFile->getIntValue("SampleDiskCacheMB", 2048) : 2048;
+        if (sampleDiskCacheMB > 0)
+            audioHandler->setSampleDiskCache(IOHelper::getFile("SampleCache"), (juce::int64) sampleDiskCacheMB * 1024 * 1024);
         audioHandler->onSfzLoadStart = [this]() {
             setLoadingOverlayVisible(true, "Preparing style...");
         };
@@ -2469,9 +2500,16 @@ void MainComponent::ensureAudioHandlerReady()
         };
     }
     if (display != nullptr)
-        display->setMidiInjectCallback([this](const juce::MidiMessage& msg) {
-            midiHandler.injectMidiMessage(msg);
+    {
+        display->setMidiInjectCallback([this](const juce::MidiMessage& msg, MidiSource source) {
+            midiHandler.injectMidiMessage(msg, source);
+        });
+        // The arranger renders inside the audio callback, so its notes hit the SFZ on their sample.
+        display->setAudioClockAttach([this](AudioClockMidiSource* source) {
+            if (audioHandler != nullptr)
+                audioHandler->setAudioClockSource(source);
         });
+    }
 
     MIDIDevice.getAudioDeviceManager().addAudioCallback(audioHandler.get());
 }
@@ -2483,10 +2521,15 @@ void MainComponent::loadSfzForCurrentStyle(const juce::String& overrideStyleId)
     const juce::String styleId = overrideStyleId.isNotEmpty() ? overrideStyleId : display->getStyleID();
     int leftProg  = propertiesFile ? propertiesFile->getIntValue(styleId + "_leftInstrumentNumber",  0) : 0;
     int rightProg = propertiesFile ? propertiesFile->getIntValue(styleId + "_rightInstrumentNumber", 0) : 0;
-    audioHandler->loadSfz(sfzManager.getSfzForStyleInstrument(styleId, leftProg),  1);
-    audioHandler->loadSfz(sfzManager.getSfzForStyleInstrument(styleId, rightProg), 16);
+    auto load = [&](int program, int channel)
+    {
+        audioHandler->loadSfz(sfzManager.getSfzForStyleInstrument(styleId, program), channel,
+                              sfzManager.getLoadOptionsForStyleInstrument(styleId, program));
+    };
+    load(leftProg,  1);
+    load(rightProg, 16);
     for (const auto& t : display->getTrackChannelInstruments())
-        audioHandler->loadSfz(sfzManager.getSfzForStyleInstrument(styleId, t.instrument), t.channel);
+        load(t.instrument, t.channel);
 }
 
 void MainComponent::applyCurrentStyleToOutput()
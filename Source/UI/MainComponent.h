@@ -32,6 +32,7 @@
 #include "styleSettingsEntry.h"
 #include "SFZLibraryUI.h"
 #include "AudioHandler.h"
+#include "ArrangerStyleIndex.h"
 #include "PlayScreenLookAndFeel.h"
 /**
  * @class SmoothRotarySlider
@@ -404,6 +405,7 @@ private:
     bool usingKeyboardInput = false;  ///< True if using keyboard input
     std::unique_ptr<TemporaryMessage> temporaryPopup;
     std::unique_ptr<juce::FileChooser> fileChooser;
+    ArrangerStyleIndex styleIndex { IOHelper::getArrangerStylesFolder() }; ///< The one index of the arranger styles folder; before display, which uses it
     std::unique_ptr<Display> display = nullptr;
     std::unique_ptr<AddDeviceWindow> addDeviceWindow=nullptr;
     std::unique_ptr<OverlayComponent> overlayWindow=nullptr;
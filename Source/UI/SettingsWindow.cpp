@@ -284,10 +284,14 @@ void MIDIWindow::toggleSFZbutton()
     if(this->sfzLibraryButton.isVisible())
     {
         this->sfzLibraryButton.setVisible(false);
+        this->audioLoadButton.setVisible(false);
+        if (audioLoadUI)
+            audioLoadUI->setVisible(false);
     }
     else
     {
         this->sfzLibraryButton.setVisible(true);
+        this->audioLoadButton.setVisible(true);
 	}
 }
 
@@ -329,9 +333,11 @@ void MIDIWindow::setBounds_components()
 
     const int buttonW = 140;
     const int buttonH = 34;
-    const int buttonX = (settingsPanel.getWidth() - buttonW) / 2;
+    const int buttonGap = 12;
+    const int buttonX = (settingsPanel.getWidth() - 2 * buttonW - buttonGap) / 2;
 
     sfzLibraryButton.setBounds(buttonX, y, buttonW, buttonH);
+    audioLoadButton.setBounds(buttonX + buttonW + buttonGap, y, buttonW, buttonH);
 
     y += buttonH + 14;
     arrangerModeToggle.setBounds(pad, y, 320, rowH);
@@ -444,6 +450,10 @@ void MIDIWindow::sfzButtonInit()
         {
             return getCurrentStyleName ? getCurrentStyleName() : juce::String("DEFAULT Style");
         };
+        sfzLibraryUI->getLoadedMemoryBytes = [this](const juce::File& sfzFile) -> juce::int64
+        {
+            return getSfzMemoryBytes ? getSfzMemoryBytes(sfzFile) : 0;
+        };
         sfzLibraryUI->onLibraryChanged = [this]()
         {
             sfzManager->save(IOHelper::getFile("SFZLibrary.json"));
@@ -465,6 +475,31 @@ void MIDIWindow::sfzButtonInit()
 	};
 }
 
+void MIDIWindow::audioLoadButtonInit()
+{
+    settingsPanel.addAndMakeVisible(audioLoadButton);
+    audioLoadButton.setVisible(false);
+    audioLoadButton.setMouseCursor(juce::MouseCursor::PointingHandCursor);
+    audioLoadButton.setTooltip("Audio callback load, per-channel timings and xruns");
+
+    audioLoadUI = std::make_unique<AudioLoadUI>();
+    settingsPanel.addChildComponent(audioLoadUI.get());
+    audioLoadUI->getMeter = [this]() -> AudioLoadMeter*
+    {
+        return getAudioLoadMeter ? getAudioLoadMeter() : nullptr;
+    };
+
+    audioLoadButton.onClick = [this]()
+    {
+        audioLoadUI->setVisible(!audioLoadUI->isVisible());
+        if (audioLoadUI->isVisible())
+        {
+            audioLoadUI->setBounds(settingsPanel.getLocalBounds().reduced(20));
+            audioLoadUI->toFront(true);
+        }
+    };
+}
+
 void MIDIWindow::allInit()
 {
     if (propertyFile != nullptr)
@@ -586,6 +621,7 @@ void MIDIWindow::allInit()
     };
 
 	sfzButtonInit();
+    audioLoadButtonInit();
 }
 
 void MIDIWindow::populateCBIN()
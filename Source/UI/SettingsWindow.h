@@ -12,6 +12,7 @@
 #include <JuceHeader.h>
 #include "MidiHandler.h"
 #include "SFZLibraryUI.h"
+#include "AudioLoadUI.h"
 
 /**
  * @class MIDIWindow
@@ -35,6 +36,8 @@ public:
     std::function<void()> onWindowClosed;
     std::function<juce::String()> getCurrentStyleId;  // optional, set by owner
     std::function<juce::String()> getCurrentStyleName; // optional, set by owner
+    std::function<juce::int64(const juce::File&)> getSfzMemoryBytes; // optional: sample memory of a loaded SFZ
+    std::function<AudioLoadMeter*()> getAudioLoadMeter;            // optional: nullptr while the SFZ engine isn't running
     std::function<void(int engineOption)> onOutputEngineChanged; // fired when engine changes while playing
     std::function<void(bool)> onArrangerModeChanged;             // fired when the Classic/Arranger toggle changes
     std::function<void(bool)> onChordBassInversionChanged;       // Phase 4: bass follows the lowest fingered note
@@ -115,6 +118,8 @@ private:
 
     void sfzButtonInit();
 
+    void audioLoadButtonInit();
+
     /** @brief Calls all initialization functions. */
     void allInit();
 
@@ -148,6 +153,8 @@ private:
 	juce::TextButton sfzLibraryButton{ "SFZ Library" };
     SFZLibraryManager* sfzManager = nullptr;
     std::unique_ptr<SFZLibraryUI> sfzLibraryUI;
+    juce::TextButton audioLoadButton{ "Audio Load" };
+    std::unique_ptr<AudioLoadUI> audioLoadUI;
 
     juce::ComboBox comboBoxDevicesIN;         /**< ComboBox for selecting MIDI input devices */
     juce::ComboBox comboBoxDevicesOUT;        /**< ComboBox for selecting MIDI output devices */
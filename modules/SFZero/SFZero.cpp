@@ -9,10 +9,13 @@
 #include "sfzero/SF2Reader.cpp" 
 #include "sfzero/SF2Sound.cpp" 
 #include "sfzero/SFZDebug.cpp" 
+#include "sfzero/SFZDiskSampleCache.cpp" 
 #include "sfzero/SFZEG.cpp" 
 #include "sfzero/SFZReader.cpp" 
 #include "sfzero/SFZRegion.cpp" 
 #include "sfzero/SFZSample.cpp" 
+#include "sfzero/SFZSampleCache.cpp" 
 #include "sfzero/SFZSound.cpp" 
+#include "sfzero/SFZStreamer.cpp" 
 #include "sfzero/SFZSynth.cpp" 
 #include "sfzero/SFZVoice.cpp" 
@@ -22,11 +22,14 @@ END_JUCE_MODULE_DECLARATION
 #include "sfzero/SF2WinTypes.h"
 #include "sfzero/SFZCommon.h"
 #include "sfzero/SFZDebug.h"
+#include "sfzero/SFZDiskSampleCache.h"
 #include "sfzero/SFZEG.h"
 #include "sfzero/SFZReader.h"
 #include "sfzero/SFZRegion.h"
 #include "sfzero/SFZSample.h"
+#include "sfzero/SFZSampleCache.h"
 #include "sfzero/SFZSound.h"
+#include "sfzero/SFZStreamer.h"
 #include "sfzero/SFZSynth.h"
 #include "sfzero/SFZVoice.h"
 
@@ -10,9 +10,19 @@
 #include "SF2Generator.h"
 #include "SF2Sound.h"
 
-sfzero::SF2Reader::SF2Reader(sfzero::SF2Sound *soundIn, const juce::File &fileIn) : sound_(soundIn)
+sfzero::SF2Reader::SF2Reader(sfzero::SF2Sound *soundIn, const juce::File &fileIn) : sound_(soundIn), path_(fileIn)
 {
-  file_ = fileIn.createInputStream().release();
+  // Chunks are read out of the mapped file, so seeking and reading never touch the disk API.
+  mapping_.reset(new juce::MemoryMappedFile(fileIn, juce::MemoryMappedFile::readOnly));
+  if (mapping_->getData() != nullptr)
+  {
+    file_ = new juce::MemoryInputStream(mapping_->getData(), mapping_->getSize(), false);
+  }
+  else
+  {
+    mapping_.reset();
+    file_ = fileIn.createInputStream().release();
+  }
 }
 
 sfzero::SF2Reader::~SF2Reader() { delete file_; }
@@ -177,14 +187,12 @@ void sfzero::SF2Reader::read()
   }
 }
 
-juce::AudioSampleBuffer *sfzero::SF2Reader::readSamples(double *progressVar, juce::Thread *thread)
+bool sfzero::SF2Reader::findSampleChunk(sfzero::RIFFChunk &chunk)
 {
-  static const int bufferSize = 32768;
-
   if (file_ == nullptr)
   {
     sound_->addError("Couldn't open file.");
-    return nullptr;
+    return false;
   }
 
   // Find the "sdta" chunk.
@@ -192,7 +200,6 @@ juce::AudioSampleBuffer *sfzero::SF2Reader::readSamples(double *progressVar, juc
   sfzero::RIFFChunk riffChunk;
   riffChunk.readFrom(file_);
   bool found = false;
-  sfzero::RIFFChunk chunk;
   while (file_->getPosition() < riffChunk.end())
   {
     chunk.readFrom(file_);
@@ -218,6 +225,17 @@ juce::AudioSampleBuffer *sfzero::SF2Reader::readSamples(double *progressVar, juc
   if (!found)
   {
     sound_->addError("SF2 is missing its \"smpl\" chunk.");
+  }
+  return found;
+}
+
+juce::AudioSampleBuffer *sfzero::SF2Reader::readSamples(double *progressVar, juce::Thread *thread)
+{
+  static const int bufferSize = 32768;
+
+  sfzero::RIFFChunk chunk;
+  if (!findSampleChunk(chunk))
+  {
     return nullptr;
   }
 
@@ -272,6 +290,68 @@ juce::AudioSampleBuffer *sfzero::SF2Reader::readSamples(double *progressVar, juc
   return sampleBuffer;
 }
 
+sfzero::SampleCache::Buffer::Ptr sfzero::SF2Reader::readSamplesInt16(double *progressVar, juce::Thread *thread)
+{
+  static const int bufferSize = 32768;
+
+  sfzero::RIFFChunk chunk;
+  if (!findSampleChunk(chunk))
+  {
+    return nullptr;
+  }
+
+  // The frames are already signed 16-bit. Mapped, they are used where they are, never copied, but
+  // referTo() reads their pages in at load rather than leaving them to fault in when a voice first
+  // plays them on the audio thread. (RIFF chunks start on even offsets, so the frames are aligned.)
+  int numSamples = chunk.size / sizeof(short);
+  sfzero::SampleCache::Buffer::Ptr sampleBuffer(new sfzero::SampleCache::Buffer());
+  if (mapping_ != nullptr)
+  {
+    const juce::Range<juce::int64> range(chunk.start, chunk.start + static_cast<juce::int64>(numSamples) * sizeof(short));
+    std::unique_ptr<juce::MemoryMappedFile> frames(new juce::MemoryMappedFile(path_, range, juce::MemoryMappedFile::readOnly));
+    // The mapping starts on the page holding the chunk's first byte.
+    if ((frames->getData() != nullptr) && (frames->getRange().getEnd() == range.getEnd()))
+    {
+      const size_t dataOffset = static_cast<size_t>(range.getStart() - frames->getRange().getStart());
+      sampleBuffer->referTo(std::move(frames), dataOffset, 1, numSamples, true);
+      if (progressVar)
+      {
+        *progressVar = 1.0;
+      }
+      return sampleBuffer;
+    }
+  }
+  sampleBuffer->allocateInt16(1, numSamples);
+
+  int samplesLeft = numSamples;
+  juce::int16 *out = sampleBuffer->getInt16Channel(0);
+  while (samplesLeft > 0)
+  {
+    int samplesToRead = juce::jmin(bufferSize, samplesLeft);
+    // If we ever need to compile for big-endian platforms, we'll need to
+    // byte-swap here.
+    file_->read(out, samplesToRead * sizeof(short));
+    out += samplesToRead;
+    samplesLeft -= samplesToRead;
+
+    if (progressVar)
+    {
+      *progressVar = static_cast<float>(numSamples - samplesLeft) / numSamples;
+    }
+    if (thread && thread->threadShouldExit())
+    {
+      return nullptr;
+    }
+  }
+
+  if (progressVar)
+  {
+    *progressVar = 1.0;
+  }
+
+  return sampleBuffer;
+}
+
 void sfzero::SF2Reader::addGeneratorToRegion(sfzero::word genOper, sfzero::SF2::genAmountType *amount, sfzero::Region *region)
 {
   switch (genOper)
@@ -8,6 +8,7 @@
 #define SF2READER_H_INCLUDED
 
 #include "SF2.h"
+#include "SFZSampleCache.h"
 
 namespace sfzero
 {
@@ -15,6 +16,7 @@ namespace sfzero
 class SF2Sound;
 class Sample;
 struct Region;
+struct RIFFChunk;
 
 class SF2Reader
 {
@@ -24,11 +26,17 @@ public:
 
   void read();
   juce::AudioSampleBuffer *readSamples(double *progressVar = nullptr, juce::Thread *thread = nullptr);
+  // The same frames kept as the file's 16-bit integers (scale by 1 / 32767 to match readSamples()),
+  // mapped in place where the file can be mapped.
+  SampleCache::Buffer::Ptr readSamplesInt16(double *progressVar = nullptr, juce::Thread *thread = nullptr);
 
 private:
   SF2Sound *sound_;
-  juce::FileInputStream *file_;
+  juce::File path_;
+  std::unique_ptr<juce::MemoryMappedFile> mapping_; // file_ reads from this when the file could be mapped
+  juce::InputStream *file_;
 
+  bool findSampleChunk(RIFFChunk &chunk);
   void addGeneratorToRegion(word genOper, SF2::genAmountType *amount, Region *region);
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SF2Reader)
 };
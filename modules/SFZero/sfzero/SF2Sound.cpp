@@ -57,6 +57,24 @@ void sfzero::SF2Sound::loadRegions()
 void sfzero::SF2Sound::loadSamples(juce::AudioFormatManager * /*formatManager*/, double *progressVar, juce::Thread *thread)
 {
   sfzero::SF2Reader reader(this, getFile());
+  if (getInt16Samples())
+  {
+    // The file's own 16-bit frames, shared by reference count.
+    sfzero::SampleCache::Buffer::Ptr int16Buffer = reader.readSamplesInt16(progressVar, thread);
+    if (int16Buffer != nullptr)
+    {
+      for (juce::HashMap<int, sfzero::Sample *>::Iterator i(samplesByRate_); i.next();)
+      {
+        i.getValue()->setSharedBuffer(int16Buffer, 1.0f / 32767.0f);
+      }
+    }
+    if (progressVar)
+    {
+      *progressVar = 1.0;
+    }
+    return;
+  }
+
   juce::AudioSampleBuffer *buffer = reader.readSamples(progressVar, thread);
 
   if (buffer)
@@ -74,6 +92,13 @@ void sfzero::SF2Sound::loadSamples(juce::AudioFormatManager * /*formatManager*/,
   }
 }
 
+juce::int64 sfzero::SF2Sound::getMemoryBytes()
+{
+  // One buffer shared by every sample.
+  juce::HashMap<int, sfzero::Sample *>::Iterator i(samplesByRate_);
+  return i.next() ? i.getValue()->getMemoryBytes() : 0;
+}
+
 void sfzero::SF2Sound::addPreset(sfzero::SF2Sound::Preset *preset) { presets_.add(preset); }
 
 int sfzero::SF2Sound::numSubsounds() { return presets_.size(); }
@@ -99,6 +124,7 @@ void sfzero::SF2Sound::useSubsound(int whichSubsound)
   selectedPreset_ = whichSubsound;
   getRegions().clear();
   getRegions().addArray(presets_[whichSubsound]->regions);
+  buildRegionIndex();
 }
 
 int sfzero::SF2Sound::selectedSubsound() { return selectedPreset_; }
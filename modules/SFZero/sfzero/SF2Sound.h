@@ -20,6 +20,7 @@ public:
 
   void loadRegions() override;
   void loadSamples(juce::AudioFormatManager *formatManager, double *progressVar = nullptr, juce::Thread *thread = nullptr) override;
+  juce::int64 getMemoryBytes() override;
 
   struct Preset
   {
@@ -0,0 +1,193 @@
+/*************************************************************************************
+ * Original code copyright (C) 2012 Steve Folta
+ * Converted to Juce module (C) 2016 Leo Olivers
+ * Forked from https://github.com/stevefolta/SFZero
+ * For license info please see the LICENSE file distributed with this source code
+ *************************************************************************************/
+#include "SFZDiskSampleCache.h"
+
+const char *const sfzero::DiskSampleCache::fileExtension = ".sfzc";
+
+// Native byte order: the files never leave the machine that wrote them.
+struct DiskSampleHeader
+{
+  char magic[4];
+  juce::uint32 version;
+  juce::uint32 keyBytes; // the UTF-8 key follows the header
+  juce::uint32 numChannels;
+  juce::uint32 numFrames;
+  juce::uint32 int16;
+  juce::uint64 dataOffset; // planar frames from here to the end of the file
+};
+
+static const juce::uint32 diskSampleVersion = 1;
+static const size_t diskSampleAlignment = 64;
+
+static juce::Array<juce::File> findDiskSampleFiles(const juce::File &folder)
+{
+  juce::Array<juce::File> files;
+  for (const auto &file : folder.findChildFiles(juce::File::findFiles, false, juce::String("*") + sfzero::DiskSampleCache::fileExtension))
+  {
+    // TemporaryFile names files being written "<name>_temp<hex><extension>".
+    if (!file.getFileName().contains("_temp"))
+    {
+      files.add(file);
+    }
+  }
+  return files;
+}
+
+sfzero::DiskSampleCache::DiskSampleCache(const juce::File &folder, juce::int64 maxBytes) : folder_(folder), maxBytes_(maxBytes)
+{
+  juce::int64 bytes = 0;
+  for (const auto &file : findDiskSampleFiles(folder_))
+  {
+    bytes += file.getSize();
+  }
+  bytesOnDisk_.store(bytes);
+}
+
+sfzero::DiskSampleCache::~DiskSampleCache() {}
+
+juce::File sfzero::DiskSampleCache::getFileFor(const juce::String &key) const
+{
+  return folder_.getChildFile(juce::String::toHexString(key.hashCode64()) + fileExtension);
+}
+
+bool sfzero::DiskSampleCache::read(const juce::String &key, sfzero::SampleCache::Buffer &buffer)
+{
+  const juce::File file = getFileFor(key);
+  if (!file.existsAsFile())
+  {
+    return false;
+  }
+
+  std::unique_ptr<juce::MemoryMappedFile> mapping(new juce::MemoryMappedFile(file, juce::MemoryMappedFile::readOnly));
+  const char *data = static_cast<const char *>(mapping->getData());
+  const size_t size = mapping->getSize();
+  if ((data == nullptr) || (size < sizeof(DiskSampleHeader)))
+  {
+    return false;
+  }
+
+  DiskSampleHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if ((std::memcmp(header.magic, "SFZC", 4) != 0) || (header.version != diskSampleVersion) ||
+      (header.keyBytes > size - sizeof(header)) || (header.numChannels == 0) ||
+      (header.numFrames > static_cast<juce::uint32>(std::numeric_limits<int>::max())))
+  {
+    return false;
+  }
+  // A hash collision or a file left by another key: decode as if it weren't there.
+  if (juce::String::fromUTF8(data + sizeof(header), static_cast<int>(header.keyBytes)) != key)
+  {
+    return false;
+  }
+  const juce::uint64 frameBytes = (header.int16 != 0) ? sizeof(juce::int16) : sizeof(float);
+  if ((header.dataOffset % diskSampleAlignment != 0) ||
+      (header.dataOffset + static_cast<juce::uint64>(header.numChannels) * header.numFrames * frameBytes != size))
+  {
+    return false;
+  }
+
+  file.setLastModificationTime(juce::Time::getCurrentTime()); // the LRU order
+  buffer.referTo(std::move(mapping), static_cast<size_t>(header.dataOffset), static_cast<int>(header.numChannels),
+                 static_cast<int>(header.numFrames), header.int16 != 0);
+  numReads_.fetch_add(1);
+  return true;
+}
+
+void sfzero::DiskSampleCache::write(const juce::String &key, const sfzero::SampleCache::Buffer &buffer)
+{
+  if (!folder_.createDirectory())
+  {
+    return;
+  }
+
+  DiskSampleHeader header;
+  std::memcpy(header.magic, "SFZC", 4);
+  header.version = diskSampleVersion;
+  header.keyBytes = static_cast<juce::uint32>(key.getNumBytesAsUTF8());
+  header.numChannels = static_cast<juce::uint32>(buffer.getNumChannels());
+  header.numFrames = static_cast<juce::uint32>(buffer.getNumFrames());
+  header.int16 = buffer.isInt16() ? 1 : 0;
+  header.dataOffset = (sizeof(header) + header.keyBytes + diskSampleAlignment - 1) / diskSampleAlignment * diskSampleAlignment;
+
+  const juce::File file = getFileFor(key);
+  juce::TemporaryFile temp(file);
+  {
+    juce::FileOutputStream out(temp.getFile());
+    if (out.failedToOpen())
+    {
+      return;
+    }
+    out.write(&header, sizeof(header));
+    out.write(key.toRawUTF8(), header.keyBytes);
+    out.writeRepeatedByte(0, static_cast<size_t>(header.dataOffset) - sizeof(header) - header.keyBytes);
+    const size_t channelBytes = static_cast<size_t>(buffer.getNumFrames()) * (buffer.isInt16() ? sizeof(juce::int16) : sizeof(float));
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+      out.write(buffer.isInt16() ? static_cast<const void *>(buffer.getInt16Channel(channel))
+                                 : static_cast<const void *>(buffer.getSamples().getReadPointer(channel)),
+                channelBytes);
+    }
+    out.flush();
+    if (out.getStatus().failed())
+    {
+      return;
+    }
+  }
+  // Replacing an existing entry only adds the difference.
+  const juce::int64 replacedBytes = file.existsAsFile() ? file.getSize() : 0;
+  if (!temp.overwriteTargetFileWithTemporary())
+  {
+    return;
+  }
+
+  numWrites_.fetch_add(1);
+  const juce::int64 addedBytes = file.getSize() - replacedBytes;
+  if (bytesOnDisk_.fetch_add(addedBytes) + addedBytes > maxBytes_.load())
+  {
+    trim(maxBytes_.load());
+  }
+}
+
+void sfzero::DiskSampleCache::setMaxBytes(juce::int64 bytes)
+{
+  maxBytes_.store(bytes);
+  trim(bytes);
+}
+
+void sfzero::DiskSampleCache::clear() { trim(0); }
+
+int sfzero::DiskSampleCache::getNumFiles() const { return findDiskSampleFiles(folder_).size(); }
+
+void sfzero::DiskSampleCache::trim(juce::int64 maxBytes)
+{
+  const juce::ScopedLock locker(trimLock_);
+
+  // Oldest first: read() touches the files it maps.
+  juce::Array<juce::File> files = findDiskSampleFiles(folder_);
+  std::sort(files.begin(), files.end(), [](const juce::File &a, const juce::File &b)
+            { return a.getLastModificationTime() < b.getLastModificationTime(); });
+
+  juce::int64 bytes = 0;
+  for (const auto &file : files)
+  {
+    bytes += file.getSize();
+  }
+  for (const auto &file : files)
+  {
+    if (bytes <= maxBytes)
+    {
+      break;
+    }
+    // A file mapped by this process can't be deleted on Windows; it goes on a later trim.
+    const juce::int64 fileBytes = file.getSize();
+    if (file.deleteFile())
+    {
+      bytes -= fileBytes;
+    }
+  }
+  bytesOnDisk_.store(bytes);
+}
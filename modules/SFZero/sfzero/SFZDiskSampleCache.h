@@ -0,0 +1,59 @@
+/*************************************************************************************
+ * Original code copyright (C) 2012 Steve Folta
+ * Converted to Juce module (C) 2016 Leo Olivers
+ * Forked from https://github.com/stevefolta/SFZero
+ * For license info please see the LICENSE file distributed with this source code
+ *************************************************************************************/
+#ifndef SFZDISKSAMPLECACHE_H_INCLUDED
+#define SFZDISKSAMPLECACHE_H_INCLUDED
+
+#include "SFZSampleCache.h"
+
+namespace sfzero
+{
+
+// Decoded sample frames kept on disk between runs, so a warm start maps them instead of decoding
+// the source files again. Each SampleCache key gets one file in the folder, named after a hash of
+// the key and checked against the whole key when opened. A file holds the frames exactly as a
+// SampleCache::Buffer does (planar, float or int16) after a 64-byte-aligned header, so it is
+// memory-mapped rather than read. Past the size limit the least recently used files are deleted.
+class DiskSampleCache
+{
+public:
+  DiskSampleCache(const juce::File &folder, juce::int64 maxBytes);
+  ~DiskSampleCache();
+
+  // Maps the frames stored for key into buffer; false if there are none or the file doesn't
+  // check out. Thread-safe.
+  bool read(const juce::String &key, SampleCache::Buffer &buffer);
+  // Stores buffer's frames for key, then deletes the least recently used files past the limit.
+  // Thread-safe; a file is written whole under a temporary name, so readers never see half of one.
+  void write(const juce::String &key, const SampleCache::Buffer &buffer);
+
+  void setMaxBytes(juce::int64 bytes);
+  juce::int64 getMaxBytes() const { return maxBytes_.load(); }
+  // Deletes every cache file.
+  void clear();
+
+  const juce::File &getFolder() const { return folder_; }
+  juce::int64 getNumBytesOnDisk() const { return bytesOnDisk_.load(); }
+  int getNumFiles() const;
+  int getNumReads() const { return numReads_.load(); }
+  int getNumWrites() const { return numWrites_.load(); }
+
+  static const char *const fileExtension;
+
+private:
+  juce::File folder_;
+  std::atomic<juce::int64> maxBytes_, bytesOnDisk_{0};
+  std::atomic<int> numReads_{0}, numWrites_{0};
+  juce::CriticalSection trimLock_;
+
+  juce::File getFileFor(const juce::String &key) const;
+  void trim(juce::int64 maxBytes);
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiskSampleCache)
+};
+}
+
+#endif // SFZDISKSAMPLECACHE_H_INCLUDED
@@ -8,36 +8,65 @@
 #include "SFZRegion.h"
 #include "SFZSound.h"
 
-sfzero::Reader::Reader(sfzero::Sound *soundIn) : sound_(soundIn), line_(1) {}
+sfzero::Reader::Reader(sfzero::Sound *soundIn)
+    : sound_(soundIn), line_(1), buildingRegion_(nullptr), inControl_(false), includeDepth_(0), fatal_(false)
+{
+}
 
 sfzero::Reader::~Reader() {}
 
 void sfzero::Reader::read(const juce::File &file)
 {
-  juce::MemoryBlock contents;
-  bool ok = file.loadFileAsData(contents);
-
-  if (!ok)
+  if (!parseFile(file))
   {
     sound_->addError("Couldn't read \"" + file.getFullPathName() + "\"");
     return;
   }
-
-  read(static_cast<const char *>(contents.getData()), static_cast<int>(contents.getSize()));
+  finish();
 }
 
 void sfzero::Reader::read(const char *text, unsigned int length)
+{
+  parse(text, text + length);
+  finish();
+}
+
+bool sfzero::Reader::parseFile(const juce::File &file)
+{
+  // Opcodes and values are parsed as slices of the mapped file, never copied out of it.
+  juce::MemoryMappedFile mapped(file, juce::MemoryMappedFile::readOnly);
+  if (mapped.getData() != nullptr)
+  {
+    const char *text = static_cast<const char *>(mapped.getData());
+    parse(text, text + mapped.getSize());
+    return true;
+  }
+
+  // Empty files (which map to nothing) and file systems that can't map.
+  juce::MemoryBlock contents;
+  if (!file.existsAsFile() || !file.loadFileAsData(contents))
+  {
+    return false;
+  }
+  const char *text = static_cast<const char *>(contents.getData());
+  parse(text, text + contents.getSize());
+  return true;
+}
+
+void sfzero::Reader::finish()
+{
+  if (buildingRegion_ && (buildingRegion_ == &curRegion_))
+  {
+    finishRegion(buildingRegion_);
+  }
+  buildingRegion_ = nullptr;
+}
+
+void sfzero::Reader::parse(const char *text, const char *end)
 {
   const char *p = text;
-  const char *end = text + length;
   char c = 0;
 
-  sfzero::Region curGroup;
-  sfzero::Region curRegion;
-  sfzero::Region *buildingRegion = nullptr;
-  bool inControl = false;
-  juce::String defaultPath;
-
   while (p < end)
   {
     // We're at the start of a line; skip any whitespace.
@@ -59,22 +88,22 @@ void sfzero::Reader::read(const char *text, unsigned int length)
     if (c == '/')
     {
       // Skip to end of line.
-      while (p < end)
+      while (++p < end)
       {
-        c = *++p;
+        c = *p;
         if ((c == '\n') || (c == '\r'))
         {
           break;
         }
       }
-      p = handleLineEnd(p);
+      p = handleLineEnd(p, end);
       continue;
     }
 
     // Check if it's a blank line.
     if ((c == '\r') || (c == '\n'))
     {
-      p = handleLineEnd(p);
+      p = handleLineEnd(p, end);
       continue;
     }
 
@@ -88,60 +117,71 @@ void sfzero::Reader::read(const char *text, unsigned int length)
       {
         p += 1;
         const char *tagStart = p;
+        bool terminated = false;
         while (p < end)
         {
           c = *p++;
           if ((c == '\n') || (c == '\r'))
           {
-            error("Unterminated tag");
-            goto fatalError;
+            break;
           }
           else if (c == '>')
           {
+            terminated = true;
             break;
           }
         }
-        if (p >= end)
+        if (!terminated)
         {
           error("Unterminated tag");
-          goto fatalError;
+          fatal_ = true;
+          return;
         }
         sfzero::StringSlice tag(tagStart, p - 1);
         if (tag == "region")
         {
-          if (buildingRegion && (buildingRegion == &curRegion))
+          if (buildingRegion_ && (buildingRegion_ == &curRegion_))
           {
-            finishRegion(&curRegion);
+            finishRegion(&curRegion_);
           }
-          curRegion = curGroup;
-          buildingRegion = &curRegion;
-          inControl = false;
+          curRegion_ = curGroup_;
+          buildingRegion_ = &curRegion_;
+          inControl_ = false;
         }
         else if (tag == "group")
         {
-          if (buildingRegion && (buildingRegion == &curRegion))
+          if (buildingRegion_ && (buildingRegion_ == &curRegion_))
           {
-            finishRegion(&curRegion);
+            finishRegion(&curRegion_);
           }
-          curGroup.clear();
-          buildingRegion = &curGroup;
-          inControl = false;
+          curGroup_.clear();
+          buildingRegion_ = &curGroup_;
+          inControl_ = false;
         }
         else if (tag == "control")
         {
-          if (buildingRegion && (buildingRegion == &curRegion))
+          if (buildingRegion_ && (buildingRegion_ == &curRegion_))
           {
-            finishRegion(&curRegion);
+            finishRegion(&curRegion_);
           }
-          curGroup.clear();
-          buildingRegion = nullptr;
-          inControl = true;
+          curGroup_.clear();
+          buildingRegion_ = nullptr;
+          inControl_ = true;
         }
         else
         {
           error("Illegal tag");
         }
       }
+      // Preprocessor directive.
+      else if (c == '#')
+      {
+        p = readDirective(p, end);
+        if (fatal_)
+        {
+          return;
+        }
+      }
       // Comment.
       else if (c == '/')
       {
@@ -175,15 +215,14 @@ void sfzero::Reader::read(const char *text, unsigned int length)
           goto nextElement;
         }
         sfzero::StringSlice opcode(parameterStart, p - 1);
-        if (inControl)
+        if (inControl_)
         {
           if (opcode == "default_path")
           {
-            p = readPathInto(&defaultPath, p, end);
+            p = readPathInto(&defaultPath_, p, end);
           }
           else
           {
-            const char *valueStart = p;
             while (p < end)
             {
               c = *p;
@@ -193,7 +232,6 @@ void sfzero::Reader::read(const char *text, unsigned int length)
               }
               p++;
             }
-            juce::String value(valueStart, p - valueStart);
             juce::String fauxOpcode = juce::String(opcode.getStart(), opcode.length()) + " (in <control>)";
             sound_->addUnsupportedOpcode(fauxOpcode);
           }
@@ -202,11 +240,16 @@ void sfzero::Reader::read(const char *text, unsigned int length)
         {
           juce::String path;
           p = readPathInto(&path, p, end);
+          if (path.containsChar('$'))
+          {
+            juce::String expandedPath;
+            path = expandDefines(sfzero::StringSlice(path.toRawUTF8(), path.toRawUTF8() + path.getNumBytesAsUTF8()), expandedPath).toString();
+          }
           if (!path.isEmpty())
           {
-            if (buildingRegion)
+            if (buildingRegion_)
             {
-              buildingRegion->sample = sound_->addSample(path, defaultPath);
+              buildingRegion_->sample = sound_->addSample(path, defaultPath_);
             }
             else
             {
@@ -230,57 +273,58 @@ void sfzero::Reader::read(const char *text, unsigned int length)
             }
             p++;
           }
-          juce::String value(valueStart, p - valueStart);
-          if (buildingRegion == nullptr)
+          juce::String expandedValue;
+          const sfzero::StringSlice value = expandDefines(sfzero::StringSlice(valueStart, p), expandedValue);
+          if (buildingRegion_ == nullptr)
           {
             error("Setting a parameter outside a region or group");
           }
           else if (opcode == "lokey")
           {
-            buildingRegion->lokey = keyValue(value);
+            buildingRegion_->lokey = keyValue(value);
           }
           else if (opcode == "hikey")
           {
-            buildingRegion->hikey = keyValue(value);
+            buildingRegion_->hikey = keyValue(value);
           }
           else if (opcode == "key")
           {
-            buildingRegion->hikey = buildingRegion->lokey = buildingRegion->pitch_keycenter = keyValue(value);
+            buildingRegion_->hikey = buildingRegion_->lokey = buildingRegion_->pitch_keycenter = keyValue(value);
           }
           else if (opcode == "lovel")
           {
-            buildingRegion->lovel = value.getIntValue();
+            buildingRegion_->lovel = value.getIntValue();
           }
           else if (opcode == "hivel")
           {
-            buildingRegion->hivel = value.getIntValue();
+            buildingRegion_->hivel = value.getIntValue();
           }
           else if (opcode == "trigger")
           {
-            buildingRegion->trigger = static_cast<sfzero::Region::Trigger>(triggerValue(value));
+            buildingRegion_->trigger = static_cast<sfzero::Region::Trigger>(triggerValue(value));
           }
           else if (opcode == "group")
           {
-            buildingRegion->group = static_cast<int>(value.getLargeIntValue());
+            buildingRegion_->group = static_cast<int>(value.getLargeIntValue());
           }
           else if (opcode == "off_by")
           {
-            buildingRegion->off_by = value.getLargeIntValue();
+            buildingRegion_->off_by = value.getLargeIntValue();
           }
           else if (opcode == "offset")
           {
-            buildingRegion->offset = value.getLargeIntValue();
+            buildingRegion_->offset = value.getLargeIntValue();
           }
           else if (opcode == "end")
           {
             juce::int64 end2 = value.getLargeIntValue();
             if (end2 < 0)
             {
-              buildingRegion->negative_end = true;
+              buildingRegion_->negative_end = true;
             }
             else
             {
-              buildingRegion->end = end2;
+              buildingRegion_->end = end2;
             }
           }
           else if (opcode == "loop_mode")
@@ -288,109 +332,109 @@ void sfzero::Reader::read(const char *text, unsigned int length)
             bool modeIsSupported = value == "no_loop" || value == "one_shot" || value == "loop_continuous";
             if (modeIsSupported)
             {
-              buildingRegion->loop_mode = static_cast<sfzero::Region::LoopMode>(loopModeValue(value));
+              buildingRegion_->loop_mode = static_cast<sfzero::Region::LoopMode>(loopModeValue(value));
             }
             else
             {
-              juce::String fauxOpcode = juce::String(opcode.getStart(), opcode.length()) + "=" + value;
+              juce::String fauxOpcode = juce::String(opcode.getStart(), opcode.length()) + "=" + value.toString();
               sound_->addUnsupportedOpcode(fauxOpcode);
             }
           }
           else if (opcode == "loop_start")
           {
-            buildingRegion->loop_start = value.getLargeIntValue();
+            buildingRegion_->loop_start = value.getLargeIntValue();
           }
           else if (opcode == "loop_end")
           {
-            buildingRegion->loop_end = value.getLargeIntValue();
+            buildingRegion_->loop_end = value.getLargeIntValue();
           }
           else if (opcode == "transpose")
           {
-            buildingRegion->transpose = value.getIntValue();
+            buildingRegion_->transpose = value.getIntValue();
           }
           else if (opcode == "tune")
           {
-            buildingRegion->tune = value.getIntValue();
+            buildingRegion_->tune = value.getIntValue();
           }
           else if (opcode == "pitch_keycenter")
           {
-            buildingRegion->pitch_keycenter = keyValue(value);
+            buildingRegion_->pitch_keycenter = keyValue(value);
           }
           else if (opcode == "pitch_keytrack")
           {
-            buildingRegion->pitch_keytrack = value.getIntValue();
+            buildingRegion_->pitch_keytrack = value.getIntValue();
           }
           else if (opcode == "bend_up")
           {
-            buildingRegion->bend_up = value.getIntValue();
+            buildingRegion_->bend_up = value.getIntValue();
           }
           else if (opcode == "bend_down")
           {
-            buildingRegion->bend_down = value.getIntValue();
+            buildingRegion_->bend_down = value.getIntValue();
           }
           else if (opcode == "volume")
           {
-            buildingRegion->volume = value.getFloatValue();
+            buildingRegion_->volume = value.getFloatValue();
           }
           else if (opcode == "pan")
           {
-            buildingRegion->pan = value.getFloatValue();
+            buildingRegion_->pan = value.getFloatValue();
           }
           else if (opcode == "amp_veltrack")
           {
-            buildingRegion->amp_veltrack = value.getFloatValue();
+            buildingRegion_->amp_veltrack = value.getFloatValue();
           }
           else if (opcode == "ampeg_delay")
           {
-            buildingRegion->ampeg.delay = value.getFloatValue();
+            buildingRegion_->ampeg.delay = value.getFloatValue();
           }
           else if (opcode == "ampeg_start")
           {
-            buildingRegion->ampeg.start = value.getFloatValue();
+            buildingRegion_->ampeg.start = value.getFloatValue();
           }
           else if (opcode == "ampeg_attack")
           {
-            buildingRegion->ampeg.attack = value.getFloatValue();
+            buildingRegion_->ampeg.attack = value.getFloatValue();
           }
           else if (opcode == "ampeg_hold")
           {
-            buildingRegion->ampeg.hold = value.getFloatValue();
+            buildingRegion_->ampeg.hold = value.getFloatValue();
           }
           else if (opcode == "ampeg_decay")
           {
-            buildingRegion->ampeg.decay = value.getFloatValue();
+            buildingRegion_->ampeg.decay = value.getFloatValue();
           }
           else if (opcode == "ampeg_sustain")
           {
-            buildingRegion->ampeg.sustain = value.getFloatValue();
+            buildingRegion_->ampeg.sustain = value.getFloatValue();
           }
           else if (opcode == "ampeg_release")
           {
-            buildingRegion->ampeg.release = value.getFloatValue();
+            buildingRegion_->ampeg.release = value.getFloatValue();
           }
           else if (opcode == "ampeg_vel2delay")
           {
-            buildingRegion->ampeg_veltrack.delay = value.getFloatValue();
+            buildingRegion_->ampeg_veltrack.delay = value.getFloatValue();
           }
           else if (opcode == "ampeg_vel2attack")
           {
-            buildingRegion->ampeg_veltrack.attack = value.getFloatValue();
+            buildingRegion_->ampeg_veltrack.attack = value.getFloatValue();
           }
           else if (opcode == "ampeg_vel2hold")
           {
-            buildingRegion->ampeg_veltrack.hold = value.getFloatValue();
+            buildingRegion_->ampeg_veltrack.hold = value.getFloatValue();
           }
           else if (opcode == "ampeg_vel2decay")
           {
-            buildingRegion->ampeg_veltrack.decay = value.getFloatValue();
+            buildingRegion_->ampeg_veltrack.decay = value.getFloatValue();
           }
           else if (opcode == "ampeg_vel2sustain")
           {
-            buildingRegion->ampeg_veltrack.sustain = value.getFloatValue();
+            buildingRegion_->ampeg_veltrack.sustain = value.getFloatValue();
           }
           else if (opcode == "ampeg_vel2release")
           {
-            buildingRegion->ampeg_veltrack.release = value.getFloatValue();
+            buildingRegion_->ampeg_veltrack.release = value.getFloatValue();
           }
           else if (opcode == "default_path")
           {
@@ -417,25 +461,24 @@ void sfzero::Reader::read(const char *text, unsigned int length)
       }
       if ((c == '\r') || (c == '\n'))
       {
-        p = handleLineEnd(p);
+        p = handleLineEnd(p, end);
         break;
       }
     }
   }
+}
 
-fatalError:
-  if (buildingRegion && (buildingRegion == &curRegion))
+const char *sfzero::Reader::handleLineEnd(const char *p, const char *end)
+{
+  if (p >= end)
   {
-    finishRegion(buildingRegion);
+    return p;
   }
-}
 
-const char *sfzero::Reader::handleLineEnd(const char *p)
-{
   // Check for DOS-style line ending.
   char lineEndChar = *p++;
 
-  if ((lineEndChar == '\r') && (*p == '\n'))
+  if ((lineEndChar == '\r') && (p < end) && (*p == '\n'))
   {
     p += 1;
   }
@@ -443,6 +486,127 @@ const char *sfzero::Reader::handleLineEnd(const char *p)
   return p;
 }
 
+const char *sfzero::Reader::readDirective(const char *p, const char *end)
+{
+  // A directive runs to the end of its line.
+  const char *lineEnd = p;
+  while ((lineEnd < end) && (*lineEnd != '\r') && (*lineEnd != '\n'))
+  {
+    lineEnd += 1;
+  }
+  auto skipSpaces = [lineEnd](const char *q)
+  {
+    while ((q < lineEnd) && ((*q == ' ') || (*q == '\t')))
+    {
+      q += 1;
+    }
+    return q;
+  };
+  auto skipWord = [lineEnd](const char *q)
+  {
+    while ((q < lineEnd) && (*q != ' ') && (*q != '\t'))
+    {
+      q += 1;
+    }
+    return q;
+  };
+
+  const char *directiveEnd = skipWord(p);
+  sfzero::StringSlice directive(p + 1, directiveEnd);
+  if (directive == "define")
+  {
+    // #define $name value: kept until a value or sample path uses $name.
+    const char *nameStart = skipSpaces(directiveEnd);
+    const char *nameEnd = skipWord(nameStart);
+    const char *valueStart = skipSpaces(nameEnd);
+    const char *valueEnd = lineEnd;
+    while ((valueEnd > valueStart) && ((valueEnd[-1] == ' ') || (valueEnd[-1] == '\t')))
+    {
+      valueEnd -= 1;
+    }
+    if ((nameEnd - nameStart < 2) || (*nameStart != '$'))
+    {
+      error("Malformed #define");
+    }
+    else
+    {
+      defines_.set(sfzero::StringSlice(nameStart, nameEnd).toString(), sfzero::StringSlice(valueStart, valueEnd).toString());
+    }
+  }
+  else if (directive == "include")
+  {
+    // #include "path": parsed in place, when the parser reaches it.
+    const char *pathStart = skipSpaces(directiveEnd);
+    const char *pathEnd = pathStart + 1;
+    while ((pathEnd < lineEnd) && (*pathEnd != '"'))
+    {
+      pathEnd += 1;
+    }
+    if ((pathStart >= lineEnd) || (*pathStart != '"') || (pathEnd >= lineEnd))
+    {
+      error("Malformed #include");
+    }
+    else if (includeDepth_ >= maxIncludeDepth)
+    {
+      error("#include nested too deeply");
+    }
+    else
+    {
+      const juce::String path = sfzero::StringSlice(pathStart + 1, pathEnd).toString().replaceCharacter('\\', '/');
+      const int line = line_;
+      line_ = 1;
+      includeDepth_ += 1;
+      const bool found = parseFile(sound_->getFile().getSiblingFile(path));
+      includeDepth_ -= 1;
+      line_ = line;
+      if (!found)
+      {
+        error("Couldn't read #include \"" + path + "\"");
+      }
+    }
+  }
+  else
+  {
+    error("Unknown directive");
+  }
+  return lineEnd;
+}
+
+sfzero::StringSlice sfzero::Reader::expandDefines(const sfzero::StringSlice &text, juce::String &storage)
+{
+  if ((defines_.size() == 0) || !text.contains('$'))
+  {
+    return text;
+  }
+
+  storage.clear();
+  const char *runStart = text.getStart();
+  const char *p = text.getStart();
+  while (p < text.getEnd())
+  {
+    if (*p != '$')
+    {
+      p += 1;
+      continue;
+    }
+    const char *nameEnd = p + 1;
+    while ((nameEnd < text.getEnd()) && (juce::CharacterFunctions::isLetterOrDigit(*nameEnd) || (*nameEnd == '_')))
+    {
+      nameEnd += 1;
+    }
+    const juce::String name = sfzero::StringSlice(p, nameEnd).toString();
+    if (defines_.contains(name))
+    {
+      storage += sfzero::StringSlice(runStart, p).toString();
+      storage += defines_[name];
+      runStart = nameEnd;
+    }
+    p = nameEnd;
+  }
+  storage += sfzero::StringSlice(runStart, text.getEnd()).toString();
+  return sfzero::StringSlice(storage.toRawUTF8(), storage.toRawUTF8() + storage.getNumBytesAsUTF8());
+}
+
 const char *sfzero::Reader::readPathInto(juce::String *pathOut, const char *pIn, const char *endIn)
 {
   // Paths are kind of funny to parse because they can contain whitespace.
@@ -465,6 +629,7 @@ const char *sfzero::Reader::readPathInto(juce::String *pathOut, const char *pIn,
       {
         p += 1;
       }
+      continue;
     }
     else if ((c == '\n') || (c == '\r') || (c == '\t'))
     {
@@ -474,17 +639,26 @@ const char *sfzero::Reader::readPathInto(juce::String *pathOut, const char *pIn,
     {
       // We've been looking at an opcode; we need to rewind to
       // potentialEnd.
-      p = potentialEnd;
+      if (potentialEnd != nullptr)
+      {
+        p = potentialEnd;
+      }
       break;
     }
     p += 1;
   }
-  if (p > pathStart)
+  // Spaces before the end of the line aren't part of the path.
+  const char *pathEnd = p;
+  while ((pathEnd > pathStart) && (pathEnd[-1] == ' '))
+  {
+    pathEnd -= 1;
+  }
+  if (pathEnd > pathStart)
   {
     // Can't do this:
     //      juce::String path(CharPointer_UTF8(pathStart), CharPointer_UTF8(p));
     // It won't compile for some unfathomable reason.
-    juce::CharPointer_UTF8 end2(p);
+    juce::CharPointer_UTF8 end2(pathEnd);
     juce::String path(juce::CharPointer_UTF8(pathStart), end2);
     *pathOut = path;
   }
@@ -495,11 +669,12 @@ const char *sfzero::Reader::readPathInto(juce::String *pathOut, const char *pIn,
   return p;
 }
 
-int sfzero::Reader::keyValue(const juce::String &str)
+int sfzero::Reader::keyValue(const sfzero::StringSlice &str)
 {
-  auto chars = str.toRawUTF8();
+  const char *chars = str.getStart();
+  const unsigned int length = str.length();
 
-  char c = chars[0];
+  char c = (length > 0) ? chars[0] : 0;
 
   if ((c >= '0') && (c <= '9'))
   {
@@ -520,7 +695,7 @@ int sfzero::Reader::keyValue(const juce::String &str)
   }
   int octaveStart = 1;
 
-  c = chars[1];
+  c = (length > 1) ? chars[1] : 0;
   if ((c == 'b') || (c == '#'))
   {
     octaveStart += 1;
@@ -534,13 +709,13 @@ int sfzero::Reader::keyValue(const juce::String &str)
     }
   }
 
-  int octave = str.substring(octaveStart).getIntValue();
+  int octave = sfzero::StringSlice(chars + juce::jmin(static_cast<unsigned int>(octaveStart), length), str.getEnd()).getIntValue();
   // A3 == 57.
   int result = octave * 12 + note + (57 - 4 * 12);
   return result;
 }
 
-int sfzero::Reader::triggerValue(const juce::String &str)
+int sfzero::Reader::triggerValue(const sfzero::StringSlice &str)
 {
   if (str == "release")
   {
@@ -557,7 +732,7 @@ int sfzero::Reader::triggerValue(const juce::String &str)
   return sfzero::Region::attack;
 }
 
-int sfzero::Reader::loopModeValue(const juce::String &str)
+int sfzero::Reader::loopModeValue(const sfzero::StringSlice &str)
 {
   if (str == "no_loop")
   {
@@ -593,3 +768,32 @@ void sfzero::Reader::error(const juce::String &message)
   fullMessage += " (line " + juce::String(line_) + ").";
   sound_->addError(fullMessage);
 }
+
+int sfzero::StringSlice::getIntValue() const
+{
+  char text[numberBufferSize];
+  copyNumberTo(text);
+  return juce::CharacterFunctions::getIntValue<int>(juce::CharPointer_UTF8(text));
+}
+
+juce::int64 sfzero::StringSlice::getLargeIntValue() const
+{
+  char text[numberBufferSize];
+  copyNumberTo(text);
+  return juce::CharacterFunctions::getIntValue<juce::int64>(juce::CharPointer_UTF8(text));
+}
+
+float sfzero::StringSlice::getFloatValue() const
+{
+  char text[numberBufferSize];
+  copyNumberTo(text);
+  return static_cast<float>(juce::CharacterFunctions::getDoubleValue(juce::CharPointer_UTF8(text)));
+}
+
+void sfzero::StringSlice::copyNumberTo(char *text) const
+{
+  // A terminated copy: the slice may end exactly where the mapped file does.
+  const size_t count = juce::jmin(static_cast<size_t>(length()), static_cast<size_t>(numberBufferSize - 1));
+  std::memcpy(text, start_, count);
+  text[count] = '\0';
+}
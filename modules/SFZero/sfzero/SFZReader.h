@@ -8,13 +8,47 @@
 #define SFZREADER_H_INCLUDED
 
 #include "SFZCommon.h"
+#include "SFZRegion.h"
 
 namespace sfzero
 {
 
-struct Region;
 class Sound;
 
+// A view of characters in the text being parsed: opcodes and values are compared and converted
+// in place, without copying them into Strings.
+class StringSlice
+{
+public:
+  StringSlice(const char *startIn, const char *endIn) : start_(startIn), end_(endIn) {}
+
+  unsigned int length() const { return static_cast<unsigned int>(end_ - start_); }
+  bool operator==(const char *other) const { return (std::strlen(other) == length()) && (std::memcmp(start_, other, length()) == 0); }
+  bool operator!=(const char *other) const { return !(*this == other); }
+  bool contains(char c) const { return std::memchr(start_, c, length()) != nullptr; }
+  const char *getStart() const { return start_; }
+  const char *getEnd() const { return end_; }
+  juce::String toString() const { return juce::String::fromUTF8(start_, static_cast<int>(length())); }
+
+  // Parsed as juce::String's getters parse them.
+  int getIntValue() const;
+  juce::int64 getLargeIntValue() const;
+  float getFloatValue() const;
+
+private:
+  enum
+  {
+    numberBufferSize = 64
+  };
+  const char *start_;
+  const char *end_;
+
+  void copyNumberTo(char *text) const;
+};
+
+// Parses an .sfz file straight out of a memory-mapped view of it. #include files are mapped and
+// parsed where the directive appears; #define'd $names are substituted only into the values and
+// sample paths that use them.
 class Reader
 {
 public:
@@ -25,35 +59,39 @@ public:
   void read(const char *text, unsigned int length);
 
 private:
-  const char *handleLineEnd(const char *p);
+  enum
+  {
+    maxIncludeDepth = 16
+  };
+
+  bool parseFile(const juce::File &file); // false if it can't be read
+  void parse(const char *text, const char *end);
+  void finish();
+  const char *handleLineEnd(const char *p, const char *end);
   const char *readPathInto(juce::String *pathOut, const char *p, const char *end);
-  int keyValue(const juce::String &str);
-  int triggerValue(const juce::String &str);
-  int loopModeValue(const juce::String &str);
+  const char *readDirective(const char *p, const char *end);
+  // text with the #define'd names in it replaced; storage holds the result if there were any.
+  StringSlice expandDefines(const StringSlice &text, juce::String &storage);
+  int keyValue(const StringSlice &str);
+  int triggerValue(const StringSlice &str);
+  int loopModeValue(const StringSlice &str);
   void finishRegion(Region *region);
   void error(const juce::String &message);
 
   Sound *sound_;
   int line_;
 
-  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Reader)
-};
-
-class StringSlice
-{
-public:
-  StringSlice(const char *startIn, const char *endIn) : start_(startIn), end_(endIn) {}
-  virtual ~StringSlice() {}
+  // Parser state, carried through #include'd files.
+  Region curGroup_;
+  Region curRegion_;
+  Region *buildingRegion_;
+  bool inControl_;
+  juce::String defaultPath_;
+  juce::HashMap<juce::String, juce::String> defines_;
+  int includeDepth_;
+  bool fatal_;
 
-  unsigned int length() { return static_cast<int>(end_ - start_); }
-  bool operator==(const char *other) { return (strncmp(start_, other, length()) == 0); }
-  bool operator!=(const char *other) { return (strncmp(start_, other, length()) != 0); }
-  const char *getStart() const { return start_; }
-  const char *getEnd() const { return end_; }
-private:
-  const char *start_;
-  const char *end_;
-  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StringSlice)
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Reader)
 };
 }
 
@@ -7,35 +7,150 @@
 #include "SFZSample.h"
 #include "SFZDebug.h"
 
-bool sfzero::Sample::load(juce::AudioFormatManager *formatManager)
+bool sfzero::Sample::load(juce::AudioFormatManager *formatManager, double preloadSeconds, sfzero::SampleCache *cache)
 {
-  juce::AudioFormatReader *reader = formatManager->createReaderFor(file_);
+  // A file another Sound already loaded through cache is taken from it without opening the file:
+  // the cache knows its header, and its frames are looked up before any reader is made.
+  std::unique_ptr<juce::AudioFormatReader> reader;
+  auto openReader = [&]() -> bool
+  {
+    if (reader == nullptr)
+    {
+      reader.reset(formatManager->createReaderFor(file_));
+    }
+    return reader != nullptr;
+  };
 
-  if (reader == nullptr)
+  const juce::String fileKey = (cache != nullptr) ? SampleCache::fileKey(file_) : juce::String();
+  SampleCache::FileInfo info;
+  if ((cache == nullptr) || !cache->findInfo(fileKey, info))
   {
-    return false;
+    if (!openReader())
+    {
+      return false;
+    }
+    info = SampleCache::FileInfo::of(*reader);
   }
-  sampleRate_ = reader->sampleRate;
-  sampleLength_ = reader->lengthInSamples;
+  sampleRate_ = info.sampleRate;
+  sampleLength_ = info.lengthInSamples;
   // Read some extra samples, which will be filled with zeros, so interpolation
   // can be done without having to check for the edge all the time.
   jassert(sampleLength_ < std::numeric_limits<int>::max());
 
-  buffer_ = new juce::AudioSampleBuffer(reader->numChannels, static_cast<int>(sampleLength_ + 4));
-  reader->read(buffer_, 0, static_cast<int>(sampleLength_ + 4), 0, true, true);
-
-  juce::StringPairArray *metadata = &reader->metadataValues;
-  int numLoops = metadata->getValue("NumSampleLoops", "0").getIntValue();
+  const int numLoops = info.numLoops;
   if (numLoops > 0)
   {
-    loopStart_ = metadata->getValue("Loop0Start", "0").getLargeIntValue();
-    loopEnd_ = metadata->getValue("Loop0End", "0").getLargeIntValue();
+    loopStart_ = info.loopStart;
+    loopEnd_ = info.loopEnd;
+  }
+
+  // Stream only when it saves something, and never a sample that a region loops.
+  const juce::int64 preloadFrames = static_cast<juce::int64>(preloadSeconds * sampleRate_);
+  const bool looped = (streamPolicy_ == neverStream) || ((streamPolicy_ == streamUnlessLooped) && (numLoops > 0));
+  const int numFrames = static_cast<int>((preloadFrames > 0) && !looped && (preloadFrames * 2 < static_cast<juce::int64>(sampleLength_))
+                                             ? preloadFrames + 4
+                                             : getNumFrames());
+  // A streamed sample reads the rest of the file as it plays, so it needs a reader either way.
+  if ((numFrames < getNumFrames()) && !openReader())
+  {
+    return false;
+  }
+
+  if ((cache != nullptr) || (format_ == int16))
+  {
+    if (cache != nullptr)
+    {
+      cachedBuffer_ = cache->findLoaded(fileKey, numFrames, format_ == int16);
+      if (cachedBuffer_ == nullptr)
+      {
+        if (!openReader())
+        {
+          return false;
+        }
+        cachedBuffer_ = cache->getOrLoad(file_, *reader, numFrames, format_ == int16);
+      }
+    }
+    else
+    {
+      cachedBuffer_ = new SampleCache::Buffer();
+      if (!cachedBuffer_->read(*reader, numFrames, true))
+      {
+        cachedBuffer_ = nullptr;
+      }
+    }
+    if (cachedBuffer_ == nullptr)
+    {
+      return false;
+    }
+    // Integer readers give 16-bit frames as v << 16, which AudioFormatReader turns into floats
+    // scaling by 2^-31, so v * 2^-15 reproduces the float frames exactly.
+    buffer_ = cachedBuffer_->isInt16() ? nullptr : cachedBuffer_->getSamples();
+    int16Scale_ = 1.0f / 32768.0f;
+  }
+  else
+  {
+    buffer_ = new juce::AudioSampleBuffer(reader->numChannels, numFrames);
+    reader->read(buffer_, 0, numFrames, 0, true, true);
+  }
+  if (numFrames < getNumFrames())
+  {
+    streamReader_ = std::move(reader);
   }
-  delete reader;
   return true;
 }
 
-sfzero::Sample::~Sample() { delete buffer_; }
+int sfzero::Sample::getNumChannels() const
+{
+  if (buffer_ != nullptr)
+  {
+    return buffer_->getNumChannels();
+  }
+  return (cachedBuffer_ != nullptr) ? cachedBuffer_->getNumChannels() : 0;
+}
+
+int sfzero::Sample::getNumLoadedFrames() const
+{
+  if (buffer_ != nullptr)
+  {
+    return buffer_->getNumSamples();
+  }
+  return (cachedBuffer_ != nullptr) ? cachedBuffer_->getNumFrames() : 0;
+}
+
+juce::int64 sfzero::Sample::getMemoryBytes() const
+{
+  if (cachedBuffer_ != nullptr)
+  {
+    return cachedBuffer_->getNumBytes();
+  }
+  return (buffer_ != nullptr) ? static_cast<juce::int64>(buffer_->getNumChannels()) * buffer_->getNumSamples() * sizeof(float) : 0;
+}
+
+void sfzero::Sample::setSharedBuffer(SampleCache::Buffer::Ptr buffer, float int16Scale)
+{
+  if (cachedBuffer_ == nullptr)
+  {
+    delete buffer_;
+  }
+  cachedBuffer_ = buffer;
+  buffer_ = ((buffer != nullptr) && !buffer->isInt16()) ? buffer->getSamples() : nullptr;
+  int16Scale_ = int16Scale;
+  sampleLength_ = (buffer != nullptr) ? buffer->getNumFrames() : 0;
+}
+
+void sfzero::Sample::readStreamFrames(juce::AudioSampleBuffer &dest, juce::int64 startFrame, int numFrames)
+{
+  jassert(streamReader_ != nullptr && numFrames <= dest.getNumSamples());
+  streamReader_->read(&dest, 0, numFrames, startFrame, true, true);
+}
+
+sfzero::Sample::~Sample()
+{
+  if (cachedBuffer_ == nullptr)
+  {
+    delete buffer_;
+  }
+}
 
 juce::String sfzero::Sample::getShortName() { return (file_.getFileName()); }
 
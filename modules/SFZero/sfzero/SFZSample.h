@@ -8,6 +8,7 @@
 #define SFZSAMPLE_H_INCLUDED
 
 #include "SFZCommon.h"
+#include "SFZSampleCache.h"
 
 namespace sfzero
 {
@@ -15,11 +16,57 @@ namespace sfzero
 class Sample
 {
 public:
-  explicit Sample(const juce::File &fileIn) : file_(fileIn), buffer_(nullptr), sampleRate_(0), sampleLength_(0), loopStart_(0), loopEnd_(0) {}
-  explicit Sample(double sampleRateIn) : buffer_(nullptr), sampleRate_(sampleRateIn), sampleLength_(0), loopStart_(0), loopEnd_(0) {}
+  explicit Sample(const juce::File &fileIn) : file_(fileIn), buffer_(nullptr), sampleRate_(0), sampleLength_(0), loopStart_(0), loopEnd_(0), streamPolicy_(canStream), format_(float32), int16Scale_(0) {}
+  explicit Sample(double sampleRateIn) : buffer_(nullptr), sampleRate_(sampleRateIn), sampleLength_(0), loopStart_(0), loopEnd_(0), streamPolicy_(canStream), format_(float32), int16Scale_(0) {}
   virtual ~Sample();
 
-  bool load(juce::AudioFormatManager *formatManager);
+  // With preloadSeconds > 0 the sample may stream: only its first preloadSeconds are read into
+  // the buffer and a SampleStreamer fetches the rest while a voice plays. Looping samples (see
+  // setStreamPolicy) are always loaded whole.
+  // With a cache, frames another Sound already decoded are shared rather than read again.
+  bool load(juce::AudioFormatManager *formatManager, double preloadSeconds = 0.0, SampleCache *cache = nullptr);
+
+  enum StreamPolicy
+  {
+    canStream,
+    streamUnlessLooped, // a region uses the sample's own loop points, if it has any
+    neverStream         // a region loops it
+  };
+  // Sound::loadSamples sets this from the regions that use the sample. Only ever tightens.
+  void setStreamPolicy(StreamPolicy policy) { streamPolicy_ = juce::jmax(streamPolicy_, policy); }
+
+  // How load() keeps the frames in memory: floats, or 16-bit integers that voices convert as they
+  // read them (half the memory; exact for 16-bit sources, rounded for deeper ones).
+  enum Format
+  {
+    float32,
+    int16
+  };
+  void setFormat(Format format) { format_ = format; }
+  Format getFormat() const { return format_; }
+
+  // The frames in memory, in whichever format they are stored: exactly one of getFloatData() and
+  // getInt16Data() is non-null once loaded. Int16 frames are scaled by getInt16Scale().
+  bool isLoaded() const { return (buffer_ != nullptr) || (getInt16Data(0) != nullptr); }
+  int getNumChannels() const;
+  int getNumLoadedFrames() const;
+  const float *getFloatData(int channel) const { return (buffer_ != nullptr) ? buffer_->getReadPointer(channel) : nullptr; }
+  const juce::int16 *getInt16Data(int channel) const
+  {
+    return ((cachedBuffer_ != nullptr) && cachedBuffer_->isInt16()) ? cachedBuffer_->getInt16Channel(channel) : nullptr;
+  }
+  float getInt16Scale() const { return int16Scale_; }
+  // Bytes of sample frames this Sample keeps in memory (shared buffers included).
+  juce::int64 getMemoryBytes() const;
+  // Makes the Sample use frames shared with others (SF2 sounds keep one buffer for all).
+  void setSharedBuffer(SampleCache::Buffer::Ptr buffer, float int16Scale);
+
+  bool isStreaming() const { return streamReader_ != nullptr; }
+  // Frames a voice may read: the sample plus the zeroed tail load() adds for interpolation. The
+  // buffer holds all of them unless the sample is streaming.
+  juce::int64 getNumFrames() const { return static_cast<juce::int64>(sampleLength_) + 4; }
+  // Streamer thread only: reads numFrames from startFrame into dest.
+  void readStreamFrames(juce::AudioSampleBuffer &dest, juce::int64 startFrame, int numFrames);
 
   juce::File getFile() { return (file_); }
   juce::AudioSampleBuffer *getBuffer() { return (buffer_); }
@@ -42,6 +89,11 @@ private:
   juce::AudioSampleBuffer *buffer_;
   double sampleRate_;
   juce::uint64 sampleLength_, loopStart_, loopEnd_;
+  StreamPolicy streamPolicy_;
+  std::unique_ptr<juce::AudioFormatReader> streamReader_;
+  SampleCache::Buffer::Ptr cachedBuffer_; // owns buffer_ when set
+  Format format_;
+  float int16Scale_;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Sample)
 };
@@ -0,0 +1,314 @@
+/*************************************************************************************
+ * Original code copyright (C) 2012 Steve Folta
+ * Converted to Juce module (C) 2016 Leo Olivers
+ * Forked from https://github.com/stevefolta/SFZero
+ * For license info please see the LICENSE file distributed with this source code
+ *************************************************************************************/
+#include "SFZSampleCache.h"
+#include "SFZDiskSampleCache.h"
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+#include <sys/mman.h>
+#endif
+
+sfzero::SampleCache::SampleCache(juce::int64 maxUnusedBytes) : maxUnusedBytes_(maxUnusedBytes) {}
+
+sfzero::SampleCache::~SampleCache() {}
+
+juce::int64 sfzero::SampleCache::Buffer::getNumBytes() const
+{
+  return static_cast<juce::int64>(numChannels_) * numFrames_ *
+         static_cast<juce::int64>(int16_ ? sizeof(juce::int16) : sizeof(float));
+}
+
+void sfzero::SampleCache::Buffer::allocateInt16(int numChannels, int numFrames)
+{
+  numChannels_ = numChannels;
+  numFrames_ = numFrames;
+  int16_ = true;
+  samples_.setSize(0, 0);
+  mapping_.reset();
+  int16Samples_.allocate(static_cast<size_t>(numChannels) * static_cast<size_t>(numFrames), true);
+  int16Data_ = int16Samples_.get();
+}
+
+// Reads one byte of every page of [data, data + numBytes), so the pages are resident before a voice
+// plays them; otherwise the first note of each sample would wait on the disk, on the audio thread.
+static void touchEveryPage(const char *data, size_t numBytes)
+{
+  const size_t pageBytes = 4096; // the smallest page size we run on; larger pages are just touched more than once
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+  // Start read-ahead of the whole range, so the touches below mostly find their pages loaded.
+  const auto start = reinterpret_cast<juce::pointer_sized_uint>(data) & ~static_cast<juce::pointer_sized_uint>(pageBytes - 1);
+  posix_madvise(reinterpret_cast<void *>(start), numBytes + (reinterpret_cast<juce::pointer_sized_uint>(data) - start),
+                POSIX_MADV_WILLNEED);
+#endif
+  volatile char sink = 0;
+  for (size_t offset = 0; offset < numBytes; offset += pageBytes)
+  {
+    sink = data[offset];
+  }
+  if (numBytes > 0)
+  {
+    sink = data[numBytes - 1];
+  }
+  juce::ignoreUnused(sink);
+}
+
+void sfzero::SampleCache::Buffer::referTo(std::unique_ptr<juce::MemoryMappedFile> mapping, size_t dataOffset, int numChannels,
+                                          int numFrames, bool asInt16)
+{
+  mapping_ = std::move(mapping);
+  numChannels_ = numChannels;
+  numFrames_ = numFrames;
+  int16_ = asInt16;
+  int16Samples_.free();
+  char *data = static_cast<char *>(mapping_->getData()) + dataOffset;
+  touchEveryPage(data, static_cast<size_t>(getNumBytes()));
+  if (asInt16)
+  {
+    samples_.setSize(0, 0);
+    int16Data_ = reinterpret_cast<juce::int16 *>(data);
+    return;
+  }
+  int16Data_ = nullptr;
+  std::vector<float *> channels(static_cast<size_t>(numChannels));
+  for (int channel = 0; channel < numChannels; ++channel)
+  {
+    channels[static_cast<size_t>(channel)] = reinterpret_cast<float *>(data) + static_cast<size_t>(channel) * numFrames;
+  }
+  samples_.setDataToReferTo(channels.data(), numChannels, numFrames);
+}
+
+bool sfzero::SampleCache::Buffer::read(juce::AudioFormatReader &reader, int numFrames, bool asInt16)
+{
+  const int numChannels = static_cast<int>(reader.numChannels);
+  if (!asInt16)
+  {
+    numChannels_ = numChannels;
+    numFrames_ = numFrames;
+    int16_ = false;
+    mapping_.reset();
+    samples_.setSize(numChannels, numFrames);
+    return reader.read(&samples_, 0, numFrames, 0, true, true);
+  }
+
+  allocateInt16(numChannels, numFrames);
+
+  // Integer formats come back left-justified in 32 bits, floating-point ones as floats.
+  enum
+  {
+    chunkFrames = 16384,
+  };
+  juce::HeapBlock<int> scratch(static_cast<size_t>(numChannels) * chunkFrames);
+  std::vector<int *> channels(static_cast<size_t>(numChannels));
+  for (int channel = 0; channel < numChannels; ++channel)
+  {
+    channels[static_cast<size_t>(channel)] = scratch.get() + static_cast<size_t>(channel) * chunkFrames;
+  }
+
+  for (int start = 0; start < numFrames; start += chunkFrames)
+  {
+    const int count = juce::jmin(static_cast<int>(chunkFrames), numFrames - start);
+    if (!reader.read(channels.data(), numChannels, start, count, false))
+    {
+      return false;
+    }
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+      const int *source = channels[static_cast<size_t>(channel)];
+      juce::int16 *dest = getInt16Channel(channel) + start;
+      if (reader.usesFloatingPointData)
+      {
+        const float *floats = reinterpret_cast<const float *>(source);
+        for (int i = 0; i < count; ++i)
+        {
+          dest[i] = static_cast<juce::int16>(juce::jlimit(-32768, 32767, juce::roundToInt(floats[i] * 32768.0f)));
+        }
+      }
+      else
+      {
+        for (int i = 0; i < count; ++i)
+        {
+          dest[i] = static_cast<juce::int16>(juce::jmin(32767, (source[i] >> 16) + ((source[i] >> 15) & 1)));
+        }
+      }
+    }
+  }
+  return true;
+}
+
+sfzero::SampleCache::FileInfo sfzero::SampleCache::FileInfo::of(const juce::AudioFormatReader &reader)
+{
+  FileInfo info;
+  info.sampleRate = reader.sampleRate;
+  info.lengthInSamples = reader.lengthInSamples;
+  info.numLoops = reader.metadataValues.getValue("NumSampleLoops", "0").getIntValue();
+  if (info.numLoops > 0)
+  {
+    info.loopStart = reader.metadataValues.getValue("Loop0Start", "0").getLargeIntValue();
+    info.loopEnd = reader.metadataValues.getValue("Loop0End", "0").getLargeIntValue();
+  }
+  return info;
+}
+
+juce::String sfzero::SampleCache::fileKey(const juce::File &file)
+{
+  juce::String key = file.getFullPathName();
+  key << '|' << file.getSize() << '|' << file.getLastModificationTime().toMilliseconds();
+  return key;
+}
+
+juce::String sfzero::SampleCache::entryKey(const juce::String &fileKey, int numFrames, bool asInt16)
+{
+  juce::String key = fileKey;
+  key << '|' << numFrames << (asInt16 ? "|i16" : "");
+  return key;
+}
+
+bool sfzero::SampleCache::findInfo(const juce::String &fileKey, FileInfo &info) const
+{
+  const juce::ScopedLock locker(lock_);
+  const auto found = fileInfos_.find(fileKey);
+  if (found == fileInfos_.end())
+  {
+    return false;
+  }
+  info = found->second;
+  return true;
+}
+
+sfzero::SampleCache::Buffer::Ptr sfzero::SampleCache::findLoaded(const juce::String &fileKey, int numFrames, bool asInt16)
+{
+  Buffer::Ptr buffer;
+  {
+    const juce::ScopedLock locker(lock_);
+    const auto found = entries_.find(entryKey(fileKey, numFrames, asInt16));
+    if (found == entries_.end())
+    {
+      return nullptr;
+    }
+    buffer = found->second;
+    buffer->lastUsed_ = ++useCounter_;
+  }
+
+  // Another Sound may be decoding it right now; it's a hit once that finishes.
+  const juce::ScopedLock loadLocker(buffer->loadLock_);
+  if (!buffer->loaded_)
+  {
+    return nullptr;
+  }
+  numHits_.fetch_add(1);
+  return buffer;
+}
+
+sfzero::SampleCache::Buffer::Ptr sfzero::SampleCache::getOrLoad(const juce::File &file, juce::AudioFormatReader &reader,
+                                                                int numFrames, bool asInt16)
+{
+  const juce::String fileKeyNow = fileKey(file);
+  const juce::String key = entryKey(fileKeyNow, numFrames, asInt16);
+
+  Buffer::Ptr buffer;
+  {
+    const juce::ScopedLock locker(lock_);
+    fileInfos_[fileKeyNow] = FileInfo::of(reader);
+    Buffer::Ptr &entry = entries_[key];
+    if (entry == nullptr)
+    {
+      entry = new Buffer();
+    }
+    buffer = entry;
+    buffer->lastUsed_ = ++useCounter_;
+  }
+
+  // Decode outside lock_, so different samples load in parallel.
+  const juce::ScopedLock loadLocker(buffer->loadLock_);
+  if (buffer->loaded_)
+  {
+    numHits_.fetch_add(1);
+    return buffer;
+  }
+
+  if ((diskCache_ != nullptr) && diskCache_->read(key, *buffer))
+  {
+    numDiskHits_.fetch_add(1);
+  }
+  else
+  {
+    if (!buffer->read(reader, numFrames, asInt16))
+    {
+      return nullptr;
+    }
+    numDecodes_.fetch_add(1);
+    if (diskCache_ != nullptr)
+    {
+      diskCache_->write(key, *buffer);
+    }
+  }
+  buffer->loaded_ = true;
+
+  const juce::ScopedLock locker(lock_);
+  trimUnused(maxUnusedBytes_);
+  return buffer;
+}
+
+void sfzero::SampleCache::setMaxUnusedBytes(juce::int64 bytes)
+{
+  const juce::ScopedLock locker(lock_);
+  maxUnusedBytes_ = bytes;
+  trimUnused(maxUnusedBytes_);
+}
+
+void sfzero::SampleCache::purgeUnused()
+{
+  const juce::ScopedLock locker(lock_);
+  trimUnused(0);
+}
+
+int sfzero::SampleCache::getNumEntries() const
+{
+  const juce::ScopedLock locker(lock_);
+  return static_cast<int>(entries_.size());
+}
+
+juce::int64 sfzero::SampleCache::getNumBytes() const
+{
+  const juce::ScopedLock locker(lock_);
+  juce::int64 bytes = 0;
+  for (const auto &entry : entries_)
+  {
+    bytes += entry.second->getNumBytes();
+  }
+  return bytes;
+}
+
+void sfzero::SampleCache::trimUnused(juce::int64 maxBytes)
+{
+  // An entry only the cache references is unused; one still loading is referenced by its loader.
+  juce::int64 unusedBytes = 0;
+  for (const auto &entry : entries_)
+  {
+    if (entry.second->getReferenceCount() == 1)
+    {
+      unusedBytes += entry.second->getNumBytes();
+    }
+  }
+
+  while (unusedBytes > maxBytes)
+  {
+    auto oldest = entries_.end();
+    for (auto it = entries_.begin(); it != entries_.end(); ++it)
+    {
+      if ((it->second->getReferenceCount() == 1) && ((oldest == entries_.end()) || (it->second->lastUsed_ < oldest->second->lastUsed_)))
+      {
+        oldest = it;
+      }
+    }
+    if (oldest == entries_.end())
+    {
+      break;
+    }
+    unusedBytes -= oldest->second->getNumBytes();
+    entries_.erase(oldest);
+  }
+}
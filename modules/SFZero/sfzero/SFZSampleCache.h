@@ -0,0 +1,129 @@
+/*************************************************************************************
+ * Original code copyright (C) 2012 Steve Folta
+ * Converted to Juce module (C) 2016 Leo Olivers
+ * Forked from https://github.com/stevefolta/SFZero
+ * For license info please see the LICENSE file distributed with this source code
+ *************************************************************************************/
+#ifndef SFZSAMPLECACHE_H_INCLUDED
+#define SFZSAMPLECACHE_H_INCLUDED
+
+#include "SFZCommon.h"
+
+namespace sfzero
+{
+
+class DiskSampleCache;
+
+// Decoded sample frames shared between Sounds. Entries are keyed by file path, size, modification
+// time, the number of frames loaded and the storage format, so an edited file is decoded again and
+// a streamed head is never mistaken for the whole sample. Samples hold their buffer by reference
+// count; entries nobody uses any more stay cached, least recently used dropped first, up to
+// setMaxUnusedBytes. With a DiskSampleCache attached, frames decoded once are found there on later
+// runs instead of being decoded again.
+class SampleCache
+{
+public:
+  class Buffer : public juce::ReferenceCountedObject
+  {
+  public:
+    typedef juce::ReferenceCountedObjectPtr<Buffer> Ptr;
+
+    // Frames are stored as floats, or as 16-bit integers that voices convert as they read them
+    // (half the memory; exact for 16-bit sources, rounded for deeper ones).
+    bool isInt16() const { return int16_; }
+    int getNumChannels() const { return numChannels_; }
+    int getNumFrames() const { return numFrames_; }
+    juce::int64 getNumBytes() const;
+
+    // Float storage only.
+    const juce::AudioSampleBuffer &getSamples() const { return samples_; }
+    juce::AudioSampleBuffer *getSamples() { return &samples_; }
+    // Int16 storage only.
+    const juce::int16 *getInt16Channel(int channel) const { return int16Data_ + static_cast<size_t>(channel) * numFrames_; }
+    juce::int16 *getInt16Channel(int channel) { return int16Data_ + static_cast<size_t>(channel) * numFrames_; }
+
+    // Int16 storage for numChannels x numFrames frames, zeroed. For sources not read through an
+    // AudioFormatReader (SF2).
+    void allocateInt16(int numChannels, int numFrames);
+    // Reads frames [0, numFrames) from reader; frames past its end are zero.
+    bool read(juce::AudioFormatReader &reader, int numFrames, bool asInt16);
+    // Uses the planar frames at dataOffset in mapping rather than a copy. Nothing writes sample
+    // frames once loaded, so a read-only mapping is fine. Every page of the frames is read in here,
+    // on the loading thread, so voices never fault on them.
+    void referTo(std::unique_ptr<juce::MemoryMappedFile> mapping, size_t dataOffset, int numChannels, int numFrames, bool asInt16);
+    bool isMapped() const { return mapping_ != nullptr; }
+
+  private:
+    friend class SampleCache;
+
+    juce::AudioSampleBuffer samples_;
+    juce::HeapBlock<juce::int16> int16Samples_;
+    juce::int16 *int16Data_ = nullptr; // int16Samples_, or into mapping_
+    std::unique_ptr<juce::MemoryMappedFile> mapping_;
+    int numChannels_ = 0, numFrames_ = 0;
+    bool int16_ = false;
+    juce::CriticalSection loadLock_; // held while the first user decodes, so the others wait for it
+    bool loaded_ = false;
+    juce::uint32 lastUsed_ = 0;
+  };
+
+  // What Sample::load needs from a file's header. Kept for every file loaded through the cache,
+  // so a later load of the same file can find its frames without opening it.
+  struct FileInfo
+  {
+    double sampleRate = 0.0;
+    juce::int64 lengthInSamples = 0;
+    int numLoops = 0;
+    juce::int64 loopStart = 0, loopEnd = 0;
+
+    static FileInfo of(const juce::AudioFormatReader &reader);
+  };
+
+  explicit SampleCache(juce::int64 maxUnusedBytes = 256 * 1024 * 1024);
+  ~SampleCache();
+
+  // Identifies what a file holds now: its path, size and modification time.
+  static juce::String fileKey(const juce::File &file);
+
+  // The header of the file with this key, if it has been loaded through the cache; never opens it.
+  bool findInfo(const juce::String &fileKey, FileInfo &info) const;
+  // Frames [0, numFrames) of the file with this key if they're decoded already; otherwise nullptr,
+  // and the caller opens a reader and calls getOrLoad.
+  Buffer::Ptr findLoaded(const juce::String &fileKey, int numFrames, bool asInt16 = false);
+
+  // Returns frames [0, numFrames) of file, decoding them with reader unless another Sound already
+  // has; nullptr if they can't be read. Thread-safe: concurrent loads of the same entry decode it
+  // once.
+  Buffer::Ptr getOrLoad(const juce::File &file, juce::AudioFormatReader &reader, int numFrames, bool asInt16 = false);
+
+  // Looks frames up in diskCache before decoding them, and stores what it decodes there. Call
+  // before loading anything; nullptr detaches.
+  void setDiskCache(DiskSampleCache *diskCache) { diskCache_ = diskCache; }
+
+  void setMaxUnusedBytes(juce::int64 bytes);
+  // Drops every entry no Sample is using.
+  void purgeUnused();
+
+  int getNumEntries() const;
+  juce::int64 getNumBytes() const;
+  int getNumDecodes() const { return numDecodes_.load(); }
+  int getNumHits() const { return numHits_.load(); }
+  int getNumDiskHits() const { return numDiskHits_.load(); }
+
+private:
+  juce::CriticalSection lock_;
+  std::map<juce::String, Buffer::Ptr> entries_;
+  std::map<juce::String, FileInfo> fileInfos_; // by fileKey; a few bytes per file, never trimmed
+  juce::int64 maxUnusedBytes_;
+  juce::uint32 useCounter_ = 0;
+  DiskSampleCache *diskCache_ = nullptr;
+  std::atomic<int> numDecodes_{0}, numHits_{0}, numDiskHits_{0};
+
+  void trimUnused(juce::int64 maxBytes); // lock_ held
+  static juce::String entryKey(const juce::String &fileKey, int numFrames, bool asInt16);
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleCache)
+};
+}
+
+#endif // SFZSAMPLECACHE_H_INCLUDED
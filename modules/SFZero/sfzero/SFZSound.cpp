@@ -8,8 +8,14 @@
 #include "SFZReader.h"
 #include "SFZRegion.h"
 #include "SFZSample.h"
+#include "SFZStreamer.h"
 
-sfzero::Sound::Sound(const juce::File &fileIn) : file_(fileIn) {}
+sfzero::Sound::Sound(const juce::File &fileIn)
+    : file_(fileIn), streamer_(nullptr), preloadSeconds_(0.0), sampleCache_(nullptr), int16Samples_(false),
+      loadPool_(nullptr), numLoadThreads_(juce::jlimit(1, 8, juce::SystemStats::getNumCpus())), numVelocityLayers_(0), numRegionsIndexed_(-1)
+{
+  std::fill(std::begin(velocityLayers_), std::end(velocityLayers_), 0);
+}
 sfzero::Sound::~Sound()
 {
   int numRegions = regions_.size();
@@ -33,7 +39,12 @@ bool sfzero::Sound::appliesToNote(int /*midiNoteNumber*/)
 }
 
 bool sfzero::Sound::appliesToChannel(int /*midiChannel*/) { return true; }
-void sfzero::Sound::addRegion(sfzero::Region *region) { regions_.add(region); }
+void sfzero::Sound::addRegion(sfzero::Region *region)
+{
+  regions_.add(region);
+  allRegionIndices_.push_back(regions_.size() - 1);
+}
+
 sfzero::Sample *sfzero::Sound::addSample(juce::String path, juce::String defaultPath)
 {
   path = path.replaceCharacter('\\', '/');
@@ -71,11 +82,18 @@ void sfzero::Sound::addUnsupportedOpcode(const juce::String &opcode)
   }
 }
 
+void sfzero::Sound::setStreaming(sfzero::SampleStreamer *streamer, double preloadSeconds)
+{
+  streamer_ = streamer;
+  preloadSeconds_ = (streamer != nullptr) ? preloadSeconds : 0.0;
+}
+
 void sfzero::Sound::loadRegions()
 {
   sfzero::Reader reader(this);
 
   reader.read(file_);
+  buildRegionIndex();
 }
 
 void sfzero::Sound::loadSamples(juce::AudioFormatManager *formatManager, double *progressVar, juce::Thread *thread)
@@ -85,24 +103,104 @@ void sfzero::Sound::loadSamples(juce::AudioFormatManager *formatManager, double
     *progressVar = 0.0;
   }
 
-  double numSamplesLoaded = 1.0, numSamples = samples_.size();
-  for (juce::HashMap<juce::String, sfzero::Sample *>::Iterator i(samples_); i.next();)
+  if (preloadSeconds_ > 0.0)
   {
-    sfzero::Sample *sample = i.getValue();
-    bool ok = sample->load(formatManager);
-    if (!ok)
+    // Looping samples stay in memory: the streamer only reads forwards.
+    for (sfzero::Region *region : regions_)
     {
-      addError("Couldn't load sample \"" + sample->getShortName() + "\"");
+      if ((region->sample == nullptr) || (region->loop_mode == sfzero::Region::no_loop) ||
+          (region->loop_mode == sfzero::Region::one_shot))
+      {
+        continue;
+      }
+      region->sample->setStreamPolicy(region->loop_mode == sfzero::Region::sample_loop ? sfzero::Sample::streamUnlessLooped
+                                                                                      : sfzero::Sample::neverStream);
     }
+    streamer_->prepare();
+  }
 
-    numSamplesLoaded += 1.0;
-    if (progressVar)
+  std::vector<sfzero::Sample *> samples;
+  for (juce::HashMap<juce::String, sfzero::Sample *>::Iterator i(samples_); i.next();)
+  {
+    i.getValue()->setFormat(int16Samples_ ? sfzero::Sample::int16 : sfzero::Sample::float32);
+    samples.push_back(i.getValue());
+  }
+  const int numSamples = static_cast<int>(samples.size());
+
+  // Decode on this thread plus jobs on the shared load pool. Only this thread writes progressVar and
+  // errors_, and it watches for thread exit: cancelling stops the workers taking more samples.
+  std::atomic<int> nextSample{0}, numSamplesLoaded{0};
+  std::atomic<bool> cancelled{false};
+  std::vector<char> loaded(samples.size(), 0);
+  auto loadNext = [&]() -> bool
+  {
+    const int index = cancelled.load() ? numSamples : nextSample.fetch_add(1);
+    if (index >= numSamples)
+    {
+      return false;
+    }
+    loaded[static_cast<size_t>(index)] = samples[static_cast<size_t>(index)]->load(formatManager, preloadSeconds_, sampleCache_);
+    numSamplesLoaded.fetch_add(1);
+    return true;
+  };
+  auto reportProgress = [&]()
+  {
+    if (progressVar && (numSamples > 0))
     {
-      *progressVar = numSamplesLoaded / numSamples;
+      *progressVar = static_cast<double>(numSamplesLoaded.load()) / numSamples;
     }
     if (thread && thread->threadShouldExit())
     {
-      return;
+      cancelled.store(true);
+    }
+  };
+
+  struct LoadJob : public juce::ThreadPoolJob
+  {
+    explicit LoadJob(std::function<bool()> &next) : juce::ThreadPoolJob("SFZ sample load"), loadNext(next) {}
+
+    JobStatus runJob() override
+    {
+      while (loadNext())
+      {
+      }
+      return jobHasFinished;
+    }
+
+    std::function<bool()> &loadNext;
+  };
+
+  std::function<bool()> next(loadNext);
+  std::vector<std::unique_ptr<LoadJob>> jobs;
+  const int numWorkers = (loadPool_ != nullptr) ? juce::jmin(numLoadThreads_, numSamples) - 1 : 0;
+  for (int i = 0; i < numWorkers; ++i)
+  {
+    jobs.push_back(std::make_unique<LoadJob>(next));
+    loadPool_->addJob(jobs.back().get(), false);
+  }
+  while (loadNext())
+  {
+    reportProgress();
+  }
+  // Every sample has been taken. Jobs still queued behind other sounds' loads are dropped; the ones
+  // running refer to this frame, so they must finish, not be interrupted, before it goes. removeJob
+  // sleeps on the pool's job-finished event rather than polling.
+  for (auto &job : jobs)
+  {
+    loadPool_->removeJob(job.get(), false, -1);
+  }
+  reportProgress();
+
+  if (cancelled.load())
+  {
+    return;
+  }
+
+  for (int i = 0; i < numSamples; ++i)
+  {
+    if (!loaded[static_cast<size_t>(i)])
+    {
+      addError("Couldn't load sample \"" + samples[static_cast<size_t>(i)]->getShortName() + "\"");
     }
   }
 
@@ -112,11 +210,21 @@ void sfzero::Sound::loadSamples(juce::AudioFormatManager *formatManager, double
   }
 }
 
-sfzero::Region *sfzero::Sound::getRegionFor(int note, int velocity, sfzero::Region::Trigger trigger)
+juce::int64 sfzero::Sound::getMemoryBytes()
 {
-  int numRegions = regions_.size();
+  juce::int64 bytes = 0;
+  for (juce::HashMap<juce::String, sfzero::Sample *>::Iterator i(samples_); i.next();)
+  {
+    bytes += i.getValue()->getMemoryBytes();
+  }
+  return bytes;
+}
 
-  for (int i = 0; i < numRegions; ++i)
+void sfzero::Sound::setNumLoadThreads(int numThreads) { numLoadThreads_ = juce::jmax(1, numThreads); }
+
+sfzero::Region *sfzero::Sound::getRegionFor(int note, int velocity, sfzero::Region::Trigger trigger)
+{
+  for (int i : getRegionIndicesFor(note, velocity, trigger))
   {
     sfzero::Region *region = regions_[i];
     if (region->matches(note, velocity, trigger))
@@ -128,6 +236,94 @@ sfzero::Region *sfzero::Sound::getRegionFor(int note, int velocity, sfzero::Regi
   return nullptr;
 }
 
+sfzero::Sound::RegionIndices sfzero::Sound::getRegionIndicesFor(int note, int velocity, sfzero::Region::Trigger trigger)
+{
+  if (!regionIndexIsValid() || (note < 0) || (note >= numIndexedNotes) || (velocity < 0) || (velocity > 127) ||
+      (static_cast<int>(trigger) >= numTriggers))
+  {
+    const int *all = allRegionIndices_.data();
+    return {all, all + juce::jmin(static_cast<int>(allRegionIndices_.size()), regions_.size())};
+  }
+
+  const size_t cell = (static_cast<size_t>(note) * numVelocityLayers_ + velocityLayers_[velocity]) * numTriggers + trigger;
+  const int *regions = indexedRegions_.data();
+  return {regions + indexStarts_[cell], regions + indexStarts_[cell + 1]};
+}
+
+void sfzero::Sound::buildRegionIndex()
+{
+  const int numRegions = regions_.size();
+  allRegionIndices_.resize(numRegions);
+  for (int i = 0; i < numRegions; ++i)
+  {
+    allRegionIndices_[i] = i;
+  }
+
+  // Velocity layers: a new layer starts at every lovel and after every hivel.
+  bool layerStarts[129] = {};
+  layerStarts[0] = true;
+  for (sfzero::Region *region : regions_)
+  {
+    layerStarts[juce::jlimit(0, 128, region->lovel)] = true;
+    layerStarts[juce::jlimit(0, 128, region->hivel + 1)] = true;
+  }
+  numVelocityLayers_ = 0;
+  for (int velocity = 0; velocity < 128; ++velocity)
+  {
+    if (layerStarts[velocity])
+    {
+      numVelocityLayers_ += 1;
+    }
+    velocityLayers_[velocity] = numVelocityLayers_ - 1;
+  }
+
+  // Calls fn(cell) for every cell the region belongs to.
+  auto forEachCell = [this](const sfzero::Region *region, auto &&fn)
+  {
+    const int loKey = juce::jmax(0, region->lokey), hiKey = juce::jmin(numIndexedNotes - 1, region->hikey);
+    const int loVel = juce::jmax(0, region->lovel), hiVel = juce::jmin(127, region->hivel);
+    if ((loKey > hiKey) || (loVel > hiVel))
+    {
+      return;
+    }
+    for (int key = loKey; key <= hiKey; ++key)
+    {
+      for (int layer = velocityLayers_[loVel]; layer <= velocityLayers_[hiVel]; ++layer)
+      {
+        for (int trigger = 0; trigger < numTriggers; ++trigger)
+        {
+          if ((trigger == region->trigger) ||
+              ((region->trigger == sfzero::Region::attack) &&
+               ((trigger == sfzero::Region::first) || (trigger == sfzero::Region::legato))))
+          {
+            fn((static_cast<size_t>(key) * numVelocityLayers_ + layer) * numTriggers + trigger);
+          }
+        }
+      }
+    }
+  };
+
+  // Count, prefix-sum, then fill in region order so each cell's list is sorted.
+  const size_t numCells = static_cast<size_t>(numIndexedNotes) * numVelocityLayers_ * numTriggers;
+  indexStarts_.assign(numCells + 1, 0);
+  for (sfzero::Region *region : regions_)
+  {
+    forEachCell(region, [this](size_t cell) { indexStarts_[cell + 1] += 1; });
+  }
+  for (size_t cell = 0; cell < numCells; ++cell)
+  {
+    indexStarts_[cell + 1] += indexStarts_[cell];
+  }
+  indexedRegions_.resize(indexStarts_[numCells]);
+  std::vector<int> fill(indexStarts_.begin(), indexStarts_.end() - 1);
+  for (int i = 0; i < numRegions; ++i)
+  {
+    forEachCell(regions_[i], [&](size_t cell) { indexedRegions_[fill[cell]++] = i; });
+  }
+
+  numRegionsIndexed_ = numRegions;
+}
+
 int sfzero::Sound::getNumRegions() { return regions_.size(); }
 
 sfzero::Region *sfzero::Sound::regionAt(int index) { return regions_[index]; }
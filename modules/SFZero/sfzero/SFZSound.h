@@ -13,6 +13,8 @@ namespace sfzero
 {
 
 class Sample;
+class SampleCache;
+class SampleStreamer;
 
 class Sound : public juce::SynthesiserSound
 {
@@ -30,11 +32,53 @@ public:
   void addError(const juce::String &message);
   void addUnsupportedOpcode(const juce::String &opcode);
 
+  // Makes loadSamples() load only the first preloadSeconds of each sample that doesn't loop and
+  // stream the rest through streamer. Call before loadSamples(); the streamer must outlive every
+  // voice playing this sound.
+  void setStreaming(SampleStreamer *streamer, double preloadSeconds);
+  SampleStreamer *getStreamer() const { return streamer_; }
+
+  // Makes loadSamples() share decoded frames through cache instead of reading every sample
+  // itself. Call before loadSamples().
+  void setSampleCache(SampleCache *cache) { sampleCache_ = cache; }
+
+  // Makes loadSamples() keep frames as 16-bit integers (Sample::int16) rather than floats: half
+  // the memory, for a conversion in every voice's inner loop. Call before loadSamples().
+  void setInt16Samples(bool int16) { int16Samples_ = int16; }
+  bool getInt16Samples() const { return int16Samples_; }
+
+  // Bytes of sample frames this sound keeps in memory, counting frames shared with other sounds.
+  virtual juce::int64 getMemoryBytes();
+
+  // Makes loadSamples() decode on threads borrowed from pool as well as its caller. One pool is
+  // shared by every sound being loaded, so concurrent loads don't each start their own threads.
+  // Without one, loadSamples() decodes on the calling thread only. Call before loadSamples().
+  void setLoadPool(juce::ThreadPool *pool) { loadPool_ = pool; }
+
+  // Threads loadSamples() decodes on, its caller included, when it has a load pool. Defaults to
+  // one per core, at most 8.
+  void setNumLoadThreads(int numThreads);
+  int getNumLoadThreads() const { return numLoadThreads_; }
+
   virtual void loadRegions();
   virtual void loadSamples(juce::AudioFormatManager *formatManager, double *progressVar = nullptr,
                            juce::Thread *thread = nullptr);
 
   Region *getRegionFor(int note, int velocity, Region::Trigger trigger = Region::attack);
+
+  // Indices (into regionAt()) of the regions matching note, velocity and trigger, in region order.
+  // Answered from the lookup index without scanning; if the index is out of date this falls back
+  // to every region, so callers that need exact matches still check Region::matches().
+  struct RegionIndices
+  {
+    const int *first, *last;
+    const int *begin() const { return first; }
+    const int *end() const { return last; }
+    int size() const { return static_cast<int>(last - first); }
+  };
+  RegionIndices getRegionIndicesFor(int note, int velocity, Region::Trigger trigger);
+  // Rebuilds the lookup index. loadRegions() calls this; so must anything that edits getRegions().
+  void buildRegionIndex();
   int getNumRegions();
   Region *regionAt(int index);
 
@@ -57,6 +101,29 @@ private:
   juce::StringArray errors_;
   juce::StringArray warnings_;
   juce::HashMap<juce::String, juce::String> unsupportedOpcodes_;
+  SampleStreamer *streamer_;
+  double preloadSeconds_;
+  SampleCache *sampleCache_;
+  bool int16Samples_;
+  juce::ThreadPool *loadPool_;
+  int numLoadThreads_;
+
+  // The lookup index: velocities are grouped into layers (runs with the same set of lovel/hivel
+  // ranges covering them), and each (note, layer, trigger) cell lists its regions in
+  // indexedRegions_[indexStarts_[cell] .. indexStarts_[cell + 1]).
+  enum
+  {
+    numIndexedNotes = 128,
+    numTriggers = 4,
+  };
+  int velocityLayers_[128];
+  int numVelocityLayers_;
+  int numRegionsIndexed_;
+  std::vector<int> indexStarts_;
+  std::vector<int> indexedRegions_;
+  std::vector<int> allRegionIndices_;
+
+  bool regionIndexIsValid() const { return numRegionsIndexed_ == regions_.size(); }
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Sound)
 };
@@ -0,0 +1,196 @@
+/*************************************************************************************
+ * Original code copyright (C) 2012 Steve Folta
+ * Converted to Juce module (C) 2016 Leo Olivers
+ * Forked from https://github.com/stevefolta/SFZero
+ * For license info please see the LICENSE file distributed with this source code
+ *************************************************************************************/
+#include "SFZStreamer.h"
+#include "SFZSample.h"
+#include "SFZSound.h"
+
+sfzero::SampleStreamer::SampleStreamer(int numStreams, int ringFrames)
+    : juce::Thread("SFZ sample streamer"), numStreams_(juce::jmax(1, numStreams)),
+      ringFrames_(juce::nextPowerOfTwo(juce::jmax(static_cast<int>(chunkFrames), ringFrames)))
+{
+}
+
+sfzero::SampleStreamer::~SampleStreamer() { stopThread(2000); }
+
+void sfzero::SampleStreamer::prepare()
+{
+  const juce::ScopedLock locker(prepareLock_);
+
+  if (isPrepared())
+  {
+    return;
+  }
+
+  streams_.reset(new Stream[static_cast<size_t>(numStreams_)]);
+  for (int i = 0; i < numStreams_; ++i)
+  {
+    for (auto &channel : streams_[i].ring_)
+    {
+      channel.assign(static_cast<size_t>(ringFrames_), 0.0f);
+    }
+    streams_[i].mask_ = static_cast<size_t>(ringFrames_ - 1);
+  }
+  scratch_.setSize(2, chunkFrames);
+
+  prepared_.store(true, std::memory_order_release);
+  startThread();
+}
+
+sfzero::SampleStreamer::Stream *sfzero::SampleStreamer::open(Sound *sound, Sample *sample, juce::int64 startFrame)
+{
+  if (!isPrepared())
+  {
+    numStreamsRefused_.fetch_add(1);
+    return nullptr;
+  }
+
+  // Round-robin from where the last search stopped, so a free stream is usually found at once.
+  const int first = nextStream_.load(std::memory_order_relaxed);
+  for (int n = 0; n < numStreams_; ++n)
+  {
+    const int index = (first + n) % numStreams_;
+    Stream &stream = streams_[index];
+    int expected = Stream::free;
+    if (!stream.state_.compare_exchange_strong(expected, Stream::claimed, std::memory_order_acquire))
+    {
+      continue;
+    }
+
+    stream.sound_ = sound;
+    stream.sample_ = sample;
+    stream.numChannels_ = juce::jmin(2, sample->getNumChannels());
+    stream.startFrame_ = startFrame;
+    stream.endFrame_ = sample->getNumFrames();
+    stream.writtenEnd_.store(startFrame, std::memory_order_relaxed);
+    stream.readPosition_.store(startFrame, std::memory_order_relaxed);
+    stream.state_.store(Stream::active, std::memory_order_release);
+
+    nextStream_.store((index + 1) % numStreams_, std::memory_order_relaxed);
+    numOpenStreams_.fetch_add(1);
+    workPending_.store(true, std::memory_order_release);
+    return &stream;
+  }
+
+  numStreamsRefused_.fetch_add(1);
+  return nullptr;
+}
+
+void sfzero::SampleStreamer::close(Stream *stream)
+{
+  if (stream != nullptr)
+  {
+    // The sound reference is dropped on the reader thread, so a sound deleted when its last
+    // voice stops is not freed on the audio thread.
+    stream->state_.store(Stream::closing, std::memory_order_release);
+    workPending_.store(true, std::memory_order_release);
+  }
+}
+
+bool sfzero::SampleStreamer::waitUntilFilled(int timeoutMs)
+{
+  if (!isPrepared())
+  {
+    return true;
+  }
+
+  const juce::uint32 deadline = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(juce::jmax(0, timeoutMs));
+  for (;;)
+  {
+    bool filled = true;
+    for (int i = 0; (i < numStreams_) && filled; ++i)
+    {
+      const Stream &stream = streams_[i];
+      filled = (stream.state_.load(std::memory_order_acquire) != Stream::active) || isFilled(stream, ringFrames_);
+    }
+    if (filled)
+    {
+      return true;
+    }
+    if (juce::Time::getMillisecondCounter() >= deadline)
+    {
+      return false;
+    }
+    wakeUp_.signal();
+    juce::Thread::sleep(1);
+  }
+}
+
+bool sfzero::SampleStreamer::isFilled(const Stream &stream, int ringFrames)
+{
+  const juce::int64 readPosition = stream.readPosition_.load(std::memory_order_acquire);
+  const juce::int64 limit = juce::jmin(readPosition + ringFrames, stream.endFrame_);
+  return stream.writtenEnd_.load(std::memory_order_acquire) >= limit;
+}
+
+void sfzero::SampleStreamer::addUnderrun(int numFrames)
+{
+  numUnderruns_.fetch_add(1);
+  numUnderrunFrames_.fetch_add(numFrames);
+}
+
+void sfzero::SampleStreamer::run()
+{
+  while (!threadShouldExit())
+  {
+    // Cleared before the scan, so a stream opened or closed during it is seen on the next pass.
+    workPending_.store(false, std::memory_order_relaxed);
+    bool didWork = false;
+    for (int i = 0; i < numStreams_; ++i)
+    {
+      Stream &stream = streams_[i];
+      const int state = stream.state_.load(std::memory_order_acquire);
+      if (state == Stream::closing)
+      {
+        stream.sound_ = nullptr;
+        stream.sample_ = nullptr;
+        stream.state_.store(Stream::free, std::memory_order_release);
+        numOpenStreams_.fetch_sub(1);
+      }
+      else if (state == Stream::active)
+      {
+        didWork = fill(stream) || didWork;
+      }
+    }
+    // The audio thread never signals (that would take a lock); it only sets workPending_, which
+    // is polled here between short sleeps.
+    if (!didWork && !workPending_.load(std::memory_order_acquire))
+    {
+      wakeUp_.wait(1);
+    }
+  }
+}
+
+bool sfzero::SampleStreamer::fill(Stream &stream)
+{
+  const juce::int64 readPosition = stream.readPosition_.load(std::memory_order_acquire);
+  juce::int64 end = stream.writtenEnd_.load(std::memory_order_relaxed);
+  if (end < readPosition)
+  {
+    // The voice ran past what we had (an underrun): skip the frames it no longer needs.
+    end = readPosition;
+  }
+
+  const juce::int64 limit = juce::jmin(readPosition + ringFrames_, stream.endFrame_);
+  const int numFrames = static_cast<int>(juce::jmin(limit - end, static_cast<juce::int64>(chunkFrames)));
+  if (numFrames <= 0)
+  {
+    return false;
+  }
+
+  stream.sample_->readStreamFrames(scratch_, end, numFrames);
+  for (int channel = 0; channel < stream.numChannels_; ++channel)
+  {
+    const float *source = scratch_.getReadPointer(channel);
+    float *ring = stream.ring_[channel].data();
+    const int offset = static_cast<int>(static_cast<size_t>(end) & stream.mask_);
+    const int firstPart = juce::jmin(numFrames, ringFrames_ - offset);
+    std::copy(source, source + firstPart, ring + offset);
+    std::copy(source + firstPart, source + numFrames, ring);
+  }
+  stream.writtenEnd_.store(end + numFrames, std::memory_order_release);
+  return true;
+}
@@ -0,0 +1,111 @@
+/*************************************************************************************
+ * Original code copyright (C) 2012 Steve Folta
+ * Converted to Juce module (C) 2016 Leo Olivers
+ * Forked from https://github.com/stevefolta/SFZero
+ * For license info please see the LICENSE file distributed with this source code
+ *************************************************************************************/
+#ifndef SFZSTREAMER_H_INCLUDED
+#define SFZSTREAMER_H_INCLUDED
+
+#include "SFZCommon.h"
+
+namespace sfzero
+{
+class Sample;
+class Sound;
+
+// Feeds streaming Samples from disk. A streaming Sample keeps only its first frames in memory;
+// each voice playing one opens a Stream, a ring buffer that a background thread keeps filled
+// ahead of the voice's read position. Streams come from a fixed pool, and opening or closing one
+// only sets atomics (the reader polls for new work every millisecond), so the audio thread never
+// allocates, locks or signals.
+class SampleStreamer : private juce::Thread
+{
+public:
+  explicit SampleStreamer(int numStreams = 256, int ringFrames = 16384);
+  ~SampleStreamer() override;
+
+  class Stream
+  {
+  public:
+    // Frames [getStartFrame(), getAvailableEnd()) are in the ring. Audio thread.
+    juce::int64 getStartFrame() const { return startFrame_; }
+    juce::int64 getAvailableEnd() const { return writtenEnd_.load(std::memory_order_acquire); }
+    float getFrame(int channel, juce::int64 frame) const
+    {
+      return ring_[static_cast<size_t>(channel)][static_cast<size_t>(frame) & mask_];
+    }
+    // The voice no longer needs frames before this one, so the reader may overwrite them.
+    void setReadPosition(juce::int64 frame) { readPosition_.store(frame, std::memory_order_release); }
+
+  private:
+    friend class SampleStreamer;
+
+    enum State
+    {
+      free,
+      claimed,
+      active,
+      closing
+    };
+
+    std::atomic<int> state_{free};
+    juce::ReferenceCountedObjectPtr<juce::SynthesiserSound> sound_; // keeps the Sample alive while streaming
+    Sample *sample_ = nullptr;
+    int numChannels_ = 0;
+    juce::int64 startFrame_ = 0, endFrame_ = 0;
+    std::atomic<juce::int64> writtenEnd_{0}, readPosition_{0};
+    std::vector<float> ring_[2];
+    size_t mask_ = 0;
+  };
+
+  // Allocates the ring buffers and starts the reader thread; call before loading streaming
+  // samples. Does nothing the second time.
+  void prepare();
+  bool isPrepared() const { return prepared_.load(std::memory_order_acquire); }
+
+  // Audio thread: opens a stream of sample (owned by sound) from startFrame on, or returns
+  // nullptr if every stream is in use.
+  Stream *open(Sound *sound, Sample *sample, juce::int64 startFrame);
+  // Audio thread: hands the stream back; the reader thread recycles it.
+  void close(Stream *stream);
+
+  // Blocks until every open stream's ring is as full as it can be, or timeoutMs passes; returns
+  // false on timeout. For offline rendering and tests, never the audio thread.
+  bool waitUntilFilled(int timeoutMs);
+
+  // Underrun accounting, for monitoring. Any thread.
+  void addUnderrun(int numFrames);
+  int getNumUnderruns() const { return numUnderruns_.load(); }
+  juce::int64 getNumUnderrunFrames() const { return numUnderrunFrames_.load(); }
+  int getNumStreamsRefused() const { return numStreamsRefused_.load(); }
+  int getNumOpenStreams() const { return numOpenStreams_.load(); }
+  int getRingFrames() const { return ringFrames_; }
+
+private:
+  const int numStreams_, ringFrames_;
+  std::unique_ptr<Stream[]> streams_;
+  std::atomic<bool> prepared_{false};
+  std::atomic<int> nextStream_{0};
+  juce::CriticalSection prepareLock_;
+  std::atomic<bool> workPending_{false}; // set by open() and close()
+  juce::WaitableEvent wakeUp_;           // only signalled off the audio thread (waitUntilFilled)
+  juce::AudioSampleBuffer scratch_;
+
+  std::atomic<int> numUnderruns_{0}, numStreamsRefused_{0}, numOpenStreams_{0};
+  std::atomic<juce::int64> numUnderrunFrames_{0};
+
+  enum
+  {
+    chunkFrames = 4096,
+  };
+
+  void run() override;
+  bool fill(Stream &stream);
+  static bool isFilled(const Stream &stream, int ringFrames);
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleStreamer)
+};
+}
+
+#endif // SFZSTREAMER_H_INCLUDED
@@ -8,7 +8,460 @@
 #include "SFZSound.h"
 #include "SFZVoice.h"
 
-sfzero::Synth::Synth() : Synthesiser() {}
+bool sfzero::VoiceLimit::tryAcquire()
+{
+  int inUse = inUse_.load();
+  while (inUse < maxVoices_.load())
+  {
+    if (inUse_.compare_exchange_weak(inUse, inUse + 1))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+sfzero::SoundReclaimer::SoundReclaimer(int intervalMs) : juce::Thread("SFZ sound reclaimer"), intervalMs_(intervalMs)
+{
+  startThread();
+}
+
+sfzero::SoundReclaimer::~SoundReclaimer()
+{
+  stopThread(2000);
+  // Synths still registered outlive us: they reclaim on their own from now on.
+  const juce::ScopedLock locker(lock_);
+  for (Synth *synth : synths_)
+  {
+    synth->reclaimer_ = nullptr;
+  }
+}
+
+void sfzero::SoundReclaimer::add(Synth *synth)
+{
+  const juce::ScopedLock locker(lock_);
+  synths_.addIfNotAlreadyThere(synth);
+}
+
+void sfzero::SoundReclaimer::remove(Synth *synth)
+{
+  const juce::ScopedLock locker(lock_);
+  synths_.removeFirstMatchingValue(synth);
+}
+
+void sfzero::SoundReclaimer::run()
+{
+  while (!threadShouldExit())
+  {
+    {
+      const juce::ScopedLock locker(lock_);
+      for (Synth *synth : synths_)
+      {
+        synth->reclaimRetiredSounds();
+      }
+    }
+    wait(intervalMs_);
+  }
+}
+
+sfzero::Synth::Synth()
+    : Synthesiser(), nextStartOrder_(0), voiceLimit_(nullptr), published_(0), silence_(new sfzero::Sound(juce::File())),
+      reclaimer_(nullptr), fadeSwappedVoices_(false)
+{
+  for (auto &slot : retired_)
+  {
+    slot.store(nullptr);
+  }
+  // Room for the one sound, so applyPublishedSound() never allocates.
+  sounds.ensureStorageAllocated(1);
+
+  for (auto &channel : firstOnNote_)
+  {
+    std::fill(std::begin(channel), std::end(channel), -1);
+  }
+  std::fill(std::begin(noteDownVoicesOnChannel_), std::end(noteDownVoicesOnChannel_), 0);
+}
+
+sfzero::Synth::~Synth()
+{
+  // Hand our slots back to a shared limit that outlives us.
+  setVoiceLimit(nullptr);
+  setReclaimer(nullptr);
+
+  // Our references only: voices still holding these Sounds release them as they are destroyed.
+  const juce::pointer_sized_uint published = published_.exchange(0);
+  if (auto *sound = reinterpret_cast<juce::SynthesiserSound *>(published & ~static_cast<juce::pointer_sized_uint>(1)))
+  {
+    sound->decReferenceCount();
+  }
+  for (auto &slot : retired_)
+  {
+    if (auto *sound = slot.exchange(nullptr))
+    {
+      sound->decReferenceCount();
+    }
+  }
+}
+
+void sfzero::Synth::publishSound(sfzero::Sound *sound)
+{
+  juce::SynthesiserSound *newSound = sound;
+  if (newSound != nullptr)
+  {
+    newSound->incReferenceCount();
+  }
+  const juce::pointer_sized_uint previous =
+      published_.exchange(reinterpret_cast<juce::pointer_sized_uint>(newSound) | 1, std::memory_order_acq_rel);
+
+  // A sound queued but never switched to was never played: free it here, not on the audio thread.
+  if (auto *superseded = reinterpret_cast<juce::SynthesiserSound *>(previous & ~static_cast<juce::pointer_sized_uint>(1)))
+  {
+    superseded->decReferenceCount();
+  }
+}
+
+bool sfzero::Synth::applyPublishedSound()
+{
+  if (published_.load(std::memory_order_acquire) == 0)
+  {
+    return false;
+  }
+
+  juce::SynthesiserSound *oldSound = sounds.isEmpty() ? nullptr : sounds.getObjectPointerUnchecked(0);
+  const bool retireOld = (oldSound != nullptr) && (oldSound != silence_.get());
+  int slot = -1;
+  for (int i = 0; (i < numRetiredSlots) && (slot < 0); ++i)
+  {
+    if (retired_[i].load(std::memory_order_acquire) == nullptr)
+    {
+      slot = i;
+    }
+  }
+  if (retireOld && (slot < 0))
+  {
+    return false;
+  }
+
+  // Only this thread takes from published_ or fills retired_ slots, so both checks above still hold.
+  const juce::pointer_sized_uint published = published_.exchange(0, std::memory_order_acq_rel);
+  auto *newSound = reinterpret_cast<juce::SynthesiserSound *>(published & ~static_cast<juce::pointer_sized_uint>(1));
+  if (newSound == oldSound)
+  {
+    if (newSound != nullptr)
+    {
+      newSound->decReferenceCountWithoutDeleting();
+    }
+    return false;
+  }
+
+  if (oldSound != nullptr)
+  {
+    oldSound->incReferenceCount(); // outlives its removal from sounds
+  }
+  juce::SynthesiserSound *installed = (newSound != nullptr) ? newSound : silence_.get();
+  if (sounds.isEmpty())
+  {
+    sounds.add(installed);
+  }
+  else
+  {
+    sounds.set(0, installed);
+  }
+  if (newSound != nullptr)
+  {
+    newSound->decReferenceCountWithoutDeleting(); // sounds holds it now
+  }
+
+  if (retireOld)
+  {
+    retired_[slot].store(oldSound, std::memory_order_release);
+  }
+  else if (oldSound != nullptr)
+  {
+    oldSound->decReferenceCountWithoutDeleting(); // silence_ still holds it
+  }
+
+  fadeSwappedVoices_ = true;
+  return true;
+}
+
+int sfzero::Synth::reclaimRetiredSounds()
+{
+  // A retired Sound is referenced only by us once the last voice playing it has stopped (nothing
+  // new can start on it), so the count can only fall to 1, never rise from it.
+  int numReclaimed = 0;
+  for (auto &slot : retired_)
+  {
+    juce::SynthesiserSound *sound = slot.load(std::memory_order_acquire);
+    if ((sound != nullptr) && (sound->getReferenceCount() == 1) && slot.compare_exchange_strong(sound, nullptr))
+    {
+      sound->decReferenceCount();
+      numReclaimed += 1;
+    }
+  }
+  return numReclaimed;
+}
+
+int sfzero::Synth::getNumRetiredSounds() const
+{
+  int numRetired = 0;
+  for (const auto &slot : retired_)
+  {
+    numRetired += (slot.load(std::memory_order_relaxed) != nullptr) ? 1 : 0;
+  }
+  return numRetired;
+}
+
+void sfzero::Synth::setReclaimer(SoundReclaimer *reclaimer)
+{
+  if (reclaimer_ != nullptr)
+  {
+    reclaimer_->remove(this);
+  }
+  reclaimer_ = reclaimer;
+  if (reclaimer_ != nullptr)
+  {
+    reclaimer_->add(this);
+  }
+}
+
+void sfzero::Synth::setNumVoices(int numVoices)
+{
+  const juce::ScopedLock locker(lock);
+
+  VoiceLimit *limit = voiceLimit_;
+  setVoiceLimit(nullptr);
+  clearVoices();
+  for (int i = 0; i < numVoices; ++i)
+  {
+    addVoice(new sfzero::Voice());
+  }
+  rebuildVoiceIndex();
+  setVoiceLimit(limit);
+}
+
+void sfzero::Synth::setVoiceLimit(VoiceLimit *limit)
+{
+  const juce::ScopedLock locker(lock);
+
+  collectFinishedVoices();
+  for (int i = static_cast<int>(activeVoices_.size()); --i >= 0;)
+  {
+    const int index = activeVoices_[i];
+    if (voiceLimit_ != nullptr)
+    {
+      voiceLimit_->release();
+    }
+    if ((limit != nullptr) && !limit->tryAcquire())
+    {
+      // Over the new cap: this voice goes.
+      sfzVoices_[index]->stopNote(0.0f, false);
+      untrackVoice(index);
+      freeVoices_.push_back(index);
+    }
+  }
+  voiceLimit_ = limit;
+}
+
+void sfzero::Synth::rebuildVoiceIndex()
+{
+  // Voices added or removed behind our back (addVoice()): start the index afresh.
+  if (voiceLimit_ != nullptr)
+  {
+    for (size_t i = 0; i < activeVoices_.size(); ++i)
+    {
+      voiceLimit_->release();
+    }
+  }
+
+  const int numVoices = voices.size();
+  sfzVoices_.assign(numVoices, nullptr);
+  freeVoices_.clear();
+  freeVoices_.reserve(numVoices);
+  activeVoices_.clear();
+  activeVoices_.reserve(numVoices);
+  activeSlot_.assign(numVoices, -1);
+  nextOnNote_.assign(numVoices, -1);
+  prevOnNote_.assign(numVoices, -1);
+  voiceChannel_.assign(numVoices, 0);
+  voiceNote_.assign(numVoices, 0);
+  voiceCountsAsNoteDown_.assign(numVoices, 0);
+  voiceStartOrder_.assign(numVoices, 0);
+  for (auto &channel : firstOnNote_)
+  {
+    std::fill(std::begin(channel), std::end(channel), -1);
+  }
+  std::fill(std::begin(noteDownVoicesOnChannel_), std::end(noteDownVoicesOnChannel_), 0);
+
+  for (int i = numVoices; --i >= 0;)
+  {
+    sfzero::Voice *voice = dynamic_cast<sfzero::Voice *>(voices.getUnchecked(i));
+    if (voice == nullptr)
+    {
+      continue;
+    }
+    sfzVoices_[i] = voice;
+    if (voice->getCurrentlyPlayingNote() >= 0)
+    {
+      voice->stopNote(0.0f, false);
+    }
+    freeVoices_.push_back(i);
+  }
+}
+
+int sfzero::Synth::allocateVoice(bool allowStealing)
+{
+  if (!freeVoices_.empty() && ((voiceLimit_ == nullptr) || voiceLimit_->tryAcquire()))
+  {
+    const int index = freeVoices_.back();
+    freeVoices_.pop_back();
+    return index;
+  }
+  if (!allowStealing || activeVoices_.empty())
+  {
+    return -1;
+  }
+
+  // The stolen voice keeps its VoiceLimit slot for the new note. Kill it here: startVoice() would
+  // otherwise stop it after setRegion() and lose the new region.
+  const int index = chooseVoiceToSteal();
+  sfzVoices_[index]->stopNote(0.0f, false);
+  untrackVoice(index);
+  return index;
+}
+
+int sfzero::Synth::chooseVoiceToSteal()
+{
+  // Prefer voices already releasing, then ones whose key is up (held by the sustain pedal or
+  // playing out a one-shot), then held notes; the quietest within each, and the oldest of equals.
+  int best = -1;
+  int bestRank = 3;
+  float bestLevel = 0.0f;
+  for (int index : activeVoices_)
+  {
+    sfzero::Voice *voice = sfzVoices_[index];
+    const int rank = voice->isReleasing() ? 0 : (voice->isKeyDown() ? 2 : 1);
+    const float level = voice->getCurrentLevel();
+    if ((rank < bestRank) || ((rank == bestRank) && (level < bestLevel)) ||
+        ((rank == bestRank) && (level == bestLevel) && (voiceStartOrder_[index] < voiceStartOrder_[best])))
+    {
+      best = index;
+      bestRank = rank;
+      bestLevel = level;
+    }
+  }
+  return best;
+}
+
+void sfzero::Synth::startRegion(int index, sfzero::Sound *sound, sfzero::Region *region, int midiChannel,
+                                int midiNoteNumber, float velocity)
+{
+  sfzero::Voice *voice = sfzVoices_[index];
+  voice->setRegion(region);
+  startVoice(voice, sound, midiChannel, midiNoteNumber, velocity);
+  if (voice->getCurrentlyPlayingNote() >= 0)
+  {
+    trackVoice(index, midiChannel, midiNoteNumber);
+  }
+  else
+  {
+    // startNote() refused the region (no sample, negative end...).
+    freeVoices_.push_back(index);
+    if (voiceLimit_ != nullptr)
+    {
+      voiceLimit_->release();
+    }
+  }
+}
+
+void sfzero::Synth::trackVoice(int index, int midiChannel, int midiNoteNumber)
+{
+  const int channel = juce::jlimit(1, static_cast<int>(numChannels), midiChannel) - 1;
+  const int note = juce::jlimit(0, numNotes - 1, midiNoteNumber);
+
+  voiceChannel_[index] = channel;
+  voiceNote_[index] = note;
+  prevOnNote_[index] = -1;
+  nextOnNote_[index] = firstOnNote_[channel][note];
+  if (nextOnNote_[index] >= 0)
+  {
+    prevOnNote_[nextOnNote_[index]] = index;
+  }
+  firstOnNote_[channel][note] = index;
+
+  voiceStartOrder_[index] = nextStartOrder_++;
+  activeSlot_[index] = static_cast<int>(activeVoices_.size());
+  activeVoices_.push_back(index);
+
+  voiceCountsAsNoteDown_[index] = sfzVoices_[index]->isPlayingNoteDown() ? 1 : 0;
+  noteDownVoicesOnChannel_[channel] += voiceCountsAsNoteDown_[index];
+}
+
+void sfzero::Synth::untrackVoice(int index)
+{
+  const int channel = voiceChannel_[index];
+  const int note = voiceNote_[index];
+
+  if (prevOnNote_[index] >= 0)
+  {
+    nextOnNote_[prevOnNote_[index]] = nextOnNote_[index];
+  }
+  else
+  {
+    firstOnNote_[channel][note] = nextOnNote_[index];
+  }
+  if (nextOnNote_[index] >= 0)
+  {
+    prevOnNote_[nextOnNote_[index]] = prevOnNote_[index];
+  }
+  prevOnNote_[index] = nextOnNote_[index] = -1;
+
+  const int slot = activeSlot_[index];
+  const int last = activeVoices_.back();
+  activeVoices_[slot] = last;
+  activeSlot_[last] = slot;
+  activeVoices_.pop_back();
+  activeSlot_[index] = -1;
+
+  noteDownVoicesOnChannel_[channel] -= voiceCountsAsNoteDown_[index];
+  voiceCountsAsNoteDown_[index] = 0;
+}
+
+void sfzero::Synth::collectFinishedVoices()
+{
+  for (int i = static_cast<int>(activeVoices_.size()); --i >= 0;)
+  {
+    const int index = activeVoices_[i];
+    if (sfzVoices_[index]->getCurrentlyPlayingNote() < 0)
+    {
+      untrackVoice(index);
+      freeVoices_.push_back(index);
+      if (voiceLimit_ != nullptr)
+      {
+        voiceLimit_->release();
+      }
+    }
+  }
+}
+
+void sfzero::Synth::renderVoices(juce::AudioBuffer<float> &outputAudio, int startSample, int numSamples)
+{
+  // Called with the lock held. Notes started since the switch already play the new sound.
+  if (fadeSwappedVoices_)
+  {
+    fadeSwappedVoices_ = false;
+    juce::SynthesiserSound *current = sounds.isEmpty() ? nullptr : sounds.getObjectPointerUnchecked(0);
+    for (int index : activeVoices_)
+    {
+      if (sfzVoices_[index]->getCurrentlyPlayingSound().get() != current)
+      {
+        sfzVoices_[index]->fadeOut();
+      }
+    }
+  }
+  Synthesiser::renderVoices(outputAudio, startSample, numSamples);
+  collectFinishedVoices();
+}
 
 void sfzero::Synth::noteOn(int midiChannel, int midiNoteNumber, float velocity)
 {
@@ -16,7 +469,14 @@ void sfzero::Synth::noteOn(int midiChannel, int midiNoteNumber, float velocity)
 
   const juce::ScopedLock locker(lock);
 
+  if (sfzVoices_.size() != static_cast<size_t>(voices.size()))
+  {
+    rebuildVoiceIndex();
+  }
+
   int midiVelocity = static_cast<int>(velocity * 127);
+  const int channel = juce::jlimit(1, static_cast<int>(numChannels), midiChannel) - 1;
+  const int note = juce::jlimit(0, numNotes - 1, midiNoteNumber);
 
   // First, stop any currently-playing sounds in the group.
   //*** Currently, this only pays attention to the first matching region.
@@ -33,65 +493,44 @@ void sfzero::Synth::noteOn(int midiChannel, int midiNoteNumber, float velocity)
   }
   if (group != 0)
   {
-    for (i = voices.size(); --i >= 0;)
+    for (int index : activeVoices_)
     {
-      sfzero::Voice *voice = dynamic_cast<sfzero::Voice *>(voices.getUnchecked(i));
-      if (voice == nullptr)
-      {
-        continue;
-      }
-      if (voice->getOffBy() == group)
+      if (sfzVoices_[index]->getOffBy() == group)
       {
-        voice->stopNoteForGroup();
+        sfzVoices_[index]->stopNoteForGroup();
       }
     }
   }
 
   // Are any notes playing?  (Needed for first/legato trigger handling.)
   // Also stop any voices still playing this note.
-  bool anyNotesPlaying = false;
-  for (i = voices.size(); --i >= 0;)
+  int noteDownVoicesOnThisNote = 0;
+  for (i = firstOnNote_[channel][note]; i >= 0; i = nextOnNote_[i])
   {
-    sfzero::Voice *voice = dynamic_cast<sfzero::Voice *>(voices.getUnchecked(i));
-    if (voice == nullptr)
-    {
-      continue;
-    }
-    if (voice->isPlayingChannel(midiChannel))
+    if (voiceCountsAsNoteDown_[i])
     {
-      if (voice->isPlayingNoteDown())
+      noteDownVoicesOnThisNote += 1;
+      if (!sfzVoices_[i]->isPlayingOneShot())
       {
-        if (voice->getCurrentlyPlayingNote() == midiNoteNumber)
-        {
-          if (!voice->isPlayingOneShot())
-          {
-            voice->stopNoteQuick();
-          }
-        }
-        else
-        {
-          anyNotesPlaying = true;
-        }
+        sfzVoices_[i]->stopNoteQuick();
       }
     }
   }
+  bool anyNotesPlaying = noteDownVoicesOnChannel_[channel] > noteDownVoicesOnThisNote;
 
   // Play *all* matching regions.
   sfzero::Region::Trigger trigger = (anyNotesPlaying ? sfzero::Region::legato : sfzero::Region::first);
   if (sound)
   {
-    int numRegions = sound->getNumRegions();
-    for (i = 0; i < numRegions; ++i)
+    for (int regionIndex : sound->getRegionIndicesFor(midiNoteNumber, midiVelocity, trigger))
     {
-      sfzero::Region *region = sound->regionAt(i);
+      sfzero::Region *region = sound->regionAt(regionIndex);
       if (region->matches(midiNoteNumber, midiVelocity, trigger))
       {
-        sfzero::Voice *voice =
-            dynamic_cast<sfzero::Voice *>(findFreeVoice(sound, midiNoteNumber, midiChannel, isNoteStealingEnabled()));
-        if (voice)
+        const int index = allocateVoice(isNoteStealingEnabled());
+        if (index >= 0)
         {
-          voice->setRegion(region);
-          startVoice(voice, sound, midiChannel, midiNoteNumber, velocity);
+          startRegion(index, sound, region, midiChannel, midiNoteNumber, velocity);
         }
       }
     }
@@ -105,6 +544,10 @@ void sfzero::Synth::noteOff(int midiChannel, int midiNoteNumber, float velocity,
   const juce::ScopedLock locker(lock);
 
   Synthesiser::noteOff(midiChannel, midiNoteNumber, velocity, allowTailOff);
+  if (!allowTailOff)
+  {
+    collectFinishedVoices();
+  }
 
   // Start release region.
   sfzero::Sound *sound = dynamic_cast<sfzero::Sound *>(getSound(0).get());
@@ -113,18 +556,29 @@ void sfzero::Synth::noteOff(int midiChannel, int midiNoteNumber, float velocity,
     sfzero::Region *region = sound->getRegionFor(midiNoteNumber, noteVelocities_[midiNoteNumber], sfzero::Region::release);
     if (region)
     {
-      sfzero::Voice *voice = dynamic_cast<sfzero::Voice *>(findFreeVoice(sound, midiNoteNumber, midiChannel, false));
-      if (voice)
+      if (sfzVoices_.size() != static_cast<size_t>(voices.size()))
+      {
+        rebuildVoiceIndex();
+      }
+      const int index = allocateVoice(false);
+      if (index >= 0)
       {
         // Synthesiser is too locked-down (ivars are private rt protected), so
         // we have to use a "setRegion()" mechanism.
-        voice->setRegion(region);
-        startVoice(voice, sound, midiChannel, midiNoteNumber, noteVelocities_[midiNoteNumber] / 127.0f);
+        startRegion(index, sound, region, midiChannel, midiNoteNumber, noteVelocities_[midiNoteNumber] / 127.0f);
       }
     }
   }
 }
 
+void sfzero::Synth::allNotesOff(int midiChannel, bool allowTailOff)
+{
+  const juce::ScopedLock locker(lock);
+
+  Synthesiser::allNotesOff(midiChannel, allowTailOff);
+  collectFinishedVoices();
+}
+
 int sfzero::Synth::numVoicesUsed()
 {
   int numUsed = 0;
@@ -139,6 +593,25 @@ int sfzero::Synth::numVoicesUsed()
   return numUsed;
 }
 
+int sfzero::Synth::numVoicesPlayingNote(int midiChannel, int midiNoteNumber)
+{
+  const juce::ScopedLock locker(lock);
+
+  if ((midiChannel < 1) || (midiChannel > numChannels) || (midiNoteNumber < 0) || (midiNoteNumber >= numNotes))
+  {
+    return 0;
+  }
+  int numPlaying = 0;
+  for (int i = firstOnNote_[midiChannel - 1][midiNoteNumber]; i >= 0; i = nextOnNote_[i])
+  {
+    if (sfzVoices_[i]->getCurrentlyPlayingNote() >= 0)
+    {
+      numPlaying += 1;
+    }
+  }
+  return numPlaying;
+}
+
 juce::String sfzero::Synth::voiceInfoString()
 {
   enum
@@ -11,21 +11,145 @@
 
 namespace sfzero
 {
+struct Region;
+class Sound;
+class Voice;
+
+// A polyphony cap shared by several Synths (e.g. one per MIDI channel). Each Synth reserves a slot
+// here before it starts a voice from its free pool, and steals one of its own voices instead when
+// the cap is reached. Thread safe: the Synths may render on different threads.
+class VoiceLimit
+{
+public:
+  explicit VoiceLimit(int maxVoices = 256) : maxVoices_(maxVoices) {}
+
+  void setMaxVoices(int maxVoices) { maxVoices_.store(juce::jmax(1, maxVoices)); }
+  int getMaxVoices() const { return maxVoices_.load(); }
+  int getNumVoicesInUse() const { return inUse_.load(); }
+
+  bool tryAcquire();
+  void release() { inUse_.fetch_sub(1); }
+
+private:
+  std::atomic<int> maxVoices_;
+  std::atomic<int> inUse_{0};
+
+  JUCE_DECLARE_NON_COPYABLE(VoiceLimit)
+};
+
+class Synth;
+
+// Frees the Sounds Synths have swapped out (see Synth::publishSound) once their last voice has
+// stopped, on its own thread, so the audio thread never runs a Sound's destructor.
+class SoundReclaimer : private juce::Thread
+{
+public:
+  explicit SoundReclaimer(int intervalMs = 10);
+  ~SoundReclaimer() override;
+
+private:
+  friend class Synth;
+
+  const int intervalMs_;
+  juce::CriticalSection lock_;
+  juce::Array<Synth *> synths_;
+
+  void add(Synth *synth);
+  void remove(Synth *synth);
+  void run() override;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SoundReclaimer)
+};
 
 class Synth : public juce::Synthesiser
 {
 public:
   Synth();
-  virtual ~Synth() {}
+  virtual ~Synth();
 
   void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
   void noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff) override;
+  void allNotesOff(int midiChannel, bool allowTailOff) override;
+
+  // Replaces the voices with numVoices new sfzero::Voices (killing any playing notes). Use this
+  // rather than addVoice(), so the voice index below stays in step. Safe while audio runs: the
+  // voice lists are only read or rebuilt under the Synthesiser lock, which render holds too.
+  void setNumVoices(int numVoices);
+  // Optional cap on the voices this Synth and others sharing the limit may play at once.
+  void setVoiceLimit(VoiceLimit *limit);
+
+  // Instrument hand-off without the Synthesiser lock. publishSound() (any thread but the audio
+  // thread) queues a fully loaded Sound, or nullptr for silence; the audio thread switches to it
+  // in applyPublishedSound() at the start of a block. That touches only the sound slot: the old
+  // sound's voices are faded out by the block's render, under the lock, so a setNumVoices() on
+  // another thread can't rebuild the voice lists while they're walked. The old
+  // Sound is kept until those voices stop and freed by reclaimRetiredSounds(), which a
+  // SoundReclaimer calls on its thread. Publishing again before the switch replaces the queued one.
+  void publishSound(Sound *sound);
+  bool hasPublishedSound() const { return published_.load(std::memory_order_acquire) != 0; }
+  // Audio thread. Returns true if it switched sounds; false if nothing was published, or if every
+  // retired slot is still waiting for its voices (it tries again next block).
+  bool applyPublishedSound();
+  // Not the audio thread. Returns the number of Sounds released.
+  int reclaimRetiredSounds();
+  int getNumRetiredSounds() const;
+  void setReclaimer(SoundReclaimer *reclaimer);
 
   int numVoicesUsed();
+  int numVoicesPlayingNote(int midiChannel, int midiNoteNumber);
   juce::String voiceInfoString();
 
+protected:
+  using juce::Synthesiser::renderVoices;
+  void renderVoices(juce::AudioBuffer<float> &outputAudio, int startSample, int numSamples) override;
+
 private:
+  friend class SoundReclaimer;
+
+  enum
+  {
+    numChannels = 16,
+    numNotes = 128,
+  };
+
   int noteVelocities_[128];
+
+  // Voice bookkeeping in flat arrays, so noteOn never scans the voice list: playing voices are
+  // linked per (channel, note), free ones sit on a stack. Voices that finish on their own (sample
+  // or release ran out) are moved back to the free stack after each render.
+  std::vector<sfzero::Voice *> sfzVoices_;
+  std::vector<int> freeVoices_;
+  std::vector<int> activeVoices_, activeSlot_;
+  std::vector<int> nextOnNote_, prevOnNote_;
+  std::vector<int> voiceChannel_, voiceNote_;
+  std::vector<char> voiceCountsAsNoteDown_;
+  std::vector<juce::uint64> voiceStartOrder_;
+  juce::uint64 nextStartOrder_;
+  int firstOnNote_[numChannels][numNotes];
+  int noteDownVoicesOnChannel_[numChannels];
+  VoiceLimit *voiceLimit_;
+
+  // The published Sound pointer with its low bit set (so nullptr can be published too); 0 when
+  // nothing is queued. Each queued or retired Sound carries one reference of ours.
+  std::atomic<juce::pointer_sized_uint> published_;
+  enum
+  {
+    numRetiredSlots = 8,
+  };
+  std::atomic<juce::SynthesiserSound *> retired_[numRetiredSlots];
+  juce::SynthesiserSound::Ptr silence_; // stands in for "no sound", so sounds never has to shrink
+  SoundReclaimer *reclaimer_;
+  bool fadeSwappedVoices_; // audio thread: set by applyPublishedSound(), honoured by renderVoices()
+
+  void rebuildVoiceIndex();
+  int allocateVoice(bool allowStealing);
+  int chooseVoiceToSteal();
+  void startRegion(int index, sfzero::Sound *sound, sfzero::Region *region, int midiChannel, int midiNoteNumber,
+                   float velocity);
+  void trackVoice(int index, int midiChannel, int midiNoteNumber);
+  void untrackVoice(int index);
+  void collectFinishedVoices();
+
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Synth)
 };
 }
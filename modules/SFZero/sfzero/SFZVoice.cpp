@@ -15,12 +15,13 @@ static const float globalGain = -1.0;
 
 sfzero::Voice::Voice()
     : region_(nullptr), trigger_(0), curMidiNote_(0), curPitchWheel_(0), pitchRatio_(0), noteGainLeft_(0), noteGainRight_(0),
-      sourceSamplePosition_(0), sampleEnd_(0), loopStart_(0), loopEnd_(0), numLoops_(0), curVelocity_(0)
+      sourceSamplePosition_(0), sampleEnd_(0), loopStart_(0), loopEnd_(0), numLoops_(0), curVelocity_(0), fadingOut_(false), streamer_(nullptr),
+      stream_(nullptr)
 {
   ampeg_.setExponentialDecay(true);
 }
 
-sfzero::Voice::~Voice() {}
+sfzero::Voice::~Voice() { closeStream(); }
 
 bool sfzero::Voice::canPlaySound(juce::SynthesiserSound *sound) { return dynamic_cast<sfzero::Sound *>(sound) != nullptr; }
 
@@ -37,11 +38,12 @@ void sfzero::Voice::startNote(int midiNoteNumber, float floatVelocity, juce::Syn
 
   int velocity = static_cast<int>(floatVelocity * 127.0);
   curVelocity_ = velocity;
+  fadingOut_ = false;
   if (region_ == nullptr)
   {
     region_ = sound->getRegionFor(midiNoteNumber, velocity);
   }
-  if ((region_ == nullptr) || (region_->sample == nullptr) || (region_->sample->getBuffer() == nullptr))
+  if ((region_ == nullptr) || (region_->sample == nullptr) || !region_->sample->isLoaded())
   {
     killNote();
     return;
@@ -110,6 +112,16 @@ void sfzero::Voice::startNote(int midiNoteNumber, float floatVelocity, juce::Syn
     }
   }
   numLoops_ = 0;
+
+  // Streaming sample: frames past the preloaded head come from disk through a stream.
+  closeStream();
+  if (region_->sample->isStreaming() && (sound->getStreamer() != nullptr))
+  {
+    streamer_ = sound->getStreamer();
+    const juce::int64 headFrames = region_->sample->getNumLoadedFrames();
+    stream_ = streamer_->open(sound, region_->sample,
+                              juce::jmax(headFrames, static_cast<juce::int64>(sourceSamplePosition_)));
+  }
 }
 
 void sfzero::Voice::stopNote(float /*velocity*/, bool allowTailOff)
@@ -119,6 +131,10 @@ void sfzero::Voice::stopNote(float /*velocity*/, bool allowTailOff)
     killNote();
     return;
   }
+  if (fadingOut_)
+  {
+    return;
+  }
 
   if (region_->loop_mode != sfzero::Region::one_shot)
   {
@@ -144,6 +160,13 @@ void sfzero::Voice::stopNoteForGroup()
 }
 
 void sfzero::Voice::stopNoteQuick() { ampeg_.fastRelease(); }
+
+void sfzero::Voice::fadeOut()
+{
+  ampeg_.fastRelease();
+  fadingOut_ = true;
+}
+
 void sfzero::Voice::pitchWheelMoved(int newValue)
 {
   if (region_ == nullptr)
@@ -163,82 +186,226 @@ void sfzero::Voice::renderNextBlock(juce::AudioSampleBuffer &outputBuffer, int s
     return;
   }
 
-  juce::AudioSampleBuffer *buffer = region_->sample->getBuffer();
-  const float *inL = buffer->getReadPointer(0, 0);
-  const float *inR = buffer->getNumChannels() > 1 ? buffer->getReadPointer(1, 0) : nullptr;
+  // In-memory frames are floats or 16-bit integers; integer frames are converted as they are gathered.
+  sfzero::Sample *sample = region_->sample;
+  const bool stereo = sample->getNumChannels() > 1;
+  const float *inL = sample->getFloatData(0);
+  const float *inR = stereo ? sample->getFloatData(1) : nullptr;
+  const juce::int16 *inL16 = sample->getInt16Data(0);
+  const juce::int16 *inR16 = stereo ? sample->getInt16Data(1) : nullptr;
+  const float int16Scale = sample->getInt16Scale();
 
   float *outL = outputBuffer.getWritePointer(0, startSample);
   float *outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer(1, startSample) : nullptr;
 
-  int bufferNumSamples = buffer->getNumSamples(); // leoo
+  // A streaming sample only has its first frames in the buffer; the rest come through stream_.
+  // Runs are split the same way either way, so streamed and in-memory voices render identically.
+  const bool streaming = sample->isStreaming();
+  const int headFrames = sample->getNumLoadedFrames();
+  const int bufferNumSamples = streaming ? static_cast<int>(sample->getNumFrames()) : headFrames;
+  const juce::int64 streamStart = stream_ ? stream_->getStartFrame() : 0;
+  const juce::int64 streamEnd = stream_ ? stream_->getAvailableEnd() : 0;
+  int missingFrames = 0;
+  auto fetch = [&](int channel, int frame) -> float
+  {
+    if (frame < headFrames)
+    {
+      if (inL16 != nullptr)
+      {
+        return static_cast<float>((channel == 0 ? inL16 : inR16)[frame]) * int16Scale;
+      }
+      return (channel == 0 ? inL : inR)[frame];
+    }
+    if ((frame >= streamStart) && (frame < streamEnd))
+    {
+      return stream_->getFrame(channel, frame);
+    }
+    missingFrames += (channel == 0) ? 1 : 0;
+    return 0.0f;
+  };
+
+  const bool looping = loopStart_ < loopEnd_;
+  const double loopStart = static_cast<double>(static_cast<float>(loopStart_));
+  const double loopEnd = static_cast<double>(static_cast<float>(loopEnd_));
+  const double sampleEnd = static_cast<double>(static_cast<float>(sampleEnd_));
+  const double pitchRatio = pitchRatio_;
+
+  // Inside a run every position p satisfies p < safeLimit: pos + 1 is neither past the loop end
+  // nor past the buffer, so the interpolation needs no checks.
+  double safeLimit = juce::jmin(static_cast<double>(bufferNumSamples - 1), sampleEnd);
+  if (looping)
+  {
+    safeLimit = juce::jmin(safeLimit, loopEnd);
+  }
 
-  // Cache some values, to give them at least some chance of ending up in
-  // registers.
   double sourceSamplePosition = this->sourceSamplePosition_;
   float ampegGain = ampeg_.getLevel();
   float ampegSlope = ampeg_.getSlope();
   int samplesUntilNextAmpSegment = ampeg_.getSamplesUntilNextSegment();
   bool ampSegmentIsExponential = ampeg_.getSegmentIsExponential();
-  float loopStart = static_cast<float>(this->loopStart_);
-  float loopEnd = static_cast<float>(this->loopEnd_);
-  float sampleEnd = static_cast<float>(this->sampleEnd_);
 
-  while (--numSamples >= 0)
+  double positions[maxRunLength];
+  float alphas[maxRunLength], gains[maxRunLength];
+  float fromL[maxRunLength], toL[maxRunLength], fromR[maxRunLength], toR[maxRunLength];
+  float mixL[maxRunLength], mixR[maxRunLength];
+
+  while (numSamples > 0)
   {
-    int pos = static_cast<int>(sourceSamplePosition);
-    jassert(pos >= 0 && pos < bufferNumSamples); // leoo
-    float alpha = static_cast<float>(sourceSamplePosition - pos);
-    float invAlpha = 1.0f - alpha;
-    int nextPos = pos + 1;
-    if ((loopStart < loopEnd) && (nextPos > loopEnd))
+    // A run ends at the envelope's next segment, the block end, or the first position needing checks.
+    // Positions accumulate exactly as the per-sample loop does, so both land on the same samples.
+    // (The sustain segment counts down from INT_MAX, so clamp before adding one.)
+    const int untilSegmentEnd = juce::jlimit(0, static_cast<int>(maxRunLength), samplesUntilNextAmpSegment) + 1;
+    const int maxLength = juce::jmin(numSamples, static_cast<int>(maxRunLength), untilSegmentEnd);
+    int runLength = 0;
+    double runEndPosition = sourceSamplePosition;
+    while (runLength < maxLength && runEndPosition < safeLimit)
     {
-      nextPos = static_cast<int>(loopStart);
+      positions[runLength++] = runEndPosition;
+      runEndPosition += pitchRatio;
     }
 
-    // Simple linear interpolation with buffer overrun check
-    float nextL = nextPos < bufferNumSamples ? inL[nextPos] : inL[pos];
-    float nextR = inR ? (nextPos < bufferNumSamples ? inR[nextPos] : inR[pos]) : nextL;
-    float l = (inL[pos] * invAlpha + nextL * alpha);
-    float r = inR ? (inR[pos] * invAlpha + nextR * alpha) : l;
-
-    //// Simple linear interpolation, old version (possible buffer overrun with non-loop??)
-    // float l = (inL[pos] * invAlpha + inL[nextPos] * alpha);
-    // float r = inR ? (inR[pos] * invAlpha + inR[nextPos] * alpha) : l;
-
-    float gainLeft = noteGainLeft_ * ampegGain;
-    float gainRight = noteGainRight_ * ampegGain;
-    l *= gainLeft;
-    r *= gainRight;
-    // Shouldn't we dither here?
+    // Gather the two source frames each output sample interpolates between.
+    if (runLength == 0)
+    {
+      // Boundary sample (loop seam, buffer end): the original per-sample checks.
+      int pos = static_cast<int>(sourceSamplePosition);
+      jassert(pos >= 0 && pos < bufferNumSamples);
+      int nextPos = pos + 1;
+      if (looping && (nextPos > loopEnd))
+      {
+        nextPos = static_cast<int>(loopStart);
+      }
+      if (nextPos >= bufferNumSamples)
+      {
+        nextPos = pos;
+      }
+      positions[0] = sourceSamplePosition;
+      fromL[0] = fetch(0, pos);
+      toL[0] = fetch(0, nextPos);
+      if (stereo)
+      {
+        fromR[0] = fetch(1, pos);
+        toR[0] = fetch(1, nextPos);
+      }
+      runLength = 1;
+      runEndPosition = sourceSamplePosition + pitchRatio;
+    }
+    else if (!streaming && (inL16 != nullptr))
+    {
+      for (int i = 0; i < runLength; ++i)
+      {
+        const int pos = static_cast<int>(positions[i]);
+        fromL[i] = static_cast<float>(inL16[pos]) * int16Scale;
+        toL[i] = static_cast<float>(inL16[pos + 1]) * int16Scale;
+      }
+      if (stereo)
+      {
+        for (int i = 0; i < runLength; ++i)
+        {
+          const int pos = static_cast<int>(positions[i]);
+          fromR[i] = static_cast<float>(inR16[pos]) * int16Scale;
+          toR[i] = static_cast<float>(inR16[pos + 1]) * int16Scale;
+        }
+      }
+    }
+    else if (!streaming)
+    {
+      for (int i = 0; i < runLength; ++i)
+      {
+        const int pos = static_cast<int>(positions[i]);
+        fromL[i] = inL[pos];
+        toL[i] = inL[pos + 1];
+      }
+      if (stereo)
+      {
+        for (int i = 0; i < runLength; ++i)
+        {
+          const int pos = static_cast<int>(positions[i]);
+          fromR[i] = inR[pos];
+          toR[i] = inR[pos + 1];
+        }
+      }
+    }
+    else
+    {
+      for (int i = 0; i < runLength; ++i)
+      {
+        const int pos = static_cast<int>(positions[i]);
+        fromL[i] = fetch(0, pos);
+        toL[i] = fetch(0, pos + 1);
+        if (stereo)
+        {
+          fromR[i] = fetch(1, pos);
+          toR[i] = fetch(1, pos + 1);
+        }
+      }
+    }
 
-    if (outR)
+    // Envelope gains for the run (a serial recurrence, but cheap).
+    float g = ampegGain;
+    if (ampSegmentIsExponential)
     {
-      *outL++ += l;
-      *outR++ += r;
+      for (int i = 0; i < runLength; ++i)
+      {
+        gains[i] = g;
+        g *= ampegSlope;
+      }
     }
     else
     {
-      *outL++ += (l + r) * 0.5f;
+      for (int i = 0; i < runLength; ++i)
+      {
+        gains[i] = g;
+        g += ampegSlope;
+      }
     }
 
-    // Next sample.
-    sourceSamplePosition += pitchRatio_;
-    if ((loopStart < loopEnd) && (sourceSamplePosition > loopEnd))
+    // Interpolate: no branches, so these loops vectorise.
+    for (int i = 0; i < runLength; ++i)
     {
-      sourceSamplePosition = loopStart;
-      numLoops_ += 1;
+      alphas[i] = static_cast<float>(positions[i] - static_cast<int>(positions[i]));
+      mixL[i] = fromL[i] + (toL[i] - fromL[i]) * alphas[i];
+    }
+    if (stereo)
+    {
+      for (int i = 0; i < runLength; ++i)
+      {
+        mixR[i] = fromR[i] + (toR[i] - fromR[i]) * alphas[i];
+      }
+    }
+    else
+    {
+      juce::FloatVectorOperations::copy(mixR, mixL, runLength);
     }
 
-    // Update EG.
-    if (ampSegmentIsExponential)
+    juce::FloatVectorOperations::multiply(mixL, gains, runLength);
+    juce::FloatVectorOperations::multiply(mixR, gains, runLength);
+    if (outR)
     {
-      ampegGain *= ampegSlope;
+      juce::FloatVectorOperations::addWithMultiply(outL, mixL, noteGainLeft_, runLength);
+      juce::FloatVectorOperations::addWithMultiply(outR, mixR, noteGainRight_, runLength);
+      outR += runLength;
     }
     else
     {
-      ampegGain += ampegSlope;
+      juce::FloatVectorOperations::addWithMultiply(outL, mixL, 0.5f * noteGainLeft_, runLength);
+      juce::FloatVectorOperations::addWithMultiply(outL, mixR, 0.5f * noteGainRight_, runLength);
+    }
+    outL += runLength;
+
+    sourceSamplePosition = runEndPosition;
+    ampegGain = g;
+    numSamples -= runLength;
+
+    // Per-sample bookkeeping, needed only at the run's last sample.
+    if (looping && (sourceSamplePosition > loopEnd))
+    {
+      sourceSamplePosition = loopStart;
+      numLoops_ += 1;
     }
-    if (--samplesUntilNextAmpSegment < 0)
+
+    samplesUntilNextAmpSegment -= runLength;
+    if (samplesUntilNextAmpSegment < 0)
     {
       ampeg_.setLevel(ampegGain);
       ampeg_.nextSegment();
@@ -255,6 +422,16 @@ void sfzero::Voice::renderNextBlock(juce::AudioSampleBuffer &outputBuffer, int s
     }
   }
 
+  // Source frames that hadn't arrived from disk in time were played as silence.
+  if ((missingFrames > 0) && (streamer_ != nullptr))
+  {
+    streamer_->addUnderrun(missingFrames);
+  }
+  if (stream_)
+  {
+    stream_->setReadPosition(static_cast<juce::int64>(sourceSamplePosition));
+  }
+
   this->sourceSamplePosition_ = sourceSamplePosition;
   ampeg_.setLevel(ampegGain);
   ampeg_.setSamplesUntilNextSegment(samplesUntilNextAmpSegment);
@@ -316,10 +493,21 @@ void sfzero::Voice::calcPitchRatio()
 
 void sfzero::Voice::killNote()
 {
+  closeStream();
   region_ = nullptr;
   clearCurrentNote();
 }
 
+void sfzero::Voice::closeStream()
+{
+  if (stream_ != nullptr)
+  {
+    streamer_->close(stream_);
+    stream_ = nullptr;
+  }
+  streamer_ = nullptr;
+}
+
 double sfzero::Voice::fractionalMidiNoteInHz(double note, double freqOfA)
 {
   // Like MidiMessage::getMidiNoteInHertz(), but with a float note.
@@ -8,6 +8,7 @@
 #define SFZVOICE_H_INCLUDED
 
 #include "SFZEG.h"
+#include "SFZStreamer.h"
 
 namespace sfzero
 {
@@ -24,11 +25,20 @@ public:
   void stopNote(float velocity, bool allowTailOff) override;
   void stopNoteForGroup();
   void stopNoteQuick();
+  // Fades the note out over the fast-release time, ignoring later note-offs that would restart the
+  // release at the region's own pace. For notes whose Sound has been swapped out.
+  void fadeOut();
   void pitchWheelMoved(int newValue) override;
   void controllerMoved(int controllerNumber, int newValue) override;
   void renderNextBlock(juce::AudioSampleBuffer &outputBuffer, int startSample, int numSamples) override;
   bool isPlayingNoteDown();
   bool isPlayingOneShot();
+  // True from startNote() until the note is killed (its sample or release ran out, or stopNoteQuick()).
+  bool hasRegion() const { return region_ != nullptr; }
+
+  // For voice stealing: whether the amp envelope is already releasing, and the voice's current level.
+  bool isReleasing() { return ampeg_.isReleasing() || ampeg_.isDone(); }
+  float getCurrentLevel() const { return ampeg_.getLevel() * juce::jmax(noteGainLeft_, noteGainRight_); }
 
   int getGroup();
   juce::uint64 getOffBy();
@@ -39,6 +49,13 @@ public:
   juce::String infoString();
 
 private:
+  // The tests' per-sample reference renderer, which renderNextBlock() is checked against.
+  friend struct ScalarVoiceRenderer;
+
+  // renderNextBlock() works in runs of at most this many samples that cross no loop point,
+  // buffer end or envelope segment change.
+  static constexpr int maxRunLength = 64;
+
   Region *region_;
   int trigger_;
   int curMidiNote_, curPitchWheel_;
@@ -52,9 +69,15 @@ private:
   // Info only.
   int numLoops_;
   int curVelocity_;
+  bool fadingOut_;
+
+  // Set while playing a streaming sample (stream_ is null if the streamer had none free).
+  SampleStreamer *streamer_;
+  SampleStreamer::Stream *stream_;
 
   void calcPitchRatio();
   void killNote();
+  void closeStream();
   double fractionalMidiNoteInHz(double note, double freqOfA = 440.0);
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Voice)
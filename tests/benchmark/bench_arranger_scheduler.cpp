@@ -0,0 +1,103 @@
+#if PROJECT_SYNTH_TESTS
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "Arranger/ArrangerScheduler.h"
+
+// Micro-benchmark: cost of ArrangerScheduler::advance per 10 ms tick for dense styles, cursor vs the
+// old full-pattern scan. Results go to the test log; run with the "Benchmark" category.
+class ArrangerSchedulerBenchmark : public juce::UnitTest
+{
+public:
+    ArrangerSchedulerBenchmark() : juce::UnitTest ("ArrangerScheduler advance", "Benchmark") {}
+
+    static std::vector<TimedBeatEvent> makeDenseLoop (int numEvents, double loopLen, juce::Random& rng)
+    {
+        std::vector<TimedBeatEvent> evs;
+        evs.reserve ((size_t) numEvents);
+        for (int i = 0; i < numEvents / 2; ++i)
+        {
+            const double on = rng.nextDouble() * (loopLen - 0.25);
+            const int ch = 1 + rng.nextInt (16), note = 24 + rng.nextInt (80);
+            evs.push_back ({ on,        juce::MidiMessage::noteOn (ch, note, (juce::uint8) 100) });
+            evs.push_back ({ on + 0.2,  juce::MidiMessage::noteOff (ch, note) });
+        }
+        return evs;
+    }
+
+    // The pre-cursor inner loop: every event of the pattern is tested on every tick.
+    static void fullScan (const std::vector<TimedBeatEvent>& sorted, double loopLen, double from, double to,
+                          std::vector<EmittedEvent>& out)
+    {
+        double pos = from;
+        while (pos < to - 1e-12)
+        {
+            const double iterStart = std::floor (pos / loopLen) * loopLen;
+            const double segEnd    = std::min (to, iterStart + loopLen);
+            for (const auto& ev : sorted)
+                if (ev.beats >= pos - iterStart - 1e-12 && ev.beats < segEnd - iterStart - 1e-12)
+                    out.push_back ({ iterStart + ev.beats, ShortMidiMessage::from (ev.message) });
+            pos = segEnd;
+        }
+    }
+
+    static bool isSeamNoteOff (const EmittedEvent& e, double loopLen)
+    {
+        const double phase = std::fmod (e.beats, loopLen);
+        return (e.message.data[0] & 0xf0) == 0x80 && (phase < 1e-9 || loopLen - phase < 1e-9);
+    }
+
+    void runTest() override
+    {
+        beginTest ("cursor vs full scan, 10 ms ticks @ 120 bpm");
+
+        constexpr double loopLen   = 64.0;     // 16 bars of 4/4
+        constexpr double tickBeats = 0.02;     // 10 ms @ 120 bpm
+        constexpr int    numTicks  = 3200;     // one full loop
+
+        for (int numEvents : { 10000, 30000, 100000 })
+        {
+            juce::Random rng (42);
+            auto evs = makeDenseLoop (numEvents, loopLen, rng);
+
+            ArrangerScheduler s;
+            s.setLoop (evs, loopLen);
+            auto sorted = evs;
+            std::stable_sort (sorted.begin(), sorted.end(),
+                              [] (const TimedBeatEvent& a, const TimedBeatEvent& b) { return a.beats < b.beats; });
+
+            std::vector<EmittedEvent> cursorOut, scanOut;
+            cursorOut.reserve ((size_t) s.getNumEvents() + 16 * 128);
+            scanOut.reserve ((size_t) s.getNumEvents());
+
+            const double t0 = juce::Time::getMillisecondCounterHiRes();
+            for (int t = 0; t < numTicks; ++t)
+                s.advance (t * tickBeats, (t + 1) * tickBeats, cursorOut);
+            const double t1 = juce::Time::getMillisecondCounterHiRes();
+            for (int t = 0; t < numTicks; ++t)
+                fullScan (sorted, loopLen, t * tickBeats, (t + 1) * tickBeats, scanOut);
+            const double t2 = juce::Time::getMillisecondCounterHiRes();
+
+            const double cursorUs = (t1 - t0) * 1000.0 / numTicks;
+            const double scanUs   = (t2 - t1) * 1000.0 / numTicks;
+            logMessage (juce::String (numEvents) + " events: cursor " + juce::String (cursorUs, 2)
+                        + " us/tick, full scan " + juce::String (scanUs, 2) + " us/tick ("
+                        + juce::String (scanUs / juce::jmax (1e-6, cursorUs), 1) + "x)");
+
+            // The cursor output also carries seam note-offs; apart from those, both emit the same events.
+            cursorOut.erase (std::remove_if (cursorOut.begin(), cursorOut.end(),
+                                             [] (const EmittedEvent& e) { return isSeamNoteOff (e, loopLen); }),
+                             cursorOut.end());
+            expectEquals ((int) cursorOut.size(), (int) scanOut.size());
+            int mismatches = 0;
+            for (size_t i = 0; i < juce::jmin (cursorOut.size(), scanOut.size()); ++i)
+                if (std::abs (cursorOut[i].beats - scanOut[i].beats) > 1e-9
+                    || std::memcmp (cursorOut[i].message.data, scanOut[i].message.data, 3) != 0)
+                    ++mismatches;
+            expectEquals (mismatches, 0, "cursor and full scan emit different events");
+        }
+    }
+};
+
+static ArrangerSchedulerBenchmark arrangerSchedulerBenchmark;
+
+#endif // PROJECT_SYNTH_TESTS
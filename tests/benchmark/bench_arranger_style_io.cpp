@@ -0,0 +1,83 @@
+#if PROJECT_SYNTH_TESTS
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "Arranger/ArrangerStyleIOHelper.h"
+
+// Load-time benchmark: binary (memory-mapped) .style vs the JSON path, on a synthetic style with
+// 50k events spread over 16 tracks. Results go to the test log.
+class ArrangerStyleIOBenchmark : public juce::UnitTest
+{
+public:
+    ArrangerStyleIOBenchmark() : juce::UnitTest ("ArrangerStyleIO load", "Benchmark") {}
+
+    static ArrangerStyleFile makeLargeStyle (int totalEvents)
+    {
+        ArrangerStyleFile s;
+        s.name = "Bench"; s.originalTempo = 120.0;
+        juce::Random rng (3);
+        const int perTrack = totalEvents / 16;
+        for (int tr = 0; tr < 16; ++tr)
+        {
+            SourceTrackFile t;
+            t.id = "t" + juce::String (tr); t.name = "Track " + juce::String (tr);
+            t.channel = tr + 1;
+            t.partType = tr == 9 ? ArrangerPartType::Drum : ArrangerPartType::Acc;
+            for (int i = 0; i < perTrack / 2; ++i)
+            {
+                const double on = i * 0.25;
+                const int note = 36 + rng.nextInt (48);
+                t.events.push_back ({ on,        juce::MidiMessage::noteOn  (tr + 1, note, (juce::uint8) 100) });
+                t.events.push_back ({ on + 0.2,  juce::MidiMessage::noteOff (tr + 1, note) });
+            }
+            s.sourceTracks.push_back (std::move (t));
+        }
+        for (int i = 0; i < 8; ++i)
+        {
+            SectionWindow w; w.id = "var_" + juce::String (i + 1); w.name = "Variation " + juce::String (i + 1);
+            w.startBar = 1 + i * 8; w.lengthBars = 8;
+            s.sections.push_back (w);
+        }
+        return s;
+    }
+
+    template <typename LoadFn>
+    double averageMs (int runs, LoadFn&& load)
+    {
+        double total = 0.0;
+        for (int i = 0; i < runs; ++i)
+        {
+            const double t0 = juce::Time::getMillisecondCounterHiRes();
+            load();
+            total += juce::Time::getMillisecondCounterHiRes() - t0;
+        }
+        return total / runs;
+    }
+
+    void runTest() override
+    {
+        beginTest ("load 50k-event style: binary vs JSON");
+
+        const auto style = makeLargeStyle (50000);
+        auto binFile  = juce::File::createTempFile (".style");
+        auto jsonFile = juce::File::createTempFile (".json");
+        ArrangerStyleIOHelper::saveToFile (binFile, style);
+        ArrangerStyleIOHelper::exportJson (jsonFile, style);
+
+        ArrangerStyleFile loaded; juce::String err;
+        bool ok = true;
+        const double binMs  = averageMs (10, [&] { ok = ArrangerStyleIOHelper::loadFromFile (binFile, loaded, err) && ok; });
+        const double jsonMs = averageMs (3,  [&] { ok = ArrangerStyleIOHelper::importJson (jsonFile, loaded, err) && ok; });
+
+        logMessage ("binary: " + juce::String (binMs, 2) + " ms (" + juce::String (binFile.getSize() / 1024) + " KB), "
+                    + "JSON: " + juce::String (jsonMs, 2) + " ms (" + juce::String (jsonFile.getSize() / 1024) + " KB), "
+                    + juce::String (jsonMs / juce::jmax (1e-6, binMs), 1) + "x");
+        expect (ok, err);
+
+        binFile.deleteFile();
+        jsonFile.deleteFile();
+    }
+};
+
+static ArrangerStyleIOBenchmark arrangerStyleIOBenchmark;
+
+#endif // PROJECT_SYNTH_TESTS
@@ -0,0 +1,60 @@
+#if PROJECT_SYNTH_TESTS
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../unit/AudioHandlerTestRig.h"
+
+// Benchmark: audio-callback time while every one of 16 playing channels receives a 1 kHz stream of
+// CC74 / CC71 / CC11 changes (a fast knob sweep), against the same chords with the knobs still.
+class CCSweepBenchmark : public juce::UnitTest
+{
+public:
+    CCSweepBenchmark() : juce::UnitTest ("CC sweep", "Benchmark") {}
+
+    void runTest() override
+    {
+        constexpr int numChannels = 16, blockSize = 64, warmUpBlocks = 100, timedBlocks = 3000;
+        constexpr int samplesPerCC = (int) (AudioHandlerTestRig::sampleRate / 1000.0);   // 1 kHz
+        TestSfzInstrument sfz (8, 2.0);
+        const double blockMicros = 1.0e6 * blockSize / AudioHandlerTestRig::sampleRate;
+
+        beginTest ("16 channels, still knobs vs 1 kHz sweep");
+        for (const bool sweeping : { false, true })
+        {
+            AudioHandlerTestRig rig (sfz, numChannels, blockSize);
+            for (int ch = 1; ch <= numChannels; ++ch)
+            {
+                rig.script.add (0, 0, juce::MidiMessage::controllerEvent (ch, 74, 64));
+                for (int n = 0; n < 4; ++n)
+                    rig.script.add (0, n, juce::MidiMessage::noteOn (ch, 40 + ch + n * 5, (juce::uint8) 100));
+            }
+
+            if (sweeping)
+                for (int t = samplesPerCC; t < (warmUpBlocks + timedBlocks) * blockSize; t += samplesPerCC)
+                {
+                    const int step  = t / samplesPerCC;
+                    const int value = std::abs ((step % 254) - 127);   // triangle 127 -> 0 -> 127
+                    for (int ch = 1; ch <= numChannels; ++ch)
+                        for (const int cc : { 74, 71, 11 })
+                            rig.script.add (t / blockSize, t % blockSize, juce::MidiMessage::controllerEvent (ch, cc, value));
+                }
+            rig.start();
+
+            for (int b = 0; b < warmUpBlocks; ++b)
+                rig.renderBlock();
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int b = 0; b < timedBlocks; ++b)
+                rig.renderBlock();
+            const double micros = 1.0e6 * juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start)
+                                  / timedBlocks;
+
+            logMessage (juce::String (sweeping ? "1 kHz sweep " : "still knobs ")
+                        + juce::String (micros, 1) + " us/block"
+                        + "  (" + juce::String (100.0 * micros / blockMicros, 1) + "% of real time)");
+        }
+    }
+};
+
+static CCSweepBenchmark ccSweepBenchmark;
+
+#endif // PROJECT_SYNTH_TESTS
@@ -0,0 +1,69 @@
+#if PROJECT_SYNTH_TESTS
+#include <juce_core/juce_core.h>
+#include "Arranger/ChordTransposer.h"
+
+// Micro-benchmark: per-note transposition cost (reference transpose() vs the table lookup) and the
+// cost of a chord change (LRU hit vs table build). Results go to the test log.
+class ChordTransposerBenchmark : public juce::UnitTest
+{
+public:
+    ChordTransposerBenchmark() : juce::UnitTest ("ChordTransposer throughput", "Benchmark") {}
+
+    void runTest() override
+    {
+        beginTest ("transpose() vs lookup()");
+        {
+            constexpr int numNotes = 1 << 20;
+            juce::Random rng (7);
+            std::vector<int> notes ((size_t) numNotes);
+            std::vector<PartKind> parts ((size_t) numNotes);
+            for (int i = 0; i < numNotes; ++i)
+            {
+                notes[(size_t) i] = rng.nextInt (128);
+                parts[(size_t) i] = rng.nextBool() ? PartKind::Acc : PartKind::Bass;
+            }
+
+            ChordTransposer t;
+            t.setOriginalChord ({ 0, ChordQuality::Maj, 0 });
+            t.setActiveChord ({ 9, ChordQuality::Min, 4 });
+            t.setBassInversion (true);
+
+            long long sumRef = 0, sumLut = 0;
+            const double t0 = juce::Time::getMillisecondCounterHiRes();
+            for (int i = 0; i < numNotes; ++i) sumRef += t.transpose (notes[(size_t) i], parts[(size_t) i]);
+            const double t1 = juce::Time::getMillisecondCounterHiRes();
+            for (int i = 0; i < numNotes; ++i) sumLut += t.lookup (notes[(size_t) i], parts[(size_t) i]);
+            const double t2 = juce::Time::getMillisecondCounterHiRes();
+
+            const double refNs = (t1 - t0) * 1.0e6 / numNotes;
+            const double lutNs = (t2 - t1) * 1.0e6 / numNotes;
+            logMessage ("transpose(): " + juce::String (refNs, 2) + " ns/note, lookup(): "
+                        + juce::String (lutNs, 2) + " ns/note ("
+                        + juce::String (refNs / juce::jmax (1e-6, lutNs), 1) + "x)");
+            expect (sumRef == sumLut);
+        }
+
+        beginTest ("chord change: cached vs rebuilt table");
+        {
+            constexpr int numChanges = 20000;
+            ChordTransposer t;
+            t.setOriginalChord ({ 0, ChordQuality::Maj, 0 });
+
+            const double t0 = juce::Time::getMillisecondCounterHiRes();
+            for (int i = 0; i < numChanges; ++i)                       // 4-chord loop: LRU hits
+                t.setActiveChord ({ (i % 4) * 2, ChordQuality::Maj, (i % 4) * 2 });
+            const double t1 = juce::Time::getMillisecondCounterHiRes();
+            for (int i = 0; i < numChanges; ++i)                       // 12 x 11 chords: mostly misses
+                t.setActiveChord ({ i % 12, (ChordQuality) (1 + (i / 12) % 10), i % 12 });
+            const double t2 = juce::Time::getMillisecondCounterHiRes();
+
+            logMessage ("chord change, cached: " + juce::String ((t1 - t0) * 1000.0 / numChanges, 3)
+                        + " us, rebuilt: " + juce::String ((t2 - t1) * 1000.0 / numChanges, 3) + " us");
+            expect (t.getNumTableBuilds() > 0);
+        }
+    }
+};
+
+static ChordTransposerBenchmark chordTransposerBenchmark;
+
+#endif // PROJECT_SYNTH_TESTS
@@ -0,0 +1,134 @@
+#if PROJECT_SYNTH_TESTS
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "DSPKernels.h"
+
+// Micro-benchmark: each ChannelDSP insert kernel against the scalar stereo loop it replaced, on
+// 64-sample stereo blocks. Results go to the test log as nanoseconds per block.
+class DSPKernelsBenchmark : public juce::UnitTest
+{
+public:
+    DSPKernelsBenchmark() : juce::UnitTest ("DSPKernels throughput", "Benchmark") {}
+
+    void runTest() override
+    {
+        beginTest ("scalar vs kernel, 64-sample stereo blocks");
+
+        juce::Random rng (1);
+        for (int i = 0; i < blockSize; ++i)
+            source[i] = rng.nextFloat() * 2.0f - 1.0f;
+
+        const float drive = 8.0f, norm = 1.0f / std::tanh (drive);
+        const float inc = juce::MathConstants<float>::twoPi * 5.0f / 48000.0f;
+
+        const auto scalarDistortion = [&]
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                left[i]  = std::tanh (left[i]  * drive) * norm;
+                right[i] = std::tanh (right[i] * drive) * norm;
+            }
+        };
+        const auto kernelDistortion = [&]
+        {
+            DSPKernels::saturate (left,  blockSize, drive, norm);
+            DSPKernels::saturate (right, blockSize, drive, norm);
+        };
+        report ("distortion", scalarDistortion, kernelDistortion);
+        expectSameOutput (scalarDistortion, kernelDistortion, [] {}, 2.0e-4f);
+
+        float phase = 0.0f;
+        const auto scalarTremolo = [&]
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const float mod = 1.0f - 0.6f * 0.5f * (1.0f + std::sin (phase));
+                left[i] *= mod; right[i] *= mod;
+                phase += inc;
+                if (phase >= juce::MathConstants<float>::twoPi) phase -= juce::MathConstants<float>::twoPi;
+            }
+        };
+        const auto kernelTremolo = [&]
+        {
+            phase = DSPKernels::tremoloGains (gains, blockSize, phase, inc, 0.6f);
+            juce::FloatVectorOperations::multiply (left,  gains, blockSize);
+            juce::FloatVectorOperations::multiply (right, gains, blockSize);
+        };
+        report ("tremolo", scalarTremolo, kernelTremolo);
+        expectSameOutput (scalarTremolo, kernelTremolo, [&] { phase = 1.0f; }, 2.0e-4f);
+
+        // The random mod's noise generator changed, so its output can't match the old loop's; the unit
+        // test checks the smoother against the scalar one-pole on the same noise.
+        juce::Random scalarNoise (7);
+        DSPKernels::NoiseSource noise (7);
+        float smoothed = 0.0f;
+        report ("random mod", [&]
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                smoothed = 0.998f * smoothed + 0.002f * scalarNoise.nextFloat();
+                const float mod = 1.0f - 0.5f * smoothed;
+                left[i] *= mod; right[i] *= mod;
+            }
+        }, [&]
+        {
+            noise.fill (gains, blockSize);
+            DSPKernels::smoothedNoiseGains (gains, blockSize, smoothed, 0.5f);
+            juce::FloatVectorOperations::multiply (left,  gains, blockSize);
+            juce::FloatVectorOperations::multiply (right, gains, blockSize);
+        });
+    }
+
+private:
+    static constexpr int blockSize = 64, numBlocks = 200000;
+    float source[blockSize], left[blockSize], right[blockSize], gains[blockSize];
+
+    template <typename Fn>
+    double nanosPerBlock (Fn&& fn)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            std::copy (source, source + blockSize, left);   // fresh input keeps values in range
+            std::copy (source, source + blockSize, right);
+            fn();
+        }
+        return 1.0e9 * juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start) / numBlocks;
+    }
+
+    template <typename Scalar, typename Kernel>
+    void report (const juce::String& name, Scalar&& scalar, Kernel&& kernel)
+    {
+        const double s = nanosPerBlock (scalar);
+        const double k = nanosPerBlock (kernel);
+        logMessage (name.paddedRight (' ', 12) + "scalar " + juce::String (s, 1) + " ns  kernel "
+                    + juce::String (k, 1) + " ns  (" + juce::String (s / juce::jmax (k, 1.0e-3), 2) + "x)");
+    }
+
+    // One block through each variant from the same state (reset() restores it) must agree within tolerance.
+    template <typename Scalar, typename Kernel, typename Reset>
+    void expectSameOutput (Scalar&& scalar, Kernel&& kernel, Reset&& reset, float tolerance)
+    {
+        float expectedLeft[blockSize], expectedRight[blockSize];
+        reset();
+        std::copy (source, source + blockSize, left);
+        std::copy (source, source + blockSize, right);
+        scalar();
+        std::copy (left, left + blockSize, expectedLeft);
+        std::copy (right, right + blockSize, expectedRight);
+
+        reset();
+        std::copy (source, source + blockSize, left);
+        std::copy (source, source + blockSize, right);
+        kernel();
+
+        float worst = 0.0f;
+        for (int i = 0; i < blockSize; ++i)
+            worst = juce::jmax (worst, std::abs (left[i] - expectedLeft[i]), std::abs (right[i] - expectedRight[i]));
+        expectLessThan (worst, tolerance);
+    }
+};
+
+static DSPKernelsBenchmark dspKernelsBenchmark;
+
+#endif // PROJECT_SYNTH_TESTS
@@ -0,0 +1,74 @@
+#if PROJECT_SYNTH_TESTS
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../unit/AudioHandlerTestRig.h"
+
+// Benchmark: audio-callback time for 16 SFZ channels (6-note chords, chorus + reverb on) at a
+// 64-sample block, rendered on the audio thread alone and then with 1..N render workers.
+// Results go to the test log as microseconds per block and as a share of the block's real time.
+class ParallelRenderBenchmark : public juce::UnitTest
+{
+public:
+    ParallelRenderBenchmark() : juce::UnitTest ("Parallel channel render", "Benchmark") {}
+
+    void runTest() override
+    {
+        constexpr int numChannels = 16, blockSize = 64, warmUpBlocks = 200, timedBlocks = 3000, checkedBlocks = 50;
+        TestSfzInstrument sfz (8, 2.0);
+
+        const int maxWorkers = juce::jlimit (0, ChannelRenderPool::maxWorkers,
+                                             juce::SystemStats::getNumCpus() - 1);
+        const double blockMicros = 1.0e6 * blockSize / AudioHandlerTestRig::sampleRate;
+
+        beginTest ("render time vs worker count");
+        std::vector<float> reference;   // the blocks after the timed ones, rendered with no workers
+        for (int workers = 0; workers <= maxWorkers; ++workers)
+        {
+            AudioHandlerTestRig rig (sfz, numChannels, blockSize);
+            for (int ch = 1; ch <= numChannels; ++ch)
+            {
+                rig.script.add (0, 0, juce::MidiMessage::controllerEvent (ch, 91, 90));
+                rig.script.add (0, 0, juce::MidiMessage::controllerEvent (ch, 93, 70));
+                for (int n = 0; n < 6; ++n)
+                    rig.script.add (0, n, juce::MidiMessage::noteOn (ch, 40 + ch + n * 5, (juce::uint8) 100));
+            }
+            rig.audio.setNumRenderWorkers (workers);
+            rig.start();
+
+            for (int b = 0; b < warmUpBlocks; ++b)
+                rig.renderBlock();
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int b = 0; b < timedBlocks; ++b)
+                rig.renderBlock();
+            const double micros = 1.0e6 * juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start)
+                                  / timedBlocks;
+
+            logMessage ("workers=" + juce::String (workers)
+                        + "  " + juce::String (micros, 1) + " us/block"
+                        + "  (" + juce::String (100.0 * micros / blockMicros, 1) + "% of real time)");
+
+            // The workers only change where channels render, not what is heard.
+            std::vector<float> checked;
+            for (int b = 0; b < checkedBlocks; ++b)
+            {
+                rig.renderBlock();
+                for (int c = 0; c < rig.out.getNumChannels(); ++c)
+                    checked.insert (checked.end(), rig.out.getReadPointer (c), rig.out.getReadPointer (c) + blockSize);
+            }
+            if (workers == 0)
+            {
+                reference = std::move (checked);
+                continue;
+            }
+            float maxDiff = 0.0f;
+            for (size_t i = 0; i < checked.size(); ++i)
+                maxDiff = juce::jmax (maxDiff, std::abs (checked[i] - reference[i]));
+            expectLessThan (maxDiff, 1.0e-5f, "workers=" + juce::String (workers) + " renders differently");
+        }
+    }
+};
+
+static ParallelRenderBenchmark parallelRenderBenchmark;
+
+#endif // PROJECT_SYNTH_TESTS
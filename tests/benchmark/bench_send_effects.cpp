@@ -0,0 +1,51 @@
+#if PROJECT_SYNTH_TESTS
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../unit/AudioHandlerTestRig.h"
+
+// Benchmark: audio-callback time with all 16 channels playing chords, first dry and then with every
+// channel sending to reverb (CC91), chorus (CC93) and delay (CC94) on the shared effects bus.
+class SendEffectsBenchmark : public juce::UnitTest
+{
+public:
+    SendEffectsBenchmark() : juce::UnitTest ("Send effects bus", "Benchmark") {}
+
+    void runTest() override
+    {
+        constexpr int numChannels = 16, blockSize = 64, warmUpBlocks = 200, timedBlocks = 3000;
+        TestSfzInstrument sfz (8, 2.0);
+        const double blockMicros = 1.0e6 * blockSize / AudioHandlerTestRig::sampleRate;
+
+        beginTest ("16 channels, dry vs all sending");
+        for (const bool sending : { false, true })
+        {
+            AudioHandlerTestRig rig (sfz, numChannels, blockSize);
+            for (int ch = 1; ch <= numChannels; ++ch)
+            {
+                if (sending)
+                    for (const int cc : { 91, 93, 94 })
+                        rig.script.add (0, 0, juce::MidiMessage::controllerEvent (ch, cc, 100));
+                for (int n = 0; n < 4; ++n)
+                    rig.script.add (0, n, juce::MidiMessage::noteOn (ch, 40 + ch + n * 5, (juce::uint8) 100));
+            }
+            rig.start();
+
+            for (int b = 0; b < warmUpBlocks; ++b)
+                rig.renderBlock();
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int b = 0; b < timedBlocks; ++b)
+                rig.renderBlock();
+            const double micros = 1.0e6 * juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start)
+                                  / timedBlocks;
+
+            logMessage (juce::String (sending ? "all sending" : "dry        ")
+                        + "  " + juce::String (micros, 1) + " us/block"
+                        + "  (" + juce::String (100.0 * micros / blockMicros, 1) + "% of real time)");
+        }
+    }
+};
+
+static SendEffectsBenchmark sendEffectsBenchmark;
+
+#endif // PROJECT_SYNTH_TESTS
@@ -0,0 +1,68 @@
+#if PROJECT_SYNTH_TESTS
+#include <JuceHeader.h>
+#include "../unit/TestSfzInstrument.h"
+
+// Cold against warm starts: time to load an SFZ with 400 WAV samples when nothing is cached on
+// disk (decode, then write the cache files) and when a previous run left them (map them).
+// Results go to the test log as milliseconds per load.
+class SfzDiskCacheBenchmark : public juce::UnitTest
+{
+public:
+    SfzDiskCacheBenchmark() : juce::UnitTest ("sfzero::DiskSampleCache cold and warm loads", "Benchmark") {}
+
+    void runTest() override
+    {
+        beginTest ("400 samples of 1 s");
+
+        formatManager.registerBasicFormats();
+        TestSfzInstrument sfz (400, 1.0);
+        const auto folder = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                                .getNonexistentChildFile ("sfz-disk-cache-bench", {}, false);
+        sfzero::DiskSampleCache disk (folder, (juce::int64) 1 << 32);
+
+        // Warm the OS file cache, so every configuration measures decoding rather than the disk.
+        load (sfz, nullptr);
+
+        double noCacheMs = 0.0, coldMs = 0.0, warmMs = 0.0;
+        for (int round = 0; round < numRounds; ++round)
+        {
+            noCacheMs += load (sfz, nullptr);
+            disk.clear();
+            coldMs += load (sfz, &disk);
+            warmMs += load (sfz, &disk);
+        }
+        expectEquals (disk.getNumFiles(), 400);
+
+        logMessage ("no disk cache: " + juce::String (noCacheMs / numRounds, 1) + " ms per load");
+        logMessage ("cold:          " + juce::String (coldMs / numRounds, 1) + " ms per load, "
+                    + juce::File::descriptionOfSizeInBytes (disk.getNumBytesOnDisk()) + " written");
+        logMessage ("warm:          " + juce::String (warmMs / numRounds, 1) + " ms per load ("
+                    + juce::String (noCacheMs / juce::jmax (warmMs, 1.0e-3), 2) + "x faster than decoding)");
+
+        folder.deleteRecursively();
+    }
+
+private:
+    static constexpr int numRounds = 5;
+    juce::AudioFormatManager formatManager;
+
+    // A fresh SampleCache each time, as after an application restart.
+    double load (const TestSfzInstrument& sfz, sfzero::DiskSampleCache* disk)
+    {
+        sfzero::SampleCache cache;
+        cache.setDiskCache (disk);
+        sfzero::Sound::Ptr sound (new sfzero::Sound (sfz.getSfzFile()));
+        sound->loadRegions();
+        sound->setSampleCache (&cache);
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        sound->loadSamples (&formatManager);
+        const double ms = 1000.0 * juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+        expect (sound->getErrors().isEmpty());
+        return ms;
+    }
+};
+
+static SfzDiskCacheBenchmark sfzDiskCacheBenchmark;
+
+#endif // PROJECT_SYNTH_TESTS
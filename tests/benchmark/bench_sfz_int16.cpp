@@ -0,0 +1,86 @@
+#if PROJECT_SYNTH_TESTS
+#include <JuceHeader.h>
+#include "../unit/TestSfzInstrument.h"
+
+// What 16-bit in-memory samples cost: voices per core at 48 kHz with 128-sample blocks, and the
+// sample memory held, for float storage and for int16 storage converted in the voice loop.
+class SfzInt16Benchmark : public juce::UnitTest
+{
+public:
+    SfzInt16Benchmark() : juce::UnitTest ("sfzero::Sample int16 render cost", "Benchmark") {}
+
+    void runTest() override
+    {
+        beginTest ("48 kHz, 128-sample blocks");
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        // Long enough that the voices' reads spread over more memory than the caches hold.
+        TestSfzInstrument sfz (8, 4.0);
+        auto floats = load (sfz, formatManager, false);
+        auto ints   = load (sfz, formatManager, true);
+
+        juce::AudioBuffer<float> floatOut (2, blockSize), int16Out (2, blockSize);
+        const double floatTime = secondsPerVoiceBlock (*floats, floatOut);
+        const double int16Time = secondsPerVoiceBlock (*ints, int16Out);
+        const double budget = blockSize / sampleRate;
+
+        logMessage ("float: " + juce::String (budget / floatTime, 0) + " voices/core ("
+                    + juce::String (floatTime * 1.0e9, 0) + " ns per voice block), "
+                    + juce::File::descriptionOfSizeInBytes (floats->getMemoryBytes()));
+        logMessage ("int16: " + juce::String (budget / int16Time, 0) + " voices/core ("
+                    + juce::String (int16Time * 1.0e9, 0) + " ns per voice block, "
+                    + juce::String (floatTime / int16Time, 2) + "x), "
+                    + juce::File::descriptionOfSizeInBytes (ints->getMemoryBytes()));
+
+        // Same last block, apart from each voice's 16-bit rounding of the samples.
+        float worst = 0.0f;
+        for (int c = 0; c < 2; ++c)
+            for (int i = 0; i < blockSize; ++i)
+                worst = juce::jmax (worst, std::abs (floatOut.getSample (c, i) - int16Out.getSample (c, i)));
+        expectLessThan (worst, numVoices / 32768.0f);
+        expectEquals (ints->getMemoryBytes() * 2, floats->getMemoryBytes());
+    }
+
+private:
+    static constexpr int numVoices = 64, blockSize = 128, numBlocks = 2000;
+    static constexpr double sampleRate = 48000.0;
+
+    static sfzero::Sound::Ptr load (const TestSfzInstrument& sfz, juce::AudioFormatManager& formatManager, bool int16)
+    {
+        sfzero::Sound::Ptr sound (new sfzero::Sound (sfz.getSfzFile()));
+        sound->loadRegions();
+        sound->setInt16Samples (int16);
+        sound->loadSamples (&formatManager);
+        return sound;
+    }
+
+    // Renders numBlocks blocks of numVoices voices; out is left holding the last one.
+    static double secondsPerVoiceBlock (sfzero::Sound& sound, juce::AudioBuffer<float>& out)
+    {
+        juce::OwnedArray<sfzero::Voice> voices;
+        for (int v = 0; v < numVoices; ++v)
+        {
+            const int note = 24 + (v * 7) % 80;
+            auto* voice = voices.add (new sfzero::Voice());
+            voice->setCurrentPlaybackSampleRate (sampleRate);
+            voice->setRegion (sound.getRegionFor (note, 100));
+            voice->startNote (note, 0.8f, &sound, 8192);
+        }
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            out.clear();
+            for (auto* voice : voices)
+                voice->renderNextBlock (out, 0, blockSize);
+        }
+        const double seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+        return seconds / ((double) numBlocks * numVoices);
+    }
+};
+
+static SfzInt16Benchmark sfzInt16Benchmark;
+
+#endif // PROJECT_SYNTH_TESTS
@@ -0,0 +1,59 @@
+#if PROJECT_SYNTH_TESTS
+#include <JuceHeader.h>
+#include "../unit/TestSfzInstrument.h"
+
+// Time to load an SFZ with 400 WAV samples, decoding on one thread and with a shared load pool.
+// Results go to the test log as milliseconds per load.
+class SfzLoadBenchmark : public juce::UnitTest
+{
+public:
+    SfzLoadBenchmark() : juce::UnitTest ("sfzero::Sound loadSamples", "Benchmark") {}
+
+    void runTest() override
+    {
+        beginTest ("400 samples of 1 s");
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        TestSfzInstrument sfz (400, 1.0);
+
+        // Warm the OS file cache, so every configuration measures decoding rather than the disk.
+        sfzero::Sound::Ptr warmUp (new sfzero::Sound (sfz.getSfzFile()));
+        warmUp->loadRegions();
+        warmUp->loadSamples (&formatManager);
+        warmUp = nullptr;
+
+        const int defaultThreads = sfzero::Sound (sfz.getSfzFile()).getNumLoadThreads();
+        juce::ThreadPool loadPool (juce::jmax (1, defaultThreads - 1));
+        double serialMs = 0.0;
+        for (int numThreads : { 1, 2, 4, defaultThreads })
+        {
+            double totalMs = 0.0;
+            for (int round = 0; round < numRounds; ++round)
+            {
+                sfzero::Sound::Ptr sound (new sfzero::Sound (sfz.getSfzFile()));
+                sound->loadRegions();
+                sound->setLoadPool (&loadPool);
+                sound->setNumLoadThreads (numThreads);
+
+                const auto start = juce::Time::getHighResolutionTicks();
+                sound->loadSamples (&formatManager);
+                totalMs += 1000.0 * juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+                expect (sound->getErrors().isEmpty());
+            }
+
+            const double ms = totalMs / numRounds;
+            if (numThreads == 1)
+                serialMs = ms;
+            logMessage (juce::String (numThreads).paddedLeft (' ', 2) + " threads: " + juce::String (ms, 1)
+                        + " ms per load (" + juce::String (serialMs / ms, 2) + "x)");
+        }
+    }
+
+private:
+    static constexpr int numRounds = 5;
+};
+
+static SfzLoadBenchmark sfzLoadBenchmark;
+
+#endif // PROJECT_SYNTH_TESTS
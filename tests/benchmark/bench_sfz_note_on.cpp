@@ -0,0 +1,64 @@
+#if PROJECT_SYNTH_TESTS
+#include <JuceHeader.h>
+#include "../unit/TestSfzInstrument.h"
+
+// Cost of sfzero::Synth::noteOn with 64, 128 and 256 voices: taking a free voice, and stealing one
+// when every voice is busy. Results go to the test log as nanoseconds per note-on.
+class SfzNoteOnBenchmark : public juce::UnitTest
+{
+public:
+    SfzNoteOnBenchmark() : juce::UnitTest ("sfzero::Synth noteOn", "Benchmark") {}
+
+    void runTest() override
+    {
+        beginTest ("noteOn, free and stealing");
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        TestSfzInstrument sfz (4, 0.1);
+        sfzero::Sound::Ptr sound (new sfzero::Sound (sfz.getSfzFile()));
+        sound->loadRegions();
+        sound->loadSamples (&formatManager);
+
+        for (int numVoices : { 64, 128, 256 })
+        {
+            sfzero::Synth synth;
+            synth.setCurrentPlaybackSampleRate (48000.0);
+            synth.setNumVoices (numVoices);
+            synth.addSound (sound.get());
+
+            double freeSeconds = 0.0, stealSeconds = 0.0;
+            for (int round = 0; round < numRounds; ++round)
+            {
+                // Fill every voice, each with a distinct (channel, note).
+                auto start = juce::Time::getHighResolutionTicks();
+                for (int i = 0; i < numVoices; ++i)
+                    synth.noteOn (1 + i / 128, i % 128, 0.5f + 0.5f * (float) ((i * 37) % 64) / 64.0f);
+                freeSeconds += juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+
+                // Now every note-on has to steal.
+                start = juce::Time::getHighResolutionTicks();
+                for (int i = 0; i < numVoices; ++i)
+                    synth.noteOn (3 + i / 128, i % 128, 0.7f);
+                stealSeconds += juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+
+                for (int ch = 1; ch <= 16; ++ch)
+                    synth.allNotesOff (ch, false);
+            }
+
+            const double notes = (double) numRounds * numVoices;
+            logMessage (juce::String (numVoices).paddedLeft (' ', 3) + " voices: free "
+                        + juce::String (1.0e9 * freeSeconds / notes, 0) + " ns  steal "
+                        + juce::String (1.0e9 * stealSeconds / notes, 0) + " ns per noteOn");
+            expectEquals (synth.numVoicesUsed(), 0);
+        }
+    }
+
+private:
+    static constexpr int numRounds = 200;
+};
+
+static SfzNoteOnBenchmark sfzNoteOnBenchmark;
+
+#endif // PROJECT_SYNTH_TESTS
@@ -0,0 +1,113 @@
+#if PROJECT_SYNTH_TESTS
+#include <JuceHeader.h>
+#include "../unit/TestSfzInstrument.h"
+
+// Parse times for large instruments: an .sfz of 20000 regions (plain, and split over #include
+// files with #define'd values), and an SF2 of 256 presets, whose int16 frames are mapped rather
+// than converted to float. Results go to the test log as milliseconds per load.
+class SfzParseBenchmark : public juce::UnitTest
+{
+public:
+    SfzParseBenchmark() : juce::UnitTest ("sfzero::Reader and SF2Reader parse times", "Benchmark") {}
+
+    void runTest() override
+    {
+        const auto folder = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                                .getNonexistentChildFile ("sfz-parse-bench", {}, false);
+        folder.createDirectory();
+
+        beginTest ("SFZ with 20000 regions");
+        {
+            const auto plain = folder.getChildFile ("plain.sfz");
+            plain.replaceWithText (regions (0, numRegions, false));
+
+            // The same regions in 20 #include'd files, with the velocity layers #define'd once.
+            juce::String main ("#define $LOVEL 1\n#define $HIVEL 127\n");
+            for (int part = 0; part < 20; ++part)
+            {
+                const auto name = "part" + juce::String (part) + ".sfzh";
+                folder.getChildFile (name).replaceWithText (regions (part * numRegions / 20, (part + 1) * numRegions / 20, true));
+                main << "#include \"" << name << "\"\n";
+            }
+            const auto included = folder.getChildFile ("included.sfz");
+            included.replaceWithText (main);
+
+            for (const auto& file : { plain, included })
+            {
+                double ms = 0.0;
+                for (int round = 0; round < numRounds; ++round)
+                {
+                    sfzero::Sound::Ptr sound (new sfzero::Sound (file));
+                    const auto start = juce::Time::getHighResolutionTicks();
+                    sound->loadRegions();
+                    ms += 1000.0 * juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+                    expectEquals (sound->getNumRegions(), numRegions);
+                    expect (sound->getErrors().isEmpty());
+                }
+                logMessage (file.getFileName() + ": " + juce::String (ms / numRounds, 1) + " ms per parse ("
+                            + juce::File::descriptionOfSizeInBytes (plain.getSize()) + " of opcodes)");
+            }
+        }
+
+        beginTest ("SF2 with 256 presets of 1 s");
+        {
+            TestSf2File sf2 (256, 44100);
+            double regionsMs = 0.0, floatMs = 0.0, int16Ms = 0.0;
+            for (int round = 0; round < numRounds; ++round)
+            {
+                regionsMs += loadSf2 (sf2, false, nullptr);
+                loadSf2 (sf2, false, &floatMs);
+                loadSf2 (sf2, true, &int16Ms);
+            }
+            logMessage ("loadRegions:          " + juce::String (regionsMs / numRounds, 2) + " ms");
+            logMessage ("loadSamples (float):  " + juce::String (floatMs / numRounds, 2) + " ms, "
+                        + juce::File::descriptionOfSizeInBytes (sf2.getFile().getSize()) + " file");
+            logMessage ("loadSamples (mapped): " + juce::String (int16Ms / numRounds, 3) + " ms ("
+                        + juce::String (floatMs / juce::jmax (int16Ms, 1.0e-3), 0) + "x faster)");
+        }
+
+        folder.deleteRecursively();
+    }
+
+private:
+    static constexpr int numRegions = 20000, numRounds = 5;
+
+    static juce::String regions (int first, int last, bool useDefines)
+    {
+        juce::String sfz;
+        for (int r = first; r < last; ++r)
+        {
+            const int key = r % 128;
+            sfz << "<region> sample=samples/layer " << r / 128 << "/note_" << key << ".wav"
+                << " lokey=" << key << " hikey=" << key << " pitch_keycenter=" << key
+                << " lovel=" << (useDefines ? "$LOVEL" : "1") << " hivel=" << (useDefines ? "$HIVEL" : "127")
+                << " volume=-" << (r % 12) << ".5 pan=" << (r % 200 - 100)
+                << " ampeg_attack=0.005 ampeg_release=0.4 loop_mode=loop_continuous"
+                << " loop_start=" << 1000 + r << " loop_end=" << 40000 + r << "\n";
+        }
+        return sfz;
+    }
+
+    // Milliseconds spent in loadRegions(), or in loadSamples() added to samplesMs when it is given.
+    double loadSf2 (const TestSf2File& sf2, bool int16, double* samplesMs)
+    {
+        sfzero::SF2Sound::Ptr sound (new sfzero::SF2Sound (sf2.getFile()));
+        sound->setInt16Samples (int16);
+        auto start = juce::Time::getHighResolutionTicks();
+        sound->loadRegions();
+        const double regionsMs = 1000.0 * juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+        expectEquals (sound->numSubsounds(), 256);
+        if (samplesMs == nullptr)
+            return regionsMs;
+
+        start = juce::Time::getHighResolutionTicks();
+        sound->loadSamples (nullptr);
+        *samplesMs += 1000.0 * juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+        expect (sound->getErrors().isEmpty());
+        return regionsMs;
+    }
+};
+
+static SfzParseBenchmark sfzParseBenchmark;
+
+#endif // PROJECT_SYNTH_TESTS
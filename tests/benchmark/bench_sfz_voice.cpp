@@ -0,0 +1,86 @@
+#if PROJECT_SYNTH_TESTS
+#include <JuceHeader.h>
+#include "../unit/TestSfzInstrument.h"
+#include "../unit/ScalarVoiceRenderer.h"
+
+// Voices per core: how many looping sfzero voices one core can render in real time at 48 kHz with
+// 128-sample blocks, for the per-sample renderer and the run-based one that replaced it.
+class SfzVoiceBenchmark : public juce::UnitTest
+{
+public:
+    SfzVoiceBenchmark() : juce::UnitTest ("sfzero::Voice voices per core", "Benchmark") {}
+
+    void runTest() override
+    {
+        beginTest ("48 kHz, 128-sample blocks");
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        TestSfzInstrument sfz (4, 0.5);
+        sfzero::Sound::Ptr sound (new sfzero::Sound (sfz.getSfzFile()));
+        sound->loadRegions();
+        sound->loadSamples (&formatManager);
+
+        juce::AudioBuffer<float> scalarOut (2, blockSize), runsOut (2, blockSize);
+        const double scalar = secondsPerVoiceBlock (*sound, false, scalarOut);
+        const double runs   = secondsPerVoiceBlock (*sound, true, runsOut);
+        const double budget = blockSize / sampleRate;
+
+        logMessage ("scalar: " + juce::String (budget / scalar, 0) + " voices/core ("
+                    + juce::String (scalar * 1.0e9, 0) + " ns per voice block)");
+        logMessage ("runs:   " + juce::String (budget / runs, 0) + " voices/core ("
+                    + juce::String (runs * 1.0e9, 0) + " ns per voice block, "
+                    + juce::String (scalar / runs, 2) + "x)");
+
+        // Both renderers must end on the same block; each voice agrees within 1e-5 (see the unit test).
+        expectLessThan (maxDifference (scalarOut, runsOut), numVoices * 1.0e-5f);
+    }
+
+private:
+    static constexpr int numVoices = 64, blockSize = 128, numBlocks = 2000;
+    static constexpr double sampleRate = 48000.0;
+
+    static float maxDifference (const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        float worst = 0.0f;
+        for (int c = 0; c < a.getNumChannels(); ++c)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                worst = juce::jmax (worst, std::abs (a.getSample (c, i) - b.getSample (c, i)));
+        return worst;
+    }
+
+    // Renders numBlocks blocks of numVoices voices; out is left holding the last one.
+    static double secondsPerVoiceBlock (sfzero::Sound& sound, bool useRuns, juce::AudioBuffer<float>& out)
+    {
+        juce::OwnedArray<sfzero::Voice> voices;
+        for (int v = 0; v < numVoices; ++v)
+        {
+            // Spread over the keyboard, so the pitch ratios (and so the run lengths) vary.
+            const int note = 24 + (v * 7) % 80;
+            auto* voice = voices.add (new sfzero::Voice());
+            voice->setCurrentPlaybackSampleRate (sampleRate);
+            voice->setRegion (sound.getRegionFor (note, 100));
+            voice->startNote (note, 0.8f, &sound, 8192);
+        }
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            out.clear();
+            for (auto* voice : voices)
+            {
+                if (useRuns)
+                    voice->renderNextBlock (out, 0, blockSize);
+                else
+                    sfzero::ScalarVoiceRenderer::render (*voice, out, 0, blockSize);
+            }
+        }
+        const double seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+        return seconds / ((double) numBlocks * numVoices);
+    }
+};
+
+static SfzVoiceBenchmark sfzVoiceBenchmark;
+
+#endif // PROJECT_SYNTH_TESTS
@@ -0,0 +1,61 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    thread_local bool        countingEnabled = false;
+    thread_local std::size_t allocationCount = 0;
+
+    void* countedAlloc (std::size_t size)
+    {
+        if (countingEnabled)
+            ++allocationCount;
+        return std::malloc (size == 0 ? 1 : size);
+    }
+}
+
+ScopedAllocationCounter::ScopedAllocationCounter()
+    : startCount (allocationCount), wasCounting (countingEnabled)
+{
+    countingEnabled = true;
+}
+
+ScopedAllocationCounter::~ScopedAllocationCounter()
+{
+    countingEnabled = wasCounting;
+}
+
+std::size_t ScopedAllocationCounter::getCount() const
+{
+    return allocationCount - startCount;
+}
+
+//==============================================================================
+// Tests are compiled into the app, so the replacements are limited to builds that define
+// PROJECT_SYNTH_TESTS (Debug); Release keeps the default allocator and counts nothing.
+#if PROJECT_SYNTH_TESTS
+void* operator new (std::size_t size)
+{
+    if (auto* p = countedAlloc (size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size)
+{
+    if (auto* p = countedAlloc (size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new   (std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc (size); }
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc (size); }
+
+void operator delete   (void* p) noexcept                              { std::free (p); }
+void operator delete[] (void* p) noexcept                              { std::free (p); }
+void operator delete   (void* p, std::size_t) noexcept                 { std::free (p); }
+void operator delete[] (void* p, std::size_t) noexcept                 { std::free (p); }
+void operator delete   (void* p, const std::nothrow_t&) noexcept       { std::free (p); }
+void operator delete[] (void* p, const std::nothrow_t&) noexcept       { std::free (p); }
+#endif
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * Test hook: counts heap allocations made by the current thread while a ScopedAllocationCounter is
+ * alive. The global operator new/delete replacements live in AllocationCounter.cpp and are only
+ * built with PROJECT_SYNTH_TESTS (the test runner's builds); outside a scope they cost one
+ * thread-local check and behave exactly like the defaults. Without the flag getCount() stays 0.
+ *
+ *     ScopedAllocationCounter counter;
+ *     engine.renderRange (0.0, 0.02, block, 480);
+ *     expectEquals (counter.getCount(), 0);
+ */
+class ScopedAllocationCounter
+{
+public:
+    ScopedAllocationCounter();
+    ~ScopedAllocationCounter();
+
+    /** Allocations on this thread since the scope opened. */
+    std::size_t getCount() const;
+
+private:
+    std::size_t startCount;
+    bool        wasCounting;
+};
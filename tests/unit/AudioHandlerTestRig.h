@@ -0,0 +1,77 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include "AudioClockMidiSource.h"
+#include "AudioHandler.h"
+#include "MidiHandler.h"
+#include "TestSfzInstrument.h"
+#include <vector>
+
+/**
+ * Test fixture: an AudioClockMidiSource that plays a fixed script of (block, sample offset, message)
+ * events, so AudioHandler tests and benchmarks can drive the audio callback without MIDI devices.
+ * Events are stored sorted by block; renderAudioBlock never allocates.
+ */
+class ScriptedMidiSource : public AudioClockMidiSource
+{
+public:
+    /** Events must be added in block order, before the source is attached. */
+    void add (int block, int sampleOffset, const juce::MidiMessage& message)
+    {
+        script.push_back ({ block, sampleOffset, message });
+    }
+
+    void renderAudioBlock (juce::MidiBuffer& out, int numSamples, double) override
+    {
+        for (; next < script.size() && script[next].block <= blockIndex; ++next)
+            if (script[next].block == blockIndex)
+                out.addEvent (script[next].message, juce::jlimit (0, numSamples - 1, script[next].sampleOffset));
+        ++blockIndex;
+    }
+
+    int getBlockIndex() const { return blockIndex; }
+
+private:
+    struct Event { int block, sampleOffset; juce::MidiMessage message; };
+    std::vector<Event> script;
+    size_t next = 0;
+    int blockIndex = 0;
+};
+
+/**
+ * Test fixture: an AudioHandler with no audio device, its channels loaded from a TestSfzInstrument
+ * and its MIDI coming from a ScriptedMidiSource. renderBlock() runs one audio callback into `out`.
+ */
+struct AudioHandlerTestRig
+{
+    static constexpr double sampleRate = 48000.0;
+
+    MidiDevice         device;
+    MidiHandler        midiHandler { device };
+    AudioHandler       audio { midiHandler };
+    ScriptedMidiSource script;
+    juce::AudioBuffer<float> out;
+    int blockSize;
+
+    /** Loads `sfz` onto channels 1..numChannels and waits for the background loads to finish. */
+    AudioHandlerTestRig (const TestSfzInstrument& sfz, int numChannels, int blockSizeToUse = 64)
+        : out (2, blockSizeToUse), blockSize (blockSizeToUse)
+    {
+        audio.prepareToPlay (sampleRate, blockSize);
+        for (int ch = 1; ch <= numChannels; ++ch)
+            audio.loadSfz (sfz.getSfzFile(), ch);
+        for (int waited = 0; audio.isLoadingSfz() && waited < 20000; waited += 5)
+            juce::Thread::sleep (5);
+    }
+
+    ~AudioHandlerTestRig() { audio.setAudioClockSource (nullptr); }
+
+    /** Call after the script is complete. */
+    void start() { audio.setAudioClockSource (&script); }
+
+    void renderBlock()
+    {
+        audio.audioDeviceIOCallbackWithContext (nullptr, 0, out.getArrayOfWritePointers(), out.getNumChannels(),
+                                                blockSize, juce::AudioIODeviceCallbackContext {});
+    }
+};
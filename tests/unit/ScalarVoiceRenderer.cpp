@@ -0,0 +1,91 @@
+#include "ScalarVoiceRenderer.h"
+
+void sfzero::ScalarVoiceRenderer::render (Voice& voice, juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
+{
+    if (voice.region_ == nullptr)
+        return;
+
+    jassert (! voice.region_->sample->isStreaming());               // reads the whole sample from its buffer
+    jassert (voice.region_->sample->getFloatData (0) != nullptr);   // and only float storage
+
+    juce::AudioSampleBuffer* buffer = voice.region_->sample->getBuffer();
+    const float* inL = buffer->getReadPointer (0, 0);
+    const float* inR = buffer->getNumChannels() > 1 ? buffer->getReadPointer (1, 0) : nullptr;
+
+    float* outL = outputBuffer.getWritePointer (0, startSample);
+    float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer (1, startSample) : nullptr;
+
+    const int bufferNumSamples = buffer->getNumSamples();
+
+    auto& ampeg = voice.ampeg_;
+    double sourceSamplePosition = voice.sourceSamplePosition_;
+    float ampegGain = ampeg.getLevel();
+    float ampegSlope = ampeg.getSlope();
+    int samplesUntilNextAmpSegment = ampeg.getSamplesUntilNextSegment();
+    bool ampSegmentIsExponential = ampeg.getSegmentIsExponential();
+    const float loopStart = static_cast<float> (voice.loopStart_);
+    const float loopEnd   = static_cast<float> (voice.loopEnd_);
+    const float sampleEnd = static_cast<float> (voice.sampleEnd_);
+
+    while (--numSamples >= 0)
+    {
+        const int pos = static_cast<int> (sourceSamplePosition);
+        jassert (pos >= 0 && pos < bufferNumSamples);
+        const float alpha = static_cast<float> (sourceSamplePosition - pos);
+        const float invAlpha = 1.0f - alpha;
+        int nextPos = pos + 1;
+        if ((loopStart < loopEnd) && (nextPos > loopEnd))
+            nextPos = static_cast<int> (loopStart);
+
+        // Linear interpolation, holding the last frame past the buffer end.
+        const float nextL = nextPos < bufferNumSamples ? inL[nextPos] : inL[pos];
+        const float nextR = inR ? (nextPos < bufferNumSamples ? inR[nextPos] : inR[pos]) : nextL;
+        float l = (inL[pos] * invAlpha + nextL * alpha);
+        float r = inR ? (inR[pos] * invAlpha + nextR * alpha) : l;
+
+        l *= voice.noteGainLeft_ * ampegGain;
+        r *= voice.noteGainRight_ * ampegGain;
+
+        if (outR)
+        {
+            *outL++ += l;
+            *outR++ += r;
+        }
+        else
+        {
+            *outL++ += (l + r) * 0.5f;
+        }
+
+        sourceSamplePosition += voice.pitchRatio_;
+        if ((loopStart < loopEnd) && (sourceSamplePosition > loopEnd))
+        {
+            sourceSamplePosition = loopStart;
+            voice.numLoops_ += 1;
+        }
+
+        if (ampSegmentIsExponential)
+            ampegGain *= ampegSlope;
+        else
+            ampegGain += ampegSlope;
+
+        if (--samplesUntilNextAmpSegment < 0)
+        {
+            ampeg.setLevel (ampegGain);
+            ampeg.nextSegment();
+            ampegGain = ampeg.getLevel();
+            ampegSlope = ampeg.getSlope();
+            samplesUntilNextAmpSegment = ampeg.getSamplesUntilNextSegment();
+            ampSegmentIsExponential = ampeg.getSegmentIsExponential();
+        }
+
+        if ((sourceSamplePosition >= sampleEnd) || ampeg.isDone())
+        {
+            voice.killNote();
+            break;
+        }
+    }
+
+    voice.sourceSamplePosition_ = sourceSamplePosition;
+    ampeg.setLevel (ampegGain);
+    ampeg.setSamplesUntilNextSegment (samplesUntilNextAmpSegment);
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <JuceHeader.h>
+
+namespace sfzero
+{
+/**
+ * Test reference: the original one-sample-at-a-time sfzero::Voice renderer, which the run-based
+ * Voice::renderNextBlock replaced. Kept out of the module; the voice unit test checks the two agree
+ * and the voice benchmark times one against the other. Only in-memory float samples (no streaming).
+ *
+ *     voice.renderNextBlock (a, 0, blockSize);
+ *     sfzero::ScalarVoiceRenderer::render (reference, b, 0, blockSize);
+ */
+struct ScalarVoiceRenderer
+{
+    static void render (Voice& voice, juce::AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
+};
+}
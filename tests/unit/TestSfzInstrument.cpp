@@ -0,0 +1,207 @@
+#include "TestSfzInstrument.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+
+TestSfzInstrument::TestSfzInstrument (int numRegions, double lengthSeconds, double sampleRate,
+                                      const juce::String& extraOpcodes)
+{
+    folder = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                 .getNonexistentChildFile ("sfz-test", {}, false);
+    folder.createDirectory();
+
+    const int numSamples = juce::jmax (64, (int) (lengthSeconds * sampleRate));
+    juce::String sfz;
+
+    for (int r = 0; r < numRegions; ++r)
+    {
+        // A whole number of periods, so the loop is seamless.
+        const int period = 100 + r;
+        const int length = numSamples - numSamples % period;
+
+        juce::AudioBuffer<float> tone (1, length);
+        for (int i = 0; i < length; ++i)
+            tone.setSample (0, i, 0.5f * std::sin (juce::MathConstants<float>::twoPi * (float) (i % period) / (float) period));
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::OutputStream> stream (getSampleFile (r).createOutputStream());
+        if (auto* writer = wav.createWriterFor (stream.get(), sampleRate, 1, 16, {}, 0))
+        {
+            stream.release();   // the writer owns it now
+            std::unique_ptr<juce::AudioFormatWriter> owned (writer);
+            owned->writeFromAudioSampleBuffer (tone, 0, length);
+        }
+
+        const int lo = r * 128 / numRegions;
+        const int hi = (r + 1) * 128 / numRegions - 1;
+        sfz << "<region> sample=" << getSampleFile (r).getFileName()
+            << " lokey=" << lo << " hikey=" << hi << " pitch_keycenter=" << (lo + hi) / 2
+            << " loop_mode=loop_continuous loop_start=0 loop_end=" << (length - 1);
+        if (extraOpcodes.isNotEmpty())
+            sfz << " " << extraOpcodes;
+        sfz << "\n";
+    }
+
+    getSfzFile().replaceWithText (sfz);
+}
+
+TestSfzInstrument::~TestSfzInstrument()
+{
+    folder.deleteRecursively();
+}
+
+juce::File TestSfzInstrument::getSampleFile (int region) const
+{
+    return folder.getChildFile ("tone" + juce::String (region) + ".wav");
+}
+
+//==============================================================================
+// RIFF chunks are written into a MemoryOutputStream with their sizes patched in afterwards.
+static juce::int64 beginChunk (juce::MemoryOutputStream& out, const char* id, const char* listType = nullptr)
+{
+    out.write (id, 4);
+    out.writeInt (0);
+    const auto start = (juce::int64) out.getPosition();
+    if (listType != nullptr)
+        out.write (listType, 4);
+    return start;
+}
+
+static void endChunk (juce::MemoryOutputStream& out, juce::int64 start)
+{
+    const auto end = (juce::int64) out.getPosition();
+    out.setPosition (start - 4);
+    out.writeInt ((int) (end - start));
+    out.setPosition (end);
+}
+
+static void writeName (juce::MemoryOutputStream& out, const juce::String& name)
+{
+    char text[20] = {};
+    name.copyToUTF8 (text, sizeof (text));
+    out.write (text, sizeof (text));
+}
+
+TestSf2File::TestSf2File (int numPresets, int numFramesIn, double sampleRate)
+    : numFrames (numFramesIn)
+{
+    folder = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                 .getNonexistentChildFile ("sf2-test", {}, false);
+    folder.createDirectory();
+
+    // The spec asks for 46 zero frames after each sample.
+    const int stride = numFrames + 46;
+    juce::MemoryOutputStream out;
+    const auto riff = beginChunk (out, "RIFF", "sfbk");
+
+    const auto info = beginChunk (out, "LIST", "INFO");
+    const auto ifil = beginChunk (out, "ifil");
+    out.writeShort (2);
+    out.writeShort (1);
+    endChunk (out, ifil);
+    endChunk (out, info);
+
+    const auto sdta = beginChunk (out, "LIST", "sdta");
+    const auto smpl = beginChunk (out, "smpl");
+    for (int s = 0; s < numPresets; ++s)
+    {
+        const int period = 100 + s;
+        for (int i = 0; i < stride; ++i)
+            out.writeShort (i < numFrames ? (short) (16000.0 * std::sin (juce::MathConstants<double>::twoPi * (i % period) / period)) : 0);
+    }
+    endChunk (out, smpl);
+    endChunk (out, sdta);
+
+    const auto pdta = beginChunk (out, "LIST", "pdta");
+    // Every list ends with a terminal record, which the one before it uses as its end index.
+    const auto phdr = beginChunk (out, "phdr");
+    for (int p = 0; p <= numPresets; ++p)
+    {
+        writeName (out, p < numPresets ? "Preset " + juce::String (p) : juce::String ("EOP"));
+        out.writeShort ((short) (p < numPresets ? p : 0));   // preset
+        out.writeShort (0);                                 // bank
+        out.writeShort ((short) p);                         // presetBagNdx
+        out.writeInt (0);
+        out.writeInt (0);
+        out.writeInt (0);
+    }
+    endChunk (out, phdr);
+
+    const auto pbag = beginChunk (out, "pbag");
+    for (int p = 0; p <= numPresets; ++p)
+    {
+        out.writeShort ((short) p);   // genNdx
+        out.writeShort (0);           // modNdx
+    }
+    endChunk (out, pbag);
+
+    const auto pmod = beginChunk (out, "pmod");
+    out.writeRepeatedByte (0, 10);
+    endChunk (out, pmod);
+
+    const auto pgen = beginChunk (out, "pgen");
+    for (int p = 0; p <= numPresets; ++p)
+    {
+        out.writeShort (p < numPresets ? 41 : 0);   // instrument
+        out.writeShort (p < numPresets ? (short) p : 0);
+    }
+    endChunk (out, pgen);
+
+    const auto inst = beginChunk (out, "inst");
+    for (int p = 0; p <= numPresets; ++p)
+    {
+        writeName (out, p < numPresets ? "Instrument " + juce::String (p) : juce::String ("EOI"));
+        out.writeShort ((short) p);   // instBagNdx
+    }
+    endChunk (out, inst);
+
+    const auto ibag = beginChunk (out, "ibag");
+    for (int p = 0; p <= numPresets; ++p)
+    {
+        out.writeShort ((short) (2 * p));   // instGenNdx
+        out.writeShort (0);                 // instModNdx
+    }
+    endChunk (out, ibag);
+
+    const auto imod = beginChunk (out, "imod");
+    out.writeRepeatedByte (0, 10);
+    endChunk (out, imod);
+
+    const auto igen = beginChunk (out, "igen");
+    for (int p = 0; p < numPresets; ++p)
+    {
+        out.writeShort (54);   // sampleModes: loop continuously
+        out.writeShort (1);
+        out.writeShort (53);   // sampleID, last in the zone
+        out.writeShort ((short) p);
+    }
+    out.writeRepeatedByte (0, 4);
+    endChunk (out, igen);
+
+    const auto shdr = beginChunk (out, "shdr");
+    for (int p = 0; p <= numPresets; ++p)
+    {
+        const int start = p * stride;
+        const int period = 100 + p;
+        const int loopEnd = numFrames - numFrames % period;
+        const bool terminal = p == numPresets;
+        writeName (out, terminal ? juce::String ("EOS") : "Sine " + juce::String (p));
+        out.writeInt (terminal ? 0 : start);
+        out.writeInt (terminal ? 0 : start + numFrames);
+        out.writeInt (terminal ? 0 : start);
+        out.writeInt (terminal ? 0 : start + loopEnd);
+        out.writeInt (terminal ? 0 : (int) sampleRate);
+        out.writeByte (60);   // originalPitch
+        out.writeByte (0);    // pitchCorrection
+        out.writeShort (0);   // sampleLink
+        out.writeShort (terminal ? 0 : 1);   // monoSample
+    }
+    endChunk (out, shdr);
+    endChunk (out, pdta);
+    endChunk (out, riff);
+
+    getFile().replaceWithData (out.getData(), out.getDataSize());
+}
+
+TestSf2File::~TestSf2File()
+{
+    folder.deleteRecursively();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+/**
+ * Test fixture: writes a small looping sine-wave SFZ instrument (one 16-bit WAV per region, regions
+ * splitting the keyboard evenly) into a fresh temp folder, and deletes it again on destruction.
+ * extraOpcodes is appended to every <region> line (later opcodes override the defaults there).
+ *
+ *     TestSfzInstrument sfz (4);
+ *     audioHandler.loadSfz (sfz.getSfzFile(), 1);
+ */
+class TestSfzInstrument
+{
+public:
+    explicit TestSfzInstrument (int numRegions = 1, double lengthSeconds = 1.0, double sampleRate = 44100.0,
+                                const juce::String& extraOpcodes = {});
+    ~TestSfzInstrument();
+
+    juce::File getSfzFile() const   { return folder.getChildFile ("test.sfz"); }
+    juce::File getFolder() const    { return folder; }
+    juce::File getSampleFile (int region) const;
+
+private:
+    juce::File folder;
+
+    JUCE_DECLARE_NON_COPYABLE (TestSfzInstrument)
+};
+
+/**
+ * Test fixture: writes a minimal SoundFont 2 file into a fresh temp folder, and deletes it again on
+ * destruction. Each of numPresets presets has one instrument with one full-range zone, playing its
+ * own looping sine of numFrames 16-bit frames.
+ *
+ *     TestSf2File sf2 (2);
+ *     sfzero::SF2Sound sound (sf2.getFile());
+ */
+class TestSf2File
+{
+public:
+    explicit TestSf2File (int numPresets = 1, int numFrames = 4410, double sampleRate = 44100.0);
+    ~TestSf2File();
+
+    juce::File getFile() const      { return folder.getChildFile ("test.sf2"); }
+    int getNumFrames() const        { return numFrames; }
+
+private:
+    juce::File folder;
+    int numFrames;
+
+    JUCE_DECLARE_NON_COPYABLE (TestSf2File)
+};
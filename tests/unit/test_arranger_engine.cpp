@@ -4,6 +4,7 @@
 #include "Arranger/ArrangerEngine.h"
 #include "Arranger/ArrangerModel.h"
 #include "Arranger/ArrangerCountIn.h"
+#include "AllocationCounter.h"
 #include <map>
 #include <utility>
 
@@ -345,6 +346,123 @@ public:
             expectEquals (on60,  0);   // nothing at the original pitch
             expectEquals (off60, 0);
         }
+
+        beginTest ("renderRange into an audio block places events at their sample offsets");
+        {
+            ArrangerEngine engine (std::weak_ptr<juce::MidiOutput>{});
+            int injected = 0;
+            engine.onMidiMessage = [&] (const juce::MidiMessage&) { ++injected; };
+
+            engine.setStyle (makeStyle());
+            juce::MidiBuffer block;
+            engine.renderRange (0.0, 1.0, block, 24000);   // one beat @ 120 bpm, 48 kHz
+
+            std::vector<std::pair<int, juce::MidiMessage>> events;
+            for (const auto md : block)
+                events.push_back ({ md.samplePosition, md.getMessage() });
+
+            expectEquals ((int) events.size(), 2);
+            expect (events[0].second.isNoteOn());
+            expectEquals (events[0].first, 0);
+            expect (events[1].second.isNoteOff());
+            expectEquals (events[1].first, 12000);          // beat 0.5 = half the block
+            expectEquals (injected, 0);                     // block rendering bypasses the inject path
+        }
+
+        beginTest ("renderAudioBlock keeps notes on their exact sample across many blocks (no drift)");
+        {
+            ArrangerEngine engine (std::weak_ptr<juce::MidiOutput>{});
+            engine.setStyle (makeStyle());                  // 120 bpm: one bar = 96000 samples @ 48 kHz
+            engine.setAudioClockDriven (true);
+            engine.start (false);
+
+            constexpr double sr = 48000.0;
+            constexpr int blockSize = 480, numBlocks = 1000;
+            constexpr int barSamples = 96000;
+            int ons = 0, offs = 0, maxError = 0;
+            juce::MidiBuffer block;
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                block.clear();
+                engine.renderAudioBlock (block, blockSize, sr);
+                for (const auto md : block)
+                {
+                    const auto m = md.getMessage();
+                    const int abs = b * blockSize + md.samplePosition;
+                    const int inBar = abs % barSamples;
+                    if (m.isNoteOn())  { ++ons;  maxError = juce::jmax (maxError, juce::jmin (inBar, barSamples - inBar)); }
+                    if (m.isNoteOff()) { ++offs; maxError = juce::jmax (maxError, std::abs (inBar - 12000)); }
+                }
+            }
+            engine.stop();
+
+            expectEquals (ons, 5);                          // 480000 samples = 5 bars
+            expectEquals (offs, 5);
+            expect (maxError <= 1, "events drifted by " + juce::String (maxError) + " samples");
+        }
+
+        beginTest ("a render tick into an audio block performs no heap allocations");
+        {
+            ArrangerEngine engine (std::weak_ptr<juce::MidiOutput>{});
+            engine.setStyle (makeAccAndDrumStyle());
+            engine.setActiveChord ({ 2, ChordQuality::Maj, 2 });   // transposed Acc notes too
+            juce::MidiBuffer block;
+            block.ensureSize (4096);
+            engine.renderRange (0.0, 0.02, block, 480);              // applies the chord mailbox
+
+            size_t allocations = 0;
+            int events = 0;
+            {
+                ScopedAllocationCounter counter;
+                for (int tick = 1; tick < 1000; ++tick)              // ~5 bars: note-ons, offs, seams
+                {
+                    block.clear();
+                    engine.renderRange (tick * 0.02, (tick + 1) * 0.02, block, 480);
+                    events += block.getNumEvents();
+                }
+                allocations = counter.getCount();
+            }
+            expect (events > 0);
+            expectEquals ((int) allocations, 0);
+        }
+
+        beginTest ("an Ending that stops the engine inside an audio block performs no heap allocations");
+        {
+            ArrangerEngine engine (std::weak_ptr<juce::MidiOutput>{});
+            engine.setStyle (makeEndingStyle());
+            juce::MidiBuffer block;
+            block.ensureSize (4096);
+            engine.renderRange (0.0, 0.02, block, 480);
+            engine.queueSection (ArrangerSectionType::Ending, "Ending 1");   // taken up by the next block
+
+            size_t allocations = 0;
+            bool sawEnding = false, stopped = false;
+            {
+                ScopedAllocationCounter counter;
+                for (int tick = 1; tick < 500 && ! stopped; ++tick)   // Ending at beat 4, stop at beat 8
+                {
+                    block.clear();
+                    engine.renderRange (tick * 0.02, (tick + 1) * 0.02, block, 480);
+                    sawEnding = sawEnding || engine.getActiveSectionIndex() == 1;
+                    stopped   = sawEnding && engine.getActiveSectionIndex() == 0;   // reset to Variation 1
+                }
+                allocations = counter.getCount();
+            }
+            expect (sawEnding);
+            expect (stopped, "the Ending never completed");
+            expectEquals ((int) allocations, 0);
+        }
+
+        beginTest ("renderAudioBlock does nothing unless audio-clock driven");
+        {
+            ArrangerEngine engine (std::weak_ptr<juce::MidiOutput>{});
+            engine.setStyle (makeStyle());
+            engine.start (false);
+            juce::MidiBuffer block;
+            engine.renderAudioBlock (block, 480, 48000.0);
+            engine.stop();
+            expect (block.isEmpty());
+        }
     }
 };
 
@@ -1,6 +1,8 @@
 #include <juce_core/juce_core.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include "Arranger/ArrangerScheduler.h"
+#include "AllocationCounter.h"
+#include <set>
 
 class ArrangerSchedulerTest : public juce::UnitTest
 {
@@ -18,6 +20,42 @@ public:
         };
     }
 
+    // The pre-cursor algorithm (scan the whole pattern for every loop iteration in the window), kept
+    // as the reference the cursor must reproduce event for event.
+    struct FullScanReference
+    {
+        std::vector<TimedBeatEvent> events;   // sorted by beats
+        double loopLen = 0.0;
+        std::set<std::pair<int,int>> active;
+
+        std::vector<std::pair<double, juce::MidiMessage>> advance (double fromBeats, double toBeats)
+        {
+            std::vector<std::pair<double, juce::MidiMessage>> out;
+            double pos = fromBeats;
+            while (pos < toBeats - 1e-12)
+            {
+                const double iterStart = std::floor (pos / loopLen) * loopLen;
+                const double nextWrap  = iterStart + loopLen;
+                const double segEnd    = std::min (toBeats, nextWrap);
+                for (const auto& ev : events)
+                    if (ev.beats >= pos - iterStart - 1e-12 && ev.beats < segEnd - iterStart - 1e-12)
+                    {
+                        out.push_back ({ iterStart + ev.beats, ev.message });
+                        const auto key = std::make_pair (ev.message.getChannel(), ev.message.getNoteNumber());
+                        if (ev.message.isNoteOn()) active.insert (key); else active.erase (key);
+                    }
+                if (std::abs (segEnd - nextWrap) < 1e-9 && nextWrap <= toBeats + 1e-12)
+                {
+                    for (const auto& key : active)
+                        out.push_back ({ nextWrap, juce::MidiMessage::noteOff (key.first, key.second) });
+                    active.clear();
+                }
+                pos = segEnd;
+            }
+            return out;
+        }
+    };
+
     void runTest() override
     {
         beginTest ("emits events whose phase is inside the swept window");
@@ -115,6 +153,92 @@ public:
             expect (foundOff);
         }
 
+        beginTest ("cursor matches a full-pattern scan across ticks, seeks and seams");
+        {
+            juce::Random rng (1234);
+            std::vector<TimedBeatEvent> evs;
+            for (int i = 0; i < 400; ++i)
+            {
+                const double on  = rng.nextInt (64) * 0.25;   // quantised, so many share a beat
+                const int    ch  = 1 + rng.nextInt (16), note = 36 + rng.nextInt (48);
+                evs.push_back ({ on, juce::MidiMessage::noteOn (ch, note, (juce::uint8) 100) });
+                evs.push_back ({ std::min (on + 0.25 + rng.nextInt (8) * 0.25, 15.75), juce::MidiMessage::noteOff (ch, note) });
+            }
+
+            ArrangerScheduler s;
+            s.setLoop (evs, 16.0);
+            FullScanReference ref;
+            ref.events = evs;
+            std::stable_sort (ref.events.begin(), ref.events.end(),
+                              [] (const TimedBeatEvent& a, const TimedBeatEvent& b) { return a.beats < b.beats; });
+            ref.loopLen = 16.0;
+
+            double pos = 0.0;
+            bool allMatch = true;
+            for (int tick = 0; tick < 5000 && allMatch; ++tick)
+            {
+                if (rng.nextInt (200) == 0)
+                    pos += rng.nextDouble() * 40.0;            // occasional seek forward
+                const double to = pos + 0.01 + rng.nextDouble() * 0.3;
+
+                const auto got  = s.advance (pos, to);
+                const auto want = ref.advance (pos, to);
+                allMatch = got.size() == want.size();
+                for (size_t i = 0; allMatch && i < got.size(); ++i)
+                    allMatch = std::abs (got[i].beats - want[i].first) < 1e-9
+                            && got[i].message.toMidiMessage().getDescription() == want[i].second.getDescription();
+                pos = to;
+            }
+            expect (allMatch, "cursor output diverged from the full scan");
+        }
+
+        beginTest ("advance and flush into a reserved vector perform no heap allocations");
+        {
+            std::vector<TimedBeatEvent> evs;
+            for (int ch = 1; ch <= 16; ++ch)
+                for (int k = 0; k < 8; ++k)
+                    evs.push_back ({ k * 0.5, juce::MidiMessage::noteOn (ch, 40 + k, (juce::uint8) 100) });   // all held
+            ArrangerScheduler s;
+            s.setLoop (evs, 4.0);
+
+            std::vector<EmittedEvent> out;
+            out.reserve ((size_t) s.getNumEvents() + 16 * 128);
+
+            size_t allocations = 0, emitted = 0;
+            {
+                ScopedAllocationCounter counter;
+                for (int tick = 0; tick < 2000; ++tick)             // 10 loops, seams included
+                {
+                    out.clear();
+                    s.advance (tick * 0.02, (tick + 1) * 0.02, out);
+                    emitted += out.size();
+                }
+                out.clear();
+                s.advance (40.0, 41.0, out);                         // re-sound some notes...
+                s.flushActiveNotes (41.0, out);                      // ...then flush them
+                allocations = counter.getCount();
+            }
+            expect (emitted > 0);
+            expectEquals ((int) allocations, 0);
+        }
+
+        beginTest ("seam note-offs come out in (channel, note) order with each note's part");
+        {
+            ArrangerScheduler s;
+            s.setLoop ({ { 0.0, juce::MidiMessage::noteOn (3, 70, (juce::uint8) 90) },
+                         { 0.0, juce::MidiMessage::noteOn (1, 50, (juce::uint8) 90) },
+                         { 0.0, juce::MidiMessage::noteOn (3, 20, (juce::uint8) 90) } },
+                       { PartKind::Acc, PartKind::Bass, PartKind::Fixed }, 4.0);
+            auto out = s.advance (0.0, 4.0);
+            expectEquals ((int) out.size(), 6);
+            expectEquals (out[3].message.getChannel(), 1); expectEquals (out[3].message.getNoteNumber(), 50);
+            expect (out[3].part == PartKind::Bass);
+            expectEquals (out[4].message.getChannel(), 3); expectEquals (out[4].message.getNoteNumber(), 20);
+            expect (out[4].part == PartKind::Fixed);
+            expectEquals (out[5].message.getNoteNumber(), 70);
+            expect (out[5].part == PartKind::Acc && out[5].message.isNoteOff());
+        }
+
         beginTest ("legacy 2-arg setLoop marks events Fixed (non-transposable)");
         {
             ArrangerScheduler s;
@@ -0,0 +1,158 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "Arranger/ArrangerStyleIndex.h"
+#include "Arranger/ArrangerStyleIOHelper.h"
+
+static ArrangerStyleFile makeIndexedStyle (const juce::String& name, double tempo, int numSections)
+{
+    ArrangerStyleFile s;
+    s.name = name;
+    s.originalTempo = tempo;
+    s.timeSigNum = 3; s.timeSigDenom = 4;
+
+    SourceTrackFile tr;
+    tr.id = "t1"; tr.name = "Bass"; tr.channel = 2;
+    tr.events.push_back ({ 0.0, juce::MidiMessage::noteOn  (2, 40, (juce::uint8) 90) });
+    tr.events.push_back ({ 1.0, juce::MidiMessage::noteOff (2, 40) });
+    s.sourceTracks.push_back (tr);
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        SectionWindow w;
+        w.id = "var_" + juce::String (i + 1); w.name = "Variation " + juce::String (i + 1);
+        w.startBar = 1 + i * 4; w.lengthBars = 4;
+        s.sections.push_back (w);
+    }
+    return s;
+}
+
+static const ArrangerStyleSummary* findSummary (const std::vector<ArrangerStyleSummary>& all, const juce::String& fileName)
+{
+    for (auto& s : all)
+        if (s.fileName == fileName) return &s;
+    return nullptr;
+}
+
+class ArrangerStyleIndexTest : public juce::UnitTest
+{
+public:
+    ArrangerStyleIndexTest() : juce::UnitTest ("ArrangerStyleIndex", "Arranger") {}
+
+    void runTest() override
+    {
+        juce::TemporaryFile tempDir;
+        const auto folder = tempDir.getFile();
+        folder.createDirectory();
+
+        ArrangerStyleIOHelper::saveToFile (folder.getChildFile ("A.style"), makeIndexedStyle ("Alpha", 96.0, 2));
+        ArrangerStyleIOHelper::saveToFile (folder.getChildFile ("B.style"), makeIndexedStyle ("Beta", 128.0, 3));
+        folder.getChildFile ("Broken.style").replaceWithText ("not a style");
+
+        beginTest ("first scan indexes every style, including unreadable ones");
+        {
+            ArrangerStyleIndex index (folder, false);
+            expect (index.getSummaries().empty());
+            expect (index.rescanNow());
+            expectEquals (index.getNumFilesParsed(), 3);
+
+            const auto all = index.getSummaries();
+            expectEquals ((int) all.size(), 3);
+            expectEquals (all[0].fileName, juce::String ("A.style"));   // sorted
+
+            auto* b = findSummary (all, "B.style");
+            expect (b != nullptr && b->readable);
+            expectEquals (b->name, juce::String ("Beta"));
+            expectWithinAbsoluteError (b->tempo, 128.0, 1e-9);
+            expectEquals (b->timeSigNum, 3);
+            expectEquals (b->sections.size(), 3);
+            expectEquals (b->sections[2], juce::String ("Variation 3"));
+            expectEquals (b->numTracks, 1);
+
+            auto* broken = findSummary (all, "Broken.style");
+            expect (broken != nullptr && ! broken->readable);
+            expect (index.getIndexFile().existsAsFile());
+        }
+
+        beginTest ("persisted index is used at once and unchanged files are not re-read");
+        {
+            ArrangerStyleIndex index (folder, false);
+            expectEquals ((int) index.getSummaries().size(), 3);   // straight from StyleIndex.json
+            expect (! index.rescanNow());
+            expectEquals (index.getNumFilesParsed(), 0);
+
+            ArrangerStyleSummary broken;
+            expect (index.getSummary ("Broken.style", broken) && ! broken.readable);
+            expect (! index.getSummary ("Missing.style", broken));
+        }
+
+        beginTest ("the background thread rescans once, then only when asked");
+        {
+            ArrangerStyleIndex index (folder, true);
+            expect (index.waitForRescan (5000));   // the first rescan: three unchanged files
+
+            const auto d = folder.getChildFile ("D.style");
+            ArrangerStyleIOHelper::saveToFile (d, makeIndexedStyle ("Delta", 90.0, 2));
+            expect (! index.waitForRescan (200), "no polling");
+            ArrangerStyleSummary delta;
+            expect (! index.getSummary ("D.style", delta));
+
+            index.requestRescan();
+            expect (index.waitForRescan (5000));
+            expect (index.getSummary ("D.style", delta) && delta.name == "Delta");
+            d.deleteFile();
+        }
+
+        beginTest ("a file named by fileChanged is re-read even if its size and time didn't change");
+        {
+            ArrangerStyleIndex index (folder, false);
+            index.rescanNow();
+            const auto b = folder.getChildFile ("B.style");
+            const auto mtime = b.getLastModificationTime();
+            const auto parsed = index.getNumFilesParsed();
+
+            ArrangerStyleIOHelper::saveToFile (b, makeIndexedStyle ("Bet2", 128.0, 3));   // same size
+            b.setLastModificationTime (mtime);
+            expect (! index.rescanNow(), "looks unchanged");
+
+            index.fileChanged (b);
+            expect (index.rescanNow());
+            expectEquals (index.getNumFilesParsed(), parsed + 1);
+            ArrangerStyleSummary beta;
+            expect (index.getSummary ("B.style", beta) && beta.name == "Bet2");
+
+            ArrangerStyleIOHelper::saveToFile (b, makeIndexedStyle ("Beta", 128.0, 3));
+            index.fileChanged (b);
+            index.rescanNow();   // leave StyleIndex.json matching the folder for the next test
+        }
+
+        beginTest ("rescan re-reads changed files and drops deleted ones");
+        {
+            ArrangerStyleIndex index (folder, false);
+
+            const auto a = folder.getChildFile ("A.style");
+            ArrangerStyleIOHelper::saveToFile (a, makeIndexedStyle ("Alpha", 100.0, 5));
+            a.setLastModificationTime (a.getLastModificationTime() + juce::RelativeTime::seconds (10));
+            folder.getChildFile ("Broken.style").deleteFile();
+            ArrangerStyleIOHelper::saveToFile (folder.getChildFile ("C.style"), makeIndexedStyle ("Gamma", 80.0, 1));
+
+            expect (index.rescanNow());
+            expectEquals (index.getNumFilesParsed(), 2);            // A changed, C new; B untouched
+
+            const auto all = index.getSummaries();
+            expectEquals ((int) all.size(), 3);
+            expect (findSummary (all, "Broken.style") == nullptr);
+            auto* alpha = findSummary (all, "A.style");
+            expect (alpha != nullptr);
+            if (alpha != nullptr)
+            {
+                expectWithinAbsoluteError (alpha->tempo, 100.0, 1e-9);
+                expectEquals (alpha->sections.size(), 5);
+            }
+            expect (findSummary (all, "C.style") != nullptr);
+        }
+
+        folder.deleteRecursively();
+    }
+};
+
+static ArrangerStyleIndexTest arrangerStyleIndexTest;
@@ -102,6 +102,84 @@ public:
             file.deleteFile();
         }
 
+        beginTest ("saveToFile writes the binary container and it round-trips every field");
+        {
+            auto s = makeSample();
+            s.id = "style-7"; s.originalTempo = 97.5; s.timeSigNum = 3; s.timeSigDenom = 4;
+            s.originalRoot = 2; s.originalQuality = ChordQuality::Dom7;
+            SourceTrackFile bass;
+            bass.id = "t2"; bass.name = juce::CharPointer_UTF8 ("B\xc3\xa4ss"); bass.partType = ArrangerPartType::Bass;
+            bass.channel = 3; bass.instrument = 33; bass.volume = 87.25;
+            bass.events.push_back ({ 0.0,   juce::MidiMessage::programChange (3, 33) });   // 2-byte message
+            bass.events.push_back ({ 0.125, juce::MidiMessage::noteOn  (3, 40, (juce::uint8) 64) });
+            bass.events.push_back ({ 2.75,  juce::MidiMessage::noteOff (3, 40) });
+            s.sourceTracks.push_back (bass);
+            SectionWindow end; end.id = "ending_1"; end.name = "Ending 1";
+            end.type = ArrangerSectionType::Ending; end.startBar = 13; end.lengthBars = 2;
+            end.afterComplete = ArrangerAfterComplete::Stop;
+            s.sections.push_back (end);
+
+            auto file = juce::File::createTempFile (".style");
+            ArrangerStyleIOHelper::saveToFile (file, s);
+            juce::MemoryBlock raw; file.loadFileAsData (raw);
+            expect (raw.getSize() > 4 && std::memcmp (raw.getData(), "ASTY", 4) == 0);
+
+            ArrangerStyleFile loaded; juce::String err;
+            expect (ArrangerStyleIOHelper::loadFromFile (file, loaded, err), err);
+            expectEquals (loaded.id, juce::String ("style-7"));
+            expectEquals (loaded.originalTempo, 97.5);
+            expectEquals (loaded.timeSigNum, 3);
+            expectEquals (loaded.originalRoot, 2);
+            expect (loaded.originalQuality == ChordQuality::Dom7);
+            expectEquals ((int) loaded.sections.size(), 2);
+            expect (loaded.sections[1].type == ArrangerSectionType::Ending);
+            expect (loaded.sections[1].afterComplete == ArrangerAfterComplete::Stop);
+            expectEquals (loaded.sections[1].startBar, 13);
+
+            expectEquals ((int) loaded.sourceTracks.size(), 2);
+            const auto& b = loaded.sourceTracks[1];
+            expectEquals (b.name, juce::String (juce::CharPointer_UTF8 ("B\xc3\xa4ss")));
+            expect (b.partType == ArrangerPartType::Bass);
+            expectEquals (b.instrument, 33);
+            expectEquals (b.volume, 87.25);
+            expectEquals ((int) b.events.size(), 3);
+            expect (b.events[0].message.isProgramChange());
+            expectEquals (b.events[0].message.getRawDataSize(), 2);
+            expectEquals (b.events[1].beats, 0.125);
+            expectEquals (b.events[1].message.getVelocity(), 64);
+            expect (b.events[2].message.isNoteOff());
+            file.deleteFile();
+        }
+
+        beginTest ("JSON export/import round-trips and loadFromFile opens JSON styles");
+        {
+            auto file = juce::File::createTempFile (".json");
+            ArrangerStyleIOHelper::exportJson (file, makeSample());
+            expect (file.loadFileAsString().trimStart().startsWith ("{"));
+
+            ArrangerStyleFile viaImport, viaLoad; juce::String err;
+            expect (ArrangerStyleIOHelper::importJson (file, viaImport, err), err);
+            expect (ArrangerStyleIOHelper::loadFromFile (file, viaLoad, err), err);
+            expectEquals (viaImport.name, juce::String ("Sunset Groove"));
+            expectEquals ((int) viaLoad.sourceTracks[0].events.size(), 2);
+            file.deleteFile();
+        }
+
+        beginTest ("a truncated binary style fails gracefully");
+        {
+            auto file = juce::File::createTempFile (".style");
+            ArrangerStyleIOHelper::saveToFile (file, makeSample());
+            juce::MemoryBlock raw; file.loadFileAsData (raw);
+            for (size_t cut : { (size_t) 6, raw.getSize() / 2, raw.getSize() - 1 })
+            {
+                file.replaceWithData (raw.getData(), cut);
+                ArrangerStyleFile loaded; juce::String err;
+                expect (! ArrangerStyleIOHelper::loadFromFile (file, loaded, err));
+                expect (err.isNotEmpty());
+            }
+            file.deleteFile();
+        }
+
         beginTest ("loading a missing file fails gracefully");
         {
             // Use a non-existent ABSOLUTE path: juce::File asserts on relative paths.
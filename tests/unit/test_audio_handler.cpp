@@ -0,0 +1,180 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "AudioHandlerTestRig.h"
+#include "AllocationCounter.h"
+
+// Chords on every channel with chorus and reverb up; notes released half way through.
+static void scriptChords (ScriptedMidiSource& script, int numChannels, int numBlocks)
+{
+    for (int ch = 1; ch <= numChannels; ++ch)
+    {
+        script.add (0, 0, juce::MidiMessage::controllerEvent (ch, 91, 80));
+        script.add (0, 0, juce::MidiMessage::controllerEvent (ch, 93, 60));
+        script.add (0, 0, juce::MidiMessage::controllerEvent (ch, 10, (ch * 8) % 128));
+    }
+    for (int ch = 1; ch <= numChannels; ++ch)
+        for (int n = 0; n < 4; ++n)
+            script.add (1, ch, juce::MidiMessage::noteOn (ch, 48 + ch + n * 4, (juce::uint8) 100));
+    for (int ch = 1; ch <= numChannels; ++ch)
+        for (int n = 0; n < 4; ++n)
+            script.add (numBlocks / 2, 10, juce::MidiMessage::noteOff (ch, 48 + ch + n * 4));
+}
+
+class AudioHandlerTest : public juce::UnitTest
+{
+public:
+    AudioHandlerTest() : juce::UnitTest ("AudioHandler", "Unit") {}
+
+    void runTest() override
+    {
+        TestSfzInstrument sfz (4, 0.5);
+
+        beginTest ("parallel channel rendering is bit-identical to serial rendering");
+        {
+            constexpr int numChannels = 16, numBlocks = 200;
+            AudioHandlerTestRig serial (sfz, numChannels), parallel (sfz, numChannels);
+            scriptChords (serial.script, numChannels, numBlocks);
+            scriptChords (parallel.script, numChannels, numBlocks);
+            parallel.audio.setNumRenderWorkers (3);
+            expectEquals (parallel.audio.getNumRenderWorkers(), 3);
+            serial.start();
+            parallel.start();
+
+            int mismatches = 0;
+            float peak = 0.0f;
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                serial.renderBlock();
+                parallel.renderBlock();
+                for (int c = 0; c < 2; ++c)
+                    for (int i = 0; i < serial.blockSize; ++i)
+                    {
+                        const float s = serial.out.getSample (c, i);
+                        if (s != parallel.out.getSample (c, i)) ++mismatches;
+                        peak = juce::jmax (peak, std::abs (s));
+                    }
+            }
+            expectEquals (mismatches, 0);
+            expect (peak > 0.01f, "the chords should actually sound");
+        }
+
+        beginTest ("one SFZ on 16 channels decodes each sample once");
+        {
+            AudioHandlerTestRig rig (sfz, 16);
+            expect (! rig.audio.isLoadingSfz());
+            const auto& cache = rig.audio.getSampleCache();
+            expectEquals (cache.getNumDecodes(), 4, "4 regions, one sample each");
+            expectEquals (cache.getNumHits(), 15 * 4);
+            expectEquals (cache.getNumEntries(), 4);
+        }
+
+        beginTest ("worker count can change between blocks");
+        {
+            AudioHandlerTestRig rig (sfz, 4);
+            scriptChords (rig.script, 4, 40);
+            rig.start();
+            for (int b = 0; b < 40; ++b)
+            {
+                if (b % 10 == 0)
+                    rig.audio.setNumRenderWorkers ((b / 10) % 3);
+                rig.renderBlock();
+            }
+            rig.audio.setNumRenderWorkers (0);
+            expectEquals (rig.audio.getNumRenderWorkers(), 0);
+        }
+
+        beginTest ("the audio callback does not allocate");
+        {
+            constexpr int numChannels = 16, numBlocks = 400;
+            AudioHandlerTestRig rig (sfz, numChannels);
+            scriptChords (rig.script, numChannels, numBlocks);
+            for (int b = 20; b < numBlocks; b += 20)   // keep CCs and notes arriving throughout
+                for (int ch = 1; ch <= numChannels; ++ch)
+                {
+                    rig.script.add (b, 5, juce::MidiMessage::controllerEvent (ch, 74, (b + ch) % 128));
+                    rig.script.add (b, 7, juce::MidiMessage::noteOn  (ch, 72, (juce::uint8) 90));
+                    rig.script.add (b + 10, 3, juce::MidiMessage::noteOff (ch, 72));
+                }
+            rig.start();
+
+            ScopedAllocationCounter counter;
+            for (int b = 0; b < numBlocks; ++b)
+                rig.renderBlock();
+            expectEquals ((int) counter.getCount(), 0);
+        }
+
+        beginTest ("idle channels are skipped until their next event");
+        {
+            AudioHandlerTestRig rig (sfz, 4);
+            rig.script.add (0, 0, juce::MidiMessage::noteOn  (2, 60, (juce::uint8) 100));
+            rig.script.add (4, 0, juce::MidiMessage::noteOff (2, 60));
+            rig.script.add (2000, 0, juce::MidiMessage::noteOn (3, 60, (juce::uint8) 100));
+            rig.start();
+
+            rig.renderBlock();
+            expectEquals (rig.audio.getNumChannelsRendered(), 4);   // nothing is known to be quiet yet
+
+            // Well past the release, with no effect tails, only silence is left to render.
+            while (rig.script.getBlockIndex() < 1999)
+                rig.renderBlock();
+            expectEquals (rig.audio.getNumChannelsRendered(), 0);
+            expect (rig.out.getMagnitude (0, rig.blockSize) == 0.0f);
+
+            rig.renderBlock();   // block 1999
+            rig.renderBlock();   // block 2000: channel 3 wakes up for its note
+            expectEquals (rig.audio.getNumChannelsRendered(), 1);
+            for (int b = 0; b < 4; ++b)
+                rig.renderBlock();
+            expect (rig.out.getMagnitude (0, rig.blockSize) > 0.0f);
+        }
+
+        beginTest ("CC changes ramp over the smoothing time instead of jumping");
+        {
+            ChannelDSP dsp;
+            dsp.prepare (48000.0, 64);
+            juce::AudioBuffer<float> buf (2, 64);
+
+            dsp.updateCC (11, 0);   // expression 1 -> 0
+            buf.clear();
+            for (int c = 0; c < 2; ++c) juce::FloatVectorOperations::fill (buf.getWritePointer (c), 1.0f, 64);
+            dsp.process (buf, 64);
+            expectGreaterThan (buf.getSample (0, 0), 0.99f);
+            expectLessThan (buf.getSample (0, 63), buf.getSample (0, 0));
+            expectGreaterThan (buf.getSample (0, 63), 0.9f);   // 64 of the 960 ramp samples done
+
+            for (int b = 0; b < 20; ++b)
+            {
+                for (int c = 0; c < 2; ++c) juce::FloatVectorOperations::fill (buf.getWritePointer (c), 1.0f, 64);
+                dsp.process (buf, 64);
+            }
+            expectLessThan (std::abs (buf.getSample (1, 63)), 1.0e-6f);
+
+            dsp.updateCC (74, 0);    // cutoff 20 kHz -> 100 Hz ramps, coefficients every 16 samples
+            dsp.process (buf, 64);
+            expect (dsp.filterCutoffHz.isSmoothing());
+            expectGreaterThan (dsp.filterCutoffHz.getCurrentValue(), 100.0f);
+            expectLessThan (dsp.filterCutoffHz.getCurrentValue(), 20000.0f);
+        }
+
+        beginTest ("reverb sends ring out on the shared bus after the channel goes idle");
+        {
+            AudioHandlerTestRig rig (sfz, 2);
+            rig.script.add (0, 0, juce::MidiMessage::controllerEvent (1, 91, 127));
+            rig.script.add (0, 0, juce::MidiMessage::noteOn  (1, 60, (juce::uint8) 100));
+            rig.script.add (20, 0, juce::MidiMessage::noteOff (1, 60));
+            rig.start();
+
+            // The channel is skipped soon after its release, while the reverb return is still audible.
+            bool sawTailWithoutChannels = false;
+            for (int b = 0; b < 200 && ! sawTailWithoutChannels; ++b)
+            {
+                rig.renderBlock();
+                sawTailWithoutChannels = b > 20 && rig.audio.getNumChannelsRendered() == 0
+                                         && rig.out.getMagnitude (0, rig.blockSize) > 1.0e-4f;
+            }
+            expect (sawTailWithoutChannels);
+        }
+    }
+};
+
+static AudioHandlerTest audioHandlerTest;
@@ -0,0 +1,129 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "AudioHandlerTestRig.h"
+#include "AudioLoadMeter.h"
+
+// AudioLoadMeter: loads, overruns and the sliding histogram from synthetic blocks; a full FIFO
+// drops blocks rather than blocking; and AudioHandler fills in every block's per-channel stats.
+class AudioLoadMeterTest : public juce::UnitTest
+{
+public:
+    AudioLoadMeterTest() : juce::UnitTest ("AudioLoadMeter", "Unit") {}
+
+    void runTest() override
+    {
+        beginTest ("load is callback time over the block period; past 1 is an overrun");
+        {
+            AudioLoadMeter meter;
+            meter.prepare (48000.0);
+            addBlock (meter, 480, 5.0);    // 10 ms periods
+            addBlock (meter, 480, 15.0);
+            expectEquals (meter.collect(), 2);
+            expectEquals (meter.getNumHistoryBlocks(), 2);
+
+            const auto& quick = meter.getHistoryBlock (0);
+            const auto& late  = meter.getHistoryBlock (1);
+            expect (quick.load >= 0.5f && quick.load < 0.9f, juce::String (quick.load));
+            expect (late.load >= 1.5f && late.load < 1.9f, juce::String (late.load));
+            expectEquals ((int) late.blockNumber, 1);
+            expectEquals (meter.getNumOverruns(), 1);
+            expect (meter.getPeakLoad() >= 1.5f);
+
+            const auto histogram = meter.getHistogram();
+            expectEquals (histogram[(size_t) (quick.load / AudioLoadMeter::binWidth)], 1);
+            expectEquals (histogram[(size_t) (late.load / AudioLoadMeter::binWidth)], 1);
+        }
+
+        beginTest ("the histogram covers the last histogramBlocks blocks only");
+        {
+            AudioLoadMeter meter;
+            meter.prepare (48000.0);
+            for (int b = 0; b < AudioLoadMeter::histogramBlocks; ++b)
+                addBlock (meter, 480, 0.0);
+            for (int b = 0; b < 100; ++b)
+                addBlock (meter, 480, 100.0);   // far past the last bin
+
+            const auto histogram = meter.getHistogram();
+            int total = 0;
+            for (auto count : histogram)
+                total += count;
+            expectEquals (total, AudioLoadMeter::histogramBlocks);
+            expectEquals (histogram[AudioLoadMeter::numBins - 1], 100);
+            expectEquals (histogram[0], AudioLoadMeter::histogramBlocks - 100);
+        }
+
+        beginTest ("a full FIFO drops blocks, and reset() starts over");
+        {
+            AudioLoadMeter meter;
+            meter.prepare (48000.0);
+            for (int b = 0; b < AudioLoadMeter::fifoBlocks + 10; ++b)
+                addBlock (meter, 480, 0.0);
+            expectEquals (meter.getNumDropped(), 10);
+            expectEquals (meter.collect(), AudioLoadMeter::fifoBlocks);
+            expectEquals ((int) meter.getNumBlocks(), AudioLoadMeter::fifoBlocks + 10);
+
+            meter.reset();
+            expectEquals (meter.getNumHistoryBlocks(), 0);
+            addBlock (meter, 480, 0.0);
+            expectEquals ((int) meter.getNumBlocks(), 1);
+            expectEquals (meter.getNumDropped(), 0);
+            expectEquals (meter.collect(), 1);
+            expectEquals ((int) meter.getHistoryBlock (0).blockNumber, 0);
+        }
+
+        beginTest ("AudioHandler records every block, per channel");
+        {
+            TestSfzInstrument sfz (4, 0.5);
+            constexpr int numBlocks = 50;
+            AudioHandlerTestRig rig (sfz, 2);
+            for (int n = 0; n < 3; ++n)
+                rig.script.add (1, 0, juce::MidiMessage::noteOn (1, 60 + n * 4, (juce::uint8) 100));
+            rig.script.add (2, 0, juce::MidiMessage::noteOn (2, 48, (juce::uint8) 100));
+            rig.start();
+            for (int b = 0; b < numBlocks; ++b)
+                rig.renderBlock();
+
+            auto& meter = rig.audio.getLoadMeter();
+            expectEquals (meter.collect(), numBlocks);
+            expectEquals ((int) meter.getNumBlocks(), numBlocks);
+
+            int midiEvents = 0;
+            for (int b = 0; b < numBlocks; ++b)
+                midiEvents += meter.getHistoryBlock (b).midiEvents;
+            expectEquals (midiEvents, 4);
+
+            const auto& last = meter.getHistoryBlock (numBlocks - 1);
+            expectEquals (last.numSamples, rig.blockSize);
+            expectEquals (last.channelsRendered, 2);
+            expectEquals (last.voices[0], 3);
+            expectEquals (last.voices[1], 1);
+            expectEquals (last.voices[2], 0);
+            expect (last.synthMs[0] > 0.0f && last.dspMs[0] >= 0.0f);
+            expectEquals (last.synthMs[2], 0.0f);
+            expect (last.callbackMs >= last.synthMs[0] + last.synthMs[1]);
+
+            const auto csv = juce::File::createTempFile (".csv");
+            expect (meter.writeCsv (csv));
+            juce::StringArray lines;
+            csv.readLines (lines);
+            lines.removeEmptyStrings();
+            expectEquals (lines.size(), numBlocks + 1);
+            expectEquals (juce::StringArray::fromTokens (lines[0], ",", {}).size(), 8 + 3 * AudioLoadMeter::numChannels);
+            expectEquals (juce::StringArray::fromTokens (lines[numBlocks], ",", {}).size(), 8 + 3 * AudioLoadMeter::numChannels);
+            expect (lines[0].startsWith ("block,start_ms,samples,callback_ms,load"));
+            csv.deleteFile();
+        }
+    }
+
+private:
+    // A block whose callback started callbackMs ago.
+    static void addBlock (AudioLoadMeter& meter, int numSamples, double callbackMs)
+    {
+        AudioLoadMeter::BlockStats stats;
+        stats.numSamples = numSamples;
+        const auto ticks = (juce::int64) (callbackMs * 0.001 * (double) juce::Time::getHighResolutionTicksPerSecond());
+        meter.addBlock (stats, juce::Time::getHighResolutionTicks() - ticks);
+    }
+};
+
+static AudioLoadMeterTest audioLoadMeterTest;
@@ -1,6 +1,7 @@
 ﻿#include <juce_core/juce_core.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include "Arranger/ChordDetector.h"
+#include <set>
 
 class ChordDetectorTest : public juce::UnitTest
 {
@@ -14,8 +15,51 @@ public:
         return d.current();
     }
 
+    // The recogniser as it was before the pitch-class table (std::set + template loop), kept as the
+    // reference for the exhaustive equivalence test.
+    static ArrangerChord referenceRecognize (int mask, int lowestPc)
+    {
+        std::set<int> pcs;
+        for (int pc = 0; pc < 12; ++pc) if (mask & (1 << pc)) pcs.insert (pc);
+        if (pcs.empty()) return {};
+
+        const ChordQuality order[] = { ChordQuality::Maj7, ChordQuality::Dom7, ChordQuality::Min7,
+                                       ChordQuality::HalfDim, ChordQuality::Maj, ChordQuality::Min,
+                                       ChordQuality::Dim, ChordQuality::Aug, ChordQuality::Sus2,
+                                       ChordQuality::Sus4 };
+        ArrangerChord firstMatch { -1, ChordQuality::None, lowestPc };
+        for (auto q : order)
+        {
+            const auto intervals = chordIntervals (q);
+            for (int root = 0; root < 12; ++root)
+            {
+                bool match = pcs.size() == intervals.size();
+                for (int iv : intervals) match = match && pcs.count ((root + iv) % 12) > 0;
+                if (! match) continue;
+                if (root == lowestPc) return { root, q, lowestPc };
+                if (! firstMatch.isValid()) firstMatch = { root, q, lowestPc };
+            }
+        }
+        return firstMatch;
+    }
+
     void runTest() override
     {
+        beginTest ("pitch-class table matches the template recogniser for all 4096 sets x bass notes");
+        {
+            int mismatches = 0, recognised = 0;
+            for (int mask = 0; mask < 4096; ++mask)
+                for (int bass = 0; bass < 12; ++bass)
+                {
+                    const ArrangerChord got  = ChordDetector::recognizePitchClasses (mask, bass);
+                    const ArrangerChord want = referenceRecognize (mask, bass);
+                    if (got != want) ++mismatches;
+                    if (got.isValid()) ++recognised;
+                }
+            expectEquals (mismatches, 0);
+            expect (recognised > 0);
+        }
+
         beginTest ("no held notes -> invalid chord");
         {
             ChordDetector d;
@@ -118,6 +118,59 @@ public:
             t.setBassInversion (true);
             expectEquals (t.transpose (43, PartKind::Acc) % 12, 7);     // Acc 5th stays G
         }
+
+        beginTest ("lookup tables match transpose() for every chord pair, part and note");
+        {
+            const ChordQuality qualities[] = { ChordQuality::None, ChordQuality::Maj, ChordQuality::Min,
+                                               ChordQuality::Dom7, ChordQuality::Maj7, ChordQuality::Min7,
+                                               ChordQuality::Dim, ChordQuality::HalfDim, ChordQuality::Aug,
+                                               ChordQuality::Sus2, ChordQuality::Sus4 };
+            ChordTransposer t;
+            int mismatches = 0;
+            for (int origRoot = 0; origRoot < 12; ++origRoot)
+                for (auto origQ : qualities)
+                {
+                    t.setOriginalChord ({ origRoot, origQ, origRoot });
+                    for (int root = -1; root < 12; ++root)
+                        for (auto q : qualities)
+                            for (int inv = 0; inv < 2; ++inv)
+                            {
+                                t.setBassInversion (inv == 1);
+                                t.setActiveChord ({ root, q, root < 0 ? -1 : (root + 7) % 12 });   // a slash bass
+                                for (int n = 0; n < 128; ++n)
+                                    for (auto part : { PartKind::Fixed, PartKind::Acc, PartKind::Bass })
+                                        if (t.lookup (n, part) != t.transpose (n, part))
+                                            ++mismatches;
+                            }
+                }
+            expectEquals (mismatches, 0);
+
+            // Every bass note under inversion, for one pair.
+            t.setOriginalChord ({ 0, ChordQuality::Maj, 0 });
+            t.setBassInversion (true);
+            for (int bass = -1; bass < 12; ++bass)
+            {
+                t.setActiveChord ({ 9, ChordQuality::Min, bass });
+                for (int n = 0; n < 128; ++n)
+                    if (t.lookup (n, PartKind::Bass) != t.transpose (n, PartKind::Bass))
+                        ++mismatches;
+            }
+            expectEquals (mismatches, 0);
+        }
+
+        beginTest ("alternating between recent chords reuses cached tables");
+        {
+            ChordTransposer t;
+            t.setOriginalChord ({ 0, ChordQuality::Maj, 0 });
+            const ArrangerChord progression[] = { { 0, ChordQuality::Maj, 0 }, { 5, ChordQuality::Maj, 5 },
+                                                  { 7, ChordQuality::Dom7, 7 }, { 9, ChordQuality::Min, 9 } };
+            for (auto& c : progression) t.setActiveChord (c);
+            const int builds = t.getNumTableBuilds();
+            for (int bar = 0; bar < 100; ++bar)
+                for (auto& c : progression) t.setActiveChord (c);
+            expectEquals (t.getNumTableBuilds(), builds);   // all hits
+            expectEquals (t.lookup (64, PartKind::Acc), t.transpose (64, PartKind::Acc));
+        }
     }
 };
 static ChordTransposerTest chordTransposerTest;
@@ -0,0 +1,95 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "DSPKernels.h"
+
+// The kernels against the scalar loops ChannelDSP used to run.
+class DSPKernelsTest : public juce::UnitTest
+{
+public:
+    DSPKernelsTest() : juce::UnitTest ("DSPKernels", "Unit") {}
+
+    void runTest() override
+    {
+        beginTest ("tanhApprox stays within 1e-4 of std::tanh");
+        {
+            float worst = 0.0f;
+            for (int i = -300000; i <= 300000; ++i)
+            {
+                const float x = (float) i * 1.0e-4f;
+                worst = juce::jmax (worst, std::abs (DSPKernels::tanhApprox (x) - std::tanh (x)));
+            }
+            expectLessThan (worst, 1.0e-4f);
+            expectEquals (DSPKernels::tanhApprox (1000.0f), 1.0f);
+            expectEquals (DSPKernels::tanhApprox (-1000.0f), -1.0f);
+        }
+
+        beginTest ("saturate matches the scalar drive loop");
+        {
+            juce::Random rng (3);
+            std::vector<float> data (257), expected (257);
+            for (size_t i = 0; i < data.size(); ++i)
+                data[i] = expected[i] = rng.nextFloat() * 2.0f - 1.0f;
+
+            const float drive = 9.5f, norm = 1.0f / std::tanh (drive);
+            for (auto& x : expected)
+                x = std::tanh (x * drive) * norm;
+            DSPKernels::saturate (data.data(), (int) data.size(), drive, norm);
+
+            float worst = 0.0f;
+            for (size_t i = 0; i < data.size(); ++i)
+                worst = juce::jmax (worst, std::abs (data[i] - expected[i]));
+            expectLessThan (worst, 2.0e-4f);
+        }
+
+        beginTest ("tremolo gains track the exact LFO over ten seconds of blocks");
+        {
+            const float sampleRate = 48000.0f, depth = 0.8f;
+            const float inc = juce::MathConstants<float>::twoPi * 5.0f / sampleRate;
+            float phase = 0.0f, worst = 0.0f;
+            std::vector<float> gains (64);
+            juce::int64 n = 0;
+
+            // Reference in double precision: the old float phase accumulator itself drifted by ~1e-2.
+            for (int block = 0; block < (int) (10 * sampleRate) / 64; ++block)
+            {
+                phase = DSPKernels::tremoloGains (gains.data(), 64, phase, inc, depth);
+                for (int i = 0; i < 64; ++i, ++n)
+                {
+                    const double ref = 1.0 - depth * 0.5 * (1.0 + std::sin ((double) inc * (double) n));
+                    worst = juce::jmax (worst, (float) std::abs (gains[(size_t) i] - ref));
+                }
+            }
+            expectLessThan (worst, 2.0e-4f);
+        }
+
+        beginTest ("noise is uniform in [0, 1) and the smoother matches the scalar one-pole");
+        {
+            DSPKernels::NoiseSource noise (42);
+            std::vector<float> block (4099);   // odd length exercises the tail
+            noise.fill (block.data(), (int) block.size());
+
+            double sum = 0.0;
+            float lo = 1.0f, hi = 0.0f;
+            for (auto x : block) { sum += x; lo = juce::jmin (lo, x); hi = juce::jmax (hi, x); }
+            expect (lo >= 0.0f && hi < 1.0f);
+            expectWithinAbsoluteError (sum / (double) block.size(), 0.5, 0.02);
+
+            float refState = 0.1f, state = 0.1f;
+            std::vector<float> expected (block.size());
+            for (size_t i = 0; i < block.size(); ++i)
+            {
+                refState = 0.998f * refState + 0.002f * block[i];
+                expected[i] = 1.0f - 0.7f * refState;
+            }
+            DSPKernels::smoothedNoiseGains (block.data(), (int) block.size(), state, 0.7f);
+
+            float worst = 0.0f;
+            for (size_t i = 0; i < block.size(); ++i)
+                worst = juce::jmax (worst, std::abs (block[i] - expected[i]));
+            expectLessThan (worst, 1.0e-6f);
+            expectWithinAbsoluteError (state, refState, 1.0e-7f);
+        }
+    }
+};
+
+static DSPKernelsTest dspKernelsTest;
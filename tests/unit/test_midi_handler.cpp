@@ -4,6 +4,8 @@
 #include "MidiHandler.h"
 #include "InstrumentHandler.h"
 #include "MidiRecordPlayer.h"
+#include <atomic>
+#include <thread>
 
 class MidiHandlerTest : public juce::UnitTest
 {
@@ -295,6 +297,169 @@ public:
             expect(buffer.getNumEvents() == 0);
         }
 
+        beginTest("getNextMidiBlock - before prepareToPlay events land on sample 0");
+        {
+            MidiDevice device;
+            MidiHandler handler(device);
+            handler.injectMidiMessageAt(juce::MidiMessage::noteOn(1, 60, (juce::uint8)100), 5.0);
+
+            juce::MidiBuffer buffer;
+            handler.getNextMidiBlockAt(buffer, 0, 512, 5.01);
+            expectEquals(buffer.getNumEvents(), 1);
+            for (const auto m : buffer)
+                expectEquals(m.samplePosition, 0);
+        }
+
+        beginTest("getNextMidiBlock - jitter: events land within one sample of their arrival offset");
+        {
+            MidiDevice device;
+            MidiHandler handler(device);
+
+            const double sampleRate = 48000.0;
+            const int blockSize = 480;                        // 10 ms
+            const double period = blockSize / sampleRate;
+            handler.prepareToPlay(sampleRate);
+
+            juce::Random rng(1234);
+            double blockTime = 100.0;
+            juce::MidiBuffer priming;
+            handler.getNextMidiBlockAt(priming, 0, blockSize, blockTime);   // starts the block clock
+
+            int maxError = 0, checked = 0;
+            for (int block = 0; block < 200; ++block)
+            {
+                // A handful of arrivals spread across this period, in time order.
+                std::vector<double> offsets;
+                for (int i = 0; i < 4; ++i)
+                    offsets.push_back(rng.nextDouble() * period * 0.999);
+                std::sort(offsets.begin(), offsets.end());
+
+                for (size_t i = 0; i < offsets.size(); ++i)
+                    handler.injectMidiMessageAt(juce::MidiMessage::noteOn(1, 60 + (int)i, (juce::uint8)100),
+                                                blockTime + offsets[i]);
+
+                blockTime += period;
+                juce::MidiBuffer buffer;
+                handler.getNextMidiBlockAt(buffer, 0, blockSize, blockTime);
+                expectEquals(buffer.getNumEvents(), (int)offsets.size());
+
+                for (const auto m : buffer)
+                {
+                    const int i = m.getMessage().getNoteNumber() - 60;
+                    const double target = offsets[(size_t)i] * sampleRate;
+                    maxError = juce::jmax(maxError, (int)std::ceil(std::abs(m.samplePosition - target)));
+                    ++checked;
+                }
+            }
+
+            expectEquals(checked, 800);
+            expect(maxError <= 1, "worst timing error was " + juce::String(maxError) + " samples");
+        }
+
+        beginTest("getNextMidiBlock - an arrival later than the block is clamped to its last sample");
+        {
+            MidiDevice device;
+            MidiHandler handler(device);
+            handler.prepareToPlay(44100.0);
+
+            juce::MidiBuffer priming;
+            handler.getNextMidiBlockAt(priming, 0, 256, 10.0);
+            handler.injectMidiMessageAt(juce::MidiMessage::noteOn(1, 60, (juce::uint8)100), 10.5);
+
+            juce::MidiBuffer buffer;
+            handler.getNextMidiBlockAt(buffer, 0, 256, 10.0 + 256.0 / 44100.0);
+            expectEquals(buffer.getNumEvents(), 1);
+            for (const auto m : buffer)
+                expectEquals(m.samplePosition, 255);
+        }
+
+        beginTest("midi queues - flooding every producer at once loses no events and keeps per-source order");
+        {
+            MidiDevice device;
+            MidiHandler handler(device);
+
+            constexpr int numSources = (int)MidiSource::NumSources;
+            constexpr int perRound = 4000;                 // just under one queue's capacity
+            constexpr int rounds = 10;
+
+            int received[numSources] = {};
+            int nextSeq[numSources] = {};
+            bool inOrder = true;
+
+            auto consume = [&](juce::MidiBuffer& buffer)
+            {
+                for (const auto m : buffer)
+                {
+                    const auto msg = m.getMessage();
+                    const int src = msg.getChannel() - 1;
+                    const int seq = msg.getControllerNumber() * 128 + msg.getControllerValue();
+                    if (seq != nextSeq[src]) inOrder = false;
+                    nextSeq[src] = seq + 1;
+                    ++received[src];
+                }
+            };
+
+            juce::MidiBuffer buffer;
+            buffer.ensureSize(1 << 20);
+
+            for (int round = 0; round < rounds; ++round)
+            {
+                for (auto& n : nextSeq) n = 0;
+                std::atomic<int> running { numSources };
+
+                std::vector<std::thread> producers;
+                for (int src = 0; src < numSources; ++src)
+                {
+                    producers.emplace_back([&handler, &running, src]
+                    {
+                        for (int seq = 0; seq < perRound; ++seq)
+                        {
+                            const auto cc = juce::MidiMessage::controllerEvent(src + 1, seq / 128, seq % 128);
+                            if (src == (int)MidiSource::HardwareInput)
+                                handler.handleIncomingMidiMessage(nullptr, cc);
+                            else
+                                handler.injectMidiMessage(cc, (MidiSource)src);
+                        }
+                        --running;
+                    });
+                }
+
+                // The audio thread drains concurrently with the producers.
+                while (running.load() > 0)
+                {
+                    buffer.clear();
+                    handler.getNextMidiBlock(buffer, 0, 512);
+                    consume(buffer);
+                }
+
+                for (auto& t : producers) t.join();
+
+                buffer.clear();
+                handler.getNextMidiBlock(buffer, 0, 512);
+                consume(buffer);
+            }
+
+            for (int src = 0; src < numSources; ++src)
+                expectEquals(received[src], perRound * rounds, "source " + juce::String(src));
+            expect(inOrder);
+            expectEquals(handler.getNumDroppedMidiEvents(), 0);
+        }
+
+        beginTest("midi queues - a full queue drops and counts instead of blocking");
+        {
+            MidiDevice device;
+            MidiHandler handler(device);
+
+            for (int i = 0; i < MidiEventQueue::capacity + 10; ++i)
+                handler.injectMidiMessage(juce::MidiMessage::controllerEvent(1, 1, 0), MidiSource::Arranger);
+
+            expect(handler.getNumDroppedMidiEvents() > 0);
+
+            juce::MidiBuffer buffer;
+            handler.getNextMidiBlock(buffer, 0, 512);
+            expectEquals(buffer.getNumEvents() + handler.getNumDroppedMidiEvents(), MidiEventQueue::capacity + 10);
+        }
+
         // ==================================================================
         //  handleIncomingMidiMessage
         // ==================================================================
@@ -0,0 +1,150 @@
+#include <JuceHeader.h>
+#include "TestSfzInstrument.h"
+
+// sfzero::DiskSampleCache: frames decoded on one run are mapped, unchanged, on the next; stale or
+// damaged files are decoded again; and the folder is trimmed to its size limit, least recently
+// used first.
+class SfzDiskCacheTest : public juce::UnitTest
+{
+public:
+    SfzDiskCacheTest() : juce::UnitTest ("sfzero::DiskSampleCache", "Unit") {}
+
+    void runTest() override
+    {
+        formatManager.registerBasicFormats();
+        TestSfzInstrument sfz (3, 0.2);
+        const auto folder = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                                .getNonexistentChildFile ("sfz-disk-cache", {}, false);
+
+        for (bool int16 : { false, true })
+        {
+            beginTest (juce::String ("a warm load maps what a cold load decoded") + (int16 ? " (int16)" : ""));
+            sfzero::DiskSampleCache disk (folder, 1 << 30);
+            disk.clear();
+
+            sfzero::SampleCache coldCache;
+            coldCache.setDiskCache (&disk);
+            auto cold = load (sfz, coldCache, int16);
+            expectEquals (coldCache.getNumDecodes(), 3);
+            expectEquals (disk.getNumWrites(), 3);
+            expectEquals (disk.getNumFiles(), 3);
+
+            sfzero::DiskSampleCache reopened (folder, 1 << 30);   // as on the next run
+            expectEquals (reopened.getNumBytesOnDisk(), disk.getNumBytesOnDisk());
+            sfzero::SampleCache warmCache;
+            warmCache.setDiskCache (&reopened);
+            auto warm = load (sfz, warmCache, int16);
+            expectEquals (warmCache.getNumDecodes(), 0);
+            expectEquals (warmCache.getNumDiskHits(), 3);
+
+            for (int r = 0; r < 3; ++r)
+            {
+                auto* a = cold->regionAt (r)->sample;
+                auto* b = warm->regionAt (r)->sample;
+                expectEquals (b->getNumLoadedFrames(), a->getNumLoadedFrames());
+                const size_t bytes = (size_t) a->getMemoryBytes();
+                const void* dataA = int16 ? (const void*) a->getInt16Data (0) : (const void*) a->getFloatData (0);
+                const void* dataB = int16 ? (const void*) b->getInt16Data (0) : (const void*) b->getFloatData (0);
+                expect (dataB != nullptr && std::memcmp (dataA, dataB, bytes) == 0, "region " + juce::String (r));
+            }
+        }
+
+        beginTest ("an edited source file is decoded again");
+        {
+            sfzero::DiskSampleCache disk (folder, 1 << 30);
+            disk.clear();
+            {
+                sfzero::SampleCache cache;
+                cache.setDiskCache (&disk);
+                load (sfz, cache, false);
+            }
+            const auto sampleFile = sfz.getSampleFile (1);
+            sampleFile.setLastModificationTime (sampleFile.getLastModificationTime() + juce::RelativeTime::seconds (10));
+
+            sfzero::SampleCache cache;
+            cache.setDiskCache (&disk);
+            load (sfz, cache, false);
+            expectEquals (cache.getNumDecodes(), 1);
+            expectEquals (cache.getNumDiskHits(), 2);
+        }
+
+        beginTest ("a damaged file is ignored and replaced");
+        {
+            sfzero::DiskSampleCache disk (folder, 1 << 30);
+            disk.clear();
+            sfzero::SampleCache::Buffer buffer;
+            buffer.allocateInt16 (2, 1000);
+            buffer.getInt16Channel (1)[999] = 1234;
+            disk.write ("key", buffer);
+
+            auto file = onlyFile (folder);
+            expect (file.getSize() > 4000);
+            {
+                juce::MemoryBlock data;
+                file.loadFileAsData (data);
+                file.replaceWithData (data.getData(), data.getSize() - 2);   // truncated
+            }
+            sfzero::SampleCache::Buffer truncated;
+            expect (! disk.read ("key", truncated));
+            expect (! disk.read ("another key", truncated));
+
+            disk.write ("key", buffer);
+            sfzero::SampleCache::Buffer mapped;
+            expect (disk.read ("key", mapped));
+            expect (mapped.isMapped() && mapped.isInt16());
+            expectEquals ((int) mapped.getInt16Channel (1)[999], 1234);
+        }
+
+        beginTest ("the folder is trimmed to its limit, least recently used first");
+        {
+            sfzero::DiskSampleCache disk (folder, 1 << 30);
+            disk.clear();
+            sfzero::SampleCache::Buffer buffer;
+            buffer.allocateInt16 (1, 10000);
+            for (auto key : { "a", "b", "c", "c" })
+                disk.write (key, buffer);
+            expectEquals (disk.getNumFiles(), 3);
+            const juce::int64 fileBytes = folder.findChildFiles (juce::File::findFiles, false).getFirst().getSize();
+            expectEquals (disk.getNumBytesOnDisk(), 3 * fileBytes, "a replaced file counts once");
+
+            const auto anHourAgo = juce::Time::getCurrentTime() - juce::RelativeTime::hours (1);
+            for (const auto& file : folder.findChildFiles (juce::File::findFiles, false))
+                file.setLastModificationTime (anHourAgo);
+            sfzero::SampleCache::Buffer used;
+            expect (disk.read ("a", used));
+
+            disk.setMaxBytes (2 * fileBytes);
+            expectEquals (disk.getNumFiles(), 2);
+            expect (disk.getNumBytesOnDisk() <= 2 * fileBytes);
+            sfzero::SampleCache::Buffer again;
+            expect (disk.read ("a", again), "the recently used file stays");
+
+            disk.write ("d", buffer);   // writing past the limit trims as well
+            expectEquals (disk.getNumFiles(), 2);
+        }
+
+        folder.deleteRecursively();
+    }
+
+private:
+    juce::AudioFormatManager formatManager;
+
+    sfzero::Sound::Ptr load (const TestSfzInstrument& sfz, sfzero::SampleCache& cache, bool int16)
+    {
+        sfzero::Sound::Ptr sound (new sfzero::Sound (sfz.getSfzFile()));
+        sound->loadRegions();
+        sound->setSampleCache (&cache);
+        sound->setInt16Samples (int16);
+        sound->loadSamples (&formatManager);
+        return sound;
+    }
+
+    juce::File onlyFile (const juce::File& folder)
+    {
+        auto files = folder.findChildFiles (juce::File::findFiles, false);
+        expectEquals (files.size(), 1);
+        return files.isEmpty() ? juce::File() : files.getFirst();
+    }
+};
+
+static SfzDiskCacheTest sfzDiskCacheTest;
@@ -0,0 +1,277 @@
+#include <JuceHeader.h>
+#include "TestSfzInstrument.h"
+
+// sfzero::Synth instrument hand-off: neither publishSound nor the audio thread's switch takes the
+// Synthesiser lock, the audio thread switches to every published sound at block start and fades
+// the old voices, and swapped-out Sounds are freed off the audio thread once their voices have
+// stopped.
+class SfzHotSwapTest : public juce::UnitTest
+{
+public:
+    SfzHotSwapTest() : juce::UnitTest ("sfzero::Synth hot swap", "Unit") {}
+
+    void runTest() override
+    {
+        formatManager.registerBasicFormats();
+        TestSfzInstrument sfz (2, 0.2, 44100.0, "ampeg_release=1");
+
+        beginTest ("old voices fade out quickly and the old sound is reclaimed");
+        {
+            Counters counters;
+            sfzero::Synth synth;
+            prepare (synth);
+
+            synth.publishSound (create (sfz, counters).get());
+            expect (synth.hasPublishedSound());
+            expect (synth.applyPublishedSound());
+            synth.noteOn (1, 60, 0.8f);
+            render (synth);
+
+            synth.publishSound (create (sfz, counters).get());
+            expect (synth.applyPublishedSound());
+            expectEquals (synth.getNumRetiredSounds(), 1);
+            render (synth);
+            expectEquals (synth.numVoicesUsed(), 1, "still fading");
+            synth.noteOff (1, 60, 0.0f, true);   // must not restart a 1 s release
+            for (int block = 0; block < 6; ++block)
+                render (synth);
+            expectEquals (synth.numVoicesUsed(), 0, "gone after the 10 ms fade");
+
+            expectEquals (synth.reclaimRetiredSounds(), 1);
+            expectEquals (counters.destroyed.load(), 1);
+            expectEquals (synth.getNumRetiredSounds(), 0);
+        }
+
+        beginTest ("publishing never waits for the Synthesiser lock");
+        {
+            Counters counters;
+            sfzero::Synth synth;
+            prepare (synth);
+            auto sound = create (sfz, counters);
+
+            LockHolder holder (synth.getLock());
+            holder.startThread();
+            expect (holder.locked.wait (5000));
+            synth.publishSound (sound.get());
+            synth.publishSound (nullptr);   // supersedes the first one
+            expect (synth.hasPublishedSound());
+            holder.release.signal();
+            holder.stopThread (5000);
+
+            sound = nullptr;
+            expectEquals (counters.destroyed.load(), 1, "the synth let go of the superseded sound");
+        }
+
+        beginTest ("1000 switches during playback");
+        {
+            Counters counters;
+            {
+                sfzero::SoundReclaimer reclaimer (1);
+                sfzero::Synth synth;
+                prepare (synth);
+                synth.setReclaimer (&reclaimer);
+
+                AudioThread audio (synth, counters);
+                audio.startThread (juce::Thread::Priority::highest);
+
+                // One at a time, so every sound is switched to rather than superseded in the queue.
+                for (int i = 0; i < numSwitches; ++i)
+                {
+                    synth.publishSound (create (sfz, counters).get());
+                    if (! waitUntilApplied (synth))
+                        break;
+                }
+
+                // Let every fade finish.
+                for (int waited = 0; waited < 10000 && synth.getNumRetiredSounds() > 0; waited += 5)
+                    juce::Thread::sleep (5);
+
+                audio.stopThread (5000);
+                expect (! synth.hasPublishedSound());
+                expectEquals (synth.getNumRetiredSounds(), 0);
+                expectEquals (audio.numSwitches.load(), numSwitches);
+                expect (audio.numBlocks > numSwitches);
+                expectEquals (counters.destroyed.load(), numSwitches - 1, "all but the playing sound are freed");
+                synth.setReclaimer (nullptr);
+            }
+            expectEquals (counters.destroyedOnAudioThread.load(), 0);
+        }
+
+        beginTest ("the audio thread switches while another thread holds the Synthesiser lock");
+        {
+            // renderNextBlock takes the Synthesiser lock itself (juce::Synthesiser::processNextBlock),
+            // so this audio thread only runs the switch each block is started with.
+            Counters counters;
+            sfzero::SoundReclaimer reclaimer (1);
+            sfzero::Synth synth;
+            prepare (synth);
+            synth.setReclaimer (&reclaimer);
+
+            LockHolder holder (synth.getLock());
+            holder.startThread();
+            expect (holder.locked.wait (5000));
+
+            AudioThread audio (synth, counters, false);
+            audio.startThread (juce::Thread::Priority::highest);
+
+            constexpr int numLockedSwitches = 50;
+            for (int i = 0; i < numLockedSwitches; ++i)
+            {
+                const int blocksBefore = audio.numBlocks.load();
+                synth.publishSound (create (sfz, counters).get());
+                if (! waitUntilApplied (synth))
+                    break;
+                for (int waited = 0; waited < 5000 && audio.numBlocks.load() == blocksBefore; ++waited)
+                    juce::Thread::sleep (1);
+                expect (audio.numBlocks.load() > blocksBefore, "blocks stalled behind the lock");
+            }
+
+            audio.stopThread (5000);
+            expectEquals (audio.numSwitches.load(), numLockedSwitches);
+            holder.release.signal();
+            holder.stopThread (5000);
+            synth.setReclaimer (nullptr);
+        }
+
+        beginTest ("the voice count changes while the audio thread switches sounds");
+        {
+            // setNumVoices rebuilds the voice lists under the lock; the switch leaves fading the old
+            // voices to the render, which holds it too, so the two never walk the lists at once.
+            Counters counters;
+            sfzero::SoundReclaimer reclaimer (1);
+            sfzero::Synth synth;
+            prepare (synth);
+            synth.setReclaimer (&reclaimer);
+
+            AudioThread audio (synth, counters);
+            audio.startThread (juce::Thread::Priority::highest);
+
+            constexpr int numResizes = 100;
+            for (int i = 0; i < numResizes; ++i)
+            {
+                synth.publishSound (create (sfz, counters).get());
+                synth.setNumVoices (8 + (i % 3) * 8);
+                if (! waitUntilApplied (synth))
+                    break;
+            }
+
+            audio.stopThread (5000);
+            expectEquals (audio.numSwitches.load(), numResizes);
+            synth.setReclaimer (nullptr);
+        }
+    }
+
+private:
+    static constexpr int blockSize = 128, numSwitches = 1000;
+    juce::AudioFormatManager formatManager;
+    sfzero::SampleCache cache;
+
+    struct Counters
+    {
+        std::atomic<int> destroyed { 0 }, destroyedOnAudioThread { 0 };
+        std::atomic<juce::Thread::ThreadID> audioThread { nullptr };
+    };
+
+    struct TrackedSound : public sfzero::Sound
+    {
+        TrackedSound (const juce::File& file, Counters& c) : sfzero::Sound (file), counters (c) {}
+
+        ~TrackedSound() override
+        {
+            ++counters.destroyed;
+            if (juce::Thread::getCurrentThreadId() == counters.audioThread.load())
+                ++counters.destroyedOnAudioThread;
+        }
+
+        Counters& counters;
+    };
+
+    sfzero::Sound::Ptr create (const TestSfzInstrument& sfz, Counters& counters)
+    {
+        sfzero::Sound::Ptr sound (new TrackedSound (sfz.getSfzFile(), counters));
+        sound->loadRegions();
+        sound->setSampleCache (&cache);
+        sound->setNumLoadThreads (1);
+        sound->loadSamples (&formatManager);
+        return sound;
+    }
+
+    static void prepare (sfzero::Synth& synth)
+    {
+        synth.setCurrentPlaybackSampleRate (48000.0);
+        synth.setNumVoices (16);
+    }
+
+    // Waits for the audio thread to switch to the published sound; false after 5 s.
+    bool waitUntilApplied (const sfzero::Synth& synth)
+    {
+        for (int waited = 0; waited < 5000 && synth.hasPublishedSound(); ++waited)
+            juce::Thread::sleep (1);
+        expect (! synth.hasPublishedSound(), "the audio thread never switched");
+        return ! synth.hasPublishedSound();
+    }
+
+    static void render (sfzero::Synth& synth)
+    {
+        juce::AudioBuffer<float> buffer (2, blockSize);
+        juce::MidiBuffer midi;
+        buffer.clear();
+        synth.renderNextBlock (buffer, midi, 0, blockSize);
+    }
+
+    // Plays notes block after block, switching sounds the way AudioHandler::renderJob does. Without
+    // rendering, each block is only the switch.
+    struct AudioThread : public juce::Thread
+    {
+        AudioThread (sfzero::Synth& s, Counters& c, bool shouldRender = true)
+            : juce::Thread ("hot swap audio"), synth (s), counters (c), rendering (shouldRender) {}
+
+        void run() override
+        {
+            counters.audioThread.store (getCurrentThreadId());
+            juce::AudioBuffer<float> buffer (2, blockSize);
+            juce::MidiBuffer midi;
+            midi.ensureSize (256);
+            while (! threadShouldExit())
+            {
+                midi.clear();
+                if (numBlocks % 4 == 0)
+                    midi.addEvent (juce::MidiMessage::noteOn (1, 48 + numBlocks % 24, (juce::uint8) 100), 7);
+                if (numBlocks % 4 == 2)
+                    midi.addEvent (juce::MidiMessage::noteOff (1, 48 + (numBlocks - 2) % 24), 3);
+
+                if (synth.applyPublishedSound())
+                    ++numSwitches;
+                if (rendering)
+                {
+                    buffer.clear();
+                    synth.renderNextBlock (buffer, midi, 0, blockSize);
+                }
+                ++numBlocks;
+                juce::Thread::yield();
+            }
+        }
+
+        sfzero::Synth& synth;
+        Counters& counters;
+        const bool rendering;
+        std::atomic<int> numBlocks { 0 }, numSwitches { 0 };
+    };
+
+    struct LockHolder : public juce::Thread
+    {
+        explicit LockHolder (const juce::CriticalSection& l) : juce::Thread ("lock holder"), lock (l) {}
+
+        void run() override
+        {
+            const juce::ScopedLock sl (lock);
+            locked.signal();
+            release.wait (5000);
+        }
+
+        const juce::CriticalSection& lock;
+        juce::WaitableEvent locked, release;
+    };
+};
+
+static SfzHotSwapTest sfzHotSwapTest;
@@ -0,0 +1,93 @@
+#include <JuceHeader.h>
+#include "TestSfzInstrument.h"
+
+// sfzero::Sound::loadSamples decodes on several threads: the result must match a single-threaded
+// load, progress must end at 1, and thread exit must still cancel it.
+class SfzLoadSamplesTest : public juce::UnitTest
+{
+public:
+    SfzLoadSamplesTest() : juce::UnitTest ("sfzero::Sound loadSamples", "Unit") {}
+
+    void runTest() override
+    {
+        formatManager.registerBasicFormats();
+        TestSfzInstrument sfz (200, 0.05);
+
+        beginTest ("a parallel load matches a serial one");
+        {
+            auto serial = create (sfz, 1);
+            auto parallel = create (sfz, 6);
+            double progress = -1.0;
+            serial->loadSamples (&formatManager);
+            parallel->loadSamples (&formatManager, &progress);
+
+            expectEquals (progress, 1.0);
+            expect (parallel->getErrors().isEmpty());
+            int differing = 0;
+            for (int r = 0; r < serial->getNumRegions(); ++r)
+            {
+                auto* a = serial->regionAt (r)->sample->getBuffer();
+                auto* b = parallel->regionAt (r)->sample->getBuffer();
+                if (b == nullptr || a->getNumSamples() != b->getNumSamples()
+                    || std::memcmp (a->getReadPointer (0), b->getReadPointer (0), sizeof (float) * (size_t) a->getNumSamples()) != 0)
+                    ++differing;
+            }
+            expectEquals (differing, 0);
+        }
+
+        beginTest ("missing samples are reported once each");
+        {
+            auto sound = create (sfz, 4);
+            sfz.getSampleFile (7).deleteFile();
+            sfz.getSampleFile (150).deleteFile();
+            sound->loadSamples (&formatManager);
+            expectEquals (sound->getErrors().size(), 2);
+        }
+
+        beginTest ("thread exit cancels the load");
+        {
+            auto sound = create (sfz, 4);
+            CancelledLoader loader (*sound, formatManager);
+            loader.startThread();
+            expect (loader.waitForThreadToExit (10000));
+
+            int numLoaded = 0;
+            for (int r = 0; r < sound->getNumRegions(); ++r)
+                if (sound->regionAt (r)->sample->getBuffer() != nullptr)
+                    ++numLoaded;
+            expect (numLoaded < sound->getNumRegions() / 2, juce::String (numLoaded) + " samples loaded");
+            expectLessThan (loader.progress, 1.0);
+        }
+    }
+
+private:
+    juce::AudioFormatManager formatManager;
+    juce::ThreadPool loadPool { 5 };
+
+    struct CancelledLoader : public juce::Thread
+    {
+        CancelledLoader (sfzero::Sound& s, juce::AudioFormatManager& fm)
+            : juce::Thread ("cancelled loader"), sound (s), formatManager (fm) {}
+
+        void run() override
+        {
+            signalThreadShouldExit();
+            sound.loadSamples (&formatManager, &progress, this);
+        }
+
+        sfzero::Sound& sound;
+        juce::AudioFormatManager& formatManager;
+        double progress = 0.0;
+    };
+
+    sfzero::Sound::Ptr create (const TestSfzInstrument& sfz, int numThreads)
+    {
+        sfzero::Sound::Ptr sound (new sfzero::Sound (sfz.getSfzFile()));
+        sound->loadRegions();
+        sound->setLoadPool (&loadPool);
+        sound->setNumLoadThreads (numThreads);
+        return sound;
+    }
+};
+
+static SfzLoadSamplesTest sfzLoadSamplesTest;
@@ -0,0 +1,139 @@
+#include <JuceHeader.h>
+#include "TestSfzInstrument.h"
+
+// sfzero::Reader parses straight out of the mapped .sfz: opcodes match exactly, values are read
+// up to the end of the file and no further, and #define / #include are resolved as they are met.
+// SF2 files are read through a mapping too, and their int16 frames stay mapped.
+class SfzReaderTest : public juce::UnitTest
+{
+public:
+    SfzReaderTest() : juce::UnitTest ("sfzero::Reader", "Unit") {}
+
+    void runTest() override
+    {
+        folder = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                     .getNonexistentChildFile ("sfz-reader-test", {}, false);
+        folder.createDirectory();
+
+        beginTest ("opcodes match exactly, not by prefix");
+        {
+            auto sound = load ("<region> sample=a.wav lo=30 lokey=40 hikeyboard=90 hikey=50\n");
+            expectEquals (sound->getNumRegions(), 1);
+            expectEquals (sound->regionAt (0)->lokey, 40);
+            expectEquals (sound->regionAt (0)->hikey, 50);
+            expect (sound->getWarnings().contains ("unsupported opcode: lo"));
+            expect (sound->getWarnings().contains ("unsupported opcode: hikeyboard"));
+        }
+
+        beginTest ("values, tags and comments at the very end of the file");
+        {
+            auto sound = load ("<region> sample=a.wav lokey=c4 hivel=99");
+            expectEquals (sound->getNumRegions(), 1);
+            expectEquals (sound->regionAt (0)->lokey, 60);
+            expectEquals (sound->regionAt (0)->hivel, 99);
+            expect (sound->getErrors().isEmpty(), sound->getErrors().joinIntoString ("; "));
+
+            sound = load ("<region> sample=a.wav\r\n<region> sample=b.wav lokey=3\n// last");
+            expectEquals (sound->getNumRegions(), 2);
+            expect (sound->getErrors().isEmpty(), sound->getErrors().joinIntoString ("; "));
+
+            sound = load ("<region> sample=a.wav\n<regi");
+            expect (sound->getErrors().joinIntoString ("; ").contains ("Unterminated tag (line 2)"));
+        }
+
+        beginTest ("sample paths with spaces");
+        {
+            auto sound = load ("<region> sample=my piano/C 4.wav   lokey=1\n<region> sample=last one.wav   ");
+            expectEquals (sound->getNumRegions(), 2);
+            expectEquals (samplePath (sound->regionAt (0)), folder.getChildFile ("my piano/C 4.wav").getFullPathName());
+            expectEquals (sound->regionAt (0)->lokey, 1);
+            expectEquals (samplePath (sound->regionAt (1)), folder.getChildFile ("last one.wav").getFullPathName());
+        }
+
+        beginTest ("#define substitutes into values and sample paths");
+        {
+            auto sound = load ("#define $KEY 62\n"
+                               "#define $DIR strings\n"
+                               "<region> sample=$DIR/$DIR_low.wav key=$KEY volume=-$KEY\n"
+                               "#define $KEY 64\n"
+                               "<region> sample=$UNDEFINED.wav key=$KEY\n");
+            expectEquals (sound->getNumRegions(), 2);
+            auto* first = sound->regionAt (0);
+            expectEquals (first->pitch_keycenter, 62);
+            expectEquals (first->volume, -62.0f);
+            expectEquals (samplePath (first), folder.getChildFile ("strings/$DIR_low.wav").getFullPathName());
+            expectEquals (sound->regionAt (1)->lokey, 64);
+            expectEquals (samplePath (sound->regionAt (1)), folder.getChildFile ("$UNDEFINED.wav").getFullPathName());
+
+            sound = load ("#define KEY 62\n<region> sample=a.wav\n");
+            expect (sound->getErrors().joinIntoString ("; ").contains ("Malformed #define (line 1)"));
+        }
+
+        beginTest ("#include is parsed where it appears");
+        {
+            folder.getChildFile ("common.sfzh").replaceWithText ("#define $VEL 80\n<group> lovel=$VEL\n");
+            folder.getChildFile ("regions.sfzh").replaceWithText ("<region> sample=a.wav key=60\n<region> sample=b.wav key=61");
+            auto sound = load ("#include \"common.sfzh\"\n"
+                               "#include \"regions.sfzh\"\n"
+                               "<region> sample=c.wav key=62 hivel=$VEL\n"
+                               "#include \"missing.sfzh\"\n");
+            expectEquals (sound->getNumRegions(), 3);
+            for (int r = 0; r < 2; ++r)
+                expectEquals (sound->regionAt (r)->lovel, 80);
+            expectEquals (samplePath (sound->regionAt (1)), folder.getChildFile ("b.wav").getFullPathName());
+            expectEquals (sound->regionAt (2)->hivel, 80);
+            expectEquals (sound->getErrors().size(), 1);
+            expect (sound->getErrors()[0].contains ("Couldn't read #include \"missing.sfzh\" (line 4)"));
+
+            folder.getChildFile ("loop.sfzh").replaceWithText ("#include \"loop.sfzh\"\n");
+            sound = load ("#include \"loop.sfzh\"\n");
+            expect (sound->getErrors().joinIntoString ("; ").contains ("nested too deeply"));
+        }
+
+        beginTest ("SF2 int16 frames are mapped, not copied");
+        {
+            TestSf2File sf2 (3, 2000);
+            sfzero::SF2Sound sound (sf2.getFile());
+            sound.loadRegions();
+            expect (sound.getErrors().isEmpty(), sound.getErrors().joinIntoString ("; "));
+            expectEquals (sound.numSubsounds(), 3);
+            expectEquals (sound.getNumRegions(), 1);
+
+            sfzero::SF2Reader reader (&sound, sf2.getFile());
+            auto mapped = reader.readSamplesInt16();
+            std::unique_ptr<juce::AudioSampleBuffer> floats (reader.readSamples());
+            expect (mapped != nullptr && floats != nullptr);
+            if (mapped != nullptr && floats != nullptr)
+            {
+                expect (mapped->isMapped() && mapped->isInt16());
+                expectEquals (mapped->getNumFrames(), floats->getNumSamples());
+                int mismatches = 0;
+                for (int i = 0; i < mapped->getNumFrames(); ++i)
+                    if (mapped->getInt16Channel (0)[i] / 32767.0f != floats->getSample (0, i))
+                        ++mismatches;
+                expectEquals (mismatches, 0);
+            }
+        }
+
+        folder.deleteRecursively();
+    }
+
+private:
+    juce::File folder;
+
+    sfzero::Sound::Ptr load (const juce::String& sfz)
+    {
+        const auto file = folder.getChildFile ("reader.sfz");
+        file.replaceWithText (sfz);
+        sfzero::Sound::Ptr sound (new sfzero::Sound (file));
+        sound->loadRegions();
+        return sound;
+    }
+
+    static juce::String samplePath (sfzero::Region* region)
+    {
+        return region->sample->getFile().getFullPathName();
+    }
+};
+
+static SfzReaderTest sfzReaderTest;
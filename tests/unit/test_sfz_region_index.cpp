@@ -0,0 +1,113 @@
+#include <JuceHeader.h>
+
+// sfzero::Sound's region lookup index must give exactly the regions a linear scan with
+// Region::matches would, in the same order.
+class SfzRegionIndexTest : public juce::UnitTest
+{
+public:
+    SfzRegionIndexTest() : juce::UnitTest ("sfzero::Sound region index", "Unit") {}
+
+    void runTest() override
+    {
+        const auto folder = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                                .getNonexistentChildFile ("sfz-index-test", {}, false);
+        folder.createDirectory();
+
+        beginTest ("random key/velocity/trigger layouts match the linear scan");
+        {
+            juce::Random rng (17);
+            for (int layout = 0; layout < 8; ++layout)
+            {
+                sfzero::Sound::Ptr sound = load (folder, randomSfz (rng, 20 + layout * 60));
+                expectMatchesLinearScan (*sound, "layout " + juce::String (layout));
+            }
+        }
+
+        beginTest ("overlapping layers, inverted and out-of-range ranges");
+        {
+            sfzero::Sound::Ptr sound = load (folder,
+                "<region> sample=a.wav\n"                                   // everything
+                "<region> sample=a.wav lokey=60 hikey=50\n"                 // empty key range
+                "<region> sample=a.wav lovel=100 hivel=20\n"                // empty velocity range
+                "<region> sample=a.wav lokey=-10 hikey=200 lovel=-5 hivel=300\n"
+                "<region> sample=a.wav key=64 lovel=1 hivel=1 trigger=release\n"
+                "<region> sample=a.wav lokey=0 hikey=0 lovel=127 hivel=127 trigger=first\n"
+                "<region> sample=a.wav lokey=127 hikey=127 trigger=legato\n");
+            expectMatchesLinearScan (*sound, "edge cases");
+        }
+
+        beginTest ("a stale index falls back to every region");
+        {
+            sfzero::Sound::Ptr sound = load (folder, "<region> sample=a.wav lokey=0 hikey=59\n");
+            auto* added = new sfzero::Region();
+            added->lokey = 60;
+            added->hikey = 127;
+            sound->addRegion (added);
+
+            expect (sound->getRegionFor (72, 100) == added);
+            sound->buildRegionIndex();
+            expect (sound->getRegionFor (72, 100) == added);
+            expectEquals (sound->getRegionIndicesFor (72, 100, sfzero::Region::attack).size(), 1);
+        }
+
+        folder.deleteRecursively();
+    }
+
+private:
+    static juce::String randomSfz (juce::Random& rng, int numRegions)
+    {
+        static const char* triggers[] = { "attack", "release", "first", "legato" };
+        juce::String sfz;
+        for (int r = 0; r < numRegions; ++r)
+        {
+            const int lokey = rng.nextInt (128), lovel = rng.nextInt (128);
+            sfz << "<region> sample=s" << r % 7 << ".wav"
+                << " lokey=" << lokey << " hikey=" << juce::jmin (127, lokey + rng.nextInt (24))
+                << " lovel=" << lovel << " hivel=" << juce::jmin (127, lovel + rng.nextInt (64))
+                << " trigger=" << triggers[rng.nextInt (8) < 5 ? 0 : rng.nextInt (4)] << "\n";
+        }
+        return sfz;
+    }
+
+    static sfzero::Sound::Ptr load (const juce::File& folder, const juce::String& sfz)
+    {
+        const auto file = folder.getChildFile ("index.sfz");
+        file.replaceWithText (sfz);
+        sfzero::Sound::Ptr sound (new sfzero::Sound (file));
+        sound->loadRegions();
+        return sound;
+    }
+
+    void expectMatchesLinearScan (sfzero::Sound& sound, const juce::String& what)
+    {
+        const sfzero::Region::Trigger triggers[] = { sfzero::Region::attack, sfzero::Region::release,
+                                                      sfzero::Region::first, sfzero::Region::legato };
+        int mismatches = 0, lookups = 0;
+
+        for (int note = 0; note < 128; ++note)
+        {
+            for (int velocity = 0; velocity < 128; ++velocity)
+            {
+                for (auto trigger : triggers)
+                {
+                    std::vector<int> expected;
+                    for (int i = 0; i < sound.getNumRegions(); ++i)
+                        if (sound.regionAt (i)->matches (note, velocity, trigger))
+                            expected.push_back (i);
+
+                    const auto indices = sound.getRegionIndicesFor (note, velocity, trigger);
+                    const std::vector<int> actual (indices.begin(), indices.end());
+                    auto* first = sound.getRegionFor (note, velocity, trigger);
+
+                    if (actual != expected || first != (expected.empty() ? nullptr : sound.regionAt (expected[0])))
+                        ++mismatches;
+                    ++lookups;
+                }
+            }
+        }
+
+        expectEquals (mismatches, 0, what + ": " + juce::String (mismatches) + " of " + juce::String (lookups) + " lookups differ");
+    }
+};
+
+static SfzRegionIndexTest sfzRegionIndexTest;
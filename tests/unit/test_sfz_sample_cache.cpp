@@ -0,0 +1,140 @@
+#include <JuceHeader.h>
+#include "TestSfzInstrument.h"
+
+// sfzero::SampleCache: Sounds loading the same samples share one decoded buffer without reopening
+// the files, an edited file is decoded again, and unused entries are dropped past the byte budget.
+class SfzSampleCacheTest : public juce::UnitTest
+{
+public:
+    SfzSampleCacheTest() : juce::UnitTest ("sfzero::SampleCache", "Unit") {}
+
+    void runTest() override
+    {
+        formatManager.registerBasicFormats();
+        TestSfzInstrument sfz (3, 0.2);
+
+        beginTest ("concurrent loads share one buffer per sample");
+        {
+            sfzero::SampleCache cache;
+            sfzero::Sound::Ptr sounds[16];
+            {
+                juce::OwnedArray<juce::Thread> loaders;
+                for (auto& sound : sounds)
+                {
+                    sound = new sfzero::Sound (sfz.getSfzFile());
+                    loaders.add (new LoaderThread (*sound, cache, formatManager))->startThread();
+                }
+                for (auto* loader : loaders)
+                    loader->stopThread (10000);
+            }
+
+            expectEquals (cache.getNumDecodes(), 3);
+            expectEquals (cache.getNumHits(), 15 * 3);
+            int shared = 0;
+            for (auto& sound : sounds)
+                for (int r = 0; r < 3; ++r)
+                    if (sound->regionAt (r)->sample->getBuffer() == sounds[0]->regionAt (r)->sample->getBuffer())
+                        ++shared;
+            expectEquals (shared, 16 * 3);
+            expect (sounds[5]->regionAt (1)->sample->getBuffer()->getMagnitude (0, 0, 1000) > 0.1f);
+        }
+
+        beginTest ("a cached sample is found without opening its file");
+        {
+            juce::AudioFormatManager countingManager;
+            auto* wav = new CountingWavFormat();
+            countingManager.registerFormat (wav, true);
+
+            sfzero::SampleCache cache;
+            auto first = load (sfz, cache, countingManager);
+            expectEquals (wav->numReaders.load(), 3);
+            auto second = load (sfz, cache, countingManager);
+            expectEquals (wav->numReaders.load(), 3, "the second load opened a file");
+            expectEquals (cache.getNumHits(), 3);
+            expect (first->regionAt (2)->sample->getBuffer() == second->regionAt (2)->sample->getBuffer());
+            expectEquals (second->regionAt (2)->sample->getSampleRate(), first->regionAt (2)->sample->getSampleRate());
+
+            const auto sampleFile = sfz.getSampleFile (0);
+            sampleFile.setLastModificationTime (sampleFile.getLastModificationTime() + juce::RelativeTime::seconds (10));
+            load (sfz, cache, countingManager);
+            expectEquals (wav->numReaders.load(), 4, "only the edited file is opened again");
+        }
+
+        beginTest ("a modified file is decoded again");
+        {
+            sfzero::SampleCache cache;
+            auto first = load (sfz, cache);
+            const auto sampleFile = sfz.getSampleFile (0);
+            sampleFile.setLastModificationTime (sampleFile.getLastModificationTime() + juce::RelativeTime::seconds (10));
+            auto second = load (sfz, cache);
+
+            expectEquals (cache.getNumDecodes(), 4);
+            expect (first->regionAt (0)->sample->getBuffer() != second->regionAt (0)->sample->getBuffer());
+            expect (first->regionAt (1)->sample->getBuffer() == second->regionAt (1)->sample->getBuffer());
+        }
+
+        beginTest ("unused entries stay cached up to the budget");
+        {
+            sfzero::SampleCache cache;
+            load (sfz, cache);   // released at once
+            expectEquals (cache.getNumEntries(), 3, "kept for the next load");
+            load (sfz, cache);
+            expectEquals (cache.getNumDecodes(), 3);
+
+            auto held = load (sfz, cache);
+            cache.setMaxUnusedBytes (0);
+            expectEquals (cache.getNumEntries(), 3, "entries in use are never dropped");
+            held = nullptr;
+            cache.purgeUnused();
+            expectEquals (cache.getNumEntries(), 0);
+            expectEquals (cache.getNumBytes(), (juce::int64) 0);
+        }
+    }
+
+private:
+    juce::AudioFormatManager formatManager;
+
+    struct CountingWavFormat : public juce::WavAudioFormat
+    {
+        juce::AudioFormatReader* createReaderFor (juce::InputStream* source, bool deleteStreamIfOpeningFails) override
+        {
+            ++numReaders;
+            return juce::WavAudioFormat::createReaderFor (source, deleteStreamIfOpeningFails);
+        }
+
+        std::atomic<int> numReaders { 0 };
+    };
+
+    struct LoaderThread : public juce::Thread
+    {
+        LoaderThread (sfzero::Sound& s, sfzero::SampleCache& c, juce::AudioFormatManager& fm)
+            : juce::Thread ("cache test loader"), sound (s), cache (c), formatManager (fm) {}
+
+        void run() override
+        {
+            sound.loadRegions();
+            sound.setSampleCache (&cache);
+            sound.loadSamples (&formatManager);
+        }
+
+        sfzero::Sound& sound;
+        sfzero::SampleCache& cache;
+        juce::AudioFormatManager& formatManager;
+    };
+
+    sfzero::Sound::Ptr load (const TestSfzInstrument& sfz, sfzero::SampleCache& cache)
+    {
+        return load (sfz, cache, formatManager);
+    }
+
+    static sfzero::Sound::Ptr load (const TestSfzInstrument& sfz, sfzero::SampleCache& cache, juce::AudioFormatManager& manager)
+    {
+        sfzero::Sound::Ptr sound (new sfzero::Sound (sfz.getSfzFile()));
+        sound->loadRegions();
+        sound->setSampleCache (&cache);
+        sound->loadSamples (&manager);
+        return sound;
+    }
+};
+
+static SfzSampleCacheTest sfzSampleCacheTest;
@@ -0,0 +1,94 @@
+#include <JuceHeader.h>
+#include "TestSfzInstrument.h"
+
+// sfzero::Sample::int16 storage: 16-bit samples kept as integers render exactly what the float
+// copy does, take half the memory, and are cached apart from float copies of the same file.
+class SfzSampleFormatTest : public juce::UnitTest
+{
+public:
+    SfzSampleFormatTest() : juce::UnitTest ("sfzero::Sample int16 storage", "Unit") {}
+
+    void runTest() override
+    {
+        formatManager.registerBasicFormats();
+        TestSfzInstrument sfz (3, 0.5);
+
+        beginTest ("int16 voices render bit-identically to float voices");
+        {
+            auto floats = load (sfz, false, nullptr);
+            auto ints   = load (sfz, true, nullptr);
+            auto* sample = ints->regionAt (0)->sample;
+            expect (sample->getInt16Data (0) != nullptr);
+            expect (sample->getFloatData (0) == nullptr);
+            expect (sample->isLoaded());
+
+            for (int note : { 30, 64, 64 + 7, 100 })
+            {
+                sfzero::Voice a, b;
+                start (a, floats, note);
+                start (b, ints, note);
+
+                juce::AudioBuffer<float> outA (2, blockSize), outB (2, blockSize);
+                int blocksDiffering = 0;
+                for (int block = 0; block < 200; ++block)
+                {
+                    outA.clear();
+                    outB.clear();
+                    a.renderNextBlock (outA, 0, blockSize);
+                    b.renderNextBlock (outB, 0, blockSize);
+                    for (int ch = 0; ch < 2; ++ch)
+                        if (std::memcmp (outA.getReadPointer (ch), outB.getReadPointer (ch), sizeof (float) * blockSize) != 0)
+                            ++blocksDiffering;
+                }
+                expectEquals (blocksDiffering, 0, "note " + juce::String (note));
+                expect (outA.getMagnitude (0, blockSize) > 0.0f, "still sounding");
+            }
+        }
+
+        beginTest ("int16 storage takes half the memory");
+        {
+            auto floats = load (sfz, false, nullptr);
+            auto ints   = load (sfz, true, nullptr);
+            auto* sample = floats->regionAt (0)->sample;
+            expect (sample->getNumLoadedFrames() >= 22050);
+            expectEquals (sample->getMemoryBytes(), (juce::int64) sample->getNumLoadedFrames() * (juce::int64) sizeof (float));
+            expectEquals (ints->getMemoryBytes() * 2, floats->getMemoryBytes());
+        }
+
+        beginTest ("float and int16 copies are cached separately");
+        {
+            sfzero::SampleCache cache;
+            auto floats = load (sfz, false, &cache);
+            auto ints   = load (sfz, true, &cache);
+            auto more   = load (sfz, true, &cache);
+            expectEquals (cache.getNumDecodes(), 6);
+            expectEquals (cache.getNumHits(), 3);
+            expect (floats->regionAt (0)->sample->getInt16Data (0) == nullptr);
+            expect (ints->regionAt (0)->sample->getInt16Data (0) == more->regionAt (0)->sample->getInt16Data (0));
+            expectEquals (cache.getNumBytes(), floats->getMemoryBytes() + ints->getMemoryBytes());
+        }
+    }
+
+private:
+    static constexpr int blockSize = 128;
+    juce::AudioFormatManager formatManager;
+
+    sfzero::Sound::Ptr load (const TestSfzInstrument& sfz, bool int16, sfzero::SampleCache* cache)
+    {
+        sfzero::Sound::Ptr sound (new sfzero::Sound (sfz.getSfzFile()));
+        sound->loadRegions();
+        sound->setSampleCache (cache);
+        sound->setInt16Samples (int16);
+        sound->loadSamples (&formatManager);
+        return sound;
+    }
+
+    static void start (sfzero::Voice& voice, sfzero::Sound* sound, int note)
+    {
+        voice.setCurrentPlaybackSampleRate (48000.0);
+        voice.setRegion (sound->getRegionFor (note, 100));
+        voice.startNote (note, 100.0f / 127.0f, sound, 8192);
+    }
+};
+
+static SfzSampleFormatTest sfzSampleFormatTest;
@@ -0,0 +1,113 @@
+#include <JuceHeader.h>
+#include "TestSfzInstrument.h"
+
+// Streaming sfzero samples: a voice reading its sample through a SampleStreamer must render exactly
+// what a voice reading the fully loaded sample does, and frames the streamer cannot supply are
+// counted as underruns.
+class SfzStreamingTest : public juce::UnitTest
+{
+public:
+    SfzStreamingTest() : juce::UnitTest ("sfzero::SampleStreamer", "Unit") {}
+
+    void runTest() override
+    {
+        formatManager.registerBasicFormats();
+        TestSfzInstrument sfz (1, 2.0, 44100.0, "loop_mode=no_loop");
+
+        beginTest ("a streamed voice renders bit-identically to a fully loaded one");
+        {
+            sfzero::SampleStreamer streamer (8, 8192);
+            auto full = load (sfz, nullptr);
+            auto streamed = load (sfz, &streamer);
+            expect (! full->regionAt (0)->sample->isStreaming());
+            expect (streamed->regionAt (0)->sample->isStreaming());
+            expect (streamed->regionAt (0)->sample->getBuffer()->getNumSamples() < 44100 / 10,
+                    "only the head is in memory");
+
+            for (int note : { 64, 76, 52 })
+            {
+                sfzero::Voice a, b;
+                start (a, full, note);
+                start (b, streamed, note);
+                expectEquals (streamer.getNumOpenStreams(), 1);
+
+                juce::AudioBuffer<float> outA (2, blockSize), outB (2, blockSize);
+                int blocksDiffering = 0, block = 0;
+                bool sameLifetime = true;
+                for (; block < maxBlocks && a.hasRegion(); ++block)
+                {
+                    expect (streamer.waitUntilFilled (5000), "the reader keeps up");
+                    outA.clear();
+                    outB.clear();
+                    a.renderNextBlock (outA, 0, blockSize);
+                    b.renderNextBlock (outB, 0, blockSize);
+
+                    for (int ch = 0; ch < 2; ++ch)
+                        if (std::memcmp (outA.getReadPointer (ch), outB.getReadPointer (ch), sizeof (float) * blockSize) != 0)
+                            ++blocksDiffering;
+                    sameLifetime = sameLifetime && a.hasRegion() == b.hasRegion();
+                }
+
+                const juce::String what = "note " + juce::String (note);
+                expect (block > 100 && block < maxBlocks, what + ": the note plays out the sample");
+                expectEquals (blocksDiffering, 0, what);
+                expect (sameLifetime, what + ": both voices end on the same block");
+                expectEquals (streamer.getNumUnderruns(), 0, what);
+            }
+
+            // Closed streams go back to the pool on the reader thread.
+            for (int i = 0; i < 500 && streamer.getNumOpenStreams() > 0; ++i)
+                juce::Thread::sleep (2);
+            expectEquals (streamer.getNumOpenStreams(), 0);
+        }
+
+        beginTest ("a voice without a stream renders its head, then counts underruns");
+        {
+            sfzero::SampleStreamer streamer (1, 8192);
+            auto streamed = load (sfz, &streamer);
+
+            sfzero::Voice first, second;
+            start (first, streamed, 64);
+            start (second, streamed, 64);   // the only stream is taken
+            expectEquals (streamer.getNumStreamsRefused(), 1);
+
+            const int headFrames = streamed->regionAt (0)->sample->getBuffer()->getNumSamples();
+            juce::AudioBuffer<float> out (2, blockSize);
+            float tailPeak = 0.0f;
+            for (int block = 0; block < 200; ++block)
+            {
+                out.clear();
+                second.renderNextBlock (out, 0, blockSize);
+                if (block * blockSize > 2 * headFrames)   // well past the head at any of these pitches
+                    tailPeak = juce::jmax (tailPeak, out.getMagnitude (0, blockSize));
+            }
+
+            expect (streamer.getNumUnderruns() > 0);
+            expect (streamer.getNumUnderrunFrames() > 0);
+            expectEquals (tailPeak, 0.0f, "missing frames render as silence");
+        }
+    }
+
+private:
+    static constexpr int blockSize = 128;
+    static constexpr int maxBlocks = 2000;
+    juce::AudioFormatManager formatManager;
+
+    sfzero::Sound::Ptr load (const TestSfzInstrument& sfz, sfzero::SampleStreamer* streamer)
+    {
+        sfzero::Sound::Ptr sound (new sfzero::Sound (sfz.getSfzFile()));
+        sound->loadRegions();
+        sound->setStreaming (streamer, 0.02);
+        sound->loadSamples (&formatManager);
+        return sound;
+    }
+
+    static void start (sfzero::Voice& voice, sfzero::Sound* sound, int note)
+    {
+        voice.setCurrentPlaybackSampleRate (48000.0);
+        voice.setRegion (sound->getRegionFor (note, 100));
+        voice.startNote (note, 100.0f / 127.0f, sound, 8192);
+    }
+};
+
+static SfzStreamingTest sfzStreamingTest;
@@ -0,0 +1,160 @@
+#include <JuceHeader.h>
+#include "TestSfzInstrument.h"
+
+// sfzero::Synth polyphony: the per-synth voice budget, the shared VoiceLimit and which voice a
+// note-on steals when both are used up.
+class SfzSynthTest : public juce::UnitTest
+{
+public:
+    SfzSynthTest() : juce::UnitTest ("sfzero::Synth voices", "Unit") {}
+
+    void runTest() override
+    {
+        formatManager.registerBasicFormats();
+        TestSfzInstrument sfz (1, 0.1, 44100.0, "ampeg_release=2");
+        TestSfzInstrument shortSfz (1, 0.01, 44100.0, "loop_mode=no_loop");
+        sfzero::Sound::Ptr sound = load (sfz);
+
+        beginTest ("the voice budget caps polyphony");
+        {
+            sfzero::Synth synth;
+            prepare (synth, sound, 8);
+            for (int note = 40; note < 52; ++note)
+                synth.noteOn (1, note, 0.8f);
+            render (synth);
+
+            expectEquals (synth.numVoicesUsed(), 8);
+            for (int note = 44; note < 52; ++note)
+                expectEquals (synth.numVoicesPlayingNote (1, note), 1, "the newest notes sound");
+        }
+
+        beginTest ("a releasing voice is stolen first");
+        {
+            sfzero::Synth synth;
+            prepare (synth, sound, 8);
+            for (int note = 40; note < 48; ++note)
+                synth.noteOn (1, note, note == 43 ? 1.0f : 0.5f);   // the released note is the loudest
+            render (synth);
+            synth.noteOff (1, 43, 0.0f, true);
+            render (synth);
+
+            synth.noteOn (1, 60, 0.8f);
+            expectEquals (synth.numVoicesPlayingNote (1, 43), 0);
+            expectEquals (synth.numVoicesPlayingNote (1, 60), 1);
+            for (int note : { 40, 41, 42, 44, 45, 46, 47 })
+                expectEquals (synth.numVoicesPlayingNote (1, note), 1);
+        }
+
+        beginTest ("sustained voices go before held ones");
+        {
+            sfzero::Synth synth;
+            prepare (synth, sound, 4);
+            synth.handleSustainPedal (1, true);
+            for (int note = 40; note < 44; ++note)
+                synth.noteOn (1, note, note < 42 ? 0.3f : 1.0f);
+            synth.noteOff (1, 42, 0.0f, true);   // keys up, but the pedal keeps them sounding
+            synth.noteOff (1, 43, 0.0f, true);
+            render (synth);
+
+            synth.noteOn (1, 60, 0.8f);
+            expectEquals (synth.numVoicesPlayingNote (1, 40), 1, "quiet but held");
+            expectEquals (synth.numVoicesPlayingNote (1, 41), 1, "quiet but held");
+            expectEquals (synth.numVoicesPlayingNote (1, 42) + synth.numVoicesPlayingNote (1, 43), 1);
+        }
+
+        beginTest ("the quietest held voice is stolen");
+        {
+            sfzero::Synth synth;
+            prepare (synth, sound, 4);
+            const float velocities[] = { 0.8f, 0.2f, 0.7f, 0.9f };
+            for (int i = 0; i < 4; ++i)
+                synth.noteOn (1, 40 + i, velocities[i]);
+            render (synth);
+
+            synth.noteOn (1, 60, 0.8f);
+            expectEquals (synth.numVoicesPlayingNote (1, 41), 0);
+            expectEquals (synth.numVoicesUsed(), 4);
+        }
+
+        beginTest ("a shared VoiceLimit caps several synths");
+        {
+            sfzero::VoiceLimit limit (6);
+            sfzero::Synth a, b;
+            prepare (a, sound, 8);
+            prepare (b, sound, 8);
+            a.setVoiceLimit (&limit);
+            b.setVoiceLimit (&limit);
+
+            for (int note = 40; note < 44; ++note)
+                a.noteOn (1, note, 0.8f);
+            for (int note = 50; note < 54; ++note)
+                b.noteOn (2, note, 0.8f);
+            render (a);
+            render (b);
+
+            expectEquals (limit.getNumVoicesInUse(), 6);
+            expectEquals (a.numVoicesUsed(), 4);
+            expectEquals (b.numVoicesUsed(), 2, "b stole its own voices");
+            expectEquals (b.numVoicesPlayingNote (2, 53), 1);
+
+            a.allNotesOff (1, false);
+            expectEquals (limit.getNumVoicesInUse(), 2, "a's slots come back at once");
+            b.noteOn (2, 60, 0.8f);
+            expectEquals (b.numVoicesUsed(), 3);
+
+            a.setVoiceLimit (nullptr);
+            b.setVoiceLimit (nullptr);
+            expectEquals (limit.getNumVoicesInUse(), 0);
+        }
+
+        beginTest ("finished voices return to the pool");
+        {
+            sfzero::VoiceLimit limit (64);
+            sfzero::Synth synth;
+            prepare (synth, load (shortSfz), 8);
+            synth.setVoiceLimit (&limit);
+            for (int note = 40; note < 48; ++note)
+                synth.noteOn (1, note, 0.8f);
+            expectEquals (limit.getNumVoicesInUse(), 8);
+
+            for (int block = 0; block < 20; ++block)
+                render (synth);
+            expectEquals (synth.numVoicesUsed(), 0);
+            expectEquals (limit.getNumVoicesInUse(), 0);
+
+            // And they are usable again.
+            for (int note = 40; note < 48; ++note)
+                synth.noteOn (1, note, 0.8f);
+            expectEquals (synth.numVoicesUsed(), 8);
+            synth.setVoiceLimit (nullptr);
+        }
+    }
+
+private:
+    juce::AudioFormatManager formatManager;
+
+    sfzero::Sound::Ptr load (const TestSfzInstrument& sfz)
+    {
+        sfzero::Sound::Ptr sound (new sfzero::Sound (sfz.getSfzFile()));
+        sound->loadRegions();
+        sound->loadSamples (&formatManager);
+        return sound;
+    }
+
+    static void prepare (sfzero::Synth& synth, sfzero::Sound* sound, int numVoices)
+    {
+        synth.setCurrentPlaybackSampleRate (48000.0);
+        synth.setNumVoices (numVoices);
+        synth.addSound (sound);
+    }
+
+    static void render (sfzero::Synth& synth)
+    {
+        juce::AudioBuffer<float> buffer (2, 128);
+        juce::MidiBuffer midi;
+        buffer.clear();
+        synth.renderNextBlock (buffer, midi, 0, buffer.getNumSamples());
+    }
+};
+
+static SfzSynthTest sfzSynthTest;
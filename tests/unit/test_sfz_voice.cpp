@@ -0,0 +1,104 @@
+#include <JuceHeader.h>
+#include "TestSfzInstrument.h"
+#include "ScalarVoiceRenderer.h"
+
+// sfzero::Voice::renderNextBlock (runs between loop seams and envelope segment changes) against
+// ScalarVoiceRenderer, the per-sample loop it replaced.
+class SfzVoiceTest : public juce::UnitTest
+{
+public:
+    SfzVoiceTest() : juce::UnitTest ("sfzero::Voice", "Unit") {}
+
+    void runTest() override
+    {
+        formatManager.registerBasicFormats();
+
+        beginTest ("looping sine, several pitch ratios");
+        {
+            // A short sample, so every voice crosses the loop seam many times.
+            TestSfzInstrument sfz (1, 0.05);
+            for (int note : { 63, 64, 51, 76, 70, 57, 100 })
+                compare (sfz, note, 2, 200, 120, "note " + juce::String (note));
+        }
+
+        beginTest ("no loop: the voice ends at the sample end");
+        {
+            TestSfzInstrument sfz (1, 0.05, 44100.0, "loop_mode=no_loop");
+            for (int note : { 64, 70, 40 })
+                compare (sfz, note, 2, 100, -1, "note " + juce::String (note));
+        }
+
+        beginTest ("envelope segments and release");
+        {
+            TestSfzInstrument sfz (1, 0.05, 44100.0,
+                                   "ampeg_delay=0.002 ampeg_attack=0.01 ampeg_hold=0.003 ampeg_decay=0.05 "
+                                   "ampeg_sustain=40 ampeg_release=0.03");
+            for (int note : { 64, 67, 52 })
+                compare (sfz, note, 2, 150, 40, "note " + juce::String (note));
+        }
+
+        beginTest ("loop_sustain stops looping at note off");
+        {
+            TestSfzInstrument sfz (1, 0.05, 44100.0, "loop_mode=loop_sustain ampeg_release=1");
+            compare (sfz, 64, 2, 150, 10, "loop_sustain");
+        }
+
+        beginTest ("mono output");
+        {
+            TestSfzInstrument sfz (1, 0.05, 44100.0, "pan=-40 ampeg_release=0.02");
+            compare (sfz, 66, 1, 100, 50, "mono");
+        }
+    }
+
+private:
+    static constexpr int blockSize = 128;
+    juce::AudioFormatManager formatManager;
+
+    // Plays one note on two voices, one per renderer, and checks every block matches. Each case is
+    // long enough for the note to end (sample end, or the release after noteOffBlock).
+    void compare (const TestSfzInstrument& sfz, int note, int numChannels, int numBlocks, int noteOffBlock,
+                  const juce::String& what)
+    {
+        sfzero::Sound::Ptr sound (new sfzero::Sound (sfz.getSfzFile()));
+        sound->loadRegions();
+        sound->loadSamples (&formatManager);
+
+        sfzero::Voice runs, scalar;
+        for (auto* voice : { &runs, &scalar })
+        {
+            voice->setCurrentPlaybackSampleRate (48000.0);
+            voice->setRegion (sound->getRegionFor (note, 100));
+            voice->startNote (note, 100.0f / 127.0f, sound.get(), 8192);
+        }
+
+        juce::AudioBuffer<float> a (numChannels, blockSize), b (numChannels, blockSize);
+        float maxError = 0.0f;
+        bool sameLifetime = true;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            if (block == noteOffBlock)
+            {
+                runs.stopNote (0.0f, true);
+                scalar.stopNote (0.0f, true);
+            }
+
+            a.clear();
+            b.clear();
+            // Odd start and length, so runs straddle block boundaries too.
+            runs.renderNextBlock (a, 3, blockSize - 3);
+            sfzero::ScalarVoiceRenderer::render (scalar, b, 3, blockSize - 3);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    maxError = juce::jmax (maxError, std::abs (a.getSample (ch, i) - b.getSample (ch, i)));
+            sameLifetime = sameLifetime && (runs.hasRegion() == scalar.hasRegion());
+        }
+
+        expect (maxError < 1.0e-5f, what + ": max error " + juce::String (maxError));
+        expect (sameLifetime, what + ": both voices end on the same block");
+        expect (! runs.hasRegion(), what + ": the voice has ended");
+    }
+};
+
+static SfzVoiceTest sfzVoiceTest;